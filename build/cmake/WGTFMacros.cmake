@@ -216,6 +216,16 @@ MACRO( BW_ADD_TOOL_TEST _PROJNAME )
 	BW_ADD_TEST( ${_PROJNAME} )
 ENDMACRO( BW_ADD_TOOL_TEST )
 
+# Benchmarks are built next to the unit tests, but are only run by hand
+MACRO( BW_ADD_TOOL_BENCHMARK _PROJNAME )
+	BW_GET_TEST_DST_DIR(TEST_DIR)
+	BW_SET_OUTPUT_NAMES( ${_PROJNAME} )
+	BW_SET_BINARY_DIR( ${_PROJNAME} "${TEST_DIR}" )
+
+	BW_DEPLOY_DEPENDENCY_TARGETS( ${_PROJNAME}  )
+	WGTF_SETUP_COMPILE_FLAGS(${_PROJNAME})
+ENDMACRO( BW_ADD_TOOL_BENCHMARK )
+
 MACRO( BW_TARGET_LINK_LIBRARIES )
 	TARGET_LINK_LIBRARIES(${ARGN} core_common)
 ENDMACRO( BW_TARGET_LINK_LIBRARIES )
@@ -23,7 +23,10 @@ IF( WG_UNIT_TESTS_ENABLED )
 		string_utils_unit_test				core/lib/core_string_utils/unit_test
 		qt_common_unit_test					core/lib/core_qt_common/unit_test
 		wg_types_unit_test					core/lib/wg_types/unit_test
+		wg_memory_unit_test					core/lib/wg_memory/unit_test
+		logging_system_unit_test			core/lib/core_logging_system/unit_test
 		curve_editor_unit_test				core/plugins/plg_curve_editor/unit_test
+		editor_interaction_unit_test		core/plugins/plg_editor_interaction/unit_test
 		)
 
 	IF(MSVC)
@@ -41,6 +44,16 @@ IF( WG_UNIT_TESTS_ENABLED )
 	ENABLE_TESTING()
 ENDIF()
 
+IF( WG_UNIT_TESTS_ENABLED AND WG_BENCHMARKS_ENABLED )
+	LIST( APPEND BW_TOOLS_BENCHMARK_BINARIES
+		core_common_benchmark				core/lib/core_common/benchmark
+		variant_benchmark					core/lib/core_variant/benchmark
+		core_data_model_benchmark			core/lib/core_data_model/benchmark
+		)
+
+	MESSAGE( STATUS "Benchmarks enabled for tools." )
+ENDIF()
+
 # Automated testing framework plugins
 LIST( APPEND WG_TOOLS_AUTO_TEST_PLUGINS
 	plg_cassert_test		core/testing/plg_cassert_test
@@ -59,6 +72,9 @@ LIST( APPEND BW_LIBRARY_PROJECTS
 LIST( APPEND BW_BINARY_PROJECTS
 	# Unit tests
 	${BW_TOOLS_UNIT_TEST_BINARIES}
+
+	# Benchmarks
+	${BW_TOOLS_BENCHMARK_BINARIES}
 )
 
 # Add all the plugin test projects
@@ -124,6 +124,10 @@ int Main(int argc, char** argv)
 	NGTAllocator::enableDebugOutput(allocatorDebugOutput);
 	NGTAllocator::enableStackTraces(allocatorStackTraces);
 	NGTAllocator::enableLeakDetection(allocatorLeakDetection);
+	if (clp->getFlag("--allocatorSlab"))
+	{
+		NGTAllocator::setBackend(NGTAllocator::Backend::SLAB);
+	}
 
 	setCustomLoggingHandle([](LogLevel level, const char* message)
 	{
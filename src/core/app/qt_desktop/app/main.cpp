@@ -351,6 +351,10 @@ int Main(int argc, char** argv)
 	NGTAllocator::enableDebugOutput(clp->getFlag("--allocatorDebugOutput"));
 	NGTAllocator::enableStackTraces(clp->getFlag("--allocatorStackTraces"));
 	NGTAllocator::enableLeakDetection(clp->getFlag("--allocatorLeakDetection"));
+	if (clp->getFlag("--allocatorSlab"))
+	{
+		NGTAllocator::setBackend(NGTAllocator::Backend::SLAB);
+	}
 
 	const bool unattended = clp->getFlag("-unattended");
 
@@ -9,6 +9,7 @@ enum SerializationFormat : int
 {
 	DEFAULT,
 	XML,
+	BINARY,
 	END
 };
 
@@ -4,6 +4,7 @@
 #include "../../../lib/core_dependency_system/i_interface.hpp"
 #include "../../../lib/core_serialization_new/serializationdocument.hpp"
 #include "../../../lib/core_serialization_new/serializationnode.hpp"
+#include <functional>
 #include <memory>
 
 namespace wgt
@@ -23,6 +24,10 @@ virtual bool serializeToStream(const Variant& v, IDataStream* stream, Serializat
 virtual bool deserializeFromDocument(Variant& v, SerializationDocument* doc) = 0;
 virtual bool deserializeFromStream(Variant& v, IDataStream* stream, SerializationFormat format) = 0;
 
+// Reads the children of the root node one at a time, without loading the whole document where the format allows.
+virtual bool readEachFromStream(IDataStream* stream, SerializationFormat format,
+                                const std::function<bool(const std::unique_ptr<SerializationNode>&)>& callback) = 0;
+
 DECLARE_INTERFACE_END()
 
 } // end namespace wgt
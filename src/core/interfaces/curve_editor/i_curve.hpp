@@ -68,6 +68,13 @@ public:
 	*/
 	virtual BezierPointData at(unsigned int /*index*/) = 0;
 
+	/*! Gets the values on the curve at each of the specified times
+	    @param times the points in time between 0.0 and 1.0, sampling is fastest when they are in increasing order
+	    @param o_Values receives the value at each time
+	    @param count the number of times to sample
+	*/
+	virtual void sample(const float* /*times*/, float* /*o_Values*/, size_t /*count*/) = 0;
+
 	/*! Removes the point at the specified time
 	    @param time an exact time between 0.0 and 1.0 at which to remove a point
 	*/
@@ -19,6 +19,15 @@ namespace wgt
 {
 class BezierPoint;
 
+/*! The curve between two points in polynomial form, for a time t between 0.0 and 1.0:
+    x(t) = x[0] + x[1] * t + x[2] * t^2 + x[3] * t^3, and likewise for y
+*/
+struct CurveSegment
+{
+	float x[4];
+	float y[4];
+};
+
 class ICurveInterpolator
 {
 public:
@@ -38,6 +47,11 @@ public:
 	*/
 	virtual float timeAtX(float x, const BezierPoint& p1, const BezierPoint& p2) = 0;
 
+	/*! Gets the curve between the specified points in polynomial form, so that it can be sampled
+	    without going through the points
+	*/
+	virtual CurveSegment getSegment(const BezierPoint& p1, const BezierPoint& p2) = 0;
+
 	/*! Update the control points for the previous and next positions of the given point
 	*/
 	virtual void updateControlPoints(BezierPoint& point, BezierPoint* prevPoint, BezierPoint* nextPoint) = 0;
@@ -2,17 +2,60 @@
 #define I_BACKGROUND_WORKER_HPP
 
 #include <functional>
+#include <memory>
+#include <vector>
 
 namespace wgt
 {
+/**
+* Handle to a job queued on an IBackgroundWorker.
+*/
+class IBackgroundJob
+{
+public:
+	virtual ~IBackgroundJob() {}
+
+	/** Stops the job from starting, along with any jobs that depend on it.
+	A job that is already running keeps running, long jobs should check isCancelled to stop early. */
+	virtual void cancel() = 0;
+	virtual bool isCancelled() const = 0;
+
+	/** Returns true once the job has run, or has been skipped because it was cancelled. */
+	virtual bool isDone() const = 0;
+
+	/** Blocks until the job is done. Never wait on a foreground job from the foreground thread. */
+	virtual void wait() const = 0;
+};
+typedef std::shared_ptr<IBackgroundJob> BackgroundJobPtr;
+
 class IBackgroundWorker
 {
 public:
 	typedef std::function<void()> JobFunction;
+	typedef std::function<void(const IBackgroundJob&)> CancellableJobFunction;
+	typedef std::vector<BackgroundJobPtr> JobDependencies;
+
+	enum class JobPriority
+	{
+		High,
+		Normal,
+		Low
+	};
+
 	virtual ~IBackgroundWorker() {}
 	virtual void queueBackgroundJob(JobFunction backgroundJob) = 0;
 	virtual void queueForegroundJob(JobFunction foregroundJob) = 0;
+
+	/** Queues a job to run on a background thread once all of its dependencies are done.
+	Jobs with a higher priority start first. The job is given its own handle to check for cancellation. */
+	virtual BackgroundJobPtr queueJob(CancellableJobFunction job, JobPriority priority = JobPriority::Normal,
+	                                  const JobDependencies& dependencies = JobDependencies()) = 0;
+
+	/** Queues a job to run on the application's update once all of its dependencies are done,
+	such as a continuation that shows the results of background jobs. */
+	virtual BackgroundJobPtr queueForegroundJob(CancellableJobFunction foregroundJob,
+	                                            const JobDependencies& dependencies) = 0;
 };
 
 }
-#endif //I_BACKGROUND_WORKER_HPP
\ No newline at end of file
+#endif //I_BACKGROUND_WORKER_HPP
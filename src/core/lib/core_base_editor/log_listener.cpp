@@ -52,7 +52,8 @@ struct LogListener::Impl
 	{
 		if (message != nullptr && message->getLevel() <= logLevel_)
 		{
-			logReport_.push_back(*static_cast<LogMessage*>(message));
+			// Messages are only valid during the call, and need not be LogMessages
+			logReport_.emplace_back(message->getLevel(), message->str());
 		}
 	}
 	LogLevel logLevel_;
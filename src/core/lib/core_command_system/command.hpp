@@ -60,6 +60,18 @@ public:
 		return CommandThreadAffinity::COMMAND_THREAD;
 	}
 
+	/**
+	 *	Whether instances of this command touch no state shared with other commands
+	 *	and may run at the same time as neighbouring independent commands.
+	 *	Consecutive independent commands are executed on the command manager's worker pool,
+	 *	their results are still added to the undo history in the order they were queued.
+	 *	Independent commands must not queue sub commands or require the UI thread.
+	 */
+	virtual bool isIndependent() const
+	{
+		return false;
+	}
+
 	virtual const char* getName() const
 	{
 		return getId();
@@ -202,32 +202,51 @@ bool CommandInstance::redo()
 //==============================================================================
 void CommandInstance::execute()
 {
-	const Command* command = getCommand();
-	Variant result;
-	if (command->customUndo())
-	{
-		result = command->execute(arguments_);
-		undoRedoData_.emplace_back(new CustomUndoRedoData(*this));
-	}
-	else
+	beginExecute(std::this_thread::get_id());
+	runExecute();
+	endExecute();
+}
+
+//==============================================================================
+void CommandInstance::beginExecute(std::thread::id threadId)
+{
+	if (!getCommand()->customUndo())
 	{
-		auto undoRedoData = new ReflectionUndoRedoData(*this);
-		undoRedoData->connect();
-		result = command->execute(arguments_);
-		undoRedoData->disconnect();
-		undoRedoData_.emplace_back(undoRedoData);
+		executingUndoRedoData_.reset(new ReflectionUndoRedoData(*this));
+		executingUndoRedoData_->connect(threadId);
 	}
-	command->fireCommandExecuted(*this, CommandOperation::EXECUTE);
+}
 
+//==============================================================================
+void CommandInstance::runExecute()
+{
+	Variant result = getCommand()->execute(arguments_);
 	if (!result.tryCast<CommandErrorCode>(errorCode_))
 	{
 		// Not returning a CommandErrorCode assumes the code is COMMAND_NO_ERROR.
 		// @see Command::execute()
-        errorCode_ = CommandErrorCode::COMMAND_NO_ERROR;
+		errorCode_ = CommandErrorCode::COMMAND_NO_ERROR;
 		returnValue_ = result;
 	}
 }
 
+//==============================================================================
+void CommandInstance::endExecute()
+{
+	const Command* command = getCommand();
+	if (command->customUndo())
+	{
+		undoRedoData_.emplace_back(new CustomUndoRedoData(*this));
+	}
+	else
+	{
+		TF_ASSERT(executingUndoRedoData_ != nullptr);
+		executingUndoRedoData_->disconnect();
+		undoRedoData_.emplace_back(executingUndoRedoData_.release());
+	}
+	command->fireCommandExecuted(*this, CommandOperation::EXECUTE);
+}
+
 //==============================================================================
 bool CommandInstance::isComplete() const
 {
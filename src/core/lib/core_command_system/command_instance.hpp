@@ -12,6 +12,7 @@
 #include "core_reflection_utils/commands/reflectedproperty_undoredo_helper.hpp"
 
 #include <mutex>
+#include <thread>
 #include "core_common/wg_condition_variable.hpp"
 
 namespace wgt
@@ -129,6 +130,12 @@ private:
 
 	void waitForCompletion();
 
+	// Stages of execute(), split so undo listeners can be connected for a thread
+	// before commands are handed to the command manager's worker pool
+	void beginExecute(std::thread::id threadId);
+	void runExecute();
+	void endExecute();
+
 	void setStatus(ExecutionStatus status);
     void setArguments(const std::nullptr_t&);
 	void setArguments(const ObjectHandle& arguments);
@@ -152,6 +159,7 @@ private:
 	ObjectHandle contextObject_;
 	CommandErrorCode errorCode_;
 	std::vector<UndoRedoDataPtr> undoRedoData_;
+	std::unique_ptr<ReflectionUndoRedoData> executingUndoRedoData_;
     mutable ManagedObject<GenericObject> description_;
 };
 } // end namespace wgt
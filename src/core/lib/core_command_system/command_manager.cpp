@@ -15,15 +15,21 @@
 #include "core_reflection/i_object_manager.hpp"
 #include "core_logging/logging.hpp"
 #include "batch_command.hpp"
+#include <algorithm>
 #include <atomic>
 #include <deque>
+#include <functional>
 #include <map>
 #include <mutex>
+#include <thread>
+#include <vector>
 #include "core_common/assert.hpp"
 #include "core_common/wg_condition_variable.hpp"
+#include "core_common/wg_mpsc_queue.hpp"
 #include "core_common/thread_local_value.hpp"
 #include "wg_types/binary_block.hpp"
 #include "reflection_undo_redo_data.hpp"
+#include "undo_redo_store.hpp"
 #include "core_environment_system/i_env_system.hpp"
 #include <memory>
 
@@ -41,6 +47,8 @@ namespace
 static const char* s_macroVersion = "_macro_ver_0_0_0";
 const int NO_SELECTION = -1;
 static const char* s_macro_file = "macro";
+// Commands that can be queued before the submitting threads start contending on the worker mutex
+const size_t SUBMITTED_COMMANDS_CAPACITY = 4096;
 
 struct CommandFrame
 {
@@ -55,6 +63,131 @@ struct CommandFrame
 	std::deque<CommandInstancePtr> commandQueue_;
 };
 
+/*
+A command pushed by queueCommand that has not been moved to its frame's command queue yet.
+*/
+struct SubmittedCommand
+{
+	SubmittedCommand() : frame_(nullptr)
+	{
+	}
+
+	SubmittedCommand(CommandFrame* frame, const CommandInstancePtr& instance) : frame_(frame), instance_(instance)
+	{
+	}
+
+	CommandFrame* frame_;
+	CommandInstancePtr instance_;
+};
+
+/*
+Fixed set of threads running independent commands, one job per thread per round.
+Bounding a round by the thread count lets every job be bound to a known thread before it starts.
+*/
+class CommandWorkerPool
+{
+public:
+	CommandWorkerPool() : round_(0), pending_(0), exiting_(false)
+	{
+	}
+
+	~CommandWorkerPool()
+	{
+		stop();
+	}
+
+	void start(size_t threadCount)
+	{
+		TF_ASSERT(threads_.empty());
+		exiting_ = false;
+		for (size_t i = 0; i < threadCount; ++i)
+		{
+			threads_.emplace_back(&CommandWorkerPool::threadFunc, this, i);
+			threadIds_.push_back(threads_.back().get_id());
+		}
+	}
+
+	void stop()
+	{
+		{
+			std::unique_lock<std::mutex> lock(mutex_);
+			exiting_ = true;
+			wakeUp_.notify_all();
+		}
+
+		for (auto& thread : threads_)
+		{
+			thread.join();
+		}
+		threads_.clear();
+		threadIds_.clear();
+	}
+
+	size_t size() const
+	{
+		return threads_.size();
+	}
+
+	std::thread::id threadId(size_t index) const
+	{
+		return threadIds_[index];
+	}
+
+	// Run jobs[i] on thread i and block until all of them have returned
+	void run(std::vector<std::function<void()>>& jobs)
+	{
+		TF_ASSERT(jobs.size() <= threads_.size());
+		std::unique_lock<std::mutex> lock(mutex_);
+		jobs_.swap(jobs);
+		pending_ = jobs_.size();
+		++round_;
+		wakeUp_.notify_all();
+		done_.wait(lock, [this] { return pending_ == 0; });
+		jobs_.swap(jobs);
+	}
+
+private:
+	void threadFunc(size_t index)
+	{
+		uint64_t round = 0;
+		std::unique_lock<std::mutex> lock(mutex_);
+		for (;;)
+		{
+			wakeUp_.wait(lock, [this, round] { return round_ != round || exiting_; });
+			if (exiting_)
+			{
+				return;
+			}
+
+			round = round_;
+			if (index >= jobs_.size())
+			{
+				continue;
+			}
+
+			auto& job = jobs_[index];
+			lock.unlock();
+			job();
+			lock.lock();
+
+			if (--pending_ == 0)
+			{
+				done_.notify_one();
+			}
+		}
+	}
+
+	std::vector<std::thread> threads_;
+	std::vector<std::thread::id> threadIds_;
+	std::vector<std::function<void()>> jobs_;
+	std::mutex mutex_;
+	wg_condition_variable wakeUp_; // assumed predicate: round_ changed || exiting_
+	wg_condition_variable done_; // assumed predicate: pending_ == 0
+	uint64_t round_;
+	size_t pending_;
+	bool exiting_;
+};
+
 class HistoryEnvComponentState : public IEnvComponentState
 {
 public:
@@ -65,6 +198,8 @@ public:
         , commandFrames_()
         , currentFrame_(nullptr)
 		, abortingBatchCommand_(false)
+		, submittedCommands_(SUBMITTED_COMMANDS_CAPACITY)
+		, submittedCount_(0)
 	{
 		commandFrames_.emplace_back(new CommandFrame(nullptr));
 		THREAD_LOCAL_SET(currentFrame_, commandFrames_.back().get());
@@ -91,6 +226,14 @@ public:
     std::vector<std::unique_ptr<CommandFrame>> commandFrames_;
 	THREAD_LOCAL(CommandFrame*) currentFrame_;
 	bool abortingBatchCommand_;
+
+	// Commands pushed without holding the worker mutex, moved to their frames by drainSubmittedCommands
+	wg_mpsc_queue<SubmittedCommand> submittedCommands_;
+	// Number of pushed commands not drained yet, may briefly go negative while a push is in flight
+	std::atomic<int> submittedCount_;
+
+	// Undo/redo streams of every command added to the history of this environment
+	UndoRedoStore undoRedoStore_;
 };
 
 bool isBatchCommand(const CommandInstancePtr& cmd)
@@ -106,7 +249,9 @@ public:
 	      ownerThreadId_(std::this_thread::get_id()), workerThreadId_(), workerMutex_(), workerWakeUp_(),
 	      ownerWakeUp_(false), commands_(), globalEventListener_(), exiting_(false), enableWorker_(true),
 	      pCommandManager_(pCommandManager), workerThread_(), batchCommand_(pCommandManager),
-	      undoRedoCommand_(pCommandManager), application_(nullptr)
+	      undoRedoCommand_(pCommandManager), application_(nullptr), workerPool_(),
+	      workerPoolSize_(std::max(std::thread::hardware_concurrency() / 2, 1u)),
+	      historyMemoryBudget_(UndoRedoStore::DEFAULT_MEMORY_BUDGET), executingIndependent_(false)
 	{
 		CommandManagerEventListener* listener = new CommandManagerEventListener();
 		listener->setCommandSystemProvider(pCommandManager_);
@@ -165,6 +310,9 @@ public:
 	void flush(LockedStateT<HistoryEnvComponentState>& state);
 	void threadFunc();
 	bool executingCommandGroup();
+	void setWorkerPoolSize(size_t size);
+	void setHistoryMemoryBudget(size_t bytes);
+	size_t getHistoryMemoryFootprint(const EnvironmentId& envId);
 
 	int currentIndex_;
 	int* previousSelectedIndex_; // always point to active state's previous selected index
@@ -207,8 +355,23 @@ private:
 	UndoRedoCommand undoRedoCommand_;
 
 	IApplication* application_;
+
+	/*
+	Threads running consecutive independent commands, started on first use.
+	Only touched by the thread that set executingIndependent_.
+	*/
+	CommandWorkerPool workerPool_;
+	std::atomic<size_t> workerPoolSize_;
+	// Applied to the undo/redo store of each environment as history is added
+	std::atomic<size_t> historyMemoryBudget_;
+	// Guarded by workerMutex_, stops other threads from running commands past an independent group
+	bool executingIndependent_;
+
 	void addBatchCommandToCompoundCommand(CompoundCommand* compoundCommand,
 	                                      const CommandInstancePtr& instance);
+	void drainSubmittedCommands(HistoryEnvComponentState& state);
+	void executeIndependent(LockedStateT<HistoryEnvComponentState>& state, std::unique_lock<std::mutex>& lock,
+	                        CommandFrame& commandFrame);
 };
 
 void CommandManagerImpl::clearMacros()
@@ -305,6 +468,7 @@ void CommandManagerImpl::fini()
 	{
 		workerThread_.join();
 	}
+	workerPool_.stop();
 	finiEnvComponent();
 }
 
@@ -412,11 +576,52 @@ CommandInstancePtr CommandManagerImpl::queueCommand(LockedStateT<HistoryEnvCompo
 	std::thread::id currentThreadId = std::this_thread::get_id();
 	assert((currentThreadId == workerThreadId_ || currentThreadId == ownerThreadId_) &&
 	       "queueCommand can only be called in command thread and owner thread. \n");
+
+	// Push the command for the command frame of the current thread without taking the worker mutex.
+	// It is moved onto the frame's queue by whichever thread processes commands next.
+	SubmittedCommand submitted(THREAD_LOCAL_GET(state->currentFrame_), instance);
+	while (!state->submittedCommands_.try_push(submitted))
 	{
+		// Full, make room ourselves
 		std::unique_lock<std::mutex> lock(workerMutex_);
-		// Push the command onto the queue of the relevant command frame, determined by the current thread
-		
-		auto commandFrame = THREAD_LOCAL_GET(state->currentFrame_);
+		drainSubmittedCommands(*state);
+	}
+
+	// If earlier submissions are still pending, the thread that made the first of them
+	// will drain ours too once it gets the lock, so there is nothing left to do here.
+	if (state->submittedCount_.fetch_add(1) > 0)
+	{
+		return instance;
+	}
+
+	// Try to execute the queued commands instantly.
+	// This will either execute the command or notify the appropriate thread to start processing
+	processCommands(state);
+
+    return instance;
+}
+
+//==============================================================================
+void CommandManagerImpl::drainSubmittedCommands(HistoryEnvComponentState& state)
+{
+	SubmittedCommand submitted;
+	for (;;)
+	{
+		if (!state.submittedCommands_.try_pop(submitted))
+		{
+			// A counted submission can sit behind a push that hasn't been published yet.
+			// Its submitter has returned expecting us to take it, so wait for the slot to be filled.
+			if (state.submittedCount_.load() <= 0)
+			{
+				break;
+			}
+			std::this_thread::yield();
+			continue;
+		}
+		state.submittedCount_.fetch_sub(1);
+
+		auto commandFrame = submitted.frame_;
+		auto& instance = submitted.instance_;
 		commandFrame->commandQueue_.push_back(instance);
 
 		// If the command is a batch command we need to push/pop to the current command frames stack queue.
@@ -442,12 +647,6 @@ CommandInstancePtr CommandManagerImpl::queueCommand(LockedStateT<HistoryEnvCompo
 			}
 		}
 	}
-
-	// Try to execute the queued commands instantly.
-	// This will either execute the command or notify the appropriate thread to start processing
-	processCommands(state);
-
-    return instance;
 }
 
 //==============================================================================
@@ -466,29 +665,29 @@ void CommandManagerImpl::waitForInstance(LockedStateT<HistoryEnvComponentState>&
 	// 5: EndBatchCommand
 	// command 4 actually needs to wait for command 1, as the result of command 2 should not be visible to
 	// command 4 until the BatchCommand it belongs to has completed.
-	std::deque<CommandInstancePtr> stackQueue;
-	std::deque<CommandInstancePtr> commandQueue;
-	CommandInstancePtr batchFrame = nullptr;
+	// Only the queued commands from that batch up to the instance are needed, copy just those.
+	std::vector<CommandInstancePtr> commandQueue;
 	{
 		std::unique_lock<std::mutex> lock(workerMutex_);
+		drainSubmittedCommands(*state);
 		auto commandFrame = THREAD_LOCAL_GET(state->currentFrame_);
-        stackQueue = commandFrame->stackQueue_;
-		commandQueue = commandFrame->commandQueue_;
-	}
-
-	auto first = commandQueue.begin();
-	auto last = std::find(commandQueue.begin(), commandQueue.end(), instance);
-	for (auto batch = stackQueue.rbegin(); batch != stackQueue.rend(); ++batch)
-	{
-		auto it = std::find(first, last, *batch);
-		if (it != last)
+		auto& stackQueue = commandFrame->stackQueue_;
+		auto first = commandFrame->commandQueue_.begin();
+		auto last = std::find(first, commandFrame->commandQueue_.end(), instance);
+		for (auto batch = stackQueue.rbegin(); batch != stackQueue.rend(); ++batch)
 		{
-			first = it;
-			break;
+			auto it = std::find(first, last, *batch);
+			if (it != last)
+			{
+				first = it;
+				break;
+			}
 		}
+		commandQueue.assign(first, last);
 	}
 
-	auto it = last;
+	auto first = commandQueue.begin();
+	auto it = commandQueue.end();
 	auto waitFor = instance;
 	while (waitFor != nullptr)
 	{
@@ -770,14 +969,16 @@ void CommandManagerImpl::popFrame(LockedStateT<HistoryEnvComponentState>& state,
 				parentInstance->consolidateChildren();
 			}
 		}
-		if (parentInstance == nullptr)
+		if (isBatch)
 		{
-			if (isBatch)
+			if (parentInstance == nullptr)
 			{
 				instance->consolidateUndoRedoData(parentInstance.get());
 				instance->consolidateChildren();
-				pCommandManager_->notifyCompleteMultiCommand();
 			}
+
+			// Every batch reports completing, as every batch reports beginning when it executes
+			pCommandManager_->notifyCompleteMultiCommand();
 		}
 	}
 
@@ -789,6 +990,16 @@ void CommandManagerImpl::addToHistory(LockedStateT<HistoryEnvComponentState>& st
 {
 	if (instance.get()->getCommand()->canUndo(instance.get()->getArguments()))
 	{
+		// The streams are final once the root instance is consolidated, move them out to the store
+		state->undoRedoStore_.setMemoryBudget(historyMemoryBudget_);
+		for (auto& data : instance->undoRedoData_)
+		{
+			auto reflectionUndoRedoData = dynamic_cast<ReflectionUndoRedoData*>(data.get());
+			if (reflectionUndoRedoData != nullptr)
+			{
+				reflectionUndoRedoData->store(state->undoRedoStore_);
+			}
+		}
 		state->pendingHistory_.push_back(instance);
 	}
 }
@@ -821,6 +1032,13 @@ void CommandManagerImpl::processCommands(LockedStateT<HistoryEnvComponentState>&
 		std::unique_lock<std::mutex> lock(workerMutex_);
 		for (;;)
 		{
+			drainSubmittedCommands(*state);
+			if (executingIndependent_)
+			{
+				// Another thread is running a group of independent commands, it will carry on afterwards
+				break;
+			}
+
 			auto commandFrame = state->commandFrames_.back().get();
 			if (commandFrame->commandQueue_.empty())
 			{
@@ -844,6 +1062,13 @@ void CommandManagerImpl::processCommands(LockedStateT<HistoryEnvComponentState>&
 				break;
 			}
 
+			if (job->getCommand()->isIndependent() && threadAffinity != CommandThreadAffinity::UI_THREAD &&
+			    workerPoolSize_ > 0)
+			{
+				executeIndependent(state, lock, *commandFrame);
+				continue;
+			}
+
 			commandFrame->commandQueue_.pop_front();
 
 			if (strcmp(job->getCommandId(), typeid(UndoRedoCommand).name()) == 0)
@@ -868,11 +1093,13 @@ void CommandManagerImpl::processCommands(LockedStateT<HistoryEnvComponentState>&
 				lock.lock();
 
 				// Spin and process commands until all sub commands for this frame have been executed
+				drainSubmittedCommands(*state);
 				while (!currentFrame->commandQueue_.empty() || state->commandFrames_.back().get() != currentFrame)
 				{
 					lock.unlock();
 					processCommands(state);
 					lock.lock();
+					drainSubmittedCommands(*state);
 				}
 
 				// Pop the command frame
@@ -913,19 +1140,106 @@ void CommandManagerImpl::processCommands(LockedStateT<HistoryEnvComponentState>&
 	updateSelected(state, static_cast<int>(history_.size() - 1));
 }
 
+//==============================================================================
+void CommandManagerImpl::executeIndependent(LockedStateT<HistoryEnvComponentState>& state,
+                                            std::unique_lock<std::mutex>& lock, CommandFrame& commandFrame)
+{
+	TF_ASSERT(!executingIndependent_);
+	executingIndependent_ = true;
+
+	const size_t poolSize = workerPoolSize_;
+	if (workerPool_.size() != poolSize)
+	{
+		workerPool_.stop();
+		workerPool_.start(poolSize);
+	}
+
+	// Take the run of independent commands at the front of the queue, at most one per pool thread
+	std::vector<CommandInstancePtr> group;
+	auto& commandQueue = commandFrame.commandQueue_;
+	while (!commandQueue.empty() && group.size() < poolSize)
+	{
+		auto& job = commandQueue.front();
+		if (!job->getCommand()->isIndependent() ||
+		    job->getCommand()->threadAffinity() == CommandThreadAffinity::UI_THREAD)
+		{
+			break;
+		}
+		group.push_back(job);
+		commandQueue.pop_front();
+	}
+	TF_ASSERT(!group.empty());
+
+	lock.unlock(); // release lock while running commands
+
+	// Listeners are only registered from this thread, each recording changes from the pool thread
+	// its command is assigned to, so none are added or removed while the group is running.
+	std::vector<std::function<void()>> jobs;
+	for (size_t i = 0; i < group.size(); ++i)
+	{
+		auto& job = group[i];
+		job->setStatus(Running);
+		job->beginExecute(workerPool_.threadId(i));
+		jobs.emplace_back([job] { job->runExecute(); });
+	}
+	workerPool_.run(jobs);
+	for (auto& job : group)
+	{
+		job->endExecute();
+	}
+
+	lock.lock();
+
+	// Push and pop a frame for each command in queue order, so undo data is consolidated
+	// into enclosing batches and history exactly as if the commands had run one by one.
+	auto previousFrame = THREAD_LOCAL_GET(state->currentFrame_);
+	for (auto& job : group)
+	{
+		pushFrame(state, job);
+		popFrame(state, lock);
+	}
+	THREAD_LOCAL_SET(state->currentFrame_, previousFrame);
+
+	executingIndependent_ = false;
+	workerWakeUp_.notify_all();
+}
+
+//==============================================================================
+void CommandManagerImpl::setWorkerPoolSize(size_t size)
+{
+	workerPoolSize_ = size;
+}
+
+//==============================================================================
+void CommandManagerImpl::setHistoryMemoryBudget(size_t bytes)
+{
+	historyMemoryBudget_ = bytes;
+	auto lockedState = getActiveStateT();
+	lockedState->undoRedoStore_.setMemoryBudget(bytes);
+}
+
+//==============================================================================
+size_t CommandManagerImpl::getHistoryMemoryFootprint(const EnvironmentId& envId)
+{
+	auto lockedState = getStateTByEnvId(envId);
+	return lockedState->undoRedoStore_.getMemoryFootprint();
+}
+
 //==============================================================================
 void CommandManagerImpl::flush(LockedStateT<HistoryEnvComponentState>& state)
 {
 	TF_ASSERT(std::this_thread::get_id() == ownerThreadId_);
 
 	std::unique_lock<std::mutex> lock(workerMutex_);
+	drainSubmittedCommands(*state);
 
 	while (state->commandFrames_.size() > 1 || !state->commandFrames_.front()->commandQueue_.empty() ||
-	       !state->pendingHistory_.empty())
+	       !state->pendingHistory_.empty() || executingIndependent_)
 	{
 		lock.unlock();
 		processCommands(state);
 		lock.lock();
+		drainSubmittedCommands(*state);
 	}
 }
 
@@ -938,8 +1252,9 @@ void CommandManagerImpl::flush(LockedStateT<HistoryEnvComponentState>& state)
 	{
 		workerWakeUp_.wait(lock, [this] {
 			auto lockedState = getActiveStateT();
+			drainSubmittedCommands(*lockedState);
 			auto& commandFrame = *lockedState->commandFrames_.back();
-			return !commandFrame.commandQueue_.empty() || exiting_;
+			return (!commandFrame.commandQueue_.empty() && !executingIndependent_) || exiting_;
 		});
 
 		// execute commands
@@ -1088,6 +1403,11 @@ void HistoryEnvComponentState::resetState()
 	cmdMgrImpl_.previousSelectedIndex_ = &previousSelectedIndex_;
 	cmdMgrImpl_.pCommandManager_->signalPostCommandIndexChanged(cmdMgrImpl_.currentIndex_);
 	currentFrame_ = nullptr;
+	SubmittedCommand submitted;
+	while (submittedCommands_.try_pop(submitted))
+	{
+		submittedCount_.fetch_sub(1);
+	}
 	commandFrames_.clear();
 	commandFrames_.emplace_back(new CommandFrame(nullptr));
 	THREAD_LOCAL_SET(currentFrame_, commandFrames_.back().get());
@@ -1128,6 +1448,24 @@ void CommandManager::fini()
 	pImpl_->fini();
 }
 
+//==============================================================================
+void CommandManager::setWorkerPoolSize(size_t size)
+{
+	pImpl_->setWorkerPoolSize(size);
+}
+
+//==============================================================================
+void CommandManager::setHistoryMemoryBudget(size_t bytes)
+{
+	pImpl_->setHistoryMemoryBudget(bytes);
+}
+
+//==============================================================================
+size_t CommandManager::getHistoryMemoryFootprint(const EnvironmentId& envId) const
+{
+	return pImpl_->getHistoryMemoryFootprint(envId);
+}
+
 //==============================================================================
 void CommandManager::registerCommand(Command* command)
 {
@@ -1315,7 +1653,6 @@ bool CommandManager::executingCommandGroup()
 void CommandManager::beginBatchCommand()
 {
 	auto lockedState = pImpl_->getActiveStateT();
-	notifyBeginMultiCommand();
 	pImpl_->beginBatchCommand(lockedState);
 }
 
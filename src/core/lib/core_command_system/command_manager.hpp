@@ -3,6 +3,7 @@
 
 #include "command_instance.hpp"
 #include "i_command_manager.hpp"
+#include "core_environment_system/i_env_system.hpp"
 
 #include <functional>
 #include <vector>
@@ -45,6 +46,24 @@ public:
 
 	void fini() override;
 
+	/**
+	 *	Set the number of threads used to run independent commands.
+	 *	@see Command::isIndependent()
+	 *	@param size thread count, 0 runs independent commands one by one like any other.
+	 */
+	void setWorkerPoolSize(size_t size);
+
+	/**
+	 *	Set the number of bytes of undo/redo data each environment keeps in memory.
+	 *	Older history is paged out to a scratch file beyond that, 0 keeps all history in memory.
+	 */
+	void setHistoryMemoryBudget(size_t bytes);
+
+	/**
+	 *	Bytes of undo/redo data the history of the given environment currently holds in memory.
+	 */
+	size_t getHistoryMemoryFootprint(const EnvironmentId& envId) const;
+
 	// From ICommandManager begin
 	void registerCommand(Command* command) override;
 	void deregisterCommand(const char* commandId) override;
@@ -51,6 +51,11 @@ public:
 	{
 	}
 
+	void setThreadId(std::thread::id threadId)
+	{
+		createdThreadId_ = threadId;
+	}
+
 	void preSetValue(const PropertyAccessor& accessor, const Variant& value) override
 	{
 		if (createdThreadId_ != std::this_thread::get_id())
@@ -255,9 +260,15 @@ ReflectionUndoRedoData::~ReflectionUndoRedoData()
 }
 
 void ReflectionUndoRedoData::connect()
+{
+	connect(std::this_thread::get_id());
+}
+
+void ReflectionUndoRedoData::connect(std::thread::id threadId)
 {
 	auto definitionManager = commandInstance_.defManager_;
 	TF_ASSERT(definitionManager != nullptr);
+	static_cast<PropertyAccessorWrapper*>(paListener_.get())->setThreadId(threadId);
 	definitionManager->registerPropertyAccessorListener(paListener_);
 }
 
@@ -270,6 +281,12 @@ void ReflectionUndoRedoData::disconnect()
 
 void ReflectionUndoRedoData::consolidate()
 {
+	if (undoRedoHelperList_.empty() && (storedUndoData_ != nullptr || storedRedoData_ != nullptr))
+	{
+		// Already consolidated and handed over to the history store
+		return;
+	}
+
 	auto definitionManager = commandInstance_.defManager_;
 	TF_ASSERT(definitionManager != nullptr);
 
@@ -290,6 +307,28 @@ void ReflectionUndoRedoData::consolidate()
 	undoRedoHelperList_.clear();
 }
 
+void ReflectionUndoRedoData::store(UndoRedoStore& store)
+{
+	if (!undoData_.buffer().empty())
+	{
+		storedUndoData_ = store.store(UndoRedoStore::UNDO_STREAM, undoData_.takeBuffer());
+	}
+	if (!redoData_.buffer().empty())
+	{
+		storedRedoData_ = store.store(UndoRedoStore::REDO_STREAM, redoData_.takeBuffer());
+	}
+}
+
+ResizingMemoryStream::Buffer ReflectionUndoRedoData::undoBuffer() const
+{
+	return storedUndoData_ != nullptr ? UndoRedoStore::load(storedUndoData_) : undoData_.buffer();
+}
+
+ResizingMemoryStream::Buffer ReflectionUndoRedoData::redoBuffer() const
+{
+	return storedRedoData_ != nullptr ? UndoRedoStore::load(storedRedoData_) : redoData_.buffer();
+}
+
 bool ReflectionUndoRedoData::undo()
 {
 	auto definitionManager = commandInstance_.defManager_;
@@ -297,10 +336,10 @@ bool ReflectionUndoRedoData::undo()
 	const auto pObjectManager = definitionManager->getObjectManager();
 	TF_ASSERT(pObjectManager != nullptr);
 
-	if (!undoData_.buffer().empty())
+	ResizingMemoryStream undoStream(undoBuffer());
+	if (!undoStream.buffer().empty())
 	{
-		undoData_.seek(0);
-		XMLSerializer serializer(undoData_, *definitionManager);
+		XMLSerializer serializer(undoStream, *definitionManager);
 		return RPURU::performReflectedUndo(serializer, *pObjectManager, *definitionManager);
 	}
 	return false;
@@ -312,10 +351,10 @@ bool ReflectionUndoRedoData::redo()
 	TF_ASSERT(definitionManager != nullptr);
 	const auto pObjectManager = definitionManager->getObjectManager();
 	TF_ASSERT(pObjectManager != nullptr);
-	if (!redoData_.buffer().empty())
+	ResizingMemoryStream redoStream(redoBuffer());
+	if (!redoStream.buffer().empty())
 	{
-		redoData_.seek(0);
-		XMLSerializer serializer(redoData_, *definitionManager);
+		XMLSerializer serializer(redoStream, *definitionManager);
 		return RPURU::performReflectedRedo(serializer, *pObjectManager, *definitionManager);
 	}
 	return false;
@@ -338,7 +377,7 @@ CommandDescription ReflectionUndoRedoData::getCommandDescription() const
 
 		// Make a copy because this function should not modify stream contents
 		// TODO ResizingMemoryStream const read implementation
-		ResizingMemoryStream undoStream(undoData_.buffer());
+		ResizingMemoryStream undoStream(undoBuffer());
 		TF_ASSERT(!undoStream.buffer().empty());
 		XMLSerializer undoSerializer(undoStream, *definitionManager);
 
@@ -350,7 +389,7 @@ CommandDescription ReflectionUndoRedoData::getCommandDescription() const
 
 		// Make a copy because this function should not modify stream contents
 		// TODO ResizingMemoryStream const read implementation
-		ResizingMemoryStream redoStream(redoData_.buffer());
+		ResizingMemoryStream redoStream(redoBuffer());
 		TF_ASSERT(!redoStream.buffer().empty());
 		XMLSerializer redoSerializer(redoStream, *definitionManager);
 
@@ -502,21 +541,25 @@ CommandDescription ReflectionUndoRedoData::getCommandDescription() const
 
 BinaryBlock ReflectionUndoRedoData::getUndoData() const
 {
-	return BinaryBlock(undoData_.buffer().c_str(), undoData_.buffer().length(), true);
+	const auto buffer = undoBuffer();
+	return BinaryBlock(buffer.c_str(), buffer.length(), true);
 }
 
 BinaryBlock ReflectionUndoRedoData::getRedoData() const
 {
-	return BinaryBlock(redoData_.buffer().c_str(), redoData_.buffer().length(), true);
+	const auto buffer = redoBuffer();
+	return BinaryBlock(buffer.c_str(), buffer.length(), true);
 }
 
 void ReflectionUndoRedoData::setUndoData(const BinaryBlock& undoData)
 {
+	storedUndoData_.reset();
 	undoData_.setBuffer(std::string(undoData.cdata(), undoData.length()));
 }
 
 void ReflectionUndoRedoData::setRedoData(const BinaryBlock& redoData)
 {
+	storedRedoData_.reset();
 	redoData_.setBuffer(std::string(redoData.cdata(), redoData.length()));
 }
 
@@ -2,11 +2,13 @@
 #define REFLECTION_UNDO_REDO_DATA_HPP
 
 #include "undo_redo_data.hpp"
+#include "undo_redo_store.hpp"
 #include "core_serialization/resizing_memory_stream.hpp"
 #include "core_reflection_utils/commands/reflectedproperty_undoredo_helper.hpp"
 #include "core_object/managed_object.hpp"
 
 #include <memory>
+#include <thread>
 #include <vector>
 
 namespace wgt
@@ -24,9 +26,19 @@ public:
 	virtual ~ReflectionUndoRedoData();
 
 	void connect();
+
+	/**
+	 *	Record property changes made on the given thread only.
+	 */
+	void connect(std::thread::id threadId);
 	void disconnect();
 	void consolidate();
 
+	/**
+	 *	Move the consolidated undo/redo streams into the history store.
+	 */
+	void store(UndoRedoStore& store);
+
 	bool undo() override;
 	bool redo() override;
 
@@ -39,9 +51,14 @@ public:
 	const CommandInstance& getCommandInstance() const;
 
 private:
+	ResizingMemoryStream::Buffer undoBuffer() const;
+	ResizingMemoryStream::Buffer redoBuffer() const;
+
 	CommandInstance& commandInstance_;
 	ResizingMemoryStream undoData_;
 	ResizingMemoryStream redoData_;
+	UndoRedoStore::EntryPtr storedUndoData_;
+	UndoRedoStore::EntryPtr storedRedoData_;
 	std::shared_ptr<PropertyAccessorListener> paListener_;
 	ReflectedPropertyUndoRedoUtility::UndoRedoHelperList undoRedoHelperList_;
 };
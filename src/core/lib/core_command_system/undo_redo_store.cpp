@@ -0,0 +1,277 @@
+#include "undo_redo_store.hpp"
+
+#include "core_common/assert.hpp"
+#include "core_logging/logging.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <cstdio>
+#include <deque>
+#include <mutex>
+
+namespace wgt
+{
+namespace
+{
+// Deltas are only applied against bases this many steps deep, bounding the cost of a load
+const size_t MAX_DELTA_DEPTH = 8;
+
+//------------------------------------------------------------------------------
+bool seekScratch(FILE* file, uint64_t offset)
+{
+#if defined(_WIN32)
+	return _fseeki64(file, static_cast<__int64>(offset), SEEK_SET) == 0;
+#else
+	return fseeko(file, static_cast<off_t>(offset), SEEK_SET) == 0;
+#endif
+}
+}
+
+//==============================================================================
+struct UndoRedoStore::Impl
+{
+	Impl() : scratchFile_(nullptr), scratchSize_(0), memoryBudget_(UndoRedoStore::DEFAULT_MEMORY_BUDGET), footprint_(0)
+	{
+	}
+
+	~Impl()
+	{
+		if (scratchFile_ != nullptr)
+		{
+			fclose(scratchFile_);
+		}
+	}
+
+	void enforceBudget();
+	bool spill(Entry& entry);
+	std::string decode(const Entry& entry);
+
+	std::mutex mutex_;
+	FILE* scratchFile_;
+	uint64_t scratchSize_;
+	std::atomic<size_t> memoryBudget_;
+	std::atomic<size_t> footprint_;
+
+	// Entries holding data in memory, oldest first
+	std::deque<std::weak_ptr<Entry>> residentEntries_;
+	// Last stored entry and its decoded stream per kind, used as the base of the next delta.
+	// Entries keep the store alive, so only weak references are held back to them.
+	std::weak_ptr<Entry> previous_[STREAM_KIND_COUNT];
+	std::string previousBuffer_[STREAM_KIND_COUNT];
+};
+
+//==============================================================================
+struct UndoRedoStore::Entry
+{
+	Entry(const std::shared_ptr<Impl>& store) : store_(store), prefix_(0), suffix_(0), depth_(0), spilled_(false),
+	                                            offset_(0), spilledSize_(0)
+	{
+	}
+
+	~Entry()
+	{
+		if (!spilled_)
+		{
+			store_->footprint_ -= data_.size();
+		}
+	}
+
+	std::shared_ptr<Impl> store_;
+	// Stream this entry is a delta of, null if data_ holds the full stream
+	EntryPtr base_;
+	// Bytes taken from the start and end of the decoded base
+	size_t prefix_;
+	size_t suffix_;
+	size_t depth_;
+	std::string data_;
+	bool spilled_;
+	uint64_t offset_;
+	size_t spilledSize_;
+};
+
+//------------------------------------------------------------------------------
+bool UndoRedoStore::Impl::spill(Entry& entry)
+{
+	if (scratchFile_ == nullptr)
+	{
+		scratchFile_ = tmpfile();
+		if (scratchFile_ == nullptr)
+		{
+			NGT_WARNING_MSG("Failed to create undo history scratch file, history will stay in memory\n");
+			memoryBudget_ = 0;
+			return false;
+		}
+	}
+
+	if (!seekScratch(scratchFile_, scratchSize_) ||
+	    fwrite(entry.data_.data(), 1, entry.data_.size(), scratchFile_) != entry.data_.size())
+	{
+		NGT_WARNING_MSG("Failed to write undo history scratch file\n");
+		return false;
+	}
+
+	entry.spilled_ = true;
+	entry.offset_ = scratchSize_;
+	entry.spilledSize_ = entry.data_.size();
+	scratchSize_ += entry.spilledSize_;
+	footprint_ -= entry.spilledSize_;
+	std::string().swap(entry.data_);
+	return true;
+}
+
+//------------------------------------------------------------------------------
+void UndoRedoStore::Impl::enforceBudget()
+{
+	const size_t budget = memoryBudget_;
+	while (budget != 0 && footprint_ > budget && !residentEntries_.empty())
+	{
+		auto entry = residentEntries_.front().lock();
+		residentEntries_.pop_front();
+		if (entry == nullptr || entry->spilled_)
+		{
+			continue;
+		}
+
+		if (!spill(*entry))
+		{
+			return;
+		}
+	}
+}
+
+//------------------------------------------------------------------------------
+std::string UndoRedoStore::Impl::decode(const Entry& entry)
+{
+	std::string data;
+	if (entry.spilled_)
+	{
+		data.resize(entry.spilledSize_);
+		if (!seekScratch(scratchFile_, entry.offset_) ||
+		    fread(&data[0], 1, entry.spilledSize_, scratchFile_) != entry.spilledSize_)
+		{
+			NGT_ERROR_MSG("Failed to read undo history scratch file\n");
+			return std::string();
+		}
+	}
+	else
+	{
+		data = entry.data_;
+	}
+
+	if (entry.base_ == nullptr)
+	{
+		return data;
+	}
+
+	const std::string base = decode(*entry.base_);
+	TF_ASSERT(entry.prefix_ + entry.suffix_ <= base.size());
+	std::string result;
+	result.reserve(entry.prefix_ + data.size() + entry.suffix_);
+	result.append(base, 0, entry.prefix_);
+	result.append(data);
+	result.append(base, base.size() - entry.suffix_, entry.suffix_);
+	return result;
+}
+
+//==============================================================================
+UndoRedoStore::UndoRedoStore() : impl_(new Impl())
+{
+}
+
+//------------------------------------------------------------------------------
+UndoRedoStore::~UndoRedoStore()
+{
+}
+
+//------------------------------------------------------------------------------
+UndoRedoStore::EntryPtr UndoRedoStore::store(StreamKind kind, std::string buffer)
+{
+	TF_ASSERT(kind < STREAM_KIND_COUNT);
+	std::lock_guard<std::mutex> guard(impl_->mutex_);
+
+	EntryPtr entry(new Entry(impl_));
+	auto previous = impl_->previous_[kind].lock();
+	auto& previousBuffer = impl_->previousBuffer_[kind];
+	if (previous != nullptr && previous->depth_ < MAX_DELTA_DEPTH)
+	{
+		const size_t maxShared = std::min(buffer.size(), previousBuffer.size());
+		size_t prefix = 0;
+		while (prefix < maxShared && buffer[prefix] == previousBuffer[prefix])
+		{
+			++prefix;
+		}
+		size_t suffix = 0;
+		while (suffix < maxShared - prefix &&
+		       buffer[buffer.size() - suffix - 1] == previousBuffer[previousBuffer.size() - suffix - 1])
+		{
+			++suffix;
+		}
+
+		// Only worth chaining the entries if the delta is considerably smaller
+		const size_t deltaSize = buffer.size() - prefix - suffix;
+		if (deltaSize < buffer.size() / 2)
+		{
+			entry->base_ = previous;
+			entry->prefix_ = prefix;
+			entry->suffix_ = suffix;
+			entry->depth_ = previous->depth_ + 1;
+			entry->data_.assign(buffer, prefix, deltaSize);
+		}
+	}
+
+	if (entry->base_ == nullptr)
+	{
+		entry->data_ = buffer;
+	}
+
+	impl_->footprint_ += entry->data_.size();
+	impl_->footprint_ -= previousBuffer.size();
+	previousBuffer = std::move(buffer);
+	impl_->footprint_ += previousBuffer.size();
+	impl_->previous_[kind] = entry;
+
+	impl_->residentEntries_.push_back(entry);
+	impl_->enforceBudget();
+	return entry;
+}
+
+//------------------------------------------------------------------------------
+/* static */ std::string UndoRedoStore::load(const EntryPtr& entry)
+{
+	if (entry == nullptr)
+	{
+		return std::string();
+	}
+
+	std::lock_guard<std::mutex> guard(entry->store_->mutex_);
+	return entry->store_->decode(*entry);
+}
+
+//------------------------------------------------------------------------------
+void UndoRedoStore::setMemoryBudget(size_t bytes)
+{
+	std::lock_guard<std::mutex> guard(impl_->mutex_);
+	impl_->memoryBudget_ = bytes;
+	impl_->enforceBudget();
+}
+
+//------------------------------------------------------------------------------
+size_t UndoRedoStore::getMemoryBudget() const
+{
+	return impl_->memoryBudget_;
+}
+
+//------------------------------------------------------------------------------
+size_t UndoRedoStore::getMemoryFootprint() const
+{
+	return impl_->footprint_;
+}
+
+//------------------------------------------------------------------------------
+size_t UndoRedoStore::getSpilledSize() const
+{
+	std::lock_guard<std::mutex> guard(impl_->mutex_);
+	return static_cast<size_t>(impl_->scratchSize_);
+}
+} // end namespace wgt
@@ -0,0 +1,62 @@
+#ifndef UNDO_REDO_STORE_HPP
+#define UNDO_REDO_STORE_HPP
+
+#include <memory>
+#include <string>
+
+namespace wgt
+{
+/**
+ *	Bounded memory storage for the serialized undo/redo streams of a command history.
+ *
+ *	Each stream is delta encoded against the previous stream of the same kind when the two
+ *	share most of their bytes, as consecutive edits of the same property do. Once the memory
+ *	budget is exceeded the oldest streams are paged out to a scratch file and read back on demand.
+ *	Entries stay readable for as long as a history entry or macro holds on to them.
+ */
+class UndoRedoStore
+{
+public:
+	enum StreamKind
+	{
+		UNDO_STREAM,
+		REDO_STREAM,
+		STREAM_KIND_COUNT
+	};
+
+	struct Entry;
+	typedef std::shared_ptr<Entry> EntryPtr;
+
+	static const size_t DEFAULT_MEMORY_BUDGET = 64 * 1024 * 1024;
+
+	UndoRedoStore();
+	~UndoRedoStore();
+
+	EntryPtr store(StreamKind kind, std::string buffer);
+	static std::string load(const EntryPtr& entry);
+
+	/**
+	 *	Set the number of bytes of stream data kept in memory, 0 keeps everything in memory.
+	 */
+	void setMemoryBudget(size_t bytes);
+	size_t getMemoryBudget() const;
+
+	/**
+	 *	Bytes of stream data currently held in memory.
+	 */
+	size_t getMemoryFootprint() const;
+
+	/**
+	 *	Bytes of stream data written to the scratch file so far.
+	 */
+	size_t getSpilledSize() const;
+
+private:
+	UndoRedoStore(const UndoRedoStore&);
+	UndoRedoStore& operator=(const UndoRedoStore&);
+
+	struct Impl;
+	std::shared_ptr<Impl> impl_;
+};
+} // end namespace wgt
+#endif // UNDO_REDO_STORE_HPP
@@ -7,7 +7,9 @@
 #include "core_reflection/property_accessor.hpp"
 #include "core_reflection_utils/reflection_controller.hpp"
 #include "core_command_system/i_command_manager.hpp"
+#include "core_command_system/command_manager.hpp"
 #include "core_command_system/compound_command.hpp"
+#include "core_command_system/undo_redo_store.hpp"
 
 namespace wgt
 {
@@ -298,6 +300,75 @@ TEST_F(TestCommandFixture, threadCommands)
 	commandManager.waitForInstance(command);
 }
 
+TEST_F(TestCommandFixture, independentCommands)
+{
+	auto& commandManager = getCommandSystemProvider();
+
+	static_cast<CommandManager&>(commandManager).setWorkerPoolSize(4);
+	TestIndependentCommand::s_MaxRunning = 0;
+
+	const size_t COMMAND_COUNT = 16;
+	std::vector<CommandInstancePtr> commands;
+	for (size_t i = 0; i < COMMAND_COUNT; ++i)
+	{
+		commands.push_back(commandManager.queueCommand("TestIndependentCommand"));
+	}
+
+	for (auto& command : commands)
+	{
+		commandManager.waitForInstance(command);
+		CHECK(command->isComplete());
+		CHECK(isCommandSuccess(command->getErrorCode()));
+	}
+
+	// A command run on this thread moves the pending history over once it completes
+	auto command = commandManager.queueCommand(TestThreadCommand::generateId(CommandThreadAffinity::UI_THREAD).c_str());
+	commandManager.waitForInstance(command);
+
+	// The commands ran on the worker pool together, but are recorded in the order they were queued
+	CHECK(TestIndependentCommand::s_MaxRunning > 1);
+	auto& history = commandManager.getHistory();
+	size_t first = 0;
+	while (first < history.size() && history[first].value<CommandInstancePtr>() != commands.front())
+	{
+		++first;
+	}
+	CHECK(first + COMMAND_COUNT <= history.size());
+	for (size_t i = 0; i < COMMAND_COUNT && first + i < history.size(); ++i)
+	{
+		CHECK(history[first + i].value<CommandInstancePtr>() == commands[i]);
+	}
+}
+
+TEST(undoRedoStore)
+{
+	UndoRedoStore store;
+	const size_t BUDGET = 512;
+	store.setMemoryBudget(BUDGET);
+
+	// Streams of repeated edits to one property only differ in the value
+	std::vector<std::string> streams;
+	std::vector<UndoRedoStore::EntryPtr> entries;
+	for (int i = 0; i < 200; ++i)
+	{
+		std::string stream = "<undo><object id=\"0123456789\"/><path>transform.position.x</path><value>";
+		stream += std::to_string(i * 7);
+		stream += "</value></undo>";
+		streams.push_back(stream);
+		entries.push_back(store.store(UndoRedoStore::UNDO_STREAM, stream));
+	}
+
+	CHECK(store.getMemoryFootprint() <= BUDGET);
+	CHECK(store.getSpilledSize() > 0);
+	for (size_t i = 0; i < entries.size(); ++i)
+	{
+		CHECK_EQUAL(streams[i], UndoRedoStore::load(entries[i]));
+	}
+
+	entries.clear();
+	CHECK(store.getMemoryFootprint() <= streams.back().size());
+}
+
 TEST_F(TestCommandFixture, compoundCommands)
 {
 	// This test attempts to verify commands do not deadlock.
@@ -26,6 +26,7 @@ TestCommandFixture::TestCommandFixture()
 	commands_.emplace_back(new TestThreadCommand(CommandThreadAffinity::UI_THREAD));
 	commands_.emplace_back(new TestThreadCommand(CommandThreadAffinity::COMMAND_THREAD));
 	commands_.emplace_back(new TestThreadCommand(CommandThreadAffinity::ANY_THREAD));
+	commands_.emplace_back(new TestIndependentCommand());
 	for (auto i = 0; i < 5; ++i)
 	{
 		commands_.emplace_back(new TestCompoundCommand(i, CommandThreadAffinity::UI_THREAD));
@@ -228,6 +229,24 @@ std::string TestThreadCommand::generateId(CommandThreadAffinity threadAffinity)
 	return id;
 }
 
+//------------------------------------------------------------------------------
+std::atomic<int> TestIndependentCommand::s_MaxRunning(0);
+std::atomic<int> TestIndependentCommand::s_Running(0);
+
+Variant TestIndependentCommand::execute(const ObjectHandle& arguments) const
+{
+	const int running = ++s_Running;
+	int maxRunning = s_MaxRunning;
+	while (running > maxRunning && !s_MaxRunning.compare_exchange_weak(maxRunning, running))
+	{
+	}
+
+	std::this_thread::sleep_for(std::chrono::milliseconds(5));
+	--s_Running;
+
+	return CommandErrorCode::COMMAND_NO_ERROR;
+}
+
 //------------------------------------------------------------------------------
 TestCompoundCommand::TestCompoundCommand(int depth, CommandThreadAffinity threadAffinity)
     : id_(generateId(depth, threadAffinity)), depth_(depth), threadAffinity_(threadAffinity)
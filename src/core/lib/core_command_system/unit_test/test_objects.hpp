@@ -8,6 +8,7 @@
 #include "core_reflection/i_definition_manager.hpp"
 #include "core_variant/collection.hpp"
 #include "wg_types/binary_block.hpp"
+#include <atomic>
 #include <vector>
 
 #include "test_command_system_fixture.hpp"
@@ -140,6 +141,34 @@ private:
 	CommandThreadAffinity threadAffinity_;
 };
 
+//------------------------------------------------------------------------------
+class TestIndependentCommand : public Command
+{
+public:
+	// This command will simply sleep for 5ms on a command worker pool thread
+	const char* getId() const
+	{
+		return "TestIndependentCommand";
+	}
+	Variant execute(const ObjectHandle& arguments) const;
+
+	bool isIndependent() const override
+	{
+		return true;
+	}
+
+	ManagedObjectPtr copyArguments(const ObjectHandle& arguments) const override
+	{
+		return nullptr;
+	}
+
+	// The most instances that were executing at the same time
+	static std::atomic<int> s_MaxRunning;
+
+private:
+	static std::atomic<int> s_Running;
+};
+
 //------------------------------------------------------------------------------
 class TestCompoundCommand : public Command
 {
@@ -1,4 +1,5 @@
 #include "scoped_stop_watch.hpp"
+#include "trace_profiler.hpp"
 #include "core_logging/logging.hpp"
 
 namespace wgt
@@ -19,6 +20,33 @@ ScopedStopwatch::~ScopedStopwatch()
 		std::chrono::duration_cast<std::chrono::milliseconds>(now - start_);
 
 	NGT_DEBUG_MSG("%s: %llu ms\n", name_, difference.count());
+	TraceProfiler::instance().addZone(name_, "stopwatch", start_, now);
+}
+
+
+//------------------------------------------------------------------------------
+ScopedTraceZone::ScopedTraceZone(const char* name, const char* category)
+	: name_(name)
+	, category_(category)
+	, profiler_(&TraceProfiler::instance())
+{
+	// Zones started while recording is off are not recorded
+	if (!profiler_->isEnabled())
+	{
+		profiler_ = nullptr;
+		return;
+	}
+	start_ = std::chrono::high_resolution_clock::now();
+}
+
+
+//------------------------------------------------------------------------------
+ScopedTraceZone::~ScopedTraceZone()
+{
+	if (profiler_ != nullptr)
+	{
+		profiler_->addZone(name_, category_, start_, std::chrono::high_resolution_clock::now());
+	}
 }
 
 }
@@ -5,6 +5,7 @@
 
 namespace wgt
 {
+class TraceProfiler;
 
 class ScopedStopwatch
 {
@@ -16,6 +17,24 @@ private:
 	std::chrono::high_resolution_clock::time_point start_;
 };
 
+/**Records the time spent in a scope as a zone in the TraceProfiler, when it's enabled.
+The name must outlive the zone, it is copied when the zone ends.*/
+class ScopedTraceZone
+{
+public:
+	ScopedTraceZone(const char* name, const char* category = "wgt");
+	~ScopedTraceZone();
+private:
+	const char* name_;
+	const char* category_;
+	TraceProfiler* profiler_;
+	std::chrono::high_resolution_clock::time_point start_;
+};
+
 #define SCOPE_TAG ScopedStopwatch sw( __FUNCTION__ );
+#define TRACE_ZONE_CONCAT_INNER(a, b) a##b
+#define TRACE_ZONE_CONCAT(a, b) TRACE_ZONE_CONCAT_INNER(a, b)
+#define TRACE_ZONE(name, category) ScopedTraceZone TRACE_ZONE_CONCAT(traceZone, __LINE__)(name, category);
+#define TRACE_FUNCTION(category) TRACE_ZONE(__FUNCTION__, category)
 }
 #endif //SCOPED_STOP_WATCH_HPP
\ No newline at end of file
@@ -11,6 +11,7 @@
 
 #pragma once
 
+#include <atomic>
 #include <functional>
 #include <mutex>
 #include <memory>
@@ -108,6 +109,9 @@ private:
 // Maintains a list of callback functions to call when an event occurs.
 // It is thread safe and does not own the callback functions so they
 // can be disconnected at any time.
+// The list is read-copy-update: connecting or disconnecting publishes a new copy
+// of the list, so emitting takes no lock and does not allocate. Replaced lists are
+// freed once the emissions that may be reading them have finished.
 template <typename Signature>
 class Signal
 {
@@ -120,27 +124,143 @@ private:
 
 	typedef std::vector<SignalHolderPtr> HolderList;
 
-	HolderList entries_;
+	// Shared by the signal and the emissions in progress, so a signal can be
+	// destroyed by one of its own callbacks
+	struct State
+	{
+		State() : entries_(nullptr), hasRetired_(false), references_(1), orphaned_(false)
+		{
+		}
+
+		~State()
+		{
+			delete entries_.load();
+			for (auto entries : retired_)
+			{
+				delete entries;
+			}
+		}
+
+		// Must be called with mutex_ held
+		void publish(const HolderList* entries)
+		{
+			// Emissions starting after the exchange see the new list,
+			// earlier ones are still counted in references_
+			auto previous = entries_.exchange(entries);
+			if (previous != nullptr)
+			{
+				retired_.push_back(previous);
+				hasRetired_ = true;
+			}
+			reclaim(0);
+		}
+
+		// Must be called with mutex_ held, emissions pass 1 to discount themselves
+		void reclaim(int emitting)
+		{
+			if (orphaned_ || references_ != 1 + emitting)
+			{
+				return;
+			}
+
+			for (auto entries : retired_)
+			{
+				delete entries;
+			}
+			retired_.clear();
+			hasRetired_ = false;
+		}
+
+		void beginEmit()
+		{
+			++references_;
+		}
+
+		void endEmit()
+		{
+			// The last emission to leave frees retired lists, unless a writer is busy and will do it instead
+			if (hasRetired_ && references_ == 2)
+			{
+				std::unique_lock<std::mutex> lock(mutex_, std::try_to_lock);
+				if (lock.owns_lock())
+				{
+					reclaim(1);
+				}
+			}
+			release();
+		}
+
+		void release()
+		{
+			if (--references_ == 0)
+			{
+				delete this;
+			}
+		}
+
+		// Null while nothing is connected
+		std::atomic<const HolderList*> entries_;
+		std::mutex mutex_;
+		// Lists replaced while an emission may still be reading them
+		std::vector<const HolderList*> retired_;
+		std::atomic<bool> hasRetired_;
+		// One reference held by the signal and one per emission in progress
+		std::atomic<int> references_;
+		// Set once the signal is destroyed, with mutex_ held
+		bool orphaned_;
+	};
+
+	struct EmitScope
+	{
+		explicit EmitScope(State* state) : state_(state)
+		{
+			state_->beginEmit();
+		}
+
+		~EmitScope()
+		{
+			state_->endEmit();
+		}
+
+		State* state_;
+	};
+
+	State* state_;
 
 	typedef std::shared_ptr<std::function<void(Connection&)>> DisconnectSig;
 	DisconnectSig disconnectSig_;
-	mutable std::mutex mutex_;
+
 public:
-	Signal()
+	Signal() : state_(new State())
 	{
-		disconnectSig_ = std::make_shared<std::function<void(Connection&)>>([this](Connection& connection) {
-			std::lock_guard<std::mutex> lock(mutex_);
-			auto findIt = std::find(entries_.begin(), entries_.end(), connection.getEntry());
+		auto state = state_;
+		disconnectSig_ = std::make_shared<std::function<void(Connection&)>>([state](Connection& connection) {
+			std::lock_guard<std::mutex> lock(state->mutex_);
+			auto entries = state->entries_.load();
+			if (entries == nullptr)
+			{
+				return;
+			}
+
+			auto findIt = std::find(entries->begin(), entries->end(), connection.getEntry());
 			// Disconnect can be called from many sources, so allow this to happen
 			// Can't warn either as the signal owner can easily just call clear
-			if (findIt != entries_.end())
+			if (findIt != entries->end())
 			{
-				entries_.erase(findIt);
+				HolderList* newEntries = nullptr;
+				if (entries->size() > 1)
+				{
+					newEntries = new HolderList();
+					newEntries->reserve(entries->size() - 1);
+					newEntries->insert(newEntries->end(), entries->begin(), findIt);
+					newEntries->insert(newEntries->end(), findIt + 1, entries->end());
+				}
+				state->publish(newEntries);
 			}
 		});
 	}
 
-	Signal(Signal&& other)
+	Signal(Signal&& other) : Signal()
 	{
 		*this = std::move(other);
 	}
@@ -148,53 +268,74 @@ public:
 	~Signal()
 	{
 		clear();
+		{
+			std::lock_guard<std::mutex> lock(state_->mutex_);
+			state_->orphaned_ = true;
+		}
+		// Emissions still running free the state once they are done
+		state_->release();
 	}
 
 	Signal& operator=(Signal&& other)
 	{
-		using std::swap;
-
-		HolderList temp;
+		const HolderList* temp = nullptr;
 
 		{
-			std::lock_guard<std::mutex> lock(other.mutex_);
-			swap(temp, other.entries_);
+			std::lock_guard<std::mutex> lock(other.state_->mutex_);
+			auto entries = other.state_->entries_.load();
+			if (entries != nullptr)
+			{
+				// Other may still be emitting, so it keeps its list until that is done
+				temp = new HolderList(*entries);
+				other.state_->publish(nullptr);
+			}
 		}
 
 		{
-			std::lock_guard<std::mutex> lock(mutex_);
-			swap(entries_, temp);
+			std::lock_guard<std::mutex> lock(state_->mutex_);
+			state_->publish(temp);
 		}
 		return *this;
 	}
 
 	void clear()
 	{
-		std::lock_guard<std::mutex> lock(mutex_);
-		entries_.clear();
+		std::lock_guard<std::mutex> lock(state_->mutex_);
+		state_->publish(nullptr);
 	}
 
 	// Connects a new callback function to this signal, returns
 	// the Connection object which owns the connection between the two.
 	Connection connect(Function callback)
 	{
-		std::lock_guard<std::mutex> lock(mutex_);
+		std::lock_guard<std::mutex> lock(state_->mutex_);
 
 		// Create new entry
 		auto entry = std::make_shared<SignatureHolder>(callback);
-		entries_.push_back(entry);
+		auto entries = state_->entries_.load();
+		auto newEntries = new HolderList();
+		newEntries->reserve((entries != nullptr ? entries->size() : 0) + 1);
+		if (entries != nullptr)
+		{
+			newEntries->insert(newEntries->end(), entries->begin(), entries->end());
+		}
+		newEntries->push_back(entry);
+		state_->publish(newEntries);
 		return Connection(entry, disconnectSig_);
 	}
 
 	template<typename ...Args>
 	void operator()(Args&&... args) const
 	{
-		HolderList copyList;
+		EmitScope scope(state_);
+		auto entries = state_->entries_.load();
+		if (entries == nullptr)
 		{
-			std::lock_guard<std::mutex> lock(mutex_);
-			copyList = entries_;
+			return;
 		}
-		for (auto entry : copyList)
+
+		// The list can't change while we iterate it and keeps every entry in it alive
+		for (auto& entry : *entries)
 		{
 			if (entry && entry->function_ && entry->enabled_)
 			{
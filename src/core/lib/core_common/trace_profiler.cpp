@@ -0,0 +1,256 @@
+#include "trace_profiler.hpp"
+
+#include "common_include/env_pointer.hpp"
+#include "core_common/platform_env.hpp"
+
+#include <cstdio>
+#include <fstream>
+
+namespace wgt
+{
+namespace
+{
+const char* TRACE_PROFILER_VAR_NAME = "WGT_TRACE_PROFILER";
+const char* TRACE_FILE_VAR_NAME = "WGT_TRACE_FILE";
+
+TraceProfiler* findOrCreateProfiler()
+{
+	auto profiler = getPointerT<TraceProfiler>(TRACE_PROFILER_VAR_NAME);
+	if (profiler == nullptr)
+	{
+		// Never destroyed, plugins may record zones while they are unloaded
+		profiler = new TraceProfiler;
+		setPointer(TRACE_PROFILER_VAR_NAME, profiler);
+	}
+	return profiler;
+}
+
+void writeJsonString(std::ostream& stream, const char* str)
+{
+	stream << '"';
+	for (; *str != '\0'; ++str)
+	{
+		const char c = *str;
+		if (c == '"' || c == '\\')
+		{
+			stream << '\\' << c;
+		}
+		else if (static_cast<unsigned char>(c) < 0x20)
+		{
+			char escaped[8];
+			snprintf(escaped, sizeof(escaped), "\\u%04x", c);
+			stream << escaped;
+		}
+		else
+		{
+			stream << c;
+		}
+	}
+	stream << '"';
+}
+}
+
+//==============================================================================
+struct TraceProfiler::Event
+{
+	char phase_; // 'X' for zones, 'i' for markers
+	uint32_t name_; // Offsets into the buffer's strings
+	uint32_t category_;
+	int64_t start_; // Nanoseconds since the profiler was created
+	int64_t duration_;
+};
+
+//==============================================================================
+struct TraceProfiler::ThreadBuffer
+{
+	ThreadBuffer(uint32_t threadId) : threadId_(threadId)
+	{
+	}
+
+	uint32_t addString(const char* str)
+	{
+		const uint32_t offset = static_cast<uint32_t>(strings_.size());
+		strings_.append(str).push_back('\0');
+		return offset;
+	}
+
+	// Only contended while the trace is written or cleared
+	std::mutex mutex_;
+	const uint32_t threadId_;
+	std::vector<Event> events_;
+	std::string strings_;
+};
+
+//==============================================================================
+TraceProfiler::TraceProfiler()
+    : enabled_(false), startupComplete_(false), epoch_(Clock::now()), threadBuffer_(nullptr)
+{
+	char traceFile[1024];
+	if (Environment::getValue(TRACE_FILE_VAR_NAME, traceFile) && traceFile[0] != '\0')
+	{
+		traceFile_ = traceFile;
+		enabled_ = true;
+	}
+}
+
+//==============================================================================
+TraceProfiler::~TraceProfiler()
+{
+}
+
+//==============================================================================
+TraceProfiler& TraceProfiler::instance()
+{
+	static TraceProfiler* s_profiler = findOrCreateProfiler();
+	return *s_profiler;
+}
+
+//==============================================================================
+void TraceProfiler::setEnabled(bool enabled)
+{
+	enabled_ = enabled;
+}
+
+//==============================================================================
+void TraceProfiler::addZone(const char* name, const char* category, const Clock::time_point& start,
+                            const Clock::time_point& end)
+{
+	addEvent('X', name, category, start, end);
+}
+
+//==============================================================================
+void TraceProfiler::addMarker(const char* name, const char* category)
+{
+	const auto now = Clock::now();
+	addEvent('i', name, category, now, now);
+}
+
+//==============================================================================
+void TraceProfiler::markStartupComplete(const char* name)
+{
+	if (startupComplete_.exchange(true))
+	{
+		return;
+	}
+
+	addMarker(name, "startup");
+	writeTraceFile();
+}
+
+//==============================================================================
+size_t TraceProfiler::getEventCount() const
+{
+	size_t count = 0;
+	std::lock_guard<std::mutex> buffersLock(buffersMutex_);
+	for (auto& buffer : buffers_)
+	{
+		std::lock_guard<std::mutex> lock(buffer->mutex_);
+		count += buffer->events_.size();
+	}
+	return count;
+}
+
+//==============================================================================
+void TraceProfiler::clear()
+{
+	// Buffers stay registered with their threads
+	std::lock_guard<std::mutex> buffersLock(buffersMutex_);
+	for (auto& buffer : buffers_)
+	{
+		std::lock_guard<std::mutex> lock(buffer->mutex_);
+		buffer->events_.clear();
+		buffer->strings_.clear();
+	}
+}
+
+//==============================================================================
+void TraceProfiler::writeChromeTrace(std::ostream& stream) const
+{
+	char number[32];
+	bool first = true;
+	stream << "{\"traceEvents\":[";
+
+	std::lock_guard<std::mutex> buffersLock(buffersMutex_);
+	for (auto& buffer : buffers_)
+	{
+		std::lock_guard<std::mutex> lock(buffer->mutex_);
+		for (const auto& event : buffer->events_)
+		{
+			stream << (first ? "\n" : ",\n") << "{\"name\":";
+			writeJsonString(stream, buffer->strings_.c_str() + event.name_);
+			stream << ",\"cat\":";
+			writeJsonString(stream, buffer->strings_.c_str() + event.category_);
+			stream << ",\"ph\":\"" << event.phase_ << "\",\"pid\":1,\"tid\":" << buffer->threadId_;
+
+			// Timestamps are in microseconds
+			snprintf(number, sizeof(number), "%.3f", event.start_ / 1000.0);
+			stream << ",\"ts\":" << number;
+			if (event.phase_ == 'X')
+			{
+				snprintf(number, sizeof(number), "%.3f", event.duration_ / 1000.0);
+				stream << ",\"dur\":" << number;
+			}
+			else
+			{
+				stream << ",\"s\":\"t\"";
+			}
+			stream << "}";
+			first = false;
+		}
+	}
+
+	stream << "\n],\"displayTimeUnit\":\"ms\"}\n";
+}
+
+//==============================================================================
+bool TraceProfiler::writeTraceFile() const
+{
+	if (traceFile_.empty())
+	{
+		return false;
+	}
+
+	std::ofstream file(traceFile_.c_str());
+	if (!file.good())
+	{
+		return false;
+	}
+
+	writeChromeTrace(file);
+	return file.good();
+}
+
+//==============================================================================
+TraceProfiler::ThreadBuffer& TraceProfiler::getThreadBuffer()
+{
+	ThreadBuffer* buffer = THREAD_LOCAL_GET(threadBuffer_);
+	if (buffer == nullptr)
+	{
+		std::lock_guard<std::mutex> buffersLock(buffersMutex_);
+		buffers_.emplace_back(new ThreadBuffer(static_cast<uint32_t>(buffers_.size() + 1)));
+		buffer = buffers_.back().get();
+		THREAD_LOCAL_SET(threadBuffer_, buffer);
+	}
+	return *buffer;
+}
+
+//==============================================================================
+void TraceProfiler::addEvent(char phase, const char* name, const char* category, const Clock::time_point& start,
+                             const Clock::time_point& end)
+{
+	if (!isEnabled())
+	{
+		return;
+	}
+
+	ThreadBuffer& buffer = getThreadBuffer();
+	std::lock_guard<std::mutex> lock(buffer.mutex_);
+	Event event;
+	event.phase_ = phase;
+	event.name_ = buffer.addString(name != nullptr ? name : "");
+	event.category_ = buffer.addString(category != nullptr ? category : "");
+	event.start_ = std::chrono::duration_cast<std::chrono::nanoseconds>(start - epoch_).count();
+	event.duration_ = std::chrono::duration_cast<std::chrono::nanoseconds>(end - start).count();
+	buffer.events_.push_back(event);
+}
+} // end namespace wgt
@@ -0,0 +1,81 @@
+#ifndef TRACE_PROFILER_HPP
+#define TRACE_PROFILER_HPP
+
+#include "core_common/thread_local_value.hpp"
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <ostream>
+#include <string>
+#include <vector>
+
+namespace wgt
+{
+/**
+* TraceProfiler collects timed zones, such as the steps of loading each plugin, and writes them in the Chrome trace
+* event format, to be opened in chrome://tracing or Perfetto.
+* Each thread records into its own buffer, so recording a zone doesn't contend with other threads.
+* Recording is off until enabled, or until a file is named by the WGT_TRACE_FILE environment variable, in which case
+* the trace is written there when the first window has been shown.
+* Plugins each link their own copy of core_common. The first module to use the profiler creates it and publishes it in
+* the environment, and the others use that one through its virtual functions, so all memory is owned by the creating
+* module. Applications use it before loading any plugins so the profiler outlives them.
+*/
+class TraceProfiler
+{
+public:
+	typedef std::chrono::high_resolution_clock Clock;
+
+	TraceProfiler();
+	virtual ~TraceProfiler();
+
+	/**The profiler shared by every module in the process.*/
+	static TraceProfiler& instance();
+
+	bool isEnabled() const
+	{
+		return enabled_.load(std::memory_order_relaxed);
+	}
+
+	virtual void setEnabled(bool enabled);
+
+	/**Records a zone on the calling thread. The name and category are copied.*/
+	virtual void addZone(const char* name, const char* category, const Clock::time_point& start,
+	                     const Clock::time_point& end);
+
+	/**Records a moment on the calling thread, such as the first window being shown.*/
+	virtual void addMarker(const char* name, const char* category);
+
+	/**Marks the end of startup with a marker the first time it's called, and writes the trace file.*/
+	virtual void markStartupComplete(const char* name);
+
+	virtual size_t getEventCount() const;
+	virtual void clear();
+
+	virtual void writeChromeTrace(std::ostream& stream) const;
+
+	/**Writes the trace to the file named by WGT_TRACE_FILE, if there is one.
+	@return true if the trace was written.*/
+	virtual bool writeTraceFile() const;
+
+private:
+	struct Event;
+	struct ThreadBuffer;
+
+	ThreadBuffer& getThreadBuffer();
+	void addEvent(char phase, const char* name, const char* category, const Clock::time_point& start,
+	              const Clock::time_point& end);
+
+	std::atomic<bool> enabled_;
+	std::atomic<bool> startupComplete_;
+	const Clock::time_point epoch_;
+	std::string traceFile_;
+	THREAD_LOCAL(ThreadBuffer*) threadBuffer_;
+	mutable std::mutex buffersMutex_;
+	std::vector<std::unique_ptr<ThreadBuffer>> buffers_;
+};
+} // end namespace wgt
+#endif // TRACE_PROFILER_HPP
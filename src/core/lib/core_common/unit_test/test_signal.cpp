@@ -0,0 +1,96 @@
+#include "CppUnitLite2/src/CppUnitLite2.h"
+#include "core_common/signal.hpp"
+
+#include <atomic>
+#include <thread>
+#include <vector>
+
+namespace wgt
+{
+TEST(signal_connect_during_emit)
+{
+	Signal<void(int)> signal;
+	int firstCalls = 0;
+	int secondCalls = 0;
+	Connection second;
+
+	Connection first = signal.connect([&](int) {
+		++firstCalls;
+		if (!second.connected())
+		{
+			second = signal.connect([&](int) { ++secondCalls; });
+		}
+		else
+		{
+			first.disconnect();
+		}
+	});
+
+	// Listeners connected during an emit are called from the next emit on
+	signal(0);
+	CHECK_EQUAL(1, firstCalls);
+	CHECK_EQUAL(0, secondCalls);
+
+	// Listeners disconnected during an emit still finish that emit
+	signal(0);
+	CHECK_EQUAL(2, firstCalls);
+	CHECK_EQUAL(1, secondCalls);
+
+	signal(0);
+	CHECK_EQUAL(2, firstCalls);
+	CHECK_EQUAL(2, secondCalls);
+
+	second.disable();
+	signal(0);
+	CHECK_EQUAL(2, secondCalls);
+}
+
+TEST(signal_destroyed_during_emit)
+{
+	std::unique_ptr<Signal<void()>> signal(new Signal<void()>());
+	int calls = 0;
+	signal->connect([&]() { signal.reset(); });
+	signal->connect([&]() { ++calls; });
+
+	(*signal)();
+	CHECK(signal == nullptr);
+	CHECK_EQUAL(1, calls);
+}
+
+TEST(signal_concurrent_emit_and_connect)
+{
+	Signal<void(int)> signal;
+	std::atomic<int> persistentCalls(0);
+	signal.connect([&](int) { ++persistentCalls; });
+
+	std::atomic<bool> done(false);
+	const int emitsPerThread = 20000;
+	std::vector<std::thread> emitters;
+	for (int i = 0; i < 4; ++i)
+	{
+		emitters.emplace_back([&] {
+			for (int emit = 0; emit < emitsPerThread; ++emit)
+			{
+				signal(emit);
+			}
+		});
+	}
+
+	std::thread connector([&] {
+		while (!done)
+		{
+			auto connection = signal.connect([](int) {});
+			connection.disconnect();
+		}
+	});
+
+	for (auto& emitter : emitters)
+	{
+		emitter.join();
+	}
+	done = true;
+	connector.join();
+
+	CHECK_EQUAL(4 * emitsPerThread, persistentCalls.load());
+}
+} // end namespace wgt
@@ -0,0 +1,91 @@
+#include "CppUnitLite2/src/CppUnitLite2.h"
+#include "core_common/scoped_stop_watch.hpp"
+#include "core_common/trace_profiler.hpp"
+
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace wgt
+{
+namespace
+{
+size_t countOccurrences(const std::string& text, const std::string& pattern)
+{
+	size_t count = 0;
+	for (size_t pos = text.find(pattern); pos != std::string::npos; pos = text.find(pattern, pos + pattern.size()))
+	{
+		++count;
+	}
+	return count;
+}
+}
+
+TEST(TraceProfiler_records_zones_per_thread)
+{
+	TraceProfiler profiler;
+	profiler.setEnabled(true);
+
+	const int threadCount = 4;
+	const int zonesPerThread = 1000;
+	std::vector<std::thread> threads;
+	for (int i = 0; i < threadCount; ++i)
+	{
+		threads.emplace_back([&profiler, i] {
+			const std::string name = "Zone " + std::to_string(i);
+			for (int zone = 0; zone < zonesPerThread; ++zone)
+			{
+				auto start = TraceProfiler::Clock::now();
+				profiler.addZone(name.c_str(), "test", start, TraceProfiler::Clock::now());
+			}
+		});
+	}
+	for (auto& thread : threads)
+	{
+		thread.join();
+	}
+	profiler.addMarker("Quote \" and \\ backslash\n", "test");
+
+	CHECK_EQUAL(size_t(threadCount * zonesPerThread + 1), profiler.getEventCount());
+
+	std::ostringstream stream;
+	profiler.writeChromeTrace(stream);
+	const std::string trace = stream.str();
+	CHECK_EQUAL(size_t(0), trace.find("{\"traceEvents\":["));
+	CHECK_EQUAL(size_t(threadCount * zonesPerThread), countOccurrences(trace, "\"ph\":\"X\""));
+	CHECK_EQUAL(size_t(zonesPerThread), countOccurrences(trace, "\"name\":\"Zone 3\""));
+	CHECK_EQUAL(size_t(1), countOccurrences(trace, "\"name\":\"Quote \\\" and \\\\ backslash\\u000a\""));
+
+	// Each thread records into its own buffer, with its own thread id
+	for (int tid = 1; tid <= threadCount + 1; ++tid)
+	{
+		CHECK(countOccurrences(trace, "\"tid\":" + std::to_string(tid) + ",") > 0);
+	}
+
+	profiler.clear();
+	CHECK_EQUAL(size_t(0), profiler.getEventCount());
+}
+
+TEST(TraceProfiler_disabled)
+{
+	TraceProfiler profiler;
+	profiler.setEnabled(false);
+	auto now = TraceProfiler::Clock::now();
+	profiler.addZone("Zone", "test", now, now);
+	profiler.addMarker("Marker", "test");
+	CHECK_EQUAL(size_t(0), profiler.getEventCount());
+
+	// Scoped zones record into the shared profiler
+	auto& shared = TraceProfiler::instance();
+	CHECK(&shared == &TraceProfiler::instance());
+	const bool wasEnabled = shared.isEnabled();
+	shared.setEnabled(true);
+	const size_t eventCount = shared.getEventCount();
+	{
+		TRACE_ZONE("Scoped zone", "test");
+	}
+	CHECK_EQUAL(eventCount + 1, shared.getEventCount());
+	shared.setEnabled(wasEnabled);
+}
+} // end namespace wgt
@@ -0,0 +1,59 @@
+#include "CppUnitLite2/src/CppUnitLite2.h"
+#include "core_common/wg_mpsc_queue.hpp"
+
+#include <array>
+#include <thread>
+#include <vector>
+
+namespace wgt
+{
+TEST(wg_mpsc_queue)
+{
+	const size_t producerCount = 4;
+	const size_t itemsPerProducer = 10000;
+
+	wg_mpsc_queue<size_t> queue(64);
+	CHECK_EQUAL(64, queue.capacity());
+
+	std::array<std::thread, producerCount> producers;
+	for (size_t producer = 0; producer < producerCount; ++producer)
+	{
+		producers[producer] = std::thread([&queue, producer, itemsPerProducer] {
+			for (size_t i = 0; i < itemsPerProducer; ++i)
+			{
+				size_t item = producer * itemsPerProducer + i;
+				while (!queue.try_push(item))
+				{
+					std::this_thread::yield();
+				}
+			}
+		});
+	}
+
+	// Items of each producer must come out in the order they were pushed
+	std::vector<size_t> nextItem(producerCount, 0);
+	size_t received = 0;
+	while (received < producerCount * itemsPerProducer)
+	{
+		size_t item;
+		if (!queue.try_pop(item))
+		{
+			std::this_thread::yield();
+			continue;
+		}
+
+		const size_t producer = item / itemsPerProducer;
+		CHECK_EQUAL(nextItem[producer], item % itemsPerProducer);
+		nextItem[producer] = item % itemsPerProducer + 1;
+		++received;
+	}
+
+	for (auto& producer : producers)
+	{
+		producer.join();
+	}
+
+	size_t item;
+	CHECK(!queue.try_pop(item));
+}
+} // end namespace wgt
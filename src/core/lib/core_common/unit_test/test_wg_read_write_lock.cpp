@@ -0,0 +1,163 @@
+#include "CppUnitLite2/src/CppUnitLite2.h"
+#include "core_common/wg_read_write_lock.hpp"
+
+#include <atomic>
+#include <chrono>
+#include <thread>
+#include <vector>
+
+namespace wgt
+{
+namespace
+{
+std::atomic<int> s_ContendedLocks(0);
+
+void countContention(const wg_read_write_lock&, wg_read_write_lock::lock_kind, uint64_t)
+{
+	++s_ContendedLocks;
+}
+}
+
+TEST(wg_read_write_lock_exclusion)
+{
+	wg_read_write_lock lock;
+	int first = 0;
+	int second = 0;
+	std::atomic<int> torn(0);
+
+	std::vector<std::thread> threads;
+	for (int i = 0; i < 2; ++i)
+	{
+		threads.emplace_back([&] {
+			for (int write = 0; write < 10000; ++write)
+			{
+				wg_write_lock_guard guard(lock);
+				++first;
+				++second;
+			}
+		});
+		threads.emplace_back([&] {
+			for (int read = 0; read < 10000; ++read)
+			{
+				wg_read_lock_guard guard(lock);
+				if (first != second)
+				{
+					++torn;
+				}
+			}
+		});
+	}
+	for (auto& thread : threads)
+	{
+		thread.join();
+	}
+
+	CHECK_EQUAL(20000, first);
+	CHECK_EQUAL(20000, second);
+	CHECK_EQUAL(0, torn.load());
+}
+
+TEST(wg_read_write_lock_recursive_read)
+{
+	wg_read_write_lock lock;
+	wg_read_lock_guard outer(lock);
+	wg_read_lock_guard inner(outer);
+}
+
+TEST(wg_read_write_lock_upgrade)
+{
+	wg_read_write_lock lock;
+	int value = 0;
+	std::atomic<int> readersDone(0);
+
+	std::vector<std::thread> threads;
+	for (int i = 0; i < 4; ++i)
+	{
+		threads.emplace_back([&] {
+			for (int attempt = 0; attempt < 1000; ++attempt)
+			{
+				// Only one thread at a time checks and updates, readers are not blocked while checking
+				wg_upgradeable_lock_guard guard(lock);
+				if (attempt % 2 == 0)
+				{
+					guard.upgrade();
+					++value;
+				}
+			}
+		});
+	}
+	threads.emplace_back([&] {
+		for (int read = 0; read < 10000; ++read)
+		{
+			wg_read_lock_guard guard(lock);
+			(void)value;
+		}
+		++readersDone;
+	});
+	for (auto& thread : threads)
+	{
+		thread.join();
+	}
+
+	CHECK_EQUAL(2000, value);
+	CHECK_EQUAL(1, readersDone.load());
+}
+
+TEST(wg_read_write_lock_upgradeable_shares_with_readers)
+{
+	wg_read_write_lock lock;
+	wg_upgradeable_lock_guard upgradeable(lock);
+
+	bool read = false;
+	std::thread reader([&] {
+		wg_read_lock_guard guard(lock);
+		read = true;
+	});
+	reader.join();
+	CHECK(read);
+
+	upgradeable.upgrade();
+}
+
+TEST(wg_read_write_lock_writer_preference)
+{
+	wg_read_write_lock lock(true);
+	std::atomic<bool> writerDone(false);
+	std::atomic<bool> readerSawWrite(false);
+
+	lock.read_lock();
+	std::thread writer([&] {
+		wg_write_lock_guard guard(lock);
+		writerDone = true;
+	});
+
+	// Give the writer time to queue behind the held read lock
+	std::this_thread::sleep_for(std::chrono::milliseconds(50));
+	std::thread reader([&] {
+		wg_read_lock_guard guard(lock);
+		readerSawWrite = writerDone.load();
+	});
+	std::this_thread::sleep_for(std::chrono::milliseconds(50));
+	lock.read_unlock();
+
+	writer.join();
+	reader.join();
+	CHECK(readerSawWrite.load());
+}
+
+TEST(wg_read_write_lock_contention_hook)
+{
+	s_ContendedLocks = 0;
+	wg_read_write_lock::set_contention_hook(&countContention);
+
+	wg_read_write_lock lock;
+	lock.write_lock();
+	std::thread reader([&] { wg_read_lock_guard guard(lock); });
+	std::this_thread::sleep_for(std::chrono::milliseconds(20));
+	lock.write_unlock();
+	reader.join();
+
+	wg_read_write_lock::set_contention_hook(nullptr);
+	CHECK_EQUAL(1, s_ContendedLocks.load());
+}
+} // end namespace wgt
@@ -0,0 +1,113 @@
+#ifndef WG_MPSC_QUEUE_HPP_INCLUDED
+#define WG_MPSC_QUEUE_HPP_INCLUDED
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <utility>
+
+namespace wgt
+{
+/// Bounded lock-free multiple producer / single consumer queue.
+/// Any number of threads may push concurrently; pops must be serialised by the caller,
+/// e.g. by only popping while holding a mutex shared by all consumers.
+/// Capacity is rounded up to a power of two.
+template <typename T>
+class wg_mpsc_queue
+{
+public:
+	explicit wg_mpsc_queue(size_t capacity) : mask_(0), enqueuePos_(0), dequeuePos_(0)
+	{
+		size_t size = 2;
+		while (size < capacity)
+		{
+			size <<= 1;
+		}
+		mask_ = size - 1;
+		cells_.reset(new Cell[size]);
+		for (size_t i = 0; i < size; ++i)
+		{
+			cells_[i].sequence_.store(i, std::memory_order_relaxed);
+		}
+	}
+
+	/// Push a value from any thread.
+	/// @return false if the queue is full, the value is left untouched.
+	bool try_push(T& value)
+	{
+		Cell* cell;
+		size_t pos = enqueuePos_.load(std::memory_order_relaxed);
+		for (;;)
+		{
+			cell = &cells_[pos & mask_];
+			const size_t sequence = cell->sequence_.load(std::memory_order_acquire);
+			const intptr_t diff = static_cast<intptr_t>(sequence) - static_cast<intptr_t>(pos);
+			if (diff == 0)
+			{
+				if (enqueuePos_.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+				{
+					break;
+				}
+			}
+			else if (diff < 0)
+			{
+				return false;
+			}
+			else
+			{
+				pos = enqueuePos_.load(std::memory_order_relaxed);
+			}
+		}
+
+		cell->value_ = std::move(value);
+		cell->sequence_.store(pos + 1, std::memory_order_release);
+		return true;
+	}
+
+	/// Pop the oldest value, only one thread may pop at a time.
+	/// @return false if the queue is empty or the next value is still being pushed.
+	bool try_pop(T& value)
+	{
+		Cell* cell = &cells_[dequeuePos_ & mask_];
+		const size_t sequence = cell->sequence_.load(std::memory_order_acquire);
+		if (sequence != dequeuePos_ + 1)
+		{
+			return false;
+		}
+
+		value = std::move(cell->value_);
+		cell->value_ = T();
+		cell->sequence_.store(dequeuePos_ + mask_ + 1, std::memory_order_release);
+		++dequeuePos_;
+		return true;
+	}
+
+	size_t capacity() const
+	{
+		return mask_ + 1;
+	}
+
+private:
+	wg_mpsc_queue(const wg_mpsc_queue&);
+	wg_mpsc_queue& operator=(const wg_mpsc_queue&);
+
+	struct Cell
+	{
+		std::atomic<size_t> sequence_;
+		T value_;
+	};
+
+	// Keep the producer and consumer positions on separate cache lines
+	static const size_t CACHE_LINE_SIZE = 64;
+
+	std::unique_ptr<Cell[]> cells_;
+	size_t mask_;
+	char pad0_[CACHE_LINE_SIZE];
+	std::atomic<size_t> enqueuePos_;
+	char pad1_[CACHE_LINE_SIZE];
+	size_t dequeuePos_;
+};
+} // end namespace wgt
+
+#endif // WG_MPSC_QUEUE_HPP_INCLUDED
@@ -1,61 +1,186 @@
 #include "wg_read_write_lock.hpp"
 
+#include <chrono>
+
 namespace wgt
 {
-wg_read_write_lock::wg_read_write_lock() : writer_(false), readers_(0), mutex_(), unlocked_()
+namespace
+{
+// Attempts made before a waiting thread blocks on the condition variable
+const int SPIN_COUNT = 64;
+
+std::atomic<wg_read_write_lock::contention_hook> s_ContentionHook(nullptr);
+}
+
+//==============================================================================
+void wg_read_write_lock::set_contention_hook(contention_hook hook)
 {
+	s_ContentionHook.store(hook, std::memory_order_release);
 }
 
+//------------------------------------------------------------------------------
+wg_read_write_lock::wg_read_write_lock(bool preferWriters)
+    : state_(0), sleepers_(0), preferWriters_(preferWriters), mutex_(), unlocked_()
+{
+}
+
+//------------------------------------------------------------------------------
 wg_read_write_lock::~wg_read_write_lock()
 {
 }
 
-void wg_read_write_lock::read_lock()
+//------------------------------------------------------------------------------
+void wg_read_write_lock::write_lock()
+{
+	uint32_t state = state_.load(std::memory_order_relaxed);
+	if ((state & (READER_MASK | UPGRADEABLE | WRITER)) != 0 ||
+	    !state_.compare_exchange_weak(state, state | WRITER, std::memory_order_acquire, std::memory_order_relaxed))
+	{
+		lock_slow(lock_kind::write);
+	}
+}
+
+//------------------------------------------------------------------------------
+void wg_read_write_lock::write_unlock()
 {
-	std::unique_lock<std::mutex> lock(mutex_);
+	state_.fetch_sub(WRITER, std::memory_order_release);
+	notify_waiters();
+}
 
-	while (writer_)
+//------------------------------------------------------------------------------
+void wg_read_write_lock::upgradeable_lock()
+{
+	if (!try_acquire(lock_kind::upgradeable))
 	{
-		// Write in progress, wait until it is done
-		unlocked_.wait(lock);
+		lock_slow(lock_kind::upgradeable);
 	}
-	++readers_;
 }
 
-void wg_read_write_lock::read_unlock()
+//------------------------------------------------------------------------------
+void wg_read_write_lock::upgradeable_unlock()
 {
-	std::unique_lock<std::mutex> lock(mutex_);
+	state_.fetch_sub(UPGRADEABLE, std::memory_order_release);
+	notify_waiters();
+}
 
-	--readers_;
-	if (0 >= readers_)
+//------------------------------------------------------------------------------
+void wg_read_write_lock::upgrade()
+{
+	// Holding the upgradeable lock keeps other writers out, only readers have to drain
+	uint32_t state = state_.load(std::memory_order_relaxed);
+	if ((state & READER_MASK) != 0 ||
+	    !state_.compare_exchange_weak(state, state - UPGRADEABLE + WRITER, std::memory_order_acquire,
+	                                  std::memory_order_relaxed))
 	{
-		readers_ = 0;
+		lock_slow(lock_kind::upgrade);
+	}
+}
 
-		// Notify all waiters
-		unlocked_.notify_all();
+//------------------------------------------------------------------------------
+// Exclusive kinds are counted as waiting writers by lock_slow, which the acquiring CAS removes again
+bool wg_read_write_lock::try_acquire(lock_kind kind)
+{
+	uint32_t state = state_.load(std::memory_order_relaxed);
+	for (;;)
+	{
+		uint32_t desired;
+		switch (kind)
+		{
+		case lock_kind::read:
+			if (!can_read(state))
+			{
+				return false;
+			}
+			desired = state + READER;
+			break;
+
+		case lock_kind::write:
+			if ((state & (READER_MASK | UPGRADEABLE | WRITER)) != 0)
+			{
+				return false;
+			}
+			desired = state - WAITING_WRITER + WRITER;
+			break;
+
+		case lock_kind::upgradeable:
+			if ((state & (UPGRADEABLE | WRITER)) != 0 || (preferWriters_ && (state & WAITING_WRITER_MASK) != 0))
+			{
+				return false;
+			}
+			desired = state + UPGRADEABLE;
+			break;
+
+		case lock_kind::upgrade:
+			if ((state & READER_MASK) != 0)
+			{
+				return false;
+			}
+			desired = state - WAITING_WRITER - UPGRADEABLE + WRITER;
+			break;
+
+		default:
+			return false;
+		}
+
+		if (state_.compare_exchange_weak(state, desired, std::memory_order_acquire, std::memory_order_relaxed))
+		{
+			return true;
+		}
 	}
 }
 
-void wg_read_write_lock::write_lock()
+//------------------------------------------------------------------------------
+void wg_read_write_lock::lock_slow(lock_kind kind)
 {
-	std::unique_lock<std::mutex> lock(mutex_);
+	const auto start = std::chrono::steady_clock::now();
 
-	while (writer_ || (0 < readers_))
+	// Pending writers hold back new readers when writers are preferred
+	if (kind == lock_kind::write || kind == lock_kind::upgrade)
 	{
-		// Write or read in progress, wait until it is done
-		unlocked_.wait(lock);
+		state_.fetch_add(WAITING_WRITER, std::memory_order_relaxed);
 	}
 
-	writer_ = true;
+	bool acquired = false;
+	for (int i = 0; i < SPIN_COUNT && !acquired; ++i)
+	{
+		acquired = try_acquire(kind);
+	}
+
+	if (!acquired)
+	{
+		std::unique_lock<std::mutex> lock(mutex_);
+		sleepers_.fetch_add(1, std::memory_order_relaxed);
+		// Pairs with the fence in notify_waiters, either the unlocking thread sees this
+		// sleeper or this thread sees the unlocked state
+		std::atomic_thread_fence(std::memory_order_seq_cst);
+		while (!try_acquire(kind))
+		{
+			unlocked_.wait(lock);
+		}
+		sleepers_.fetch_sub(1, std::memory_order_relaxed);
+	}
+
+	contention_hook hook = s_ContentionHook.load(std::memory_order_acquire);
+	if (hook != nullptr)
+	{
+		const auto waited = std::chrono::steady_clock::now() - start;
+		hook(*this, kind, std::chrono::duration_cast<std::chrono::nanoseconds>(waited).count());
+	}
 }
 
-void wg_read_write_lock::write_unlock()
+//------------------------------------------------------------------------------
+void wg_read_write_lock::notify_waiters()
 {
-	std::unique_lock<std::mutex> lock(mutex_);
-
-	writer_ = false;
+	std::atomic_thread_fence(std::memory_order_seq_cst);
+	if (sleepers_.load(std::memory_order_relaxed) == 0)
+	{
+		return;
+	}
 
-	// The lock is available now, notify all waiters
+	// Taking the mutex ensures a sleeper has either not checked the state yet or is already waiting
+	{
+		std::lock_guard<std::mutex> lock(mutex_);
+	}
 	unlocked_.notify_all();
 }
 } // end namespace wgt
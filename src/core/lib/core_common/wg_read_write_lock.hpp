@@ -1,28 +1,94 @@
 #ifndef WG_READ_WRITE_LOCK
 #define WG_READ_WRITE_LOCK
 
+#include <atomic>
+#include <cstdint>
 #include <mutex>
 
 #include "wg_condition_variable.hpp"
 
 namespace wgt
 {
-/// Read / write lock implementation with mutex and conditional variable
+/// Read / write lock implementation on an atomic state word.
+/// Uncontended read lock and unlock are a single compare-and-swap / decrement,
+/// threads only block on a mutex and condition variable when they have to wait.
+/// Read locks may be taken recursively unless writers are preferred: with writer
+/// preference new readers wait for pending writers, so re-entering a read lock
+/// while a writer waits deadlocks.
+/// One thread at a time may hold an upgradeable read lock, which coexists with
+/// readers and can be turned into a write lock without releasing it.
 class wg_read_write_lock
 {
 public:
-	wg_read_write_lock();
+	enum class lock_kind
+	{
+		read,
+		write,
+		upgradeable,
+		upgrade
+	};
+
+	/// Called after a thread had to wait for a lock, with the time it waited.
+	/// Must be thread safe, shared by all locks.
+	typedef void (*contention_hook)(const wg_read_write_lock& lock, lock_kind kind, uint64_t waitNanoseconds);
+	static void set_contention_hook(contention_hook hook);
+
+	explicit wg_read_write_lock(bool preferWriters = false);
 	~wg_read_write_lock();
 
-	void read_lock();
-	void read_unlock();
+	void read_lock()
+	{
+		uint32_t state = state_.load(std::memory_order_relaxed);
+		if (!can_read(state) ||
+		    !state_.compare_exchange_weak(state, state + READER, std::memory_order_acquire, std::memory_order_relaxed))
+		{
+			lock_slow(lock_kind::read);
+		}
+	}
+
+	void read_unlock()
+	{
+		const uint32_t previous = state_.fetch_sub(READER, std::memory_order_release);
+		if ((previous & READER_MASK) == READER)
+		{
+			notify_waiters();
+		}
+	}
+
 	void write_lock();
 	void write_unlock();
 
+	void upgradeable_lock();
+	void upgradeable_unlock();
+
+	/// Turn the upgradeable read lock held by this thread into a write lock,
+	/// release it with write_unlock().
+	void upgrade();
+
 private:
-	bool writer_;
-	int readers_;
-	mutable std::mutex mutex_;
+	wg_read_write_lock(const wg_read_write_lock&);
+	wg_read_write_lock& operator=(const wg_read_write_lock&);
+
+	static const uint32_t READER = 1;
+	static const uint32_t READER_MASK = 0x000fffff;
+	static const uint32_t WAITING_WRITER = 0x00100000;
+	static const uint32_t WAITING_WRITER_MASK = 0x1ff00000;
+	static const uint32_t UPGRADEABLE = 0x20000000;
+	static const uint32_t WRITER = 0x40000000;
+
+	bool can_read(uint32_t state) const
+	{
+		return (state & WRITER) == 0 && (!preferWriters_ || (state & WAITING_WRITER_MASK) == 0);
+	}
+
+	bool try_acquire(lock_kind kind);
+	void lock_slow(lock_kind kind);
+	void notify_waiters();
+
+	std::atomic<uint32_t> state_;
+	std::atomic<int> sleepers_;
+	const bool preferWriters_;
+	std::mutex mutex_;
 	wg_condition_variable unlocked_;
 };
 
@@ -63,5 +129,42 @@ public:
 private:
 	wg_read_write_lock& write_Lock_;
 };
+
+/// Upgradeable read lock guard, upgrade() holds the lock for writing until the guard goes out of scope
+class wg_upgradeable_lock_guard
+{
+public:
+	explicit wg_upgradeable_lock_guard(wg_read_write_lock& lock) : lock_(lock), upgraded_(false)
+	{
+		lock_.upgradeable_lock();
+	}
+	~wg_upgradeable_lock_guard()
+	{
+		if (upgraded_)
+		{
+			lock_.write_unlock();
+		}
+		else
+		{
+			lock_.upgradeable_unlock();
+		}
+	}
+
+	void upgrade()
+	{
+		if (!upgraded_)
+		{
+			lock_.upgrade();
+			upgraded_ = true;
+		}
+	}
+
+private:
+	wg_upgradeable_lock_guard(const wg_upgradeable_lock_guard&);
+	wg_upgradeable_lock_guard& operator=(const wg_upgradeable_lock_guard&);
+
+	wg_read_write_lock& lock_;
+	bool upgraded_;
+};
 } // end namespace wgt
 #endif // WG_READ_WRITE_LOCK
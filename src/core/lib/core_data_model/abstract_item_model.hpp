@@ -286,6 +286,24 @@ public:
 		return Connection();
 	}
 
+	/** Adds a callback to call before the model reports a batch of item data changes,
+	such as the changes made by a batch command. Listeners can merge the changes reported
+	until the batch ends, the items stay valid until then.
+	@param callback The callback to call.
+	@return A Connection between the Signal and the callback. */
+	virtual Connection connectPreItemDataBatch(VoidCallback callback)
+	{
+		return Connection();
+	}
+
+	/** Adds a callback to call after the model reported a batch of item data changes.
+	@param callback The callback to call.
+	@return A Connection between the Signal and the callback. */
+	virtual Connection connectPostItemDataBatch(VoidCallback callback)
+	{
+		return Connection();
+	}
+
 	/** Adds a callback to call before an item's model changes.
 	@param callback The callback to call.
 	@return A Connection between the Signal and the callback. */
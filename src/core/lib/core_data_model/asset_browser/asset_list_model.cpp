@@ -7,6 +7,7 @@
 #include <vector>
 #include <algorithm>
 #include <array>
+#include <iterator>
 #include <string>
 #include <memory>
 #include <thread>
@@ -146,6 +147,40 @@ void AssetListModel::push_front(IAssetObjectItem* value)
 	signalPostItemsInserted(index, 1);
 }
 
+void AssetListModel::append(Items&& values)
+{
+	if (values.empty())
+	{
+		return;
+	}
+
+	auto index = items_.size();
+	auto count = values.size();
+
+	signalPreItemsInserted(index, count);
+	items_.insert(items_.end(), std::make_move_iterator(values.begin()), std::make_move_iterator(values.end()));
+	signalPostItemsInserted(index, count);
+	values.clear();
+}
+
+void AssetListModel::removeAt(size_t index)
+{
+	assert(index < items_.size());
+
+	signalPreItemsRemoved(index, 1);
+	items_.erase(items_.begin() + index);
+	signalPostItemsRemoved(index, 1);
+}
+
+void AssetListModel::replaceAt(size_t index, IAssetObjectItem* value)
+{
+	removeAt(index);
+
+	signalPreItemsInserted(index, 1);
+	items_.emplace(items_.begin() + index, value);
+	signalPostItemsInserted(index, 1);
+}
+
 const IAssetObjectItem& AssetListModel::back() const
 {
 	return *items_.back().get();
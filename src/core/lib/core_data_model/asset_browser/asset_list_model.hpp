@@ -185,6 +185,12 @@ public:
 
 	void push_back(IAssetObjectItem* value);
 	void push_front(IAssetObjectItem* value);
+
+	// Adds the items to the end with a single insertion notification
+	void append(Items&& values);
+	void removeAt(size_t index);
+	void replaceAt(size_t index, IAssetObjectItem* value);
+
 	const IAssetObjectItem& back() const;
 	const IAssetObjectItem& front() const;
 
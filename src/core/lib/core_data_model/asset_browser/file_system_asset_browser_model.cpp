@@ -21,32 +21,371 @@
 #include "core_logging/logging.hpp"
 #include "core_serialization/i_file_system.hpp"
 #include "core_reflection/type_class_definition.hpp"
+#include "core_dependency_system/depends.hpp"
+#include "editor_interaction/i_background_worker.hpp"
 
-#include <list>
+#include <algorithm>
+#include <atomic>
+#include <deque>
+#include <mutex>
+#include <unordered_map>
+#include <unordered_set>
 
 namespace wgt
 {
 static const int NO_SELECTION = -1;
 
-struct FileSystemAssetBrowserModel::FileSystemAssetBrowserModelImplementation
+namespace
 {
+// Enumerated files are added to the folder contents in chunks of this many
+const size_t POPULATE_CHUNK_SIZE = 256;
+
+typedef std::vector<IFileInfoPtr> FileInfos;
+typedef std::vector<std::string> Folders;
+
+// Paths are compared with forward slashes and without a trailing separator
+std::string normalisePath(const std::string& path)
+{
+	std::string normalised(path);
+	std::replace(normalised.begin(), normalised.end(), '\\', '/');
+	while (normalised.size() > 1 && normalised.back() == '/')
+	{
+		normalised.pop_back();
+	}
+	return normalised;
+}
+
+std::string getParentFolder(const std::string& path)
+{
+	auto separator = path.find_last_of('/');
+	return separator == std::string::npos ? std::string() : path.substr(0, separator == 0 ? 1 : separator);
+}
+
+bool isInFolder(const std::string& path, const std::string& folder)
+{
+	return path.size() > folder.size() && path.compare(0, folder.size(), folder) == 0 &&
+	(folder.back() == '/' || path[folder.size()] == '/');
+}
+
+// The folder being browsed, navigating away cancels its enumeration
+struct Population
+{
+	Population(const std::string& root) : root_(root), cancelled_(false)
+	{
+	}
+
+	const std::string root_;
+	std::atomic<bool> cancelled_;
+};
+typedef std::shared_ptr<Population> PopulationPtr;
+
+// Enumerates the folder and all of its sub-folders breadth first, publishing the files found in chunks
+void enumerateFolders(IFileSystem& fileSystem, const std::string& folder, const Population& population,
+                      const std::function<void(FileInfos&, Folders&)>& publish)
+{
+	std::deque<std::string> directories(1, folder);
+	FileInfos files;
+	Folders folders;
+	while (!directories.empty() && !population.cancelled_)
+	{
+		const std::string directory = std::move(directories.front());
+		directories.pop_front();
+
+		fileSystem.enumerate(directory.c_str(), [&](IFileInfoPtr&& info) {
+			if (population.cancelled_)
+			{
+				return false;
+			}
+			if (info->isDots())
+			{
+				return true;
+			}
+
+			if (!info->isDirectory())
+			{
+				files.push_back(std::move(info));
+				if (files.size() >= POPULATE_CHUNK_SIZE)
+				{
+					publish(files, folders);
+					files.clear();
+					folders.clear();
+				}
+			}
+			else if (!info->isHidden())
+			{
+				directories.push_back(info->fullPath().str());
+				folders.push_back(info->fullPath().str());
+			}
+			return true;
+		});
+	}
+
+	if (!population.cancelled_ && (!files.empty() || !folders.empty()))
+	{
+		publish(files, folders);
+	}
+}
+}
+
+struct FileSystemAssetBrowserModel::FileSystemAssetBrowserModelImplementation : public Depends<IBackgroundWorker>
+{
+	// File system changes may be reported on any thread, they are applied in batches on the foreground thread
+	struct ChangeQueue
+	{
+		std::mutex mutex_;
+		FileSystemAssetBrowserModelImplementation* owner_; // Cleared when the model is destroyed
+		std::vector<std::pair<std::string, IFileInfoPtr>> changes_;
+	};
+
 	FileSystemAssetBrowserModelImplementation(FileSystemAssetBrowserModel& self, IFileSystem& fileSystem,
 	                                          IAssetPresentationProvider& presentationProvider)
 	    : self_(self), folders_(nullptr), activeFiltersModel_(new SimpleActiveFiltersModel("AssetBrowserFilter")),
 	      presentationProvider_(presentationProvider), fileSystem_(fileSystem), folderContentsFilter_(""),
-	      currentCustomFilterIndex_(-1), iconSize_(64)
+	      currentCustomFilterIndex_(-1), iconSize_(64), changeQueue_(std::make_shared<ChangeQueue>())
+	{
+		changeQueue_->owner_ = this;
+		auto changeQueue = changeQueue_;
+		IFileSystem::PathChangedCallback changeCallback = [changeQueue](const char* path, const IFileInfoPtr info) {
+			queueChange(changeQueue, path, info);
+		};
+		changesConnection_ = fileSystem_.listenForChanges(changeCallback);
+	}
+
+	~FileSystemAssetBrowserModelImplementation()
+	{
+		changesConnection_.disconnect();
+		{
+			std::lock_guard<std::mutex> lock(changeQueue_->mutex_);
+			changeQueue_->owner_ = nullptr;
+		}
+
+		// Enumeration jobs still running use the file system
+		cancelPopulation();
+		for (auto& job : jobs_)
+		{
+			job->wait();
+		}
+	}
+
+	void populate(const std::string& folder)
+	{
+		cancelPopulation();
+		folderContents_.clear();
+		files_.clear();
+		knownFolders_.clear();
+
+		population_ = std::make_shared<Population>(normalisePath(folder));
+		knownFolders_.insert(population_->root_);
+	}
+
+	void cancelPopulation()
+	{
+		if (population_ == nullptr)
+		{
+			return;
+		}
+
+		// Chunks already queued for the foreground are dropped when they see the flag
+		population_->cancelled_ = true;
+		for (auto& job : jobs_)
+		{
+			job->cancel();
+		}
+		population_ = nullptr;
+	}
+
+	void enumerate(const std::string& folder)
+	{
+		if (population_ == nullptr)
+		{
+			return;
+		}
+
+		PopulationPtr population = population_;
+		auto worker = get<IBackgroundWorker>();
+		if (worker == nullptr)
+		{
+			enumerateFolders(fileSystem_, folder, *population, [this, &population](FileInfos& files, Folders& folders) {
+				publish(*population, files, folders);
+			});
+			return;
+		}
+
+		auto isDone = [](const BackgroundJobPtr& job) { return job->isDone(); };
+		jobs_.erase(std::remove_if(jobs_.begin(), jobs_.end(), isDone), jobs_.end());
+
+		// The destructor waits for these jobs, so the file system and worker outlive them
+		IFileSystem* fileSystem = &fileSystem_;
+		jobs_.push_back(worker->queueJob([this, fileSystem, worker, folder, population](const IBackgroundJob&) {
+			auto publishChunk = [this, worker, population](FileInfos& files, Folders& folders) {
+				auto chunk = std::make_shared<std::pair<FileInfos, Folders>>(std::move(files), std::move(folders));
+				worker->queueForegroundJob(
+				[this, population, chunk](const IBackgroundJob&) { publish(*population, chunk->first, chunk->second); },
+				IBackgroundWorker::JobDependencies());
+			};
+			enumerateFolders(*fileSystem, folder, *population, publishChunk);
+		}));
+	}
+
+	// Called on the foreground thread
+	void publish(const Population& population, FileInfos& files, Folders& folders)
+	{
+		// The model may have been destroyed if the population was cancelled
+		if (population.cancelled_ || &population != population_.get())
+		{
+			return;
+		}
+
+		for (auto& folder : folders)
+		{
+			knownFolders_.insert(normalisePath(folder));
+		}
+
+		AssetListModel::Items items;
+		for (auto& info : files)
+		{
+			std::string path = normalisePath(info->fullPath().str());
+			if (files_.find(path) == files_.end() && self_.fileHasFilteredExtension(info))
+			{
+				auto item = new BaseAssetObjectItem(info, nullptr, nullptr, &presentationProvider_);
+				files_.emplace(std::move(path), item);
+				items.emplace_back(item);
+			}
+		}
+		folderContents_.append(std::move(items));
+	}
+
+	static void queueChange(const std::shared_ptr<ChangeQueue>& changeQueue, const char* path, const IFileInfoPtr& info)
+	{
+		std::unique_lock<std::mutex> lock(changeQueue->mutex_);
+		if (changeQueue->owner_ == nullptr)
+		{
+			return;
+		}
+
+		const bool flushQueued = !changeQueue->changes_.empty();
+		changeQueue->changes_.emplace_back(path, info);
+		if (flushQueued)
+		{
+			return;
+		}
+
+		auto worker = changeQueue->owner_->get<IBackgroundWorker>();
+		if (worker != nullptr)
+		{
+			worker->queueForegroundJob([changeQueue](const IBackgroundJob&) { flushChanges(changeQueue); },
+			                           IBackgroundWorker::JobDependencies());
+			return;
+		}
+
+		lock.unlock();
+		flushChanges(changeQueue);
+	}
+
+	static void flushChanges(const std::shared_ptr<ChangeQueue>& changeQueue)
 	{
+		std::vector<std::pair<std::string, IFileInfoPtr>> changes;
+		FileSystemAssetBrowserModelImplementation* owner;
+		{
+			std::lock_guard<std::mutex> lock(changeQueue->mutex_);
+			owner = changeQueue->owner_;
+			changes.swap(changeQueue->changes_);
+		}
+
+		if (owner != nullptr)
+		{
+			for (auto& change : changes)
+			{
+				owner->applyChange(change.first, change.second);
+			}
+		}
 	}
 
-	void addFolderItem(const IFileInfoPtr& fileInfo)
+	// Updates the folder contents for a single changed path instead of enumerating the folder again
+	void applyChange(const std::string& changedPath, const IFileInfoPtr& info)
 	{
-		if (self_.fileHasFilteredExtension(fileInfo))
+		if (population_ == nullptr)
+		{
+			return;
+		}
+
+		const std::string path = normalisePath(changedPath);
+		if (!isInFolder(path, population_->root_))
+		{
+			return;
+		}
+
+		if (info == nullptr || info->attributes() == FileAttributes::None)
+		{
+			removeFolder(path);
+			removeFile(path);
+			return;
+		}
+
+		// Changes in folders that weren't enumerated, such as hidden ones, are ignored
+		if (knownFolders_.find(getParentFolder(path)) == knownFolders_.end())
+		{
+			return;
+		}
+
+		if (info->isDirectory())
 		{
-			auto item = new BaseAssetObjectItem(fileInfo, nullptr, nullptr, &presentationProvider_);
+			// Files in known folders report their own changes, only new folders need enumerating
+			if (!info->isHidden() && knownFolders_.insert(path).second)
+			{
+				enumerate(changedPath);
+			}
+			return;
+		}
+
+		auto it = files_.find(path);
+		if (it != files_.end())
+		{
+			auto item = new BaseAssetObjectItem(info, nullptr, nullptr, &presentationProvider_);
+			folderContents_.replaceAt(folderContents_.index(it->second), item);
+			it->second = item;
+		}
+		else if (self_.fileHasFilteredExtension(info))
+		{
+			auto item = new BaseAssetObjectItem(info, nullptr, nullptr, &presentationProvider_);
+			files_.emplace(path, item);
 			folderContents_.push_back(item);
 		}
 	}
 
+	void removeFile(const std::string& path)
+	{
+		auto it = files_.find(path);
+		if (it != files_.end())
+		{
+			folderContents_.removeAt(folderContents_.index(it->second));
+			files_.erase(it);
+		}
+	}
+
+	void removeFolder(const std::string& path)
+	{
+		if (knownFolders_.erase(path) == 0)
+		{
+			return;
+		}
+
+		for (auto it = knownFolders_.begin(); it != knownFolders_.end();)
+		{
+			it = isInFolder(*it, path) ? knownFolders_.erase(it) : std::next(it);
+		}
+
+		for (size_t i = folderContents_.size(); i-- > 0;)
+		{
+			const std::string itemPath = normalisePath(folderContents_[i].getFullPath());
+			if (isInFolder(itemPath, path))
+			{
+				files_.erase(itemPath);
+				folderContents_.removeAt(i);
+			}
+		}
+	}
+
 	IAssetObjectItem* getFolderContentsAtIndex(const int& index)
 	{
 		if (index < 0 || index >= (int)folderContents_.size())
@@ -70,6 +409,13 @@ struct FileSystemAssetBrowserModel::FileSystemAssetBrowserModelImplementation
 
 	int currentCustomFilterIndex_;
 	int iconSize_;
+
+	PopulationPtr population_;
+	std::vector<BackgroundJobPtr> jobs_; // Enumerations of this and previous populations that may still be running
+	std::unordered_map<std::string, const IAssetObjectItem*> files_; // The folder contents by normalised path
+	std::unordered_set<std::string> knownFolders_;
+	std::shared_ptr<ChangeQueue> changeQueue_;
+	Connection changesConnection_;
 };
 
 FileSystemAssetBrowserModel::FileSystemAssetBrowserModel(const AssetPaths& assetPaths,
@@ -130,18 +476,19 @@ const AssetPaths& FileSystemAssetBrowserModel::assetPaths() const
 
 void FileSystemAssetBrowserModel::populateFolderContents(const IItem* item)
 {
-	impl_->folderContents_.clear();
-	if (item)
+	auto folderItem = dynamic_cast<const BaseAssetObjectItem*>(item);
+	if (folderItem == nullptr)
 	{
-		auto folderItem = dynamic_cast<const BaseAssetObjectItem*>(item);
-		if (folderItem)
-		{
-			std::vector<std::string> paths;
-			auto fileInfo = folderItem->getFileInfo();
-			paths.push_back(fileInfo->fullPath());
-			addFolderItems(paths);
-		}
+		impl_->cancelPopulation();
+		impl_->folderContents_.clear();
+		return;
 	}
+
+	std::vector<std::string> paths;
+	auto fileInfo = folderItem->getFileInfo();
+	paths.push_back(fileInfo->fullPath().str());
+	impl_->populate(paths.front());
+	addFolderItems(paths);
 }
 
 bool FileSystemAssetBrowserModel::fileHasFilteredExtension(const IFileInfoPtr& fileInfo)
@@ -231,8 +578,6 @@ void FileSystemAssetBrowserModel::addFolderItems(const AssetPaths& paths)
 {
 	IFileSystem& fs = impl_->fileSystem_;
 
-	std::list<std::string> directories;
-
 	for (auto& path : paths)
 	{
 		if (!fs.exists(path.c_str()))
@@ -243,29 +588,8 @@ void FileSystemAssetBrowserModel::addFolderItems(const AssetPaths& paths)
 			continue;
 		}
 
-		directories.push_back(path);
-	}
-
-	while (!directories.empty())
-	{
-		const std::string& dir = directories.front();
-
-		fs.enumerate(dir.c_str(), [&](IFileInfoPtr&& info) {
-			if (!info->isDirectory())
-			{
-				impl_->addFolderItem(info);
-			}
-			// TODO: For search/filtering we should add all resources on a separate thread
-			// We don't want to block the main UI thread
-			// For now do not add sub-folders to avoid performance issues
-			// else if (!info.isDots())
-			//{
-			//	directories.push_back( info.fullPath );
-			//}
-			return true;
-		});
-
-		directories.pop_front();
+		// Sub-folders are enumerated on background workers, with their files added in chunks as they are found
+		impl_->enumerate(path);
 	}
 }
 
@@ -0,0 +1,114 @@
+#include "CppUnitLite2/src/CppUnitLite2.h"
+#include "core_data_model/common_data_roles.hpp"
+#include "core_data_model/variant_list.hpp"
+#include "core_data_model/filtering/string_filter_index.hpp"
+#include "core_data_model/filtering/tokenized_string_filter.hpp"
+#include "testing/data_model_test/test_data.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <string>
+#include <vector>
+
+namespace wgt
+{
+namespace
+{
+std::vector<std::string> dictionary(bool isShort)
+{
+	// next() wraps around to the first word after the last one
+	StringList list(isShort);
+	std::vector<std::string> words;
+	do
+	{
+		std::string word = list.next();
+		if (!word.empty())
+		{
+			words.push_back(word);
+		}
+	} while (list.position != 0);
+	return words;
+}
+
+// Items of the list the filter accepts
+std::vector<const IItem*> filterItems(const VariantList& list, IItemFilter& filter)
+{
+	std::vector<const IItem*> items;
+	for (size_t i = 0; i < list.size(); ++i)
+	{
+		if (filter.checkFilter(list.item(i)))
+		{
+			items.push_back(list.item(i));
+		}
+	}
+	return items;
+}
+
+// Filters the whole list for each prefix of the text, as typing it into a search box does
+double keystrokesPerSecond(const VariantList& list, TokenizedStringFilter& filter, const std::string& text)
+{
+	size_t matches = 0;
+	auto start = std::chrono::high_resolution_clock::now();
+	for (size_t length = 1; length <= text.length(); ++length)
+	{
+		filter.updateFilterTokens(text.substr(0, length).c_str());
+		matches += filterItems(list, filter).size();
+	}
+	std::chrono::duration<double> elapsed = std::chrono::high_resolution_clock::now() - start;
+	return matches > 0 ? text.length() / std::max(elapsed.count(), 1e-9) : 0.0;
+}
+
+// Queries the index directly for each prefix of the text
+double queriesPerSecond(const StringFilterIndex& index, const std::string& text)
+{
+	size_t matches = 0;
+	std::vector<const IItem*> items;
+	auto start = std::chrono::high_resolution_clock::now();
+	for (size_t length = 1; length <= text.length(); ++length)
+	{
+		index.find(std::vector<std::string>(1, text.substr(0, length)), items);
+		matches += items.size();
+	}
+	std::chrono::duration<double> elapsed = std::chrono::high_resolution_clock::now() - start;
+	return matches > 0 ? text.length() / std::max(elapsed.count(), 1e-9) : 0.0;
+}
+}
+
+TEST(stringFilterIndexBenchmark)
+{
+	// The dictionary repeated to a million rows, each copy with its own suffix
+	const size_t rowCount = 1000000;
+	const std::vector<std::string> words = dictionary(false /* isShort */);
+
+	VariantList list;
+	list.resize(rowCount);
+	for (size_t i = 0; i < rowCount; ++i)
+	{
+		list.item(i)->setData(0, ValueRole::roleId_,
+		                      words[i % words.size()] + "_" + std::to_string(i / words.size()));
+	}
+
+	auto start = std::chrono::high_resolution_clock::now();
+	StringFilterIndex index;
+	index.setRole(ValueRole::roleId_);
+	index.setSource(&list);
+	std::chrono::duration<double> buildTime = std::chrono::high_resolution_clock::now() - start;
+	CHECK_EQUAL(rowCount, index.size());
+
+	TokenizedStringFilter filter;
+	filter.setRole(ValueRole::roleId_);
+	TokenizedStringFilter indexedFilter;
+	indexedFilter.setRole(ValueRole::roleId_);
+	indexedFilter.setIndex(&index);
+
+	const std::string text = "accomplish_1";
+	const double search = keystrokesPerSecond(list, filter, text);
+	const double indexed = keystrokesPerSecond(list, indexedFilter, text);
+	const double queries = queriesPerSecond(index, text);
+	printf("String filter keystrokes/s over %zu rows: search %.1f, indexed filter %.1f (%.1fx), "
+	       "index queries %.1f (%.1fx), index built in %.2fs\n",
+	       rowCount, search, indexed, indexed / search, queries, queries / search, buildTime.count());
+	CHECK(filterItems(list, filter) == filterItems(list, indexedFilter));
+}
+} // end namespace wgt
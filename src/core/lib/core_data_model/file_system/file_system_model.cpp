@@ -130,8 +130,15 @@ struct FileItem : public AbstractTreeItem
 			{
 				return Variant();
 			}
+			if (fileInfo_->isDirectory())
+			{
+				return Variant();
+			}
+
+			// Shows the default icon until the thumbnail has loaded in the background,
+			// or for good if the file turns out to have no thumbnail
 			auto thumbnailFile = fileInfo_->fullPath();
-			if (!uiFramework->hasThumbnail(thumbnailFile.str().c_str()))
+			if (!uiFramework->loadThumbnail(thumbnailFile.str().c_str(), fileInfo_->modified(), fileInfo_->size()))
 			{
 				return Variant();
 			}
@@ -193,6 +200,13 @@ struct FileItem : public AbstractTreeItem
 		throw std::logic_error("The method or operation is not implemented.");
 	}
 
+	void thumbnailChanged()
+	{
+		const auto thumbnailFile = fileInfo_->fullPath();
+		fireDataChanged(PRE_DATA_CHANGED, *this, 0, ItemRole::thumbnailId, thumbnailFile);
+		fireDataChanged(POST_DATA_CHANGED, *this, 0, ItemRole::thumbnailId, thumbnailFile);
+	}
+
 	void invalidate(IFileInfoPtr info)
 	{
 		auto leftAttributes = fileInfo_->attributes();
@@ -202,6 +216,7 @@ struct FileItem : public AbstractTreeItem
 		bool leftCompressed = (leftAttributes & FileAttributes::Compressed) != 0;
 		bool rightCompressed = (rightAttributes & FileAttributes::Compressed) != 0;
 		bool compressedChanged = leftCompressed != rightCompressed;
+		bool contentsChanged = fileInfo_->modified() != info->modified() || fileInfo_->size() != info->size();
 
 		fileInfo_ = info;
 
@@ -222,6 +237,12 @@ struct FileItem : public AbstractTreeItem
 			fireDataChanged(PRE_DATA_CHANGED, *this, 0, ItemRole::compressedId, leftCompressed);
 			fireDataChanged(POST_DATA_CHANGED, *this, 0, ItemRole::compressedId, rightCompressed);
 		}
+
+		// The thumbnail of the old contents is replaced once the view requests it again
+		if (contentsChanged && !fileInfo_->isDirectory())
+		{
+			thumbnailChanged();
+		}
 	}
 
 
@@ -332,6 +353,13 @@ struct FileSystemModel::Impl : DependsLocal<IUIFramework>
 		auto uiFramework = get<IUIFramework>();
 		TF_ASSERT(uiFramework != nullptr);
 		uiFramework->loadIconData(":/WGControls/wg_file_system_icons.xml", IUIFramework::ResourceType::File);
+		thumbnailLoadedConnection_ =
+		uiFramework->connectThumbnailLoaded([this](const char* path) { thumbnailLoaded(path); });
+	}
+
+	~Impl()
+	{
+		thumbnailLoadedConnection_.disconnect();
 	}
 
 	const FileItems& getItems(const FileItem* parentItem)
@@ -383,6 +411,14 @@ struct FileSystemModel::Impl : DependsLocal<IUIFramework>
 		}
 	}
 
+	void thumbnailLoaded(const char* path)
+	{
+		if (auto item = findItem(path))
+		{
+			item->thumbnailChanged();
+		}
+	}
+
 	FileItem* findItem(const char* path)
 	{
 		if (!rootItems_)
@@ -433,6 +469,7 @@ struct FileSystemModel::Impl : DependsLocal<IUIFramework>
 	ModelSignals signals_;
 	std::mutex connectionsMutex_;
 	std::vector<Connection> connections_;
+	Connection thumbnailLoadedConnection_;
 };
 
 const char* FileSystemModel::s_mimeFilePath = "application/file-path";
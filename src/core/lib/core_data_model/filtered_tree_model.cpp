@@ -94,11 +94,28 @@ For every change in the item, a preDataChanged needs to be fired before the
 change, and a postDataChange after the change.
 
 This is to tell the view to update its data.
+
+Refreshes run as a background job. The job walks the parents in the index map
+and evaluates the filter a chunk of children at a time, holding the event lock
+only for a chunk so source model events and the view are not blocked for the
+whole remap. Changes found in a chunk are published as ranges. The first chunks
+are small, so the first matches show up quickly. Every refresh starts a new
+remap generation, which cancels the remap in progress. The job restarts from
+the root when the source model changes between two chunks.
+
+The views of the model may forward its signals to their own thread and wait for
+them there, so when an application is running the remap job doesn't publish its
+chunks itself. It hands each chunk to the thread that created the model, which
+publishes it on the application's next update, and the thread that created the
+model never waits for the remap job.
 */
 
 #include "filtered_tree_model.hpp"
 #include "core_variant/variant.hpp"
 #include "core_common/assert.hpp"
+#include "core_common/wg_condition_variable.hpp"
+#include "core_dependency_system/depends.hpp"
+#include "core_generic_plugin/interfaces/i_application.hpp"
 
 #include <unordered_map>
 #include <vector>
@@ -107,10 +124,11 @@ This is to tell the view to update its data.
 #include <thread>
 #include <functional>
 #include <atomic>
+#include <chrono>
 
 namespace wgt
 {
-struct FilteredTreeModel::Implementation
+struct FilteredTreeModel::Implementation : Depends<IApplication>
 {
 	enum class FilterUpdateType
 	{
@@ -122,6 +140,52 @@ struct FilteredTreeModel::Implementation
 
 	typedef std::unordered_map<const IItem*, std::vector<size_t>> IndexMap;
 
+	enum class RemapResult
+	{
+		DONE,
+		RESTART,
+		CANCELLED
+	};
+
+	struct RemapState
+	{
+		explicit RemapState(uint32_t generation)
+		    : generation_(generation), sourceChanges_(0), chunkSize_(FIRST_REMAP_CHUNK)
+		{
+		}
+
+		uint32_t generation_;
+		uint32_t sourceChanges_;
+		size_t chunkSize_;
+	};
+
+	// Mapped indices of a parent removed or inserted by a remap, at their position once the ranges before are published
+	struct RemapRange
+	{
+		RemapRange() : start_(0), removeCount_(0)
+		{
+		}
+
+		size_t start_;
+		size_t removeCount_;
+		std::vector<size_t> newIndices_;
+		std::vector<bool> newInFilter_;
+	};
+
+	// The ranges found in a chunk of a parent's children, only valid until the source or the filter changes
+	struct RemapChunk
+	{
+		RemapChunk(const IItem* parent, const RemapState& state)
+		    : parent_(parent), generation_(state.generation_), sourceChanges_(state.sourceChanges_)
+		{
+		}
+
+		const IItem* parent_;
+		uint32_t generation_;
+		uint32_t sourceChanges_;
+		std::vector<RemapRange> ranges_;
+	};
+
 	Implementation(FilteredTreeModel& self);
 
 	Implementation(FilteredTreeModel& self, const FilteredTreeModel::Implementation& rhs);
@@ -131,6 +195,11 @@ struct FilteredTreeModel::Implementation
 	void initialize();
 
 	void haltRemapping();
+	void cancelRemapping();
+	void startRemapping();
+	void stopRemapThread();
+	bool remapCancelled(const RemapState& state) const;
+	bool lockEvents(const RemapState& state) const;
 
 	void setSource(ITreeModel* source);
 
@@ -165,8 +234,13 @@ struct FilteredTreeModel::Implementation
 
 	bool mapIndices(const IItem* parent, bool parentInFilter);
 	void mapIndices();
-	void remapIndices(const IItem* parent, bool parentInFilter);
-	void remapIndices();
+	RemapResult remapIndices(const IItem* parent, bool parentInFilter, RemapState& state);
+	void remapIndices(uint32_t generation);
+	void remapJob();
+	bool publishOnOwnerThread() const;
+	void publishChunk(RemapChunk& chunk);
+	bool queueChunk(RemapChunk& chunk, const RemapState& state);
+	void publishQueuedChunk();
 	void copyIndices(IndexMap& target) const;
 
 	void preItemDataChanged(const IItem* item, int column, ItemRole::Id roleId, const Variant& data);
@@ -180,6 +254,7 @@ struct FilteredTreeModel::Implementation
 	bool ancestorFilterMatched(const IItem* item) const;
 	bool filterMatched(const IItem* item) const;
 	bool descendantFilterMatched(const IItem* item) const;
+	bool descendantFilterMatched(const IItem* item, const RemapState* state) const;
 
 	struct UpdateData
 	{
@@ -206,23 +281,48 @@ struct FilteredTreeModel::Implementation
 	IItemFilter* filter_;
 	IndexMap indexMap_;
 	mutable std::recursive_mutex indexMapMutex_;
-	mutable std::mutex eventControlMutex_;
-	std::atomic_uint_fast8_t remapping_;
-	std::atomic<bool> stopRemapping_;
+	mutable std::timed_mutex eventControlMutex_;
+	std::atomic<uint32_t> remapGeneration_;
+	std::atomic<uint32_t> sourceChanges_;
+	mutable std::mutex remapMutex_;
+	wg_condition_variable remapRequested_;
+	wg_condition_variable remapStopped_;
+	bool remapPending_;
+	bool remapExit_;
+	bool remapping_;
+	// The remap thread is walking the source, cancelled or not
+	bool remapRunning_;
+	std::thread remapThread_;
+	std::atomic<std::thread::id> remapThreadId_;
+	// Chunks queued by the remap thread for the owner thread, guarded by remapMutex_
+	std::unique_ptr<RemapChunk> queuedChunk_;
+	size_t queuedChunks_;
+	size_t publishedChunks_;
+	wg_condition_variable chunkPublished_;
+	std::thread::id ownerThreadId_;
+	Connection updateConnection_;
 	ConnectionHolder connections_;
 
 	static const size_t INVALID_INDEX = SIZE_MAX;
+
+	// Changes published by the first chunk of a remap, doubled for each chunk after it
+	static const size_t FIRST_REMAP_CHUNK = 64;
+	static const size_t MAX_REMAP_CHUNK = 4096;
+	// Source items evaluated before a chunk is published even if it has few changes
+	static const size_t MAX_REMAP_SCAN = 16384;
 };
 
 FilteredTreeModel::Implementation::Implementation(FilteredTreeModel& self)
-    : self_(self), model_(nullptr), filter_(nullptr)
+    : self_(self), model_(nullptr), filter_(nullptr), remapPending_(false), remapExit_(false), remapping_(false),
+      remapRunning_(false), queuedChunks_(0), publishedChunks_(0)
 {
 	mapIndices();
 	initialize();
 }
 
 FilteredTreeModel::Implementation::Implementation(FilteredTreeModel& self, const FilteredTreeModel::Implementation& rhs)
-    : self_(self), model_(rhs.model_), filter_(rhs.filter_)
+    : self_(self), model_(rhs.model_), filter_(rhs.filter_), remapPending_(false), remapExit_(false),
+      remapping_(false), remapRunning_(false), queuedChunks_(0), publishedChunks_(0)
 {
 	rhs.copyIndices(indexMap_);
 	initialize();
@@ -230,22 +330,249 @@ FilteredTreeModel::Implementation::Implementation(FilteredTreeModel& self, const
 
 FilteredTreeModel::Implementation::~Implementation()
 {
+	updateConnection_.disconnect();
+	haltRemapping();
+	stopRemapThread();
 }
 
 void FilteredTreeModel::Implementation::haltRemapping()
 {
-	stopRemapping_ = true;
+	bool wasRemapping;
+	{
+		std::unique_lock<std::mutex> lock(remapMutex_);
+		// Cancels the remap in progress, the remap thread stays alive for the next refresh
+		cancelRemapping();
+		remapPending_ = false;
+
+		// The remap thread can't wait for itself, it only cancels its current remap
+		if (std::this_thread::get_id() == remapThreadId_.load())
+		{
+			return;
+		}
+
+		// A cancelled remap returns at its next check, after that it no longer reads the source or the filter.
+		// The owner thread doesn't wait, the remap may be blocked on the owner's views until it returns.
+		// The remap only reads the filter and the source under the event lock, so it is enough to take that.
+		if (std::this_thread::get_id() != ownerThreadId_)
+		{
+			remapStopped_.wait(lock, [this] { return !remapRunning_; });
+		}
+		wasRemapping = remapping_;
+		remapping_ = false;
+	}
+
+	if (wasRemapping)
+	{
+		self_.onFilteringEnd();
+	}
+}
+
+// Must be called with remapMutex_ held
+void FilteredTreeModel::Implementation::cancelRemapping()
+{
+	++remapGeneration_;
+	queuedChunk_.reset();
+	chunkPublished_.notify_all();
+}
+
+void FilteredTreeModel::Implementation::stopRemapThread()
+{
+	{
+		std::lock_guard<std::mutex> guard(remapMutex_);
+		if (!remapThread_.joinable())
+		{
+			return;
+		}
+		remapExit_ = true;
+	}
+
+	remapRequested_.notify_one();
+	remapThread_.join();
+}
+
+void FilteredTreeModel::Implementation::startRemapping()
+{
+	bool wasRemapping;
+	{
+		std::lock_guard<std::mutex> guard(remapMutex_);
+		// Cancels the remap in progress, the remap thread starts over with the new generation
+		cancelRemapping();
+		remapPending_ = true;
+		wasRemapping = remapping_;
+		remapping_ = true;
+
+		if (!remapThread_.joinable())
+		{
+			remapThread_ = std::thread(&FilteredTreeModel::Implementation::remapJob, this);
+		}
+	}
+
+	remapRequested_.notify_one();
+
+	if (!wasRemapping)
+	{
+		self_.onFilteringBegin();
+	}
+}
+
+void FilteredTreeModel::Implementation::remapJob()
+{
+	remapThreadId_ = std::this_thread::get_id();
+
+	std::unique_lock<std::mutex> lock(remapMutex_);
+	for (;;)
+	{
+		remapRequested_.wait(lock, [this] { return remapPending_ || remapExit_; });
+
+		if (remapExit_)
+		{
+			break;
+		}
+
+		remapPending_ = false;
+		remapRunning_ = true;
+		const uint32_t generation = remapGeneration_;
+		lock.unlock();
+		remapIndices(generation);
+		lock.lock();
+		remapRunning_ = false;
+		remapStopped_.notify_all();
+
+		// Nothing to report if the remap was halted, haltRemapping ends the filtering then
+		if (!remapPending_ && !remapExit_ && remapping_)
+		{
+			remapping_ = false;
+			lock.unlock();
+			self_.onFilteringEnd();
+			lock.lock();
+		}
+	}
+
+	remapThreadId_ = std::thread::id();
+}
+
+bool FilteredTreeModel::Implementation::publishOnOwnerThread() const
+{
+	return updateConnection_.connected() && std::this_thread::get_id() != ownerThreadId_;
+}
+
+// Must be called with the event lock held
+void FilteredTreeModel::Implementation::publishChunk(RemapChunk& chunk)
+{
+	std::vector<size_t>* mappedIndicesPointer;
+	{
+		std::lock_guard<std::recursive_mutex> guard(indexMapMutex_);
+		mappedIndicesPointer = findMappedIndices(chunk.parent_);
+	}
+
+	if (mappedIndicesPointer == nullptr)
+	{
+		return;
+	}
+
+	std::vector<size_t>& mappedIndices = *mappedIndicesPointer;
+	const IItem* parent = chunk.parent_;
+	for (auto& range : chunk.ranges_)
+	{
+		if (range.removeCount_ > 0)
+		{
+			self_.signalPreItemsRemoved(parent, range.start_, range.removeCount_);
+			removeItems(range.start_, range.removeCount_, 0, parent, mappedIndices, false);
+			self_.signalPostItemsRemoved(parent, range.start_, range.removeCount_);
+		}
+		else
+		{
+			const size_t count = range.newIndices_.size();
+			self_.signalPreItemsInserted(parent, range.start_, count);
+			insertItems(range.start_, 0, parent, mappedIndices, range.newIndices_, range.newInFilter_);
+			self_.signalPostItemsInserted(parent, range.start_, count);
+		}
+	}
+}
+
+// Hands the chunk to the owner thread and waits until it is published or the remap is cancelled
+bool FilteredTreeModel::Implementation::queueChunk(RemapChunk& chunk, const RemapState& state)
+{
+	std::unique_lock<std::mutex> lock(remapMutex_);
+	if (remapCancelled(state))
+	{
+		return false;
+	}
 
-	while (remapping_ > 0)
+	queuedChunk_.reset(new RemapChunk(std::move(chunk)));
+	const size_t queued = ++queuedChunks_;
+	chunkPublished_.wait(lock, [&] { return publishedChunks_ >= queued || remapCancelled(state); });
+	return !remapCancelled(state);
+}
+
+// Called on the owner thread by the application's update
+void FilteredTreeModel::Implementation::publishQueuedChunk()
+{
+	std::unique_ptr<RemapChunk> chunk;
+	size_t queued;
 	{
-		std::this_thread::yield();
+		std::lock_guard<std::mutex> guard(remapMutex_);
+		if (queuedChunk_ == nullptr)
+		{
+			return;
+		}
+		chunk = std::move(queuedChunk_);
+		queued = queuedChunks_;
 	}
+
+	{
+		// The remap thread doesn't wait for anything while it holds the event lock
+		std::lock_guard<std::timed_mutex> blockEvents(eventControlMutex_);
+
+		// A chunk found before the source or the filter changed is dropped, the remap restarts or is cancelled
+		if (chunk->generation_ == remapGeneration_ && chunk->sourceChanges_ == sourceChanges_)
+		{
+			publishChunk(*chunk);
+		}
+	}
+
+	std::lock_guard<std::mutex> guard(remapMutex_);
+	publishedChunks_ = std::max(publishedChunks_, queued);
+	chunkPublished_.notify_all();
+}
+
+bool FilteredTreeModel::Implementation::remapCancelled(const RemapState& state) const
+{
+	return remapGeneration_.load(std::memory_order_relaxed) != state.generation_;
+}
+
+bool FilteredTreeModel::Implementation::lockEvents(const RemapState& state) const
+{
+	// Event handlers may hold the lock while they wait for this remap to be cancelled
+	while (!eventControlMutex_.try_lock_for(std::chrono::milliseconds(10)))
+	{
+		if (remapCancelled(state))
+		{
+			return false;
+		}
+	}
+
+	if (remapCancelled(state))
+	{
+		eventControlMutex_.unlock();
+		return false;
+	}
+
+	return true;
 }
 
 void FilteredTreeModel::Implementation::initialize()
 {
-	remapping_ = 0;
-	stopRemapping_ = false;
+	remapGeneration_ = 0;
+	sourceChanges_ = 0;
+	remapThreadId_ = std::thread::id();
+	ownerThreadId_ = std::this_thread::get_id();
+
+	auto application = get<IApplication>();
+	if (application != nullptr)
+	{
+		updateConnection_ = application->signalUpdate.connect([this]() { publishQueuedChunk(); });
+	}
 }
 
 void FilteredTreeModel::Implementation::setSource(ITreeModel* source)
@@ -720,64 +1047,174 @@ void FilteredTreeModel::Implementation::mapIndices()
 	mapIndices(nullptr, false);
 }
 
-void FilteredTreeModel::Implementation::remapIndices(const IItem* parent, bool parentInFilter)
+FilteredTreeModel::Implementation::RemapResult FilteredTreeModel::Implementation::remapIndices(
+const IItem* parent, bool parentInFilter, RemapState& state)
 {
-	std::vector<size_t>* mappedIndicesPointer = findMappedIndices(parent);
-
-	if (mappedIndicesPointer == nullptr || stopRemapping_ || model_ == nullptr)
-	{
-		return;
-	}
-
-	std::vector<size_t>& mappedIndices = *mappedIndicesPointer;
-	size_t modelCount = model_->size(parent);
+	size_t i = 0;
 	size_t index = 0;
-	bool includeDueToAncestor = parentInFilter && !filter_->filterDescendantsOfMatchingItems();
+	bool finished = false;
 
-	for (size_t i = 0; i < modelCount; ++i)
+	while (!finished)
 	{
-		if (stopRemapping_)
+		std::vector<std::pair<const IItem*, bool>> remainingItems;
+		RemapChunk chunk(parent, state);
+
 		{
-			return;
-		}
+			if (!lockEvents(state))
+			{
+				return RemapResult::CANCELLED;
+			}
+			std::lock_guard<std::timed_mutex> blockEvents(eventControlMutex_, std::adopt_lock);
 
-		const IItem* item = model_->item(i, parent);
+			if (sourceChanges_ != state.sourceChanges_)
+			{
+				return RemapResult::RESTART;
+			}
 
-		bool itemInFilter = item == nullptr ? false : includeDueToAncestor || filterMatched(item);
-		bool wasInFilter = index < mappedIndices.size() && mappedIndices[index] == i;
-		bool nowInFilter = itemInFilter || descendantFilterMatched(item);
+			const std::vector<size_t>* mappedIndicesPointer;
+			{
+				std::lock_guard<std::recursive_mutex> guard(indexMapMutex_);
+				mappedIndicesPointer = findMappedIndices(parent);
+			}
 
-		if (wasInFilter && nowInFilter)
-		{
-			remapIndices(item, itemInFilter);
-			++index;
-		}
-		else if (wasInFilter && !nowInFilter)
-		{
-			self_.signalPreItemsRemoved(parent, index, 1);
-			removeItems(index, 1, 0, parent, mappedIndices, false);
-			self_.signalPostItemsRemoved(parent, index, 1);
+			if (mappedIndicesPointer == nullptr || model_ == nullptr)
+			{
+				return RemapResult::DONE;
+			}
+
+			// The filter is only read under the event lock, which setFilter takes to replace it
+			const bool includeDueToAncestor = parentInFilter && !filter_->filterDescendantsOfMatchingItems();
+			const std::vector<size_t>& mappedIndices = *mappedIndicesPointer;
+			const size_t modelCount = model_->size(parent);
+			const size_t scanEnd = std::min(modelCount, i + MAX_REMAP_SCAN);
+			size_t changes = 0;
+
+			// Consecutive removals and insertions become one range. The mapped indices only change when the
+			// chunk is published, so cursor is the next mapped entry not compared yet and index is where it
+			// will be once the ranges before it are published.
+			size_t cursor = index;
+			RemapRange range;
+			auto endRange = [&]() {
+				if (range.removeCount_ > 0 || !range.newIndices_.empty())
+				{
+					index += range.newIndices_.size();
+					chunk.ranges_.push_back(std::move(range));
+					range = RemapRange();
+				}
+			};
+
+			for (; i < scanEnd && changes < state.chunkSize_; ++i)
+			{
+				if (remapCancelled(state))
+				{
+					// Changes not published yet are dropped, the index map is left consistent
+					return RemapResult::CANCELLED;
+				}
+
+				const IItem* item = model_->item(i, parent);
+
+				bool itemInFilter = item == nullptr ? false : includeDueToAncestor || filterMatched(item);
+				bool wasInFilter = cursor < mappedIndices.size() && mappedIndices[cursor] == i;
+				bool nowInFilter = itemInFilter || descendantFilterMatched(item, &state);
+
+				if (remapCancelled(state))
+				{
+					// The descendant check may have been cut short
+					return RemapResult::CANCELLED;
+				}
+
+				if (wasInFilter && nowInFilter)
+				{
+					endRange();
+					remainingItems.emplace_back(item, itemInFilter);
+					++cursor;
+					++index;
+				}
+				else if (wasInFilter)
+				{
+					if (!range.newIndices_.empty())
+					{
+						endRange();
+					}
+					if (range.removeCount_ == 0)
+					{
+						range.start_ = index;
+					}
+					++range.removeCount_;
+					++cursor;
+					++changes;
+				}
+				else if (nowInFilter)
+				{
+					if (range.removeCount_ > 0)
+					{
+						endRange();
+					}
+					if (range.newIndices_.empty())
+					{
+						range.start_ = index;
+					}
+					range.newIndices_.push_back(i);
+					range.newInFilter_.push_back(itemInFilter);
+					++changes;
+				}
+			}
+
+			endRange();
+
+			if (changes > 0)
+			{
+				state.chunkSize_ = std::min(state.chunkSize_ * 2, MAX_REMAP_CHUNK);
+			}
+
+			finished = i >= modelCount;
+
+			if (!publishOnOwnerThread())
+			{
+				publishChunk(chunk);
+				chunk.ranges_.clear();
+			}
 		}
-		else if (nowInFilter)
+
+		// The owner thread publishes the chunk under the event lock, so it must not be held while waiting
+		if (!chunk.ranges_.empty())
 		{
-			self_.signalPreItemsInserted(parent, index, 1);
+			if (!queueChunk(chunk, state))
+			{
+				return RemapResult::CANCELLED;
+			}
 
-			std::vector<size_t> newIndices(1, i);
-			std::vector<bool> newInFilter(1, itemInFilter);
-			insertItems(index, 0, parent, mappedIndices, newIndices, newInFilter);
+			// The owner thread drops a chunk found before the source changed
+			if (sourceChanges_ != state.sourceChanges_)
+			{
+				return RemapResult::RESTART;
+			}
+		}
 
-			self_.signalPostItemsInserted(parent, index, 1);
-			++index;
+		// Children are remapped without holding the event lock, each of them takes it per chunk
+		for (auto& remaining : remainingItems)
+		{
+			RemapResult result = remapIndices(remaining.first, remaining.second, state);
+			if (result != RemapResult::DONE)
+			{
+				return result;
+			}
 		}
 	}
+
+	return RemapResult::DONE;
 }
 
-void FilteredTreeModel::Implementation::remapIndices()
+void FilteredTreeModel::Implementation::remapIndices(uint32_t generation)
 {
-	++remapping_;
-	std::lock_guard<std::mutex> blockEvents(eventControlMutex_);
-	remapIndices(nullptr, false);
-	--remapping_;
+	RemapState state(generation);
+	RemapResult result;
+
+	do
+	{
+		state.sourceChanges_ = sourceChanges_;
+		result = remapIndices(nullptr, false, state);
+	} while (result == RemapResult::RESTART);
 }
 
 void FilteredTreeModel::Implementation::copyIndices(IndexMap& target) const
@@ -800,12 +1237,18 @@ void FilteredTreeModel::Implementation::postItemDataChanged(const IItem* item, i
                                                             const Variant& data)
 {
 	indexMapMutex_.unlock();
-	std::lock_guard<std::mutex> blockEvents(eventControlMutex_, std::adopt_lock);
+	std::lock_guard<std::timed_mutex> blockEvents(eventControlMutex_, std::adopt_lock);
 
 	ItemIndex sourceIndex;
 	size_t newIndex;
 	FilterUpdateType updateType = checkUpdateType(item, sourceIndex, newIndex);
 
+	if (updateType != FilterUpdateType::IGNORE)
+	{
+		// Mapped indices the remap in progress may be walking change, it has to start over
+		++sourceChanges_;
+	}
+
 	if (updateType == FilterUpdateType::UPDATE)
 	{
 		if (item != nullptr)
@@ -844,7 +1287,8 @@ void FilteredTreeModel::Implementation::preItemsInserted(const IItem* parent, si
 
 void FilteredTreeModel::Implementation::postItemsInserted(const IItem* parent, size_t index, size_t count)
 {
-	std::lock_guard<std::mutex> blockEvents(eventControlMutex_, std::adopt_lock);
+	std::lock_guard<std::timed_mutex> blockEvents(eventControlMutex_, std::adopt_lock);
+	++sourceChanges_;
 
 	// Optimization, delay inserting until getChildCount has been called.
 	// ItemIndex itemIndex = findInsertPoint( args.item_, args.index_ );
@@ -923,7 +1367,8 @@ void FilteredTreeModel::Implementation::preItemsRemoved(const IItem* parent, siz
 
 void FilteredTreeModel::Implementation::postItemsRemoved(const IItem* parent, size_t index, size_t count)
 {
-	std::lock_guard<std::mutex> blockEvents(eventControlMutex_, std::adopt_lock);
+	std::lock_guard<std::timed_mutex> blockEvents(eventControlMutex_, std::adopt_lock);
+	++sourceChanges_;
 
 	if (lastUpdateData_.valid_)
 	{
@@ -972,7 +1417,12 @@ bool FilteredTreeModel::Implementation::filterMatched(const IItem* item) const
 
 bool FilteredTreeModel::Implementation::descendantFilterMatched(const IItem* item) const
 {
-	if (item == nullptr || filter_ == nullptr)
+	return descendantFilterMatched(item, nullptr);
+}
+
+bool FilteredTreeModel::Implementation::descendantFilterMatched(const IItem* item, const RemapState* state) const
+{
+	if (item == nullptr || filter_ == nullptr || (state != nullptr && remapCancelled(*state)))
 	{
 		return false;
 	}
@@ -988,7 +1438,7 @@ bool FilteredTreeModel::Implementation::descendantFilterMatched(const IItem* ite
 			continue;
 		}
 
-		if (filter_->checkFilter(child) || descendantFilterMatched(child))
+		if (filter_->checkFilter(child) || descendantFilterMatched(child, state))
 		{
 			return true;
 		}
@@ -1106,20 +1556,22 @@ void FilteredTreeModel::setSource(ITreeModel* source)
 	impl_->haltRemapping();
 
 	// Initialize and remap the indices based on the new source
-	std::lock_guard<std::mutex> blockEvents(impl_->eventControlMutex_);
+	std::lock_guard<std::timed_mutex> blockEvents(impl_->eventControlMutex_);
 
 	// Set the new source
 	impl_->setSource(source);
 
 	impl_->mapIndices();
-	impl_->initialize();
+	++impl_->sourceChanges_;
 }
 
 void FilteredTreeModel::setFilter(IItemFilter* filter)
 {
+	// Cancel the remap for the previous filter rather than waiting for it to finish
+	impl_->haltRemapping();
+
 	{
-		// wait for previous refresh to finish.
-		std::lock_guard<std::mutex> blockEvents(impl_->eventControlMutex_);
+		std::lock_guard<std::timed_mutex> blockEvents(impl_->eventControlMutex_);
 		impl_->filter_ = filter;
 	}
 
@@ -1136,6 +1588,12 @@ const ITreeModel* FilteredTreeModel::getSource() const
 	return impl_->model_;
 }
 
+bool FilteredTreeModel::isFiltering() const
+{
+	std::lock_guard<std::mutex> guard(impl_->remapMutex_);
+	return impl_->remapping_;
+}
+
 void FilteredTreeModel::refresh(bool wait)
 {
 	if (impl_->model_ == nullptr)
@@ -1145,19 +1603,13 @@ void FilteredTreeModel::refresh(bool wait)
 
 	if (wait)
 	{
-		impl_->remapIndices();
-		return;
-	}
-
-	// if one refresh is finishing and another is waiting, then there's no
-	// point in queuing another refresh operation. (2 = two refreshes)
-	if (impl_->remapping_ > 1)
-	{
+		impl_->haltRemapping();
+		onFilteringBegin();
+		impl_->remapIndices(++impl_->remapGeneration_);
+		onFilteringEnd();
 		return;
 	}
 
-	void (FilteredTreeModel::Implementation::*refreshMethod)() = &FilteredTreeModel::Implementation::remapIndices;
-	std::thread nextRefresh(std::bind(refreshMethod, impl_.get()));
-	nextRefresh.detach();
+	impl_->startRemapping();
 }
 } // end namespace wgt
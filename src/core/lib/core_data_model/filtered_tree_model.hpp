@@ -8,8 +8,15 @@
 
 namespace wgt
 {
+/**
+ *	Tree model exposing the items of a source model which pass a filter.
+ *	Refreshes remap the filtered items in the background, publishing them in chunks.
+ *	A refresh cancels the one in progress, so refreshing as a filter is edited never waits.
+ */
 class FilteredTreeModel : public ITreeModel
 {
+	typedef Signal<void(void)> SignalVoid;
+
 public:
 	FilteredTreeModel();
 	FilteredTreeModel(const FilteredTreeModel& rhs);
@@ -32,8 +39,19 @@ public:
 	ITreeModel* getSource();
 	const ITreeModel* getSource() const;
 
+	/**
+	 *	Remap the filtered items, in the background unless wait is set.
+	 *	While an application is running, background remaps send the signals for the changed items
+	 *	from the thread that created the model, on the application's update.
+	 *	Otherwise they are sent from the thread doing the remap.
+	 */
 	void refresh(bool wait = false);
 
+	bool isFiltering() const;
+
+	SignalVoid onFilteringBegin;
+	SignalVoid onFilteringEnd;
+
 private:
 	struct Implementation;
 	std::unique_ptr<Implementation> impl_;
@@ -1,6 +1,10 @@
 #include "string_filter.hpp"
+#include "string_filter_index.hpp"
 #include "../i_item.hpp"
 #include "../i_item_role.hpp"
+#include <algorithm>
+#include <cctype>
+#include <vector>
 
 namespace wgt
 {
@@ -10,10 +14,14 @@ struct StringFilter::Implementation
 
 	StringFilter& self_;
 	std::string filterText_;
+	// The lowercase filter text, as the only token of index queries
+	std::vector<std::string> filterTokens_;
 	ItemRole::Id roleId_;
+	StringFilterIndex* index_;
 };
 
-StringFilter::Implementation::Implementation(StringFilter& self) : self_(self), filterText_(""), roleId_(0)
+StringFilter::Implementation::Implementation(StringFilter& self)
+    : self_(self), filterText_(""), filterTokens_(1), roleId_(0), index_(nullptr)
 {
 }
 
@@ -28,6 +36,10 @@ StringFilter::~StringFilter()
 void StringFilter::setFilterText(const char* filterText)
 {
 	impl_->filterText_ = filterText;
+
+	std::string& filter = impl_->filterTokens_.front();
+	filter = impl_->filterText_;
+	std::transform(filter.begin(), filter.end(), filter.begin(), ::tolower);
 }
 
 const char* StringFilter::getFilterText()
@@ -40,6 +52,11 @@ void StringFilter::setRole(ItemRole::Id roleId)
 	impl_->roleId_ = roleId;
 }
 
+void StringFilter::setIndex(StringFilterIndex* index)
+{
+	impl_->index_ = index;
+}
+
 bool StringFilter::checkFilter(const IItem* item)
 {
 	if (impl_->filterText_ == "")
@@ -47,6 +64,15 @@ bool StringFilter::checkFilter(const IItem* item)
 		return true;
 	}
 
+	if (impl_->index_ != nullptr && impl_->index_->getRole() == impl_->roleId_)
+	{
+		auto match = impl_->index_->match(impl_->filterTokens_, item);
+		if (match != StringFilterIndex::Match::NOT_INDEXED)
+		{
+			return match == StringFilterIndex::Match::YES;
+		}
+	}
+
 	std::string haystack = "";
 	if (impl_->roleId_ == 0)
 	{
@@ -65,10 +91,7 @@ bool StringFilter::checkFilter(const IItem* item)
 
 	std::transform(haystack.begin(), haystack.end(), haystack.begin(), ::tolower);
 
-	std::string filter = impl_->filterText_;
-	std::transform(filter.begin(), filter.end(), filter.begin(), ::tolower);
-
-	if (haystack.find(filter) != std::string::npos)
+	if (haystack.find(impl_->filterTokens_.front()) != std::string::npos)
 	{
 		return true;
 	}
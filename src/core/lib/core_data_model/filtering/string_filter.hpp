@@ -6,9 +6,12 @@
 
 namespace wgt
 {
+class StringFilterIndex;
+
 /**
  *	StringFilter
  *  A simple string filter implementation.
+ *  An optional StringFilterIndex over the same role answers checkFilter without searching each item's string.
  */
 class StringFilter : public IItemFilter
 {
@@ -23,6 +26,8 @@ public:
 	void setFilterText(const char* filterText);
 	const char* getFilterText();
 
+	void setIndex(StringFilterIndex* index);
+
 private:
 	struct Implementation;
 	std::unique_ptr<Implementation> impl_;
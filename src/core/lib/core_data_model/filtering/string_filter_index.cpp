@@ -0,0 +1,626 @@
+#include "string_filter_index.hpp"
+#include "../i_item.hpp"
+#include "../i_list_model.hpp"
+#include "../i_tree_model.hpp"
+#include "core_common/signal.hpp"
+#include "core_variant/variant.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <cctype>
+#include <cstdint>
+#include <mutex>
+#include <unordered_map>
+
+namespace wgt
+{
+struct StringFilterIndex::Implementation
+{
+	typedef uint32_t Slot;
+	typedef uint32_t Trigram;
+	typedef std::vector<Slot> Postings;
+
+	struct Entry
+	{
+		const IItem* item_;
+		std::string text_;
+	};
+
+	Implementation();
+
+	void getText(const IItem* item, std::string& text) const;
+	static void getTrigrams(const std::string& text, std::vector<Trigram>& trigrams);
+	static bool containsTokens(const std::string& text, const std::vector<std::string>& tokens);
+
+	void insert(const IItem* item);
+	void erase(const IItem* item);
+	void addPostings(Slot slot, const std::string& text);
+	void removePostings(Slot slot, const std::string& text);
+	void updateMatch(Slot slot);
+	void reset();
+	void reindex();
+
+	void query(const std::vector<std::string>& tokens, std::vector<Slot>& slots) const;
+	void cacheQuery(const std::vector<std::string>& tokens);
+	bool isCached(const std::vector<std::string>& tokens) const;
+	Match lookup(const IItem* item) const;
+
+	void detach();
+	void insertItems(const IItem* parent, size_t index, size_t count);
+	void eraseItems(const IItem* parent, size_t index, size_t count);
+	void insertTree(const IItem* item);
+	void eraseTree(const IItem* item);
+	void preItemDataChanged(const IItem* item, int column);
+	void postItemDataChanged(const IItem* item, int column);
+
+	std::atomic<ItemRole::Id> roleId_;
+	std::vector<Entry> entries_;
+	std::vector<Slot> freeSlots_;
+	std::unordered_map<const IItem*, Slot> slots_;
+	std::unordered_map<Trigram, Postings> postings_;
+
+	// Slots matching the cached query are stamped with the query's stamp
+	std::vector<uint32_t> matchStamps_;
+	std::vector<std::string> queryTokens_;
+	uint32_t queryStamp_;
+	bool queryCached_;
+
+	IListModel* listModel_;
+	ITreeModel* treeModel_;
+	ConnectionHolder connections_;
+	mutable std::mutex lock_;
+
+	// Postings at least this many times longer than the candidates are binary searched instead of merged
+	static const size_t SEARCH_RATIO = 16;
+};
+
+StringFilterIndex::Implementation::Implementation()
+    : roleId_(0), queryStamp_(0), queryCached_(false), listModel_(nullptr), treeModel_(nullptr)
+{
+}
+
+void StringFilterIndex::Implementation::getText(const IItem* item, std::string& text) const
+{
+	const ItemRole::Id roleId = roleId_.load();
+	if (roleId == 0)
+	{
+		const char* displayText = item->getDisplayText(0);
+		text = displayText != nullptr ? displayText : "";
+	}
+	else
+	{
+		auto data = item->getData(0, roleId);
+		if (!data.tryCast(text))
+		{
+			// Items without string data never match, as with the filters
+			text.clear();
+			return;
+		}
+	}
+
+	std::transform(text.begin(), text.end(), text.begin(), ::tolower);
+}
+
+void StringFilterIndex::Implementation::getTrigrams(const std::string& text, std::vector<Trigram>& trigrams)
+{
+	trigrams.clear();
+	if (text.size() < 3)
+	{
+		return;
+	}
+
+	const unsigned char* chars = reinterpret_cast<const unsigned char*>(text.data());
+	for (size_t i = 0; i + 3 <= text.size(); ++i)
+	{
+		trigrams.push_back(Trigram(chars[i]) | (Trigram(chars[i + 1]) << 8) | (Trigram(chars[i + 2]) << 16));
+	}
+	std::sort(trigrams.begin(), trigrams.end());
+	trigrams.erase(std::unique(trigrams.begin(), trigrams.end()), trigrams.end());
+}
+
+bool StringFilterIndex::Implementation::containsTokens(const std::string& text, const std::vector<std::string>& tokens)
+{
+	for (auto& token : tokens)
+	{
+		if (text.find(token) == std::string::npos)
+		{
+			return false;
+		}
+	}
+	return true;
+}
+
+void StringFilterIndex::Implementation::insert(const IItem* item)
+{
+	if (item == nullptr)
+	{
+		return;
+	}
+
+	auto found = slots_.find(item);
+	if (found != slots_.end())
+	{
+		auto& entry = entries_[found->second];
+		removePostings(found->second, entry.text_);
+		getText(item, entry.text_);
+		addPostings(found->second, entry.text_);
+		updateMatch(found->second);
+		return;
+	}
+
+	Slot slot;
+	if (freeSlots_.empty())
+	{
+		slot = static_cast<Slot>(entries_.size());
+		entries_.emplace_back();
+		matchStamps_.push_back(0);
+	}
+	else
+	{
+		slot = freeSlots_.back();
+		freeSlots_.pop_back();
+	}
+
+	auto& entry = entries_[slot];
+	entry.item_ = item;
+	getText(item, entry.text_);
+	addPostings(slot, entry.text_);
+	slots_[item] = slot;
+	updateMatch(slot);
+}
+
+void StringFilterIndex::Implementation::erase(const IItem* item)
+{
+	auto found = slots_.find(item);
+	if (found == slots_.end())
+	{
+		return;
+	}
+
+	const Slot slot = found->second;
+	auto& entry = entries_[slot];
+	removePostings(slot, entry.text_);
+	entry.item_ = nullptr;
+	entry.text_.clear();
+	matchStamps_[slot] = 0;
+	slots_.erase(found);
+	freeSlots_.push_back(slot);
+}
+
+void StringFilterIndex::Implementation::addPostings(Slot slot, const std::string& text)
+{
+	std::vector<Trigram> trigrams;
+	getTrigrams(text, trigrams);
+	for (auto trigram : trigrams)
+	{
+		auto& postings = postings_[trigram];
+		if (postings.empty() || postings.back() < slot)
+		{
+			postings.push_back(slot);
+		}
+		else
+		{
+			postings.insert(std::lower_bound(postings.begin(), postings.end(), slot), slot);
+		}
+	}
+}
+
+void StringFilterIndex::Implementation::removePostings(Slot slot, const std::string& text)
+{
+	std::vector<Trigram> trigrams;
+	getTrigrams(text, trigrams);
+	for (auto trigram : trigrams)
+	{
+		auto found = postings_.find(trigram);
+		if (found == postings_.end())
+		{
+			continue;
+		}
+
+		auto& postings = found->second;
+		auto it = std::lower_bound(postings.begin(), postings.end(), slot);
+		if (it != postings.end() && *it == slot)
+		{
+			postings.erase(it);
+		}
+		if (postings.empty())
+		{
+			postings_.erase(found);
+		}
+	}
+}
+
+void StringFilterIndex::Implementation::updateMatch(Slot slot)
+{
+	if (queryCached_)
+	{
+		matchStamps_[slot] = containsTokens(entries_[slot].text_, queryTokens_) ? queryStamp_ : 0;
+	}
+}
+
+void StringFilterIndex::Implementation::reset()
+{
+	entries_.clear();
+	freeSlots_.clear();
+	slots_.clear();
+	postings_.clear();
+	matchStamps_.clear();
+	queryCached_ = false;
+}
+
+void StringFilterIndex::Implementation::reindex()
+{
+	std::vector<const IItem*> items;
+	items.reserve(slots_.size());
+	for (auto& entry : entries_)
+	{
+		if (entry.item_ != nullptr)
+		{
+			items.push_back(entry.item_);
+		}
+	}
+
+	reset();
+	if (listModel_ != nullptr)
+	{
+		insertItems(nullptr, 0, listModel_->size());
+	}
+	else if (treeModel_ != nullptr)
+	{
+		insertItems(nullptr, 0, treeModel_->size(nullptr));
+	}
+	else
+	{
+		for (auto item : items)
+		{
+			insert(item);
+		}
+	}
+}
+
+void StringFilterIndex::Implementation::query(const std::vector<std::string>& tokens, std::vector<Slot>& slots) const
+{
+	slots.clear();
+
+	std::vector<Trigram> trigrams;
+	std::vector<Trigram> tokenTrigrams;
+	for (auto& token : tokens)
+	{
+		getTrigrams(token, tokenTrigrams);
+		trigrams.insert(trigrams.end(), tokenTrigrams.begin(), tokenTrigrams.end());
+	}
+	std::sort(trigrams.begin(), trigrams.end());
+	trigrams.erase(std::unique(trigrams.begin(), trigrams.end()), trigrams.end());
+
+	std::vector<const Postings*> postingLists;
+	for (auto trigram : trigrams)
+	{
+		auto found = postings_.find(trigram);
+		if (found == postings_.end())
+		{
+			return;
+		}
+		postingLists.push_back(&found->second);
+	}
+
+	std::vector<Slot> candidates;
+	if (postingLists.empty())
+	{
+		for (Slot slot = 0; slot < entries_.size(); ++slot)
+		{
+			if (entries_[slot].item_ != nullptr)
+			{
+				candidates.push_back(slot);
+			}
+		}
+	}
+	else
+	{
+		// Intersect from the shortest list, so the candidates shrink as fast as possible
+		std::sort(postingLists.begin(), postingLists.end(),
+		          [](const Postings* lhs, const Postings* rhs) { return lhs->size() < rhs->size(); });
+		candidates = *postingLists.front();
+
+		std::vector<Slot> intersection;
+		for (size_t i = 1; i < postingLists.size() && !candidates.empty(); ++i)
+		{
+			const Postings& postings = *postingLists[i];
+			intersection.clear();
+			if (postings.size() / SEARCH_RATIO > candidates.size())
+			{
+				for (auto slot : candidates)
+				{
+					if (std::binary_search(postings.begin(), postings.end(), slot))
+					{
+						intersection.push_back(slot);
+					}
+				}
+			}
+			else
+			{
+				std::set_intersection(candidates.begin(), candidates.end(), postings.begin(), postings.end(),
+				                      std::back_inserter(intersection));
+			}
+			candidates.swap(intersection);
+		}
+	}
+
+	// Sharing trigrams doesn't mean the text contains the token
+	for (auto slot : candidates)
+	{
+		if (containsTokens(entries_[slot].text_, tokens))
+		{
+			slots.push_back(slot);
+		}
+	}
+}
+
+void StringFilterIndex::Implementation::cacheQuery(const std::vector<std::string>& tokens)
+{
+	if (++queryStamp_ == 0)
+	{
+		std::fill(matchStamps_.begin(), matchStamps_.end(), 0);
+		queryStamp_ = 1;
+	}
+
+	std::vector<Slot> slots;
+	query(tokens, slots);
+	for (auto slot : slots)
+	{
+		matchStamps_[slot] = queryStamp_;
+	}
+	queryTokens_ = tokens;
+	queryCached_ = true;
+}
+
+bool StringFilterIndex::Implementation::isCached(const std::vector<std::string>& tokens) const
+{
+	return queryCached_ && queryTokens_ == tokens;
+}
+
+StringFilterIndex::Match StringFilterIndex::Implementation::lookup(const IItem* item) const
+{
+	auto found = slots_.find(item);
+	if (found == slots_.end())
+	{
+		return Match::NOT_INDEXED;
+	}
+	return matchStamps_[found->second] == queryStamp_ ? Match::YES : Match::NO;
+}
+
+void StringFilterIndex::Implementation::detach()
+{
+	connections_.clear();
+	listModel_ = nullptr;
+	treeModel_ = nullptr;
+}
+
+void StringFilterIndex::Implementation::insertItems(const IItem* parent, size_t index, size_t count)
+{
+	for (size_t i = index; i < index + count; ++i)
+	{
+		if (listModel_ != nullptr)
+		{
+			insert(listModel_->item(i));
+		}
+		else if (treeModel_ != nullptr)
+		{
+			insertTree(treeModel_->item(i, parent));
+		}
+	}
+}
+
+void StringFilterIndex::Implementation::eraseItems(const IItem* parent, size_t index, size_t count)
+{
+	for (size_t i = index; i < index + count; ++i)
+	{
+		if (listModel_ != nullptr)
+		{
+			erase(listModel_->item(i));
+		}
+		else if (treeModel_ != nullptr)
+		{
+			eraseTree(treeModel_->item(i, parent));
+		}
+	}
+}
+
+void StringFilterIndex::Implementation::insertTree(const IItem* item)
+{
+	if (item == nullptr)
+	{
+		return;
+	}
+
+	insert(item);
+	insertItems(item, 0, treeModel_->size(item));
+}
+
+void StringFilterIndex::Implementation::eraseTree(const IItem* item)
+{
+	if (item == nullptr)
+	{
+		return;
+	}
+
+	eraseItems(item, 0, treeModel_->size(item));
+	erase(item);
+}
+
+void StringFilterIndex::Implementation::preItemDataChanged(const IItem* item, int column)
+{
+	// Until the change is posted filters fall back to searching the item's string,
+	// whichever order they and the index are notified in
+	if (column == 0)
+	{
+		erase(item);
+	}
+}
+
+void StringFilterIndex::Implementation::postItemDataChanged(const IItem* item, int column)
+{
+	if (column == 0)
+	{
+		insert(item);
+	}
+}
+
+StringFilterIndex::StringFilterIndex() : impl_(new Implementation())
+{
+}
+
+StringFilterIndex::~StringFilterIndex()
+{
+	impl_->detach();
+}
+
+void StringFilterIndex::setRole(ItemRole::Id roleId)
+{
+	std::lock_guard<std::mutex> guard(impl_->lock_);
+	if (impl_->roleId_.load() == roleId)
+	{
+		return;
+	}
+
+	impl_->roleId_ = roleId;
+	impl_->reindex();
+}
+
+ItemRole::Id StringFilterIndex::getRole() const
+{
+	return impl_->roleId_.load();
+}
+
+void StringFilterIndex::setSource(IListModel* source)
+{
+	impl_->detach();
+
+	std::lock_guard<std::mutex> guard(impl_->lock_);
+	impl_->reset();
+	impl_->listModel_ = source;
+	if (source == nullptr)
+	{
+		return;
+	}
+
+	auto& impl = *impl_;
+	impl.connections_ +=
+	source->signalPreItemDataChanged.connect([&impl](const IItem* item, int column, ItemRole::Id, const Variant&) {
+		std::lock_guard<std::mutex> guard(impl.lock_);
+		impl.preItemDataChanged(item, column);
+	});
+	impl.connections_ +=
+	source->signalPostItemDataChanged.connect([&impl](const IItem* item, int column, ItemRole::Id, const Variant&) {
+		std::lock_guard<std::mutex> guard(impl.lock_);
+		impl.postItemDataChanged(item, column);
+	});
+	impl.connections_ += source->signalPostItemsInserted.connect([&impl](size_t index, size_t count) {
+		std::lock_guard<std::mutex> guard(impl.lock_);
+		impl.insertItems(nullptr, index, count);
+	});
+	impl.connections_ += source->signalPreItemsRemoved.connect([&impl](size_t index, size_t count) {
+		std::lock_guard<std::mutex> guard(impl.lock_);
+		impl.eraseItems(nullptr, index, count);
+	});
+	impl.connections_ +=
+	source->signalDestructing.connect([this]() { setSource(static_cast<IListModel*>(nullptr)); });
+
+	impl.insertItems(nullptr, 0, source->size());
+}
+
+void StringFilterIndex::setSource(ITreeModel* source)
+{
+	impl_->detach();
+
+	std::lock_guard<std::mutex> guard(impl_->lock_);
+	impl_->reset();
+	impl_->treeModel_ = source;
+	if (source == nullptr)
+	{
+		return;
+	}
+
+	auto& impl = *impl_;
+	impl.connections_ +=
+	source->signalPreItemDataChanged.connect([&impl](const IItem* item, int column, ItemRole::Id, const Variant&) {
+		std::lock_guard<std::mutex> guard(impl.lock_);
+		impl.preItemDataChanged(item, column);
+	});
+	impl.connections_ +=
+	source->signalPostItemDataChanged.connect([&impl](const IItem* item, int column, ItemRole::Id, const Variant&) {
+		std::lock_guard<std::mutex> guard(impl.lock_);
+		impl.postItemDataChanged(item, column);
+	});
+	impl.connections_ +=
+	source->signalPostItemsInserted.connect([&impl](const IItem* parent, size_t index, size_t count) {
+		std::lock_guard<std::mutex> guard(impl.lock_);
+		impl.insertItems(parent, index, count);
+	});
+	impl.connections_ +=
+	source->signalPreItemsRemoved.connect([&impl](const IItem* parent, size_t index, size_t count) {
+		std::lock_guard<std::mutex> guard(impl.lock_);
+		impl.eraseItems(parent, index, count);
+	});
+	impl.connections_ +=
+	source->signalDestructing.connect([this]() { setSource(static_cast<ITreeModel*>(nullptr)); });
+
+	impl.insertItems(nullptr, 0, source->size(nullptr));
+}
+
+void StringFilterIndex::addItem(const IItem* item)
+{
+	std::lock_guard<std::mutex> guard(impl_->lock_);
+	impl_->insert(item);
+}
+
+void StringFilterIndex::updateItem(const IItem* item)
+{
+	std::lock_guard<std::mutex> guard(impl_->lock_);
+	if (impl_->slots_.find(item) != impl_->slots_.end())
+	{
+		impl_->insert(item);
+	}
+}
+
+void StringFilterIndex::removeItem(const IItem* item)
+{
+	std::lock_guard<std::mutex> guard(impl_->lock_);
+	impl_->erase(item);
+}
+
+void StringFilterIndex::clear()
+{
+	std::lock_guard<std::mutex> guard(impl_->lock_);
+	impl_->reset();
+}
+
+size_t StringFilterIndex::size() const
+{
+	std::lock_guard<std::mutex> guard(impl_->lock_);
+	return impl_->slots_.size();
+}
+
+void StringFilterIndex::find(const std::vector<std::string>& tokens, std::vector<const IItem*>& items) const
+{
+	items.clear();
+
+	std::lock_guard<std::mutex> guard(impl_->lock_);
+	std::vector<Implementation::Slot> slots;
+	impl_->query(tokens, slots);
+	items.reserve(slots.size());
+	for (auto slot : slots)
+	{
+		items.push_back(impl_->entries_[slot].item_);
+	}
+}
+
+StringFilterIndex::Match StringFilterIndex::match(const std::vector<std::string>& tokens, const IItem* item) const
+{
+	std::lock_guard<std::mutex> guard(impl_->lock_);
+	if (!impl_->isCached(tokens))
+	{
+		impl_->cacheQuery(tokens);
+	}
+	return impl_->lookup(item);
+}
+} // end namespace wgt
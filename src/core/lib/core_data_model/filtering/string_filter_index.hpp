@@ -0,0 +1,78 @@
+#ifndef STRING_FILTER_INDEX_HPP
+#define STRING_FILTER_INDEX_HPP
+
+#include "core_data_model/i_item_role.hpp"
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace wgt
+{
+class IItem;
+class IListModel;
+class ITreeModel;
+
+/**
+ *	StringFilterIndex
+ *  A lowercase trigram index over the string role of a model's items.
+ *  StringFilter and TokenizedStringFilter can be given an index, so they look up
+ *  whether an item matches instead of fetching and searching its string.
+ *  A query intersects the posting lists of the trigrams in its tokens, only the
+ *  remaining candidates have their text searched. Tokens shorter than a trigram
+ *  search the text of every item.
+ *  The index follows insert, remove and data change signals of its source model.
+ */
+class StringFilterIndex
+{
+public:
+	enum class Match
+	{
+		YES,
+		NO,
+		NOT_INDEXED
+	};
+
+	StringFilterIndex();
+	~StringFilterIndex();
+
+	/**
+	 *	Role of the indexed string, 0 indexes the display text.
+	 *	Changing the role reindexes the items of the source model.
+	 */
+	void setRole(ItemRole::Id roleId);
+	ItemRole::Id getRole() const;
+
+	/**
+	 *	Index all items of a model and keep the index up to date with it.
+	 *	Passing nullptr detaches the index from its model and clears it.
+	 */
+	void setSource(IListModel* source);
+	void setSource(ITreeModel* source);
+
+	void addItem(const IItem* item);
+	void updateItem(const IItem* item);
+	void removeItem(const IItem* item);
+	void clear();
+	size_t size() const;
+
+	/**
+	 *	Find the items whose string contains all of the lowercase tokens.
+	 */
+	void find(const std::vector<std::string>& tokens, std::vector<const IItem*>& items) const;
+
+	/**
+	 *	Check if an item's string contains all of the lowercase tokens.
+	 *	The items matching the last tokens are cached, so filtering a whole model
+	 *	with the same tokens only runs the query once.
+	 */
+	Match match(const std::vector<std::string>& tokens, const IItem* item) const;
+
+private:
+	StringFilterIndex(const StringFilterIndex&);
+	StringFilterIndex& operator=(const StringFilterIndex&);
+
+	struct Implementation;
+	std::unique_ptr<Implementation> impl_;
+};
+} // end namespace wgt
+#endif // STRING_FILTER_INDEX_HPP
@@ -1,8 +1,9 @@
 #include "tokenized_string_filter.hpp"
+#include "string_filter_index.hpp"
 #include "../i_item.hpp"
 #include "../i_item_role.hpp"
-#include <iostream>
-#include <sstream>
+#include <algorithm>
+#include <cctype>
 #include <mutex>
 
 namespace wgt
@@ -16,11 +17,12 @@ struct TokenizedStringFilter::Implementation
 	std::string sourceFilterText_;
 	std::string splitter_;
 	ItemRole::Id roleId_;
+	StringFilterIndex* index_;
 	std::mutex filterTokensLock_;
 };
 
 TokenizedStringFilter::Implementation::Implementation(TokenizedStringFilter& self)
-    : self_(self), sourceFilterText_(""), splitter_(" "), roleId_(0)
+    : self_(self), sourceFilterText_(""), splitter_(" "), roleId_(0), index_(nullptr)
 {
 }
 
@@ -36,25 +38,32 @@ void TokenizedStringFilter::updateFilterTokens(const char* filterText)
 {
 	impl_->sourceFilterText_ = filterText;
 
-	std::lock_guard<std::mutex>(impl_->filterTokensLock_);
+	std::lock_guard<std::mutex> guard(impl_->filterTokensLock_);
 	impl_->filterTokens_.clear();
 
-	std::istringstream stream(filterText);
-	std::string token;
-
 	char splitter = ' ';
 	if (impl_->splitter_.length() > 0)
 	{
 		splitter = impl_->splitter_[0];
 	}
 
-	while (std::getline(stream, token, splitter))
+	const std::string& text = impl_->sourceFilterText_;
+	size_t start = 0;
+	while (start < text.length())
 	{
-		if (token.length() > 0)
+		size_t end = text.find(splitter, start);
+		if (end == std::string::npos)
+		{
+			end = text.length();
+		}
+
+		if (end > start)
 		{
+			impl_->filterTokens_.emplace_back(text, start, end - start);
+			std::string& token = impl_->filterTokens_.back();
 			std::transform(token.begin(), token.end(), token.begin(), ::tolower);
-			impl_->filterTokens_.push_back(token);
 		}
+		start = end + 1;
 	}
 }
 
@@ -78,13 +87,28 @@ void TokenizedStringFilter::setRole(ItemRole::Id roleId)
 	impl_->roleId_ = roleId;
 }
 
+void TokenizedStringFilter::setIndex(StringFilterIndex* index)
+{
+	impl_->index_ = index;
+}
+
 bool TokenizedStringFilter::checkFilter(const IItem* item)
 {
+	std::lock_guard<std::mutex> guard(impl_->filterTokensLock_);
 	if (impl_->filterTokens_.size() < 1)
 	{
 		return true;
 	}
 
+	if (impl_->index_ != nullptr && impl_->index_->getRole() == impl_->roleId_)
+	{
+		auto match = impl_->index_->match(impl_->filterTokens_, item);
+		if (match != StringFilterIndex::Match::NOT_INDEXED)
+		{
+			return match == StringFilterIndex::Match::YES;
+		}
+	}
+
 	std::string haystack = "";
 
 	if (impl_->roleId_ == 0)
@@ -108,7 +132,6 @@ bool TokenizedStringFilter::checkFilter(const IItem* item)
 	}
 
 	std::transform(haystack.begin(), haystack.end(), haystack.begin(), ::tolower);
-	std::lock_guard<std::mutex>(impl_->filterTokensLock_);
 
 	for (auto& filter : impl_->filterTokens_)
 	{
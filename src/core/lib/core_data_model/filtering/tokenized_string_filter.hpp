@@ -6,9 +6,12 @@
 
 namespace wgt
 {
+class StringFilterIndex;
+
 /**
  *	TokenizedStringFilter
  *  A filter implementation, which uses a vector of strings to compare text against.
+ *  An optional StringFilterIndex over the same role answers checkFilter without searching each item's string.
  */
 class TokenizedStringFilter : public IItemFilter
 {
@@ -26,6 +29,8 @@ public:
 	void setSplitterChar(const char* splitter);
 	const char* getSplitterChar();
 
+	void setIndex(StringFilterIndex* index);
+
 private:
 	struct Implementation;
 	std::unique_ptr<Implementation> impl_;
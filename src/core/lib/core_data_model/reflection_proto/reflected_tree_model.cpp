@@ -15,11 +15,14 @@
 #include "core_reflection/utilities/object_handle_reflection_utils.hpp"
 #include "core_command_system/i_command_manager.hpp"
 #include "core_data_model/file_system/file_system_model.hpp"
+#include "core_generic_plugin/interfaces/i_application.hpp"
 
 #include "core_common/scoped_stop_watch.hpp"
 #include "core_reflection/interfaces/i_property_path.hpp"
 #include "core_reflection/reflection_batch_query.hpp"
 #include <algorithm>
+#include <mutex>
+#include <thread>
 
 
 namespace wgt
@@ -127,17 +130,142 @@ bool isVectorType(const Variant& value)
 
 namespace proto
 {
-class ReflectedTreeModelPropertyListener : public PropertyAccessorListener, Depends<IDefinitionManager, ICommandManager>
+/**
+* Turns property changes into model signals.
+* While a batch command runs, each changed property is reported once: the pre signal on its first change, and the post
+* signal with its final value when the batch ends, between the model's item data batch signals.
+* Batches may begin and end on the command thread, but the model is only signalled on the thread that created it.
+*/
+class ReflectedTreeModelPropertyListener : public PropertyAccessorListener,
+                                           public ICommandEventListener,
+                                           Depends<IDefinitionManager, ICommandManager, IApplication>
 {
 public:
-	ReflectedTreeModelPropertyListener(ReflectedTreeModel& model) : model_(model)
+	ReflectedTreeModelPropertyListener(ReflectedTreeModel& model)
+	    : model_(model), ownerThreadId_(std::this_thread::get_id()), batchDepth_(0)
 	{
+		auto commandManager = get<ICommandManager>();
+		if (commandManager != nullptr)
+		{
+			commandManager->registerCommandStatusListener(this);
+		}
+
+		auto application = get<IApplication>();
+		if (application != nullptr)
+		{
+			updateConnection_ = application->signalUpdate.connect([this]() { flushCompletedBatch(); });
+		}
 	}
 
 	~ReflectedTreeModelPropertyListener()
 	{
+		updateConnection_.disconnect();
+		auto commandManager = get<ICommandManager>();
+		if (commandManager != nullptr)
+		{
+			commandManager->deregisterCommandStatusListener(this);
+		}
 	}
 
+	// ICommandEventListener
+	virtual void multiCommandStatusChanged(MultiCommandStatus multiCommandStatus) const override
+	{
+		{
+			std::lock_guard<std::mutex> lock(mutex_);
+			switch (multiCommandStatus)
+			{
+			case MultiCommandStatus_Begin:
+				++batchDepth_;
+				break;
+
+			// Every batch that begins is either cancelled or completed
+			case MultiCommandStatus_Cancel:
+			case MultiCommandStatus_Complete:
+				batchDepth_ = std::max(batchDepth_ - 1, 0);
+				break;
+			}
+		}
+
+		flushCompletedBatch();
+	}
+
+	// Reports the held changes before the model's layout changes, whether or not the batch has ended.
+	// Off the owner thread nothing is reported; the held changes wait for the next update.
+	void flushPendingChanges() const
+	{
+		if (std::this_thread::get_id() != ownerThreadId_)
+		{
+			return;
+		}
+
+		PendingChanges pendingChanges;
+		{
+			std::lock_guard<std::mutex> lock(mutex_);
+			pendingChanges.swap(pendingChanges_);
+		}
+		reportPendingChanges(pendingChanges);
+	}
+
+	void flushCompletedBatch() const
+	{
+		if (std::this_thread::get_id() != ownerThreadId_)
+		{
+			return;
+		}
+
+		PendingChanges pendingChanges;
+		{
+			std::lock_guard<std::mutex> lock(mutex_);
+			if (batchDepth_ > 0)
+			{
+				return;
+			}
+			pendingChanges.swap(pendingChanges_);
+		}
+		reportPendingChanges(pendingChanges);
+	}
+
+private:
+	struct PendingChange
+	{
+		PendingChange() : isPolyStruct_(false)
+		{
+		}
+
+		Variant value_;
+		bool isPolyStruct_;
+	};
+	typedef std::unordered_map<const ReflectedPropertyItem*, PendingChange> PendingChanges;
+
+	void reportPendingChanges(const PendingChanges& pendingChanges) const
+	{
+		TF_ASSERT(std::this_thread::get_id() == ownerThreadId_);
+		if (pendingChanges.empty())
+		{
+			return;
+		}
+
+		model_.preItemDataBatch_();
+		for (auto& pendingChange : pendingChanges)
+		{
+			auto property = pendingChange.first;
+			if (!model_.isMapped(property))
+			{
+				continue;
+			}
+
+			const auto index = model_.index(property);
+			const int column = 0;
+			model_.postItemDataChanged_(index, column, ValueRole::roleId_, pendingChange.second.value_);
+			if (pendingChange.second.isPolyStruct_)
+			{
+				model_.postItemDataChanged_(index, column, DefinitionRole::roleId_, pendingChange.second.value_);
+			}
+		}
+		model_.postItemDataBatch_();
+	}
+
+public:
 	// PropertyAccessorListener
 	virtual void preSetValue(const PropertyAccessor& accessor, const Variant& value) override
 	{
@@ -185,6 +313,9 @@ public:
 		
 		if (invalidateItem)
 		{
+			// Pending properties may be unmapped by the layout change
+			flushPendingChanges();
+
 			auto item = model_.mappedItem(property);
 			const auto index = model_.index(item);
 
@@ -202,6 +333,24 @@ public:
 		
 		if (mapped)
 		{
+			// Changes held by a batch that ended on another thread come before this one.
+			// Off the owner thread they cannot be reported yet, so this change is held behind them.
+			flushCompletedBatch();
+			{
+				const bool onOwnerThread = std::this_thread::get_id() == ownerThreadId_;
+				std::lock_guard<std::mutex> lock(mutex_);
+				if (batchDepth_ > 0 || (!onOwnerThread && !pendingChanges_.empty()))
+				{
+					auto inserted = pendingChanges_.insert(std::make_pair(property, PendingChange()));
+					inserted.first->second.value_ = value;
+					inserted.first->second.isPolyStruct_ |= isPolyStruct;
+					if (!inserted.second)
+					{
+						return;
+					}
+				}
+			}
+
 			const auto index = model_.index(property);
 			const int column = 0;
 			ItemRole::Id roleId = ValueRole::roleId_;
@@ -279,6 +428,16 @@ public:
 	
 		if (mapped)
 		{
+			{
+				std::lock_guard<std::mutex> lock(mutex_);
+				auto pendingIt = pendingChanges_.find(property);
+				if (pendingIt != pendingChanges_.end())
+				{
+					pendingIt->second.value_ = value;
+					return;
+				}
+			}
+
 			const auto index = model_.index(property);
 			const int column = 0;
 			ItemRole::Id roleId = ValueRole::roleId_;
@@ -294,6 +453,7 @@ public:
 
 	virtual void preInsert(const PropertyAccessor& accessor, size_t index, size_t count) override
 	{
+		flushPendingChanges();
 		auto item = model_.findProperty(accessor.getRootObject(), accessor.getFullPath());
 		if (item == nullptr)
 		{
@@ -399,6 +559,7 @@ public:
 
 	virtual void preErase(const PropertyAccessor& accessor, size_t index, size_t count) override
 	{
+		flushPendingChanges();
 		auto item = model_.findProperty(accessor.getRootObject(), accessor.getFullPath());
 		if (item == nullptr)
 		{
@@ -498,6 +659,13 @@ public:
 
 private:
 	ReflectedTreeModel& model_;
+	const std::thread::id ownerThreadId_;
+	Connection updateConnection_;
+
+	// Guards the batch state, which the command thread changes too
+	mutable std::mutex mutex_;
+	mutable int batchDepth_;
+	mutable PendingChanges pendingChanges_;
 };
 
 ReflectedTreeModel::ReflectedTreeModel(const ObjectHandle& object)
@@ -533,6 +701,7 @@ void ReflectedTreeModel::setObject(const ObjectHandle& object)
 {
 	SCOPE_TAG
 	ReflectionBatchQuery batchQuery;
+	static_cast<ReflectedTreeModelPropertyListener*>(listener_.get())->flushPendingChanges();
 	preModelReset_();
 
 	unmapItem(nullptr);
@@ -1126,6 +1295,16 @@ Connection ReflectedTreeModel::connectPostItemDataChanged(AbstractTreeModel::Dat
 	return postItemDataChanged_.connect(callback);
 }
 
+Connection ReflectedTreeModel::connectPreItemDataBatch(VoidCallback callback)
+{
+	return preItemDataBatch_.connect(callback);
+}
+
+Connection ReflectedTreeModel::connectPostItemDataBatch(VoidCallback callback)
+{
+	return postItemDataBatch_.connect(callback);
+}
+
 Connection ReflectedTreeModel::connectPreLayoutChanged(LayoutCallback callback)
 {
 	return preLayoutChanged_.connect(callback);
@@ -58,6 +58,8 @@ public:
 
 	virtual Connection connectPreItemDataChanged(DataCallback callback) override;
 	virtual Connection connectPostItemDataChanged(DataCallback callback) override;
+	virtual Connection connectPreItemDataBatch(VoidCallback callback) override;
+	virtual Connection connectPostItemDataBatch(VoidCallback callback) override;
 	virtual Connection connectPreLayoutChanged(LayoutCallback callback) override;
 	virtual Connection connectPostLayoutChanged(LayoutCallback callback) override;
 	virtual Connection connectModelChanged(VoidCallback callback) override;
@@ -139,6 +141,9 @@ private:
 	Signal<AbstractTreeModel::DataSignature> preItemDataChanged_;
 	Signal<AbstractTreeModel::DataSignature> postItemDataChanged_;
 
+	Signal<VoidSignature> preItemDataBatch_;
+	Signal<VoidSignature> postItemDataBatch_;
+
 	Signal<AbstractTreeModel::RangeSignature> preRowsInserted_;
 	Signal<AbstractTreeModel::RangeSignature> postRowsInserted_;
 
@@ -124,7 +124,8 @@ void SimpleActiveFiltersModel::Impl::generateStringValue()
 
 void SimpleActiveFiltersModel::Impl::saveSavedFilterPreferences()
 {
-	auto preferences = get<IUIFramework>()->getPreferences();
+	auto uiFramework = get<IUIFramework>();
+	auto preferences = uiFramework != nullptr ? uiFramework->getPreferences() : nullptr;
 	if (preferences == nullptr)
 	{
 		// evgenys: generic_app crashes on plugins unload here, UIFramework is already uninitialized
@@ -150,7 +151,13 @@ void SimpleActiveFiltersModel::Impl::saveSavedFilterPreferences()
 
 void SimpleActiveFiltersModel::Impl::loadSavedFilterPreferences()
 {
-	auto preferences = get<IUIFramework>()->getPreferences();
+	// Models created without a UI framework, such as in unit tests, have no saved filters
+	auto uiFramework = get<IUIFramework>();
+	auto preferences = uiFramework != nullptr ? uiFramework->getPreferences() : nullptr;
+	if (preferences == nullptr)
+	{
+		return;
+	}
 
 	GenericObjectPtr& preference = preferences->getPreference(id_.c_str());
 	auto accessor = preference->findProperty("savedFilterCount");
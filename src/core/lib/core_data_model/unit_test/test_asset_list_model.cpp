@@ -0,0 +1,150 @@
+#include "pch.hpp"
+
+#include "core_data_model/asset_browser/asset_list_model.hpp"
+#include "core_data_model/asset_browser/base_asset_object_item.hpp"
+#include "core_serialization/i_file_info.hpp"
+#include "core_unit_test/unit_test.hpp"
+
+#include <string>
+#include <vector>
+
+namespace wgt
+{
+namespace
+{
+class MockFileInfo : public IFileInfo
+{
+public:
+	MockFileInfo(const std::string& fullPath) : fullPath_(fullPath), name_(fullPath)
+	{
+	}
+
+	virtual bool isDirectory() const override
+	{
+		return false;
+	}
+
+	virtual bool isReadOnly() const override
+	{
+		return false;
+	}
+
+	virtual bool isHidden() const override
+	{
+		return false;
+	}
+
+	virtual bool isDots() const override
+	{
+		return false;
+	}
+
+	virtual uint64_t size() const override
+	{
+		return 0;
+	}
+
+	virtual uint64_t created() const override
+	{
+		return 0;
+	}
+
+	virtual uint64_t modified() const override
+	{
+		return 0;
+	}
+
+	virtual uint64_t accessed() const override
+	{
+		return 0;
+	}
+
+	virtual const char* extension() const override
+	{
+		return "";
+	}
+
+	virtual const SharedString& name() const override
+	{
+		return name_;
+	}
+
+	virtual const SharedString& fullPath() const override
+	{
+		return fullPath_;
+	}
+
+	virtual const SharedString& absolutePath() const override
+	{
+		return fullPath_;
+	}
+
+	virtual const FileAttributes::FileAttribute attributes() const override
+	{
+		return FileAttributes::Normal;
+	}
+
+private:
+	SharedString fullPath_;
+	SharedString name_;
+};
+
+IAssetObjectItem* createItem(const std::string& path)
+{
+	return new BaseAssetObjectItem(std::make_shared<MockFileInfo>(path), nullptr, nullptr, nullptr);
+}
+
+std::string getPath(const AssetListModel& model, size_t index)
+{
+	return model[index].getFullPath();
+}
+}
+
+TEST(asset_list_model_batch_changes)
+{
+	AssetListModel model;
+	model.push_back(createItem("a"));
+
+	std::vector<std::pair<size_t, size_t>> inserted;
+	std::vector<std::pair<size_t, size_t>> removed;
+	auto insertedConnection = model.signalPostItemsInserted.connect(
+	[&inserted](size_t index, size_t count) { inserted.emplace_back(index, count); });
+	auto removedConnection = model.signalPostItemsRemoved.connect(
+	[&removed](size_t index, size_t count) { removed.emplace_back(index, count); });
+
+	// Appending a chunk notifies once for all of its items
+	AssetListModel::Items items;
+	items.emplace_back(createItem("b"));
+	items.emplace_back(createItem("c"));
+	items.emplace_back(createItem("d"));
+	model.append(std::move(items));
+	CHECK(items.empty());
+	CHECK_EQUAL(4, model.size());
+	CHECK_EQUAL(1, inserted.size());
+	CHECK_EQUAL(1, inserted[0].first);
+	CHECK_EQUAL(3, inserted[0].second);
+	CHECK_EQUAL("d", getPath(model, 3));
+
+	model.append(AssetListModel::Items());
+	CHECK_EQUAL(1, inserted.size());
+
+	model.removeAt(1);
+	CHECK_EQUAL(3, model.size());
+	CHECK_EQUAL(1, removed.size());
+	CHECK_EQUAL(1, removed[0].first);
+	CHECK_EQUAL("c", getPath(model, 1));
+
+	// Replacing keeps the item's position
+	model.replaceAt(1, createItem("e"));
+	CHECK_EQUAL(3, model.size());
+	CHECK_EQUAL("a", getPath(model, 0));
+	CHECK_EQUAL("e", getPath(model, 1));
+	CHECK_EQUAL("d", getPath(model, 2));
+	CHECK_EQUAL(2, removed.size());
+	CHECK_EQUAL(2, inserted.size());
+	CHECK_EQUAL(1, inserted[1].first);
+
+	insertedConnection.disconnect();
+	removedConnection.disconnect();
+}
+} // end namespace wgt
@@ -3,9 +3,55 @@
 #include "test_data_model_objects.hpp"
 #include "core_data_model/i_item_role.hpp"
 #include "core_unit_test/unit_test.hpp"
+#include "core_unit_test/test_application.hpp"
+#include "core_unit_test/test_global_context.hpp"
+
+#include <atomic>
+#include <chrono>
+#include <cstring>
+#include <string>
+#include <thread>
 
 namespace wgt
 {
+namespace
+{
+// Matches items whose display text starts with a prefix, which may change while a remap runs
+class PrefixFilter : public IItemFilter
+{
+public:
+	PrefixFilter(const char* prefix) : prefix_(prefix)
+	{
+	}
+
+	virtual bool checkFilter(const IItem* item) override
+	{
+		const char* prefix = prefix_.load();
+		return strncmp(item->getDisplayText(0), prefix, strlen(prefix)) == 0;
+	}
+
+	virtual void setRole(ItemRole::Id roleId) override
+	{
+	}
+
+	std::atomic<const char*> prefix_;
+};
+
+bool waitForFiltering(const FilteredTreeModel& model)
+{
+	auto timeout = std::chrono::steady_clock::now() + std::chrono::seconds(30);
+	while (model.isFiltering())
+	{
+		if (std::chrono::steady_clock::now() > timeout)
+		{
+			return false;
+		}
+		std::this_thread::sleep_for(std::chrono::milliseconds(1));
+	}
+	return true;
+}
+}
+
 //---------------------------------------------------------------------------
 // List Model Tests
 //---------------------------------------------------------------------------
@@ -614,4 +660,176 @@ TEST_F(TestFixture, changeTreeItem)
 		CHECK(size == oldSize);
 	}
 }
+
+TEST(filteredTreeRefreshPublishesChunks)
+{
+	UnitTestTreeModel tree;
+	for (int i = 0; i < 2000; ++i)
+	{
+		std::string name = "match" + std::to_string(i);
+		tree.insert(nullptr, name, InsertAt::BACK);
+	}
+
+	PrefixFilter filter("none");
+	FilteredTreeModel filteredTree;
+	filteredTree.setSource(&tree);
+	filteredTree.setFilter(&filter);
+	filteredTree.refresh(true);
+	CHECK(filteredTree.size(nullptr) == 0);
+
+	std::vector<size_t> insertedCounts;
+	auto connection = filteredTree.signalPostItemsInserted.connect(
+	[&insertedCounts](const IItem*, size_t, size_t count) { insertedCounts.push_back(count); });
+
+	filter.prefix_ = "match";
+	filteredTree.refresh(true);
+	connection.disconnect();
+
+	// The first matches are published on their own, the rest in growing ranges rather than one by one
+	CHECK(filteredTree.size(nullptr) == 2000);
+	CHECK(insertedCounts.size() > 1 && insertedCounts.size() < 20);
+	if (insertedCounts.size() > 1)
+	{
+		CHECK(insertedCounts[0] < insertedCounts[1]);
+	}
+	size_t inserted = 0;
+	for (auto count : insertedCounts)
+	{
+		inserted += count;
+	}
+	CHECK(inserted == 2000);
+}
+
+TEST(filteredTreeRefreshCancelsPreviousRefresh)
+{
+	UnitTestTreeModel tree;
+	for (int i = 0; i < 200; ++i)
+	{
+		std::string name = "group" + std::to_string(i);
+		auto group = tree.insert(nullptr, name, InsertAt::BACK);
+		for (int j = 0; j < 20; ++j)
+		{
+			name = "leaf" + std::to_string(j);
+			tree.insert(group, name, InsertAt::BACK);
+		}
+	}
+
+	PrefixFilter filter("leaf1");
+	FilteredTreeModel filteredTree;
+	filteredTree.setSource(&tree);
+	filteredTree.setFilter(&filter);
+	filteredTree.refresh(true);
+
+	// Map every group, so remaps walk their children as well
+	CHECK(filteredTree.size(nullptr) == 200);
+	for (size_t i = 0; i < 200; ++i)
+	{
+		CHECK(filteredTree.size(filteredTree.item(i, nullptr)) == 11);
+	}
+
+	// Each refresh cancels the remap in progress without waiting for it
+	filter.prefix_ = "group1";
+	filteredTree.refresh();
+	filter.prefix_ = "leaf";
+	filteredTree.refresh();
+	filter.prefix_ = "leaf2";
+	filteredTree.refresh();
+	CHECK(waitForFiltering(filteredTree));
+
+	FilteredTreeModel expectedTree;
+	expectedTree.setSource(&tree);
+	expectedTree.setFilter(&filter);
+	expectedTree.refresh(true);
+
+	CHECK(filteredTree.size(nullptr) == expectedTree.size(nullptr));
+	for (size_t i = 0; i < expectedTree.size(nullptr); ++i)
+	{
+		auto item = filteredTree.item(i, nullptr);
+		CHECK(item == expectedTree.item(i, nullptr));
+		CHECK(filteredTree.size(item) == 1);
+		CHECK(expectedTree.size(item) == 1);
+		CHECK(filteredTree.item(0, item) == expectedTree.item(0, item));
+	}
+}
+
+class TestFilteredTreeUpdateFixture : public TestDataModelFixture
+{
+public:
+	TestFilteredTreeUpdateFixture()
+	{
+		applicationHolder_ = registerInterface<IApplication>(&application_);
+	}
+
+	~TestFilteredTreeUpdateFixture()
+	{
+		deregisterInterface(applicationHolder_.get());
+	}
+
+	// Runs the application's update until the model is done filtering
+	bool updateUntilFiltered(const FilteredTreeModel& model)
+	{
+		auto timeout = std::chrono::steady_clock::now() + std::chrono::seconds(30);
+		while (model.isFiltering())
+		{
+			if (std::chrono::steady_clock::now() > timeout)
+			{
+				return false;
+			}
+			application_.signalUpdate();
+			std::this_thread::sleep_for(std::chrono::milliseconds(1));
+		}
+		return true;
+	}
+
+protected:
+	TestApplication application_;
+	InterfacePtr applicationHolder_;
+};
+
+TEST_F(TestFilteredTreeUpdateFixture, filteredTreeRefreshPublishesOnOwnerThread)
+{
+	UnitTestTreeModel tree;
+	for (int i = 0; i < 2000; ++i)
+	{
+		std::string name = "match" + std::to_string(i);
+		tree.insert(nullptr, name, InsertAt::BACK);
+	}
+
+	PrefixFilter filter("none");
+	FilteredTreeModel filteredTree;
+	filteredTree.setSource(&tree);
+	filteredTree.setFilter(&filter);
+	filteredTree.refresh(true);
+
+	const auto ownerThread = std::this_thread::get_id();
+	std::atomic<int> otherThreadSignals(0);
+	auto connection = filteredTree.signalPreItemsInserted.connect([&](const IItem*, size_t, size_t) {
+		if (std::this_thread::get_id() != ownerThread)
+		{
+			++otherThreadSignals;
+		}
+	});
+
+	// The remap only publishes its chunks on the application's update
+	filter.prefix_ = "match";
+	filteredTree.refresh();
+	std::this_thread::sleep_for(std::chrono::milliseconds(10));
+	CHECK(filteredTree.size(nullptr) == 0);
+
+	for (int i = 0; i < 1000 && filteredTree.size(nullptr) == 0; ++i)
+	{
+		application_.signalUpdate();
+		std::this_thread::sleep_for(std::chrono::milliseconds(1));
+	}
+	CHECK(filteredTree.size(nullptr) > 0);
+
+	// Changing the filter while the remap waits for the owner thread doesn't wait for the remap
+	filter.prefix_ = "match1";
+	filteredTree.setFilter(&filter);
+	CHECK(updateUntilFiltered(filteredTree));
+	connection.disconnect();
+
+	CHECK(otherThreadSignals == 0);
+	CHECK(filteredTree.size(nullptr) == 1111);
+}
 } // end namespace wgt
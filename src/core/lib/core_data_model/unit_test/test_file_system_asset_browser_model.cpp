@@ -0,0 +1,421 @@
+#include "pch.hpp"
+
+#include "core_data_model/asset_browser/base_asset_object_item.hpp"
+#include "core_data_model/asset_browser/file_system_asset_browser_model.hpp"
+#include "core_data_model/asset_browser/i_asset_presentation_provider.hpp"
+#include "core_data_model/i_list_model.hpp"
+#include "core_serialization/i_file_system.hpp"
+
+#include <functional>
+#include <map>
+#include <memory>
+#include <set>
+#include <string>
+#include <vector>
+
+namespace wgt
+{
+namespace
+{
+class MockFileInfo : public IFileInfo
+{
+public:
+	MockFileInfo(const std::string& fullPath, FileAttributes::FileAttribute attributes)
+	    : fullPath_(fullPath), name_(fullPath.substr(fullPath.find_last_of('/') + 1)), attributes_(attributes)
+	{
+		auto dot = fullPath.find_last_of('.');
+		extension_ = dot == std::string::npos ? "" : fullPath.substr(dot + 1);
+	}
+
+	virtual bool isDirectory() const override
+	{
+		return (attributes_ & FileAttributes::Directory) != 0;
+	}
+
+	virtual bool isReadOnly() const override
+	{
+		return false;
+	}
+
+	virtual bool isHidden() const override
+	{
+		return (attributes_ & FileAttributes::Hidden) != 0;
+	}
+
+	virtual bool isDots() const override
+	{
+		return false;
+	}
+
+	virtual uint64_t size() const override
+	{
+		return 0;
+	}
+
+	virtual uint64_t created() const override
+	{
+		return 0;
+	}
+
+	virtual uint64_t modified() const override
+	{
+		return 0;
+	}
+
+	virtual uint64_t accessed() const override
+	{
+		return 0;
+	}
+
+	virtual const char* extension() const override
+	{
+		return extension_.c_str();
+	}
+
+	virtual const SharedString& name() const override
+	{
+		return name_;
+	}
+
+	virtual const SharedString& fullPath() const override
+	{
+		return fullPath_;
+	}
+
+	virtual const SharedString& absolutePath() const override
+	{
+		return fullPath_;
+	}
+
+	virtual const FileAttributes::FileAttribute attributes() const override
+	{
+		return attributes_;
+	}
+
+private:
+	SharedString fullPath_;
+	SharedString name_;
+	std::string extension_;
+	FileAttributes::FileAttribute attributes_;
+};
+
+IFileInfoPtr fileInfo(const std::string& path)
+{
+	return std::make_shared<MockFileInfo>(path, FileAttributes::Normal);
+}
+
+IFileInfoPtr folderInfo(const std::string& path, bool hidden = false)
+{
+	return std::make_shared<MockFileInfo>(
+	path, static_cast<FileAttributes::FileAttribute>(FileAttributes::Directory | (hidden ? FileAttributes::Hidden : 0)));
+}
+
+// An in-memory folder hierarchy that reports changes when the test asks it to
+class MockFileSystem : public IFileSystem
+{
+public:
+	void addFolder(const std::string& path, bool hidden = false)
+	{
+		add(path, folderInfo(path, hidden));
+		entries_[path];
+	}
+
+	void addFile(const std::string& path)
+	{
+		add(path, fileInfo(path));
+	}
+
+	void addFiles(const std::string& folder, size_t count)
+	{
+		for (size_t i = 0; i < count; ++i)
+		{
+			addFile(folder + "/file" + std::to_string(i) + ".txt");
+		}
+	}
+
+	void notifyChanged(const std::string& path, const IFileInfoPtr& info)
+	{
+		signalPathChanged_(path.c_str(), info);
+	}
+
+	// Called before each folder is enumerated
+	std::function<void(const std::string&)> onEnumerate_;
+
+	virtual bool copy(const char* path, const char* new_path) override
+	{
+		return false;
+	}
+
+	virtual bool remove(const char* path) override
+	{
+		return false;
+	}
+
+	virtual bool exists(const char* path) const override
+	{
+		return entries_.find(path) != entries_.end();
+	}
+
+	virtual void enumerate(const char* dir, EnumerateCallback callback) const override
+	{
+		if (onEnumerate_)
+		{
+			onEnumerate_(dir);
+		}
+
+		auto it = entries_.find(dir);
+		if (it == entries_.end())
+		{
+			return;
+		}
+
+		for (auto& info : it->second)
+		{
+			if (!callback(IFileInfoPtr(info)))
+			{
+				return;
+			}
+		}
+	}
+
+	virtual FileType getFileType(const char* path) const override
+	{
+		return exists(path) ? Directory : NotFound;
+	}
+
+	virtual IFileInfoPtr getFileInfo(const char* path) const override
+	{
+		return folderInfo(path);
+	}
+
+	virtual bool move(const char* path, const char* new_path) override
+	{
+		return false;
+	}
+
+	virtual IStreamPtr readFile(const char* path, std::ios::openmode mode) const override
+	{
+		return nullptr;
+	}
+
+	virtual bool writeFile(const char* path, const void* data, size_t len, std::ios::openmode mode) override
+	{
+		return false;
+	}
+
+	virtual bool createDirectory(const char* path) override
+	{
+		return false;
+	}
+
+	virtual bool removeDirectory(const char* path) override
+	{
+		return false;
+	}
+
+	virtual bool makeWritable(const char* path) override
+	{
+		return false;
+	}
+
+	virtual void invalidateFileInfo(const char* path) override
+	{
+	}
+
+	virtual Connection listenForChanges(PathChangedCallback& callback) override
+	{
+		return signalPathChanged_.connect(callback);
+	}
+
+private:
+	void add(const std::string& path, const IFileInfoPtr& info)
+	{
+		entries_[path.substr(0, path.find_last_of('/'))].push_back(info);
+	}
+
+	std::map<std::string, std::vector<IFileInfoPtr>> entries_;
+	Signal<PathChangedSignature> signalPathChanged_;
+};
+
+class MockPresentationProvider : public IAssetPresentationProvider
+{
+public:
+	virtual ThumbnailData getThumbnail(const IAssetObjectItem* asset) override
+	{
+		return nullptr;
+	}
+
+	virtual ThumbnailData getStatusIconData(const IAssetObjectItem* asset) override
+	{
+		return nullptr;
+	}
+
+	virtual const char* getTypeIconResourceString(const IAssetObjectItem* asset) const override
+	{
+		return nullptr;
+	}
+};
+}
+
+// No background worker is registered, so enumerations and changes are applied before the calls return
+class TestFileSystemAssetBrowserModelFixture
+{
+public:
+	TestFileSystemAssetBrowserModelFixture()
+	{
+		fileSystem_.addFolder("/assets");
+		fileSystem_.addFiles("/assets", 600);
+		fileSystem_.addFolder("/assets/sub");
+		fileSystem_.addFiles("/assets/sub", 10);
+		fileSystem_.addFolder("/assets/sub/deep");
+		fileSystem_.addFiles("/assets/sub/deep", 5);
+		fileSystem_.addFolder("/assets/.hidden", true);
+		fileSystem_.addFiles("/assets/.hidden", 3);
+		fileSystem_.addFolder("/other");
+		fileSystem_.addFiles("/other", 7);
+
+		model_.reset(
+		new FileSystemAssetBrowserModel(AssetPaths(), CustomContentFilters(), fileSystem_, presentationProvider_));
+	}
+
+	// The asset browser interface is what the views use
+	IAssetBrowserModel& model() const
+	{
+		return *model_;
+	}
+
+	void navigate(const std::string& folder)
+	{
+		BaseAssetObjectItem item(folderInfo(folder), nullptr, nullptr, nullptr);
+		model().populateFolderContents(&item);
+	}
+
+	size_t contentsSize() const
+	{
+		return model().getFolderContents()->size();
+	}
+
+	std::set<std::string> contentsPaths() const
+	{
+		std::set<std::string> paths;
+		for (size_t i = 0; i < contentsSize(); ++i)
+		{
+			paths.insert(model().getFolderContentsAtIndex(static_cast<int>(i))->getFullPath());
+		}
+		return paths;
+	}
+
+	size_t countInFolder(const std::string& folder) const
+	{
+		size_t count = 0;
+		for (auto& path : contentsPaths())
+		{
+			count += path.compare(0, folder.size() + 1, folder + "/") == 0 ? 1 : 0;
+		}
+		return count;
+	}
+
+protected:
+	MockFileSystem fileSystem_;
+	MockPresentationProvider presentationProvider_;
+	std::unique_ptr<FileSystemAssetBrowserModel> model_;
+};
+
+TEST_F(TestFileSystemAssetBrowserModelFixture, file_system_asset_browser_model_chunked_enumeration)
+{
+	std::vector<size_t> inserted;
+	auto connection = model().getFolderContents()->signalPostItemsInserted.connect(
+	[&inserted](size_t index, size_t count) { inserted.push_back(count); });
+
+	navigate("/assets");
+
+	// Sub-folders are enumerated breadth first and their files share the last chunk, hidden folders are skipped
+	CHECK_EQUAL(615, contentsSize());
+	CHECK_EQUAL(3, inserted.size());
+	if (inserted.size() == 3)
+	{
+		CHECK_EQUAL(256, inserted[0]);
+		CHECK_EQUAL(256, inserted[1]);
+		CHECK_EQUAL(103, inserted[2]);
+	}
+	CHECK_EQUAL(615, contentsPaths().size());
+	CHECK_EQUAL(0, countInFolder("/assets/.hidden"));
+	CHECK_EQUAL(5, countInFolder("/assets/sub/deep"));
+
+	// Navigating to the same folder again starts over instead of adding duplicates
+	navigate("/assets");
+	CHECK_EQUAL(615, contentsSize());
+
+	connection.disconnect();
+}
+
+TEST_F(TestFileSystemAssetBrowserModelFixture, file_system_asset_browser_model_cancel_on_navigation)
+{
+	// Navigate away once the first chunks of the root folder have been published
+	fileSystem_.onEnumerate_ = [&](const std::string& folder) {
+		if (folder == "/assets/sub")
+		{
+			CHECK_EQUAL(512, contentsSize());
+			fileSystem_.onEnumerate_ = nullptr;
+			navigate("/other");
+		}
+	};
+	navigate("/assets");
+
+	// Nothing found by the cancelled enumeration is added after the navigation
+	CHECK_EQUAL(7, contentsSize());
+	CHECK_EQUAL(7, countInFolder("/other"));
+
+	// Leaving the folder tree empties the contents
+	model().populateFolderContents(nullptr);
+	CHECK_EQUAL(0, contentsSize());
+}
+
+TEST_F(TestFileSystemAssetBrowserModelFixture, file_system_asset_browser_model_apply_changes)
+{
+	navigate("/assets");
+	CHECK_EQUAL(615, contentsSize());
+
+	// New files are added, changed files keep their position
+	fileSystem_.notifyChanged("/assets/added.txt", fileInfo("/assets/added.txt"));
+	CHECK_EQUAL(616, contentsSize());
+	CHECK_EQUAL(std::string("/assets/added.txt"), model().getFolderContentsAtIndex(615)->getFullPath());
+
+	auto index = 0;
+	for (; index < static_cast<int>(contentsSize()); ++index)
+	{
+		if (std::string(model().getFolderContentsAtIndex(index)->getFullPath()) == "/assets/sub/file3.txt")
+		{
+			break;
+		}
+	}
+	fileSystem_.notifyChanged("/assets/sub/file3.txt", fileInfo("/assets/sub/file3.txt"));
+	CHECK_EQUAL(616, contentsSize());
+	CHECK_EQUAL(std::string("/assets/sub/file3.txt"), model().getFolderContentsAtIndex(index)->getFullPath());
+
+	// Changes outside the folder or in folders that weren't enumerated are ignored
+	fileSystem_.notifyChanged("/other/file100.txt", fileInfo("/other/file100.txt"));
+	fileSystem_.notifyChanged("/assets/.hidden/file100.txt", fileInfo("/assets/.hidden/file100.txt"));
+	CHECK_EQUAL(616, contentsSize());
+
+	// A new folder is enumerated along with its files
+	fileSystem_.addFolder("/assets/new");
+	fileSystem_.addFiles("/assets/new", 4);
+	fileSystem_.notifyChanged("/assets/new", folderInfo("/assets/new"));
+	CHECK_EQUAL(620, contentsSize());
+	CHECK_EQUAL(4, countInFolder("/assets/new"));
+
+	// Removing a file or a folder removes everything beneath it
+	fileSystem_.notifyChanged("/assets/added.txt", nullptr);
+	CHECK_EQUAL(619, contentsSize());
+	CHECK(contentsPaths().count("/assets/added.txt") == 0);
+
+	fileSystem_.notifyChanged("/assets/sub", nullptr);
+	CHECK_EQUAL(604, contentsSize());
+	CHECK_EQUAL(0, countInFolder("/assets/sub"));
+
+	// Once removed, the folder's later changes are ignored until it is reported again
+	fileSystem_.notifyChanged("/assets/sub/deep/file100.txt", fileInfo("/assets/sub/deep/file100.txt"));
+	CHECK_EQUAL(604, contentsSize());
+}
+} // end namespace wgt
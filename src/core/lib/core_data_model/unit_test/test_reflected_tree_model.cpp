@@ -0,0 +1,136 @@
+#include "pch.hpp"
+
+#include "test_data_model_fixture.hpp"
+#include "core_command_system/command_manager.hpp"
+#include "core_data_model/common_data_roles.hpp"
+#include "core_data_model/reflection_proto/reflected_tree_model.hpp"
+#include "core_environment_system/env_system.hpp"
+#include "core_object/managed_object.hpp"
+#include "core_reflection/property_accessor.hpp"
+#include "core_reflection/reflected_property.hpp"
+#include "core_reflection/function_property.hpp"
+#include "core_reflection/reflected_object.hpp"
+#include "core_reflection/metadata/meta_types.hpp"
+#include "core_reflection/reflection_macros.hpp"
+#include "core_reflection/utilities/reflection_auto_register.hpp"
+#include "core_reflection/utilities/reflection_function_utilities.hpp"
+#include "core_reflection_utils/commands/set_reflectedproperty_command.hpp"
+#include "core_reflection_utils/reflection_controller.hpp"
+#include "core_unit_test/test_application.hpp"
+#include "core_unit_test/test_global_context.hpp"
+
+#include "core_reflection_utils/reflection_auto_reg.mpp"
+#include "core_command_system/reflection_auto_reg.mpp"
+
+#include <vector>
+
+namespace wgt
+{
+class TestReflectedTreeObject
+{
+	DECLARE_REFLECTED
+
+public:
+	TestReflectedTreeObject() : value_(0)
+	{
+	}
+
+	int value_;
+};
+
+BEGIN_EXPOSE(TestReflectedTreeObject)
+EXPOSE("value", value_)
+END_EXPOSE()
+
+class TestReflectedTreeModelFixture : public TestDataModelFixture
+{
+public:
+	TestReflectedTreeModelFixture()
+	    : envManager_(new EnvManager())
+	    , commandManager_(new CommandManager(*envManager_))
+	    , setReflectedPropertyCmd_(new SetReflectedPropertyCommand(*getDefinitionManager()))
+	    , reflectionController_(new ReflectionController())
+	{
+		ReflectionAutoRegistration::initAutoRegistration(*getDefinitionManager());
+		commandManager_->init(application_, *getDefinitionManager());
+		commandManager_->registerCommand(setReflectedPropertyCmd_.get());
+		reflectionController_->init(*commandManager_);
+
+		applicationHolder_ = registerInterface<IApplication>(&application_);
+		commandManagerHolder_ = registerInterface<ICommandManager>(commandManager_.get());
+	}
+
+	~TestReflectedTreeModelFixture()
+	{
+		deregisterInterface(commandManagerHolder_.get());
+		deregisterInterface(applicationHolder_.get());
+
+		commandManager_->deregisterCommand(setReflectedPropertyCmd_->getId());
+		commandManager_->fini();
+
+		setReflectedPropertyCmd_.reset();
+		reflectionController_.reset();
+		commandManager_.reset();
+	}
+
+protected:
+	TestApplication application_;
+	std::unique_ptr<EnvManager> envManager_;
+	std::unique_ptr<CommandManager> commandManager_;
+	std::unique_ptr<Command> setReflectedPropertyCmd_;
+	std::unique_ptr<ReflectionController> reflectionController_;
+	InterfacePtr applicationHolder_;
+	InterfacePtr commandManagerHolder_;
+};
+
+TEST_F(TestReflectedTreeModelFixture, reflectedTreeModelReportsEditsAfterAbortedBatch)
+{
+	auto object = ManagedObject<TestReflectedTreeObject>::make();
+	auto handle = object.getHandle();
+	auto definition = getDefinitionManager()->getDefinition<TestReflectedTreeObject>();
+	PropertyAccessor value = definition->bindProperty("value", handle);
+	CHECK(value.isValid());
+
+	proto::ReflectedTreeModel model(handle);
+
+	// Only mapped properties are signalled
+	CHECK_EQUAL(1, model.rowCount(nullptr));
+	auto item = model.item(AbstractTreeModel::ItemIndex(0, nullptr));
+	CHECK(item != nullptr);
+	model.rowCount(item);
+
+	std::vector<int> reportedValues;
+	auto dataChanged = model.connectPostItemDataChanged(
+	[&reportedValues](const AbstractTreeModel::ItemIndex&, int, ItemRole::Id roleId, const Variant& data) {
+		int reportedValue = 0;
+		if (roleId == ValueRole::roleId_ && data.tryCast(reportedValue))
+		{
+			reportedValues.push_back(reportedValue);
+		}
+	});
+
+	// Changes made by the batch are undone when it is aborted
+	auto& commandManager = *commandManager_;
+	commandManager.beginBatchCommand();
+	reflectionController_->setValue(value, 1);
+	commandManager.abortBatchCommand();
+	int currentValue = -1;
+	CHECK(reflectionController_->getValue(value).tryCast(currentValue));
+	CHECK_EQUAL(0, currentValue);
+	application_.signalUpdate();
+	CHECK(reportedValues.empty() || reportedValues.back() == 0);
+
+	// An edit after the aborted batch is reported straight away, rather than being held for a batch that has ended
+	const size_t reportedCount = reportedValues.size();
+	reflectionController_->setValue(value, 2);
+	CHECK(reflectionController_->getValue(value).tryCast(currentValue));
+	CHECK_EQUAL(2, currentValue);
+	CHECK_EQUAL(reportedCount + 1, reportedValues.size());
+	if (!reportedValues.empty())
+	{
+		CHECK_EQUAL(2, reportedValues.back());
+	}
+
+	dataChanged.disconnect();
+}
+} // end namespace wgt
@@ -0,0 +1,155 @@
+#include "pch.hpp"
+
+#include "core_data_model/variant_list.hpp"
+#include "core_data_model/filtering/string_filter.hpp"
+#include "core_data_model/filtering/string_filter_index.hpp"
+#include "core_data_model/filtering/tokenized_string_filter.hpp"
+#include "testing/data_model_test/test_data.hpp"
+
+#include <algorithm>
+#include <string>
+#include <vector>
+
+namespace wgt
+{
+namespace
+{
+std::vector<std::string> dictionary(bool isShort)
+{
+	// next() wraps around to the first word after the last one
+	StringList list(isShort);
+	std::vector<std::string> words;
+	do
+	{
+		std::string word = list.next();
+		if (!word.empty())
+		{
+			words.push_back(word);
+		}
+	} while (list.position != 0);
+	return words;
+}
+
+// Items of the list the filter accepts
+std::vector<const IItem*> filterItems(const VariantList& list, IItemFilter& filter)
+{
+	std::vector<const IItem*> items;
+	for (size_t i = 0; i < list.size(); ++i)
+	{
+		if (filter.checkFilter(list.item(i)))
+		{
+			items.push_back(list.item(i));
+		}
+	}
+	return items;
+}
+}
+
+TEST(stringFilterIndexMatchesSearch)
+{
+	VariantList list;
+	for (auto& word : dictionary(true /* isShort */))
+	{
+		list.push_back(word);
+	}
+
+	StringFilterIndex index;
+	index.setRole(ValueRole::roleId_);
+	index.setSource(&list);
+	CHECK_EQUAL(list.size(), index.size());
+
+	TokenizedStringFilter filter;
+	filter.setRole(ValueRole::roleId_);
+	TokenizedStringFilter indexedFilter;
+	indexedFilter.setRole(ValueRole::roleId_);
+	indexedFilter.setIndex(&index);
+
+	const char* queries[] = { "a", "ab", "ABS", "tion", "ion abs", "ab ly", "zzz", "ac ce ss" };
+	for (auto query : queries)
+	{
+		filter.updateFilterTokens(query);
+		indexedFilter.updateFilterTokens(query);
+		CHECK(filterItems(list, filter) == filterItems(list, indexedFilter));
+	}
+
+	// Inserted, changed and removed items update the cached query
+	indexedFilter.updateFilterTokens("absolute");
+	filter.updateFilterTokens("absolute");
+	const size_t absoluteCount = filterItems(list, indexedFilter).size();
+	list.push_back(std::string("NotAbsolutely"));
+	list.push_front(std::string("absolutely_first"));
+	CHECK_EQUAL(absoluteCount + 2, filterItems(list, indexedFilter).size());
+
+	IItem* item = list.item(list.size() - 1);
+	list.signalPreItemDataChanged(item, 0, ValueRole::roleId_, std::string("relative"));
+	item->setData(0, ValueRole::roleId_, std::string("relative"));
+	list.signalPostItemDataChanged(item, 0, ValueRole::roleId_, std::string("relative"));
+	CHECK_EQUAL(absoluteCount + 1, filterItems(list, indexedFilter).size());
+
+	list.erase(list.begin());
+	CHECK_EQUAL(absoluteCount, filterItems(list, indexedFilter).size());
+	CHECK(filterItems(list, filter) == filterItems(list, indexedFilter));
+	CHECK_EQUAL(list.size(), index.size());
+
+	std::vector<const IItem*> found;
+	index.find(std::vector<std::string>(1, "relative"), found);
+	CHECK(found.size() == 1 && found.front() == item);
+
+	// Items the index doesn't know are searched
+	StringFilter stringFilter;
+	stringFilter.setRole(ValueRole::roleId_);
+	stringFilter.setIndex(&index);
+	stringFilter.setFilterText("Relative");
+	index.removeItem(item);
+	CHECK(stringFilter.checkFilter(item));
+	CHECK(filterItems(list, stringFilter).size() == 1);
+
+	index.setSource(static_cast<IListModel*>(nullptr));
+	CHECK_EQUAL(0, index.size());
+}
+
+TEST(stringFilterIndexPrefixes)
+{
+	// The dictionary repeated a few times, each copy with its own suffix
+	const size_t copies = 3;
+	const std::vector<std::string> words = dictionary(true /* isShort */);
+	const size_t rowCount = words.size() * copies;
+
+	VariantList list;
+	list.resize(rowCount);
+	for (size_t i = 0; i < rowCount; ++i)
+	{
+		list.item(i)->setData(0, ValueRole::roleId_,
+		                      words[i % words.size()] + "_" + std::to_string(i / words.size()));
+	}
+
+	StringFilterIndex index;
+	index.setRole(ValueRole::roleId_);
+	index.setSource(&list);
+	CHECK_EQUAL(rowCount, index.size());
+
+	TokenizedStringFilter filter;
+	filter.setRole(ValueRole::roleId_);
+	TokenizedStringFilter indexedFilter;
+	indexedFilter.setRole(ValueRole::roleId_);
+	indexedFilter.setIndex(&index);
+
+	// Each prefix of the text, as typing it into a search box filters for it
+	const std::string text = words[words.size() / 2] + "_1";
+	std::vector<const IItem*> found;
+	for (size_t length = 1; length <= text.length(); ++length)
+	{
+		const std::string prefix = text.substr(0, length);
+		filter.updateFilterTokens(prefix.c_str());
+		indexedFilter.updateFilterTokens(prefix.c_str());
+		std::vector<const IItem*> expected = filterItems(list, filter);
+		CHECK(expected == filterItems(list, indexedFilter));
+
+		index.find(std::vector<std::string>(1, prefix), found);
+		std::sort(expected.begin(), expected.end());
+		std::sort(found.begin(), found.end());
+		CHECK(expected == found);
+	}
+	CHECK(!filterItems(list, filter).empty());
+}
+} // end namespace wgt
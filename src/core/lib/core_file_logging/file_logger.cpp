@@ -292,6 +292,22 @@ void FileLogger::out(ILogMessage* message)
 	}
 }
 
+void FileLogger::outBatch(ILogMessage* const* messages, size_t count)
+{
+	// Write the queue to file once for the whole batch rather than as it fills
+	batching_ = true;
+	for (size_t i = 0; i < count; ++i)
+	{
+		out(messages[i]);
+	}
+	batching_ = false;
+
+	if (queueSize_ >= utils::MaxQueue)
+	{
+		logQueueToFile();
+	}
+}
+
 void FileLogger::log(LogLevel level, const char* message)
 {
 	if(shutdown_)
@@ -300,7 +316,7 @@ void FileLogger::log(LogLevel level, const char* message)
 	}
 	else if(loggingSystem_)
 	{
-		loggingSystem_->log(level, message);
+		loggingSystem_->log(level, "%s", message);
 	}
 	else
 	{
@@ -333,7 +349,7 @@ void FileLogger::logToQueue(LogLevel level, const std::string& message)
 				logQueueToFile();
 				flushFile();
 			}
-			else if (queueSize_ >= utils::MaxQueue)
+			else if (queueSize_ >= utils::MaxQueue && !batching_)
 			{
 				logQueueToFile();
 			}
@@ -34,6 +34,7 @@ public:
 private:
 	void createFile(int id = 0);
 	void out(ILogMessage* message) override;
+	void outBatch(ILogMessage* const* messages, size_t count) override;
 	void logToQueue(LogLevel level, const std::string& message);
 	void logQueueToFile();
 	void logToFile(const char* message);
@@ -63,6 +64,7 @@ private:
 	std::string lastMessage_;
 	size_t queueSize_ = 0;
 	unsigned int duplicateCount_ = 0;
+	bool batching_ = false;
 	
 	bool registered_ = false;
 	bool enabled_ = false;
@@ -160,7 +160,7 @@ public:
 	template <class T>
 	T* queryInterface()
 	{
-		return reinterpret_cast<T*>(queryInterface(typeid(T).name()));
+		return reinterpret_cast<T*>(queryInterface(TypeId::getType<T>()));
 	}
 
 	virtual void queryInterface(const TypeId&, std::vector<void*>& o_Impls) = 0;
@@ -168,7 +168,7 @@ public:
 	template <class T>
 	void queryInterface(std::vector<T*>& o_Impls)
 	{
-		queryInterface(typeid(T).name(), reinterpret_cast<std::vector<void*>&>(o_Impls));
+		queryInterface(TypeId::getType<T>(), reinterpret_cast<std::vector<void*>&>(o_Impls));
 	}
 
 	typedef ConnectionHolderT<IComponentContextListener> ConnectionHolder;
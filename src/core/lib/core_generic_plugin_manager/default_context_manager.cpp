@@ -1,6 +1,8 @@
 #include "default_context_manager.hpp"
 
 #include "core_common/assert.hpp"
+#include "core_common/scoped_stop_watch.hpp"
+#include "core_common/thread_local_value.hpp"
 #include "core_generic_plugin/interfaces/i_component_context_creator.hpp"
 #include "core_dependency_system/i_interface.hpp"
 #include <unordered_map>
@@ -16,8 +18,130 @@ static const TypeId getComponentContextCreatorTypeId()
 	static const TypeId s_ComponentContextCreatorTypeId = TypeId::getType<IComponentContextCreator>();
 	return s_ComponentContextCreatorTypeId;
 }
+
+// Changes whenever an interface is registered or deregistered in any context. Contexts query their parents, so a
+// change anywhere invalidates the query caches of every context.
+std::atomic<uint64_t> s_RegistryGeneration(1);
+
+void onRegistryChanged()
+{
+	s_RegistryGeneration.fetch_add(1);
 }
 
+// The query cache a thread is reading, published so that it isn't freed under the thread. There is one for each
+// thread that has queried an interface, and they are never freed so that they can be scanned without a lock.
+struct QueryHazard
+{
+	std::atomic<const void*> table_;
+	QueryHazard* next_;
+};
+
+std::atomic<QueryHazard*> s_QueryHazards(nullptr);
+THREAD_LOCAL(QueryHazard*) s_QueryHazard;
+
+QueryHazard& getQueryHazard()
+{
+	QueryHazard* hazard = THREAD_LOCAL_GET(s_QueryHazard);
+	if (hazard == nullptr)
+	{
+		hazard = new QueryHazard();
+		hazard->table_.store(nullptr);
+		hazard->next_ = s_QueryHazards.load();
+		while (!s_QueryHazards.compare_exchange_weak(hazard->next_, hazard))
+		{
+		}
+		THREAD_LOCAL_SET(s_QueryHazard, hazard);
+	}
+	return *hazard;
+}
+
+bool isQueryHazard(const void* table)
+{
+	for (auto hazard = s_QueryHazards.load(); hazard != nullptr; hazard = hazard->next_)
+	{
+		if (hazard->table_.load() == table)
+		{
+			return true;
+		}
+	}
+	return false;
+}
+}
+
+//==============================================================================
+// Open addressed table from TypeId hashes to the result of queryInterface, including null results.
+// Entries are only ever added, a key is published after its value so readers can probe it without a lock.
+struct DefaultComponentContext::QueryCache
+{
+	struct Entry
+	{
+		std::atomic<uint64_t> key_;
+		std::atomic<void*> value_;
+	};
+
+	QueryCache(uint64_t generation, size_t capacity)
+	    : generation_(generation), mask_(capacity - 1), size_(0), entries_(new Entry[capacity])
+	{
+		for (size_t i = 0; i < capacity; ++i)
+		{
+			entries_[i].key_.store(0, std::memory_order_relaxed);
+			entries_[i].value_.store(nullptr, std::memory_order_relaxed);
+		}
+	}
+
+	bool find(uint64_t key, void*& o_Value) const
+	{
+		for (size_t i = static_cast<size_t>(key) & mask_;; i = (i + 1) & mask_)
+		{
+			const uint64_t entryKey = entries_[i].key_.load(std::memory_order_acquire);
+			if (entryKey == key)
+			{
+				o_Value = entries_[i].value_.load(std::memory_order_relaxed);
+				return true;
+			}
+			if (entryKey == 0)
+			{
+				return false;
+			}
+		}
+	}
+
+	// Only called while holding queryCacheMutex_, and while the table is less than half full
+	void insert(uint64_t key, void* value)
+	{
+		for (size_t i = static_cast<size_t>(key) & mask_;; i = (i + 1) & mask_)
+		{
+			const uint64_t entryKey = entries_[i].key_.load(std::memory_order_relaxed);
+			if (entryKey == key)
+			{
+				return;
+			}
+			if (entryKey == 0)
+			{
+				entries_[i].value_.store(value, std::memory_order_relaxed);
+				entries_[i].key_.store(key, std::memory_order_release);
+				++size_;
+				return;
+			}
+		}
+	}
+
+	bool isFull() const
+	{
+		return (size_ + 1) * 2 > mask_ + 1;
+	}
+
+	size_t capacity() const
+	{
+		return mask_ + 1;
+	}
+
+	const uint64_t generation_;
+	const size_t mask_;
+	size_t size_;
+	std::unique_ptr<Entry[]> entries_;
+};
+
 class RTTIHelper
 {
 public:
@@ -60,7 +184,8 @@ private:
 DefaultComponentContext::DefaultComponentContext(const std::wstring& name, IComponentContext* parentContext)
     : name_(name), parentContext_(parentContext),
       disconnectSig_(std::make_shared<std::function<void(IComponentContextListener&)>>(
-      [this](IComponentContextListener& listener) { deregisterListener(listener); }))
+      [this](IComponentContextListener& listener) { deregisterListener(listener); })),
+      queryCache_(nullptr), hasRetiredQueryCaches_(false)
 {
 }
 
@@ -82,6 +207,8 @@ DefaultComponentContext::~DefaultComponentContext()
 		}
 		interfaces_.clear();
 	}
+	onRegistryChanged();
+	delete queryCache_.exchange(nullptr);
 
 	if (parentContext_ == nullptr)
 	{
@@ -108,6 +235,7 @@ DefaultComponentContext::~DefaultComponentContext()
 InterfacePtr DefaultComponentContext::registerInterfaceImpl(const TypeId& id, InterfacePtr pImpl,
                                                            ContextRegState regState)
 {
+	TRACE_ZONE(id.getName(), "context");
 	std::shared_ptr<RTTIHelper> rttiHelper;
 	{
 		wg_write_lock_guard writeGuard(lock_);
@@ -122,6 +250,7 @@ InterfacePtr DefaultComponentContext::registerInterfaceImpl(const TypeId& id, In
 		wg_write_lock_guard writeGuard(lock_);
 		rttiHelper = interfaces_.insert(std::make_pair(id, std::make_shared<RTTIHelper>(pImpl)))->second;
 	}
+	onRegistryChanged();
 
 	auto contextCreator =
 	static_cast<IComponentContextCreator*>(pImpl->queryInterface(getComponentContextCreatorTypeId()));
@@ -252,6 +381,7 @@ bool DefaultComponentContext::deregisterInterface(IInterface* pImpl)
 		if(it !=  interfaces_.end())
 		{
 			interfaces_.erase(it);
+			onRegistryChanged();
 		}
 		auto iter = std::find_if(registeredInterfaces_.begin(), registeredInterfaces_.end(), [&](const InterfacePtr& i)
 		{
@@ -285,6 +415,106 @@ bool DefaultComponentContext::deregisterInterface(IInterface* pImpl)
 
 //==============================================================================
 void* DefaultComponentContext::queryInterface(const TypeId& name)
+{
+	const uint64_t key = name.getHashcode();
+	if (key == 0)
+	{
+		return findInterface(name);
+	}
+
+	// The generation must be read before searching, so a result found while the registry changes isn't cached
+	const uint64_t generation = s_RegistryGeneration.load();
+	void* found = nullptr;
+	bool cached = false;
+
+	// The table is published before it is read, and only read if it is still current afterwards, so a swap either
+	// sees it when reclaiming or has already replaced it
+	QueryHazard& hazard = getQueryHazard();
+	const QueryCache* cache = queryCache_.load();
+	for (;;)
+	{
+		hazard.table_.store(cache);
+		const QueryCache* current = queryCache_.load();
+		if (current == cache)
+		{
+			break;
+		}
+		cache = current;
+	}
+	if (cache != nullptr && cache->generation_ == generation)
+	{
+		cached = cache->find(key, found);
+	}
+	hazard.table_.store(nullptr, std::memory_order_release);
+
+	// Tables still being read when they were retired are freed by a later lookup
+	if (hasRetiredQueryCaches_.load(std::memory_order_relaxed))
+	{
+		std::unique_lock<std::mutex> guard(queryCacheMutex_, std::try_to_lock);
+		if (guard.owns_lock())
+		{
+			reclaimQueryCaches();
+		}
+	}
+	if (cached)
+	{
+		return found;
+	}
+
+	found = findInterface(name);
+	cacheInterface(name, found, generation);
+	return found;
+}
+
+//==============================================================================
+void DefaultComponentContext::cacheInterface(const TypeId& name, void* found, uint64_t generation)
+{
+	std::lock_guard<std::mutex> guard(queryCacheMutex_);
+	if (s_RegistryGeneration.load() != generation)
+	{
+		return;
+	}
+
+	QueryCache* cache = queryCache_.load();
+	if (cache == nullptr || cache->generation_ != generation || cache->isFull())
+	{
+		const bool grow = cache != nullptr && cache->generation_ == generation;
+		auto newCache = new QueryCache(generation, grow ? cache->capacity() * 2 : 16);
+		if (grow)
+		{
+			for (size_t i = 0; i < cache->capacity(); ++i)
+			{
+				const uint64_t key = cache->entries_[i].key_.load(std::memory_order_relaxed);
+				if (key != 0)
+				{
+					newCache->insert(key, cache->entries_[i].value_.load(std::memory_order_relaxed));
+				}
+			}
+		}
+		queryCache_.store(newCache);
+		if (cache != nullptr)
+		{
+			retiredQueryCaches_.emplace_back(cache);
+		}
+		cache = newCache;
+		reclaimQueryCaches();
+	}
+	cache->insert(name.getHashcode(), found);
+}
+
+//==============================================================================
+void DefaultComponentContext::reclaimQueryCaches()
+{
+	// Only called while holding queryCacheMutex_. Readers that start from now on only see the current table, so
+	// retired tables that no thread has published can go.
+	auto isUnused = [](const std::unique_ptr<QueryCache>& cache) { return !isQueryHazard(cache.get()); };
+	auto retiredEnd = std::remove_if(retiredQueryCaches_.begin(), retiredQueryCaches_.end(), isUnused);
+	retiredQueryCaches_.erase(retiredEnd, retiredQueryCaches_.end());
+	hasRetiredQueryCaches_.store(!retiredQueryCaches_.empty(), std::memory_order_relaxed);
+}
+
+//==============================================================================
+void* DefaultComponentContext::findInterface(const TypeId& name)
 {
 	wg_read_lock_guard readGuard(lock_);
 	for (auto& interfaceIt : interfaces_)
@@ -5,9 +5,12 @@
 #include "core_generic_plugin/interfaces/i_component_context.hpp"
 #include "core_variant/type_id.hpp"
 
+#include <atomic>
 #include <set>
 #include <map>
 #include <memory>
+#include <mutex>
+#include <vector>
 
 namespace wgt
 {
@@ -30,6 +33,12 @@ public:
 	ConnectionHolder registerListener(IComponentContextListener& listener) override;
 
 private:
+	struct QueryCache;
+
+	void* findInterface(const TypeId& name);
+	void cacheInterface(const TypeId& name, void* found, uint64_t generation);
+	void reclaimQueryCaches();
+
 	virtual void onInterfaceRegistered(InterfaceCaster&) override;
 	virtual void onInterfaceDeregistered(InterfaceCaster&) override;
 	void deregisterListener(IComponentContextListener& listener);
@@ -47,6 +56,12 @@ private:
 	ComponentContextListeners listeners_;
 	std::wstring name_;
 	std::shared_ptr<std::function<void(IComponentContextListener&)>> disconnectSig_;
+
+	// Results of queryInterface, valid until an interface is registered or deregistered in any context
+	std::atomic<QueryCache*> queryCache_;
+	std::mutex queryCacheMutex_;
+	std::vector<std::unique_ptr<QueryCache>> retiredQueryCaches_;
+	std::atomic<bool> hasRetiredQueryCaches_;
 };
 } // end namespace wgt
 #endif
@@ -11,8 +11,11 @@
 #include "core_generic_plugin/interfaces/i_memory_allocator.hpp"
 #include "notify_plugin.hpp"
 #include "plugin_context_manager.hpp"
+#include "plugin_file_prefetcher.hpp"
 
 #include "core_common/assert.hpp"
+#include "core_common/scoped_stop_watch.hpp"
+#include "core_common/trace_profiler.hpp"
 #include "core_common/platform_dbg.hpp"
 #include "core_common/platform_env.hpp"
 #include "core_common/platform_dll.hpp"
@@ -20,8 +23,10 @@
 #include "common_include/i_static_initializer.hpp"
 
 #include "core_logging/logging.hpp"
+#include "core_string_utils/string_utils.hpp"
 
 #include <algorithm>
+#include <chrono>
 #include <iterator>
 #include <cstdint>
 
@@ -31,6 +36,25 @@
 
 namespace wgt
 {
+namespace
+{
+const char* s_LoadStepNames[GenericPluginManager::LoadStepCount] = { "Load library", "Create", "Post load",
+                                                                     "Initialise" };
+
+// Adds the plugin's step to the trace, and returns the time it took in seconds
+double recordLoadStep(const std::wstring& pluginName, GenericPluginManager::LoadStep step,
+                      const TraceProfiler::Clock::time_point& start)
+{
+	const auto end = TraceProfiler::Clock::now();
+	auto& profiler = TraceProfiler::instance();
+	if (profiler.isEnabled())
+	{
+		const std::string name = StringUtils::to_string(pluginName) + " " + s_LoadStepNames[step];
+		profiler.addZone(name.c_str(), "plugin", start, end);
+	}
+	return std::chrono::duration<double>(end - start).count();
+}
+}
 
 //==============================================================================
 class PluginStaticInitializerContextCreator : public Implements<IComponentContextCreator>
@@ -54,6 +78,9 @@ GenericPluginManager::GenericPluginManager(bool applyDebugPostfix,
 	, applyDebugPostfix_(applyDebugPostfix)
 	, applyHybridPostfix_(applyHybridPostfix)
 {
+	// Create the profiler before any plugins use it, so it outlives them
+	TraceProfiler::instance();
+
 	contextManager_->getGlobalContext()->registerInterface(new PluginStaticInitializer);
 	contextManager_->getGlobalContext()->registerInterface(new PluginStaticInitializerContextCreator);
 }
@@ -86,13 +113,27 @@ void GenericPluginManager::unloadPlugins(const PluginNameList& pluginNames)
 //==============================================================================
 void GenericPluginManager::runLoadStep(const PluginNameList& pluginNames)
 {
+	TRACE_ZONE("Load plugins", "plugin");
 	PluginList plgs;
-	std::transform(std::begin(pluginNames), std::end(pluginNames), std::back_inserter(plgs),
-	               std::bind(&GenericPluginManager::loadPlugin, this, std::placeholders::_1));
+	{
+		PluginNameList filenames;
+		std::transform(std::begin(pluginNames), std::end(pluginNames), std::back_inserter(filenames),
+		               std::bind(&GenericPluginManager::processPluginFilename, this, std::placeholders::_1));
+		PluginFilePrefetcher prefetcher(std::move(filenames));
+
+		for (const auto& name : pluginNames)
+		{
+			auto start = TraceProfiler::Clock::now();
+			plgs.push_back(loadPlugin(name));
+			LoadStepTimes& times = pluginTimings_[name];
+			times.fill(0.0);
+			times[LoadLibraryStep] = recordLoadStep(name, LoadLibraryStep, start);
+		}
+	}
 
-	notifyPlugins(plgs, NotifyPlugin(*this, GenericPluginLoadState::Create));
+	notifyPlugins(pluginNames, plgs, NotifyPlugin(*this, GenericPluginLoadState::Create), CreateStep);
 
-	notifyPlugins(plgs, NotifyPluginPostLoad(*this));
+	notifyPlugins(pluginNames, plgs, NotifyPluginPostLoad(*this), PostLoadStep);
 
 	for (const auto& name : pluginNames)
 	{
@@ -103,8 +144,9 @@ void GenericPluginManager::runLoadStep(const PluginNameList& pluginNames)
 //==============================================================================
 void GenericPluginManager::runInitiliseStep(const PluginNameList& pluginNames)
 {
+	TRACE_ZONE("Initialise plugins", "plugin");
 	PluginList plgs = generateList(pluginNames, false);
-	notifyPlugins(plgs, NotifyPlugin(*this, GenericPluginLoadState::Initialise));
+	notifyPlugins(pluginNames, plgs, NotifyPlugin(*this, GenericPluginLoadState::Initialise), InitialiseStep);
 
 	for (const auto& name : pluginNames)
 	{
@@ -113,6 +155,8 @@ void GenericPluginManager::runInitiliseStep(const PluginNameList& pluginNames)
 		pluginStates_[name] = Initialise;
 		pluginLoadOrder_.push_back(name);
 	}
+
+	logPluginTimings(pluginNames);
 }
 //==============================================================================
 void GenericPluginManager::unloadPlugins(const PluginList& plugins)
@@ -229,6 +273,7 @@ void GenericPluginManager::runDestroyStep(const PluginNameList& pluginNames, boo
 		TF_ASSERT(pluginStates_.find(name) != pluginStates_.end() && pluginStates_[name] == Unload);
 		plugins_.erase(name);
 		pluginStates_.erase(name);
+		pluginTimings_.erase(name);
 	}
 
 	memoryContext_.clear();
@@ -240,6 +285,65 @@ void GenericPluginManager::notifyPlugins(const PluginList& plugins, NotifyFuncti
 	std::for_each(std::begin(plugins), std::end(plugins), func);
 }
 
+//==============================================================================
+void GenericPluginManager::notifyPlugins(const PluginNameList& pluginNames, const PluginList& plugins,
+                                         NotifyFunction func, LoadStep step)
+{
+	TF_ASSERT(pluginNames.size() == plugins.size());
+	for (size_t i = 0; i < plugins.size(); ++i)
+	{
+		auto start = TraceProfiler::Clock::now();
+		func(plugins[i]);
+		pluginTimings_[pluginNames[i]][step] += recordLoadStep(pluginNames[i], step, start);
+	}
+}
+
+//==============================================================================
+void GenericPluginManager::logPluginTimings(const PluginNameList& pluginNames) const
+{
+	LoadStepTimes totals = {};
+	std::vector<std::pair<double, const std::wstring*>> pluginTotals;
+	for (const auto& name : pluginNames)
+	{
+		auto it = pluginTimings_.find(name);
+		if (it == pluginTimings_.end())
+		{
+			continue;
+		}
+
+		double pluginTotal = 0.0;
+		for (int step = 0; step < LoadStepCount; ++step)
+		{
+			totals[step] += it->second[step];
+			pluginTotal += it->second[step];
+		}
+		pluginTotals.emplace_back(pluginTotal, &it->first);
+	}
+
+	double total = 0.0;
+	for (double stepTime : totals)
+	{
+		total += stepTime;
+	}
+
+	NGT_DEBUG_MSG("Loaded %d plugins in %.1f ms (load library %.1f ms, create %.1f ms, post load %.1f ms, "
+	              "initialise %.1f ms)\n",
+	              static_cast<int>(pluginTotals.size()), total * 1000.0, totals[LoadLibraryStep] * 1000.0,
+	              totals[CreateStep] * 1000.0, totals[PostLoadStep] * 1000.0, totals[InitialiseStep] * 1000.0);
+
+	// Slowest first
+	std::stable_sort(pluginTotals.begin(), pluginTotals.end(),
+	                 [](const std::pair<double, const std::wstring*>& a,
+	                    const std::pair<double, const std::wstring*>& b) { return a.first > b.first; });
+	for (const auto& pluginTotal : pluginTotals)
+	{
+		const LoadStepTimes& times = pluginTimings_.find(*pluginTotal.second)->second;
+		NGT_DEBUG_MSG("    %8.1f ms %S (load library %.1f, create %.1f, post load %.1f, initialise %.1f)\n",
+		              pluginTotal.first * 1000.0, pluginTotal.second->c_str(), times[LoadLibraryStep] * 1000.0,
+		              times[CreateStep] * 1000.0, times[PostLoadStep] * 1000.0, times[InitialiseStep] * 1000.0);
+	}
+}
+
 //==============================================================================
 HMODULE GenericPluginManager::loadPlugin(const std::wstring& filename)
 {
@@ -335,6 +439,12 @@ IPluginContextManager& GenericPluginManager::getContextManager() const
 	return *contextManager_.get();
 }
 
+//==============================================================================
+const GenericPluginManager::PluginTimingMap& GenericPluginManager::getPluginTimings() const
+{
+	return pluginTimings_;
+}
+
 //==============================================================================
 void* GenericPluginManager::queryInterface(const char* name) const
 {
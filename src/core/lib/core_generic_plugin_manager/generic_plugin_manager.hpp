@@ -5,6 +5,7 @@
 #include "core_generic_plugin/interfaces/i_memory_allocator.hpp"
 #include "core_generic_plugin/interfaces/i_component_context.hpp"
 #include "core_generic_plugin/generic_plugin.hpp"
+#include <array>
 #include <vector>
 #include <map>
 #include <unordered_map>
@@ -23,6 +24,18 @@ public:
 	typedef std::vector<std::wstring> PluginNameList;
 	typedef std::unordered_map<std::wstring, GenericPluginLoadState> PluginStateMap;
 
+	enum LoadStep
+	{
+		LoadLibraryStep,
+		CreateStep,
+		PostLoadStep,
+		InitialiseStep,
+		LoadStepCount
+	};
+	// Seconds each plugin spent in each load step, by the plugin names passed to runLoadStep
+	typedef std::array<double, LoadStepCount> LoadStepTimes;
+	typedef std::unordered_map<std::wstring, LoadStepTimes> PluginTimingMap;
+
 	GenericPluginManager(bool applyDebugPostfix = true,
 		bool applyHybridPostfix = true);
 	virtual ~GenericPluginManager();
@@ -39,6 +52,7 @@ public:
 	void runDestroyStep(const PluginNameList& plugins, bool destroyGlobal = false);
 
 	IPluginContextManager& getContextManager() const;
+	const PluginTimingMap& getPluginTimings() const;
 
 	template <class T>
 	T* queryInterface()
@@ -53,6 +67,9 @@ private:
 
 	typedef std::function<bool(HMODULE)> NotifyFunction;
 	void notifyPlugins(const PluginList& plugins, NotifyFunction func);
+	void notifyPlugins(const PluginNameList& pluginNames, const PluginList& plugins, NotifyFunction func,
+	                   LoadStep step);
+	void logPluginTimings(const PluginNameList& pluginNames) const;
 
 	HMODULE loadPlugin(const std::wstring& filename);
 	bool unloadPlugin(HMODULE hPlugin);
@@ -66,6 +83,7 @@ private:
 	PluginMap plugins_;
 	PluginNameList pluginLoadOrder_;
 	PluginStateMap pluginStates_;
+	PluginTimingMap pluginTimings_;
 
 	std::map<std::wstring, IMemoryAllocator*> memoryContext_;
 	std::unique_ptr<IPluginContextManager> contextManager_;
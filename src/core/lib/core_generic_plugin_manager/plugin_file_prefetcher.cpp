@@ -0,0 +1,81 @@
+#include "plugin_file_prefetcher.hpp"
+
+#include <algorithm>
+#include <fstream>
+
+#ifndef _WIN32
+#include <codecvt>
+#include <locale>
+#endif // _WIN32
+
+namespace wgt
+{
+namespace
+{
+// Plugins are read from one disk, more threads than this only compete for it
+const size_t MAX_PREFETCH_THREADS = 4;
+const size_t PREFETCH_BLOCK_SIZE = 256 * 1024;
+}
+
+//==============================================================================
+PluginFilePrefetcher::PluginFilePrefetcher(std::vector<std::wstring> filenames)
+    : filenames_(std::move(filenames)), next_(0), stop_(false)
+{
+	// The first plugin is loaded straight away, so leave it to the loader
+	if (filenames_.size() < 2)
+	{
+		return;
+	}
+
+	next_ = 1;
+	const size_t threadCount = std::min(
+	std::min(MAX_PREFETCH_THREADS, static_cast<size_t>(std::max(std::thread::hardware_concurrency(), 1u))),
+	filenames_.size() - 1);
+	for (size_t i = 0; i < threadCount; ++i)
+	{
+		threads_.emplace_back(&PluginFilePrefetcher::run, this);
+	}
+}
+
+//==============================================================================
+PluginFilePrefetcher::~PluginFilePrefetcher()
+{
+	stop_ = true;
+	for (auto& thread : threads_)
+	{
+		thread.join();
+	}
+}
+
+//==============================================================================
+void PluginFilePrefetcher::run()
+{
+	std::vector<char> buffer(PREFETCH_BLOCK_SIZE);
+	while (!stop_)
+	{
+		const size_t index = next_++;
+		if (index >= filenames_.size())
+		{
+			return;
+		}
+
+		prefetch(filenames_[index], buffer);
+	}
+}
+
+//==============================================================================
+void PluginFilePrefetcher::prefetch(const std::wstring& filename, std::vector<char>& buffer)
+{
+#ifdef _WIN32
+	std::ifstream file(filename.c_str(), std::ios::binary);
+#else
+	std::wstring_convert<std::codecvt_utf8<wchar_t>> conv;
+	std::ifstream file(conv.to_bytes(filename).c_str(), std::ios::binary);
+#endif // _WIN32
+
+	// Missing plugins are reported by the loader
+	while (!stop_ && file.read(buffer.data(), buffer.size()))
+	{
+	}
+}
+} // end namespace wgt
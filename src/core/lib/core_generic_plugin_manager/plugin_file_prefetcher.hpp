@@ -0,0 +1,33 @@
+#ifndef PLUGIN_FILE_PREFETCHER_HPP
+#define PLUGIN_FILE_PREFETCHER_HPP
+
+#include <atomic>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace wgt
+{
+/**
+* Reads plugin binaries on worker threads, in the order they will be loaded, so the files are in the OS file cache
+* by the time the loader reaches them. Plugins have to be loaded one at a time, as the loader and the plugins' static
+* initialisation are not thread safe, but on a cold start most of that time is spent waiting on the disk.
+* Reading stops when the prefetcher is destroyed.
+*/
+class PluginFilePrefetcher
+{
+public:
+	PluginFilePrefetcher(std::vector<std::wstring> filenames);
+	~PluginFilePrefetcher();
+
+private:
+	void run();
+	void prefetch(const std::wstring& filename, std::vector<char>& buffer);
+
+	std::vector<std::wstring> filenames_;
+	std::atomic<size_t> next_;
+	std::atomic<bool> stop_;
+	std::vector<std::thread> threads_;
+};
+} // end namespace wgt
+#endif // PLUGIN_FILE_PREFETCHER_HPP
@@ -1,4 +1,5 @@
 #include "plugin_static_initializer.hpp"
+#include "core_common/scoped_stop_watch.hpp"
 
 namespace wgt
 {
@@ -64,6 +65,7 @@ void PluginStaticInitializer::registerStaticInitializer(
 //------------------------------------------------------------------------------
 void PluginStaticInitializer::initStatics(IComponentContext& context)
 {
+	TRACE_ZONE("Init statics", "plugin");
 	auto node = headInitNode_.get();
 	while (node)
 	{
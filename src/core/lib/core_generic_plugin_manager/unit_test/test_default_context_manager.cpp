@@ -0,0 +1,131 @@
+#include "pch.hpp"
+
+#include "core_dependency_system/i_interface.hpp"
+#include "core_generic_plugin_manager/default_context_manager.hpp"
+
+#include <atomic>
+#include <thread>
+#include <vector>
+
+namespace wgt
+{
+namespace
+{
+class ITestContextA
+{
+public:
+	virtual ~ITestContextA()
+	{
+	}
+	virtual int getValue() const = 0;
+};
+
+class ITestContextB
+{
+public:
+	virtual ~ITestContextB()
+	{
+	}
+};
+
+class TestContextA : public Implements<ITestContextA>
+{
+public:
+	TestContextA(int value) : value_(value)
+	{
+	}
+
+	int getValue() const override
+	{
+		return value_;
+	}
+
+private:
+	int value_;
+};
+
+class TestContextB : public Implements<ITestContextB>
+{
+};
+}
+
+//------------------------------------------------------------------------------
+TEST(context_query_after_registry_changes)
+{
+	DefaultComponentContext rootContext(L"root");
+	DefaultComponentContext childContext(L"child", &rootContext);
+	IComponentContext& root = rootContext;
+	IComponentContext& child = childContext;
+
+	// Missing interfaces are cached too, and must be found once registered
+	CHECK(child.queryInterface<ITestContextA>() == nullptr);
+	CHECK(child.queryInterface<ITestContextA>() == nullptr);
+
+	auto a = root.registerInterface(new TestContextA(1));
+	auto found = child.queryInterface<ITestContextA>();
+	CHECK(found != nullptr);
+	CHECK_EQUAL(1, found->getValue());
+	CHECK(child.queryInterface<ITestContextB>() == nullptr);
+
+	// A change in the parent invalidates the child's results
+	auto b = root.registerInterface(new TestContextB());
+	CHECK(child.queryInterface<ITestContextB>() != nullptr);
+
+	auto childA = child.registerInterface(new TestContextA(2), true, IComponentContext::Reg_Local);
+	CHECK_EQUAL(2, child.queryInterface<ITestContextA>()->getValue());
+	CHECK_EQUAL(1, root.queryInterface<ITestContextA>()->getValue());
+
+	std::vector<ITestContextA*> all;
+	child.queryInterface(all);
+	CHECK_EQUAL(size_t(2), all.size());
+
+	CHECK(child.deregisterInterface(childA.get()));
+	CHECK_EQUAL(1, child.queryInterface<ITestContextA>()->getValue());
+	CHECK(root.deregisterInterface(a.get()));
+	CHECK(root.deregisterInterface(b.get()));
+	CHECK(child.queryInterface<ITestContextA>() == nullptr);
+	CHECK(child.queryInterface<ITestContextB>() == nullptr);
+}
+
+//------------------------------------------------------------------------------
+TEST(context_query_concurrent_registration)
+{
+	DefaultComponentContext rootContext(L"root");
+	DefaultComponentContext childContext(L"child", &rootContext);
+	IComponentContext& root = rootContext;
+	IComponentContext& child = childContext;
+	auto a = root.registerInterface(new TestContextA(1));
+
+	std::atomic<bool> done(false);
+	std::atomic<int> failures(0);
+	std::vector<std::thread> readers;
+	for (int i = 0; i < 4; ++i)
+	{
+		readers.emplace_back([&] {
+			while (!done)
+			{
+				auto found = child.queryInterface<ITestContextA>();
+				if (found == nullptr || found->getValue() != 1)
+				{
+					++failures;
+				}
+				child.queryInterface<ITestContextB>();
+			}
+		});
+	}
+
+	for (int i = 0; i < 200; ++i)
+	{
+		auto b = child.registerInterface(new TestContextB(), true, IComponentContext::Reg_Local);
+		child.deregisterInterface(b.get());
+	}
+	done = true;
+	for (auto& reader : readers)
+	{
+		reader.join();
+	}
+	CHECK_EQUAL(0, failures.load());
+	CHECK(child.queryInterface<ITestContextB>() == nullptr);
+	root.deregisterInterface(a.get());
+}
+} // end namespace wgt
@@ -18,6 +18,8 @@
 #include "core_generic_plugin_test/memory_plugin_context_creator.hpp"
 #include "core_generic_plugin_test/test_plugin_loader.hpp"
 
+#include <algorithm>
+
 namespace wgt
 {
 namespace
@@ -262,6 +264,40 @@ TEST(more_plugins)
 	CHECK(testObj2 == nullptr);
 }
 
+//------------------------------------------------------------------------------
+TEST(plugin_load_timings)
+{
+	auto& pluginManager = *getPluginManager();
+
+	std::vector<std::wstring> plugins;
+	plugins.push_back(s_Plugin1Path);
+	plugins.push_back(s_Plugin2Path);
+	pluginManager.loadPlugins(plugins);
+
+	// Each plugin is timed through every load step under the name it was loaded with
+	const auto& timings = pluginManager.getPluginTimings();
+	for (const auto& plugin : plugins)
+	{
+		auto it = timings.find(plugin);
+		CHECK(it != timings.end());
+		if (it == timings.end())
+		{
+			continue;
+		}
+
+		CHECK(it->second[GenericPluginManager::LoadLibraryStep] > 0.0);
+		for (double stepTime : it->second)
+		{
+			CHECK(stepTime >= 0.0);
+		}
+	}
+
+	std::reverse(plugins.begin(), plugins.end());
+	pluginManager.unloadPlugins(plugins);
+	CHECK(timings.find(s_Plugin1Path) == timings.end());
+	CHECK(timings.find(s_Plugin2Path) == timings.end());
+}
+
 //------------------------------------------------------------------------------
 TEST(unload_plugin)
 {
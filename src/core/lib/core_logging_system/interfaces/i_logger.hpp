@@ -1,6 +1,8 @@
 #ifndef I_LOGGER_HPP
 #define I_LOGGER_HPP
 
+#include <cstddef>
+
 namespace wgt
 {
 class ILogMessage;
@@ -9,6 +11,15 @@ class ILogger
 {
 public:
 	virtual void out(ILogMessage* message) = 0;
+
+	/** Receive the messages processed together by the logging system, in order */
+	virtual void outBatch(ILogMessage* const* messages, size_t count)
+	{
+		for (size_t i = 0; i < count; ++i)
+		{
+			out(messages[i]);
+		}
+	}
 };
 } // end namespace wgt
 #endif // I_LOGGER_HPP
@@ -0,0 +1,520 @@
+#include "log_record.hpp"
+
+#include "log_message.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+
+namespace wgt
+{
+namespace
+{
+enum class ArgType
+{
+	NONE,
+	INT,
+	LONG,
+	LONG_LONG,
+	SIZE,
+	INTMAX,
+	PTRDIFF,
+	DOUBLE,
+	LONG_DOUBLE,
+	STRING,
+	POINTER,
+	UNSUPPORTED
+};
+
+const size_t MAX_SPEC_LENGTH = 32;
+
+struct FormatSpec
+{
+	const char* begin_;
+	size_t length_;
+	bool starWidth_;
+	bool starPrecision_;
+	int precision_;
+	ArgType type_;
+};
+
+//------------------------------------------------------------------------------
+// Parse the conversion specification starting at the '%' pointed to by cursor
+// and move cursor past it
+FormatSpec parseSpec(const char*& cursor)
+{
+	FormatSpec spec = { cursor, 0, false, false, -1, ArgType::UNSUPPORTED };
+	++cursor;
+
+	while (*cursor != '\0' && strchr("-+ #0", *cursor) != nullptr)
+	{
+		++cursor;
+	}
+
+	if (*cursor == '*')
+	{
+		spec.starWidth_ = true;
+		++cursor;
+	}
+	while (*cursor >= '0' && *cursor <= '9')
+	{
+		++cursor;
+	}
+
+	if (*cursor == '.')
+	{
+		++cursor;
+		if (*cursor == '*')
+		{
+			spec.starPrecision_ = true;
+			++cursor;
+		}
+		else
+		{
+			spec.precision_ = 0;
+			while (*cursor >= '0' && *cursor <= '9')
+			{
+				spec.precision_ = spec.precision_ * 10 + (*cursor - '0');
+				++cursor;
+			}
+		}
+	}
+
+	enum
+	{
+		LENGTH_NONE,
+		LENGTH_LONG,
+		LENGTH_LONG_LONG,
+		LENGTH_SIZE,
+		LENGTH_INTMAX,
+		LENGTH_PTRDIFF,
+		LENGTH_LONG_DOUBLE,
+	} length = LENGTH_NONE;
+
+	switch (*cursor)
+	{
+	case 'h':
+		++cursor;
+		cursor += *cursor == 'h' ? 1 : 0;
+		break;
+	case 'l':
+		++cursor;
+		length = *cursor == 'l' ? LENGTH_LONG_LONG : LENGTH_LONG;
+		cursor += *cursor == 'l' ? 1 : 0;
+		break;
+	case 'z':
+		++cursor;
+		length = LENGTH_SIZE;
+		break;
+	case 'j':
+		++cursor;
+		length = LENGTH_INTMAX;
+		break;
+	case 't':
+		++cursor;
+		length = LENGTH_PTRDIFF;
+		break;
+	case 'L':
+		++cursor;
+		length = LENGTH_LONG_DOUBLE;
+		break;
+	}
+
+	const char conversion = *cursor;
+	if (conversion != '\0')
+	{
+		++cursor;
+	}
+	spec.length_ = cursor - spec.begin_;
+
+	switch (conversion)
+	{
+	case '%':
+		spec.type_ = ArgType::NONE;
+		break;
+
+	case 'd':
+	case 'i':
+	case 'u':
+	case 'o':
+	case 'x':
+	case 'X':
+		switch (length)
+		{
+		case LENGTH_NONE:
+			spec.type_ = ArgType::INT;
+			break;
+		case LENGTH_LONG:
+			spec.type_ = ArgType::LONG;
+			break;
+		case LENGTH_LONG_LONG:
+			spec.type_ = ArgType::LONG_LONG;
+			break;
+		case LENGTH_SIZE:
+			spec.type_ = ArgType::SIZE;
+			break;
+		case LENGTH_INTMAX:
+			spec.type_ = ArgType::INTMAX;
+			break;
+		case LENGTH_PTRDIFF:
+			spec.type_ = ArgType::PTRDIFF;
+			break;
+		default:
+			break;
+		}
+		break;
+
+	case 'c':
+		spec.type_ = length == LENGTH_NONE ? ArgType::INT : ArgType::UNSUPPORTED;
+		break;
+
+	case 'f':
+	case 'F':
+	case 'e':
+	case 'E':
+	case 'g':
+	case 'G':
+	case 'a':
+	case 'A':
+		if (length == LENGTH_LONG_DOUBLE)
+		{
+			spec.type_ = ArgType::LONG_DOUBLE;
+		}
+		else if (length == LENGTH_NONE || length == LENGTH_LONG)
+		{
+			spec.type_ = ArgType::DOUBLE;
+		}
+		break;
+
+	case 's':
+		spec.type_ = length == LENGTH_NONE ? ArgType::STRING : ArgType::UNSUPPORTED;
+		break;
+
+	case 'p':
+		spec.type_ = ArgType::POINTER;
+		break;
+
+	default:
+		// %n, wide characters and platform specific extensions are formatted immediately
+		spec.type_ = ArgType::UNSUPPORTED;
+		break;
+	}
+
+	if (spec.length_ >= MAX_SPEC_LENGTH)
+	{
+		spec.type_ = ArgType::UNSUPPORTED;
+	}
+	return spec;
+}
+
+//------------------------------------------------------------------------------
+class ArgumentWriter
+{
+public:
+	ArgumentWriter(char* data, size_t offset, size_t size) : data_(data), offset_(offset), size_(size)
+	{
+	}
+
+	template <typename T>
+	bool write(const T& value)
+	{
+		return write(&value, sizeof(T));
+	}
+
+	bool write(const void* value, size_t size)
+	{
+		if (size > size_ - offset_)
+		{
+			return false;
+		}
+		memcpy(data_ + offset_, value, size);
+		offset_ += size;
+		return true;
+	}
+
+	size_t offset() const
+	{
+		return offset_;
+	}
+
+private:
+	char* data_;
+	size_t offset_;
+	size_t size_;
+};
+
+//------------------------------------------------------------------------------
+class ArgumentReader
+{
+public:
+	explicit ArgumentReader(const char* data) : data_(data)
+	{
+	}
+
+	template <typename T>
+	T read()
+	{
+		T value;
+		memcpy(&value, data_, sizeof(T));
+		data_ += sizeof(T);
+		return value;
+	}
+
+	const char* readString()
+	{
+		const char* value = data_;
+		data_ += strlen(value) + 1;
+		return value;
+	}
+
+private:
+	const char* data_;
+};
+
+//------------------------------------------------------------------------------
+template <typename T>
+int print(char* buffer, size_t size, const char* spec, const int* stars, int starCount, T value)
+{
+	switch (starCount)
+	{
+	case 0:
+		return snprintf(buffer, size, spec, value);
+	case 1:
+		return snprintf(buffer, size, spec, stars[0], value);
+	default:
+		return snprintf(buffer, size, spec, stars[0], stars[1], value);
+	}
+}
+
+//------------------------------------------------------------------------------
+template <typename T>
+void append(std::string& text, const char* spec, const int* stars, int starCount, T value)
+{
+	char buffer[256];
+	const int length = print(buffer, sizeof(buffer), spec, stars, starCount, value);
+	if (length < 0)
+	{
+		return;
+	}
+	if (static_cast<size_t>(length) < sizeof(buffer))
+	{
+		text.append(buffer, length);
+		return;
+	}
+
+	const size_t offset = text.size();
+	text.resize(offset + length + 1);
+	print(&text[offset], length + 1, spec, stars, starCount, value);
+	text.resize(offset + length);
+}
+}
+
+//==============================================================================
+void LogRecord::set(LogLevel level, const char* format, va_list arguments)
+{
+	message_ = nullptr;
+	level_ = level;
+
+	va_list captureArguments;
+	va_copy(captureArguments, arguments);
+	const bool captured = capture(format, captureArguments);
+	va_end(captureArguments);
+	if (captured)
+	{
+		kind_ = CAPTURED;
+		return;
+	}
+
+	va_list formatArguments;
+	va_copy(formatArguments, arguments);
+	const int length = vsnprintf(data_, sizeof(data_), format, formatArguments);
+	va_end(formatArguments);
+	if (length >= 0 && static_cast<size_t>(length) < sizeof(data_))
+	{
+		kind_ = FORMATTED;
+		size_ = static_cast<uint16_t>(length);
+		return;
+	}
+
+	kind_ = MESSAGE;
+	message_ = new LogMessage(level, format, arguments);
+}
+
+//------------------------------------------------------------------------------
+void LogRecord::set(ILogMessage* message)
+{
+	kind_ = MESSAGE;
+	message_ = message;
+	level_ = message != nullptr ? message->getLevel() : LOG_DEBUG;
+	size_ = 0;
+}
+
+//------------------------------------------------------------------------------
+bool LogRecord::capture(const char* format, va_list arguments)
+{
+	const size_t formatLength = strlen(format) + 1;
+	ArgumentWriter writer(data_, 0, sizeof(data_));
+	if (!writer.write(format, formatLength))
+	{
+		return false;
+	}
+
+	for (const char* cursor = strchr(format, '%'); cursor != nullptr; cursor = strchr(cursor, '%'))
+	{
+		FormatSpec spec = parseSpec(cursor);
+		if (spec.starWidth_ && !writer.write(va_arg(arguments, int)))
+		{
+			return false;
+		}
+		if (spec.starPrecision_)
+		{
+			spec.precision_ = va_arg(arguments, int);
+			if (!writer.write(spec.precision_))
+			{
+				return false;
+			}
+		}
+
+		bool written = true;
+		switch (spec.type_)
+		{
+		case ArgType::NONE:
+			break;
+		case ArgType::INT:
+			written = writer.write(va_arg(arguments, int));
+			break;
+		case ArgType::LONG:
+			written = writer.write(va_arg(arguments, long));
+			break;
+		case ArgType::LONG_LONG:
+			written = writer.write(va_arg(arguments, long long));
+			break;
+		case ArgType::SIZE:
+			written = writer.write(va_arg(arguments, size_t));
+			break;
+		case ArgType::INTMAX:
+			written = writer.write(va_arg(arguments, intmax_t));
+			break;
+		case ArgType::PTRDIFF:
+			written = writer.write(va_arg(arguments, ptrdiff_t));
+			break;
+		case ArgType::DOUBLE:
+			written = writer.write(va_arg(arguments, double));
+			break;
+		case ArgType::LONG_DOUBLE:
+			written = writer.write(va_arg(arguments, long double));
+			break;
+		case ArgType::POINTER:
+			written = writer.write(va_arg(arguments, void*));
+			break;
+		case ArgType::STRING:
+		{
+			// The string may not outlive the call, copy it, honouring the precision as it
+			// may not be null terminated
+			const char* value = va_arg(arguments, const char*);
+			if (value == nullptr)
+			{
+				value = "(null)";
+			}
+			size_t length = 0;
+			while ((spec.precision_ < 0 || length < static_cast<size_t>(spec.precision_)) && value[length] != '\0')
+			{
+				++length;
+			}
+			const char terminator = '\0';
+			written = writer.write(value, length) && writer.write(terminator);
+			break;
+		}
+		default:
+			return false;
+		}
+
+		if (!written)
+		{
+			return false;
+		}
+	}
+
+	size_ = static_cast<uint16_t>(writer.offset());
+	return true;
+}
+
+//------------------------------------------------------------------------------
+void LogRecord::format(std::string& text) const
+{
+	if (kind_ == FORMATTED)
+	{
+		text.append(data_, size_);
+		return;
+	}
+	if (kind_ != CAPTURED)
+	{
+		return;
+	}
+
+	const char* format = data_;
+	ArgumentReader reader(data_ + strlen(format) + 1);
+	const char* cursor = format;
+	for (const char* next = strchr(cursor, '%'); next != nullptr; next = strchr(cursor, '%'))
+	{
+		text.append(cursor, next - cursor);
+		cursor = next;
+		const FormatSpec spec = parseSpec(cursor);
+
+		char specText[MAX_SPEC_LENGTH];
+		memcpy(specText, spec.begin_, spec.length_);
+		specText[spec.length_] = '\0';
+
+		int stars[2];
+		int starCount = 0;
+		if (spec.starWidth_)
+		{
+			stars[starCount++] = reader.read<int>();
+		}
+		if (spec.starPrecision_)
+		{
+			stars[starCount++] = reader.read<int>();
+		}
+
+		switch (spec.type_)
+		{
+		case ArgType::NONE:
+			text.push_back('%');
+			break;
+		case ArgType::INT:
+			append(text, specText, stars, starCount, reader.read<int>());
+			break;
+		case ArgType::LONG:
+			append(text, specText, stars, starCount, reader.read<long>());
+			break;
+		case ArgType::LONG_LONG:
+			append(text, specText, stars, starCount, reader.read<long long>());
+			break;
+		case ArgType::SIZE:
+			append(text, specText, stars, starCount, reader.read<size_t>());
+			break;
+		case ArgType::INTMAX:
+			append(text, specText, stars, starCount, reader.read<intmax_t>());
+			break;
+		case ArgType::PTRDIFF:
+			append(text, specText, stars, starCount, reader.read<ptrdiff_t>());
+			break;
+		case ArgType::DOUBLE:
+			append(text, specText, stars, starCount, reader.read<double>());
+			break;
+		case ArgType::LONG_DOUBLE:
+			append(text, specText, stars, starCount, reader.read<long double>());
+			break;
+		case ArgType::POINTER:
+			append(text, specText, stars, starCount, reader.read<void*>());
+			break;
+		case ArgType::STRING:
+			append(text, specText, stars, starCount, reader.readString());
+			break;
+		default:
+			return;
+		}
+	}
+	text.append(cursor);
+}
+} // end namespace wgt
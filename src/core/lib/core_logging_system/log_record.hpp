@@ -0,0 +1,56 @@
+#ifndef LOG_RECORD_HPP
+#define LOG_RECORD_HPP
+
+#include "log_level.hpp"
+#include <cstdarg>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+namespace wgt
+{
+class ILogMessage;
+
+/**
+ *	Fixed size log entry queued by the LoggingSystem.
+ *	A record either stores a copy of the format string and its captured arguments,
+ *	which are only formatted when a logger asks for the text, or owns a prebuilt
+ *	ILogMessage when the arguments could not be captured.
+ */
+struct LogRecord
+{
+	static const size_t RECORD_SIZE = 512;
+
+	enum Kind : uint8_t
+	{
+		EMPTY,
+		CAPTURED,
+		FORMATTED,
+		MESSAGE
+	};
+
+	LogRecord() : message_(nullptr), level_(LOG_DEBUG), size_(0), kind_(EMPTY)
+	{
+	}
+
+	/**
+	 *	Store the format and arguments, falling back to formatting them straight away
+	 *	and then to a heap allocated LogMessage if they do not fit the record.
+	 */
+	void set(LogLevel level, const char* format, va_list arguments);
+	void set(ILogMessage* message);
+
+	/** Append the formatted text of a CAPTURED or FORMATTED record */
+	void format(std::string& text) const;
+
+	ILogMessage* message_;
+	LogLevel level_;
+	uint16_t size_;
+	Kind kind_;
+	char data_[RECORD_SIZE - sizeof(ILogMessage*) - sizeof(LogLevel) - sizeof(uint16_t) - sizeof(Kind)];
+
+private:
+	bool capture(const char* format, va_list arguments);
+};
+} // end namespace wgt
+#endif // LOG_RECORD_HPP
@@ -9,13 +9,100 @@
 #include "core_common/assert.hpp"
 #include "core_reflection/i_definition_manager.hpp"
 #include "core_reflection/reflection_macros.hpp"
+#include <algorithm>
 #include <cstdarg>
 #include <cstdio>
 
 namespace wgt
 {
+namespace
+{
+const size_t QUEUE_CAPACITY = 1024;
+const size_t BATCH_SIZE = 64;
+// Times the processor looks for more records before it sleeps, saving the producers a wake up per burst
+const int IDLE_SPIN_COUNT = 64;
+
+//------------------------------------------------------------------------------
+// Message given to the loggers for a captured record, formatted the first time its text is read
+class RecordMessage : public ILogMessage
+{
+public:
+	RecordMessage() : record_(nullptr), formatted_(false)
+	{
+	}
+
+	void reset(const LogRecord* record)
+	{
+		record_ = record;
+		formatted_ = false;
+		text_.clear();
+		tags_.clear();
+	}
+
+	const char* c_str() const override
+	{
+		return str().c_str();
+	}
+
+	const std::string& str() const override
+	{
+		if (!formatted_)
+		{
+			record_->format(text_);
+			formatted_ = true;
+		}
+		return text_;
+	}
+
+	LogLevel getLevel() const override
+	{
+		return record_->level_;
+	}
+
+	const char* getLevelString() const override
+	{
+		return LogMessage::getLevelString(getLevel());
+	}
+
+	std::string getAsHtml() const override
+	{
+		return LogMessage::getAsHtml(str(), getLevel());
+	}
+
+	bool addTag(std::string tag) override
+	{
+		if (hasTag(tag.c_str()))
+		{
+			return false;
+		}
+		tags_.push_back(tag);
+		return true;
+	}
+
+	bool hasTag(const char* needle) const override
+	{
+		return std::find(tags_.begin(), tags_.end(), needle) != tags_.end();
+	}
+
+private:
+	const LogRecord* record_;
+	mutable std::string text_;
+	mutable bool formatted_;
+	std::vector<std::string> tags_;
+};
+}
+
+// Reused between batches so formatting can reuse the message buffers
+struct LoggingSystem::DispatchBuffers
+{
+	std::vector<RecordMessage> recordMessages_;
+	std::vector<ILogMessage*> messages_;
+};
+
 LoggingSystem::LoggingSystem()
-    : alertManager_(new AlertManager()), basicAlertLogger_(nullptr), hasAlertManagement_(false), running_(true)
+    : records_(QUEUE_CAPACITY), submitted_(0), processed_(0), processor_(nullptr), processorID_(std::thread::id()),
+      processorWaiting_(false), flushWaiters_(0), alertManager_(new AlertManager()), basicAlertLogger_(nullptr),
+      hasAlertManagement_(false), running_(true)
 {
 	processor_ = new std::thread(&LoggingSystem::process, this);
 	get<IDefinitionManager>()->registerDefinition<TypeClassDefinition<ILoggingModel>>();
@@ -23,6 +110,8 @@ LoggingSystem::LoggingSystem()
 
 LoggingSystem::~LoggingSystem()
 {
+	shutdown();
+
 	// Kill specialized alert management and presentation
 	disableAlertManagement();
 	if (alertManager_ != nullptr)
@@ -54,17 +143,12 @@ void LoggingSystem::disableAlertManagement()
 }
 
 void LoggingSystem::shutdown()
-{	
+{
 	if (processor_ != nullptr)
 	{
-		while (!messages_.empty())
-		{
-			using namespace std::chrono_literals;
-			std::this_thread::sleep_for(1ms);
-		}
-
+		// The processor drains everything submitted so far before it exits
 		{
-			tMessageLock guard(messageMutex_);
+			tMessageLock guard(processorMutex_);
 			running_ = false;
 		}
 		processorCV_.notify_one();
@@ -108,87 +192,196 @@ bool LoggingSystem::unregisterLogger(ILogger* logger)
 
 void LoggingSystem::log(LogLevel level, const char* format, ...)
 {
+	LogRecord record;
 	va_list arguments;
 	va_start(arguments, format);
-	ILogMessage* message = new LogMessage(level, format, arguments);
+	record.set(level, format, arguments);
 	va_end(arguments);
 
-	log(message);
+	submit(record);
 }
 
 void LoggingSystem::log(ILogMessage* message)
 {
+	LogRecord record;
+	record.set(message);
+	submit(record);
+}
+
+void LoggingSystem::submit(LogRecord& record)
+{
+	// Counted before the push so the processor and flush never miss a record in flight
+	submitted_.fetch_add(1);
+	if (!running_ && !isProcessorThread())
+	{
+		// The processor is draining or gone, hand the record to the loggers directly
+		DispatchBuffers buffers;
+		dispatch(&record, 1, buffers);
+		processed_.fetch_add(1);
+		notifyFlushWaiters();
+		return;
+	}
+
+	while (!records_.try_push(record))
+	{
+		if (isProcessorThread())
+		{
+			// Logged by a logger while the queue is full, waiting would never end
+			overflow_.push_back(record);
+			return;
+		}
+
+		processorCV_.notify_one();
+		std::this_thread::yield();
+	}
+
+	// Pairs with the fence in process(), either we see the processor waiting or it sees our record
+	std::atomic_thread_fence(std::memory_order_seq_cst);
+	if (processorWaiting_.load(std::memory_order_relaxed))
 	{
-		tMessageLock guard(messageMutex_);
-		messages_.push(message);
+		{
+			tMessageLock guard(processorMutex_);
+		}
+		processorCV_.notify_one();
 	}
-	processorCV_.notify_one();
 }
 
 void LoggingSystem::flush()
 {
-	if (std::this_thread::get_id() == processorID_)
+	if (isProcessorThread())
+	{
+		return;
+	}
+
+	const uint64_t target = submitted_.load();
+	if (processed_.load() >= target)
 	{
 		return;
 	}
-	tMessageLock guard(messageMutex_);
-	if(!messages_.empty())
+
+	flushWaiters_.fetch_add(1);
+	{
+		tMessageLock guard(processorMutex_);
+		flushCV_.wait(guard, [this, target]() { return processed_.load() >= target; });
+	}
+	flushWaiters_.fetch_sub(1);
+}
+
+void LoggingSystem::notifyFlushWaiters()
+{
+	if (flushWaiters_.load() > 0)
+	{
+		{
+			tMessageLock guard(processorMutex_);
+		}
+		flushCV_.notify_all();
+	}
+}
+
+bool LoggingSystem::isProcessorThread() const
+{
+	return std::this_thread::get_id() == processorID_.load(std::memory_order_relaxed);
+}
+
+void LoggingSystem::dispatch(LogRecord* records, size_t count, DispatchBuffers& buffers)
+{
+	auto& recordMessages = buffers.recordMessages_;
+	auto& messages = buffers.messages_;
+	if (recordMessages.size() < count)
+	{
+		recordMessages.resize(count);
+	}
+	messages.clear();
+
+	for (size_t i = 0; i < count; ++i)
+	{
+		LogRecord& record = records[i];
+		if (record.kind_ == LogRecord::MESSAGE)
+		{
+			if (record.message_ != nullptr)
+			{
+				messages.push_back(record.message_);
+			}
+		}
+		else
+		{
+			recordMessages[i].reset(&record);
+			messages.push_back(&recordMessages[i]);
+		}
+	}
+
+	if (!messages.empty())
 	{
-		flushCV_.wait(guard);
+		std::lock_guard<std::mutex> guard(loggerMutex_);
+
+		for (auto& logger : loggers_)
+		{
+			TF_ASSERT(logger != nullptr);
+			logger->outBatch(messages.data(), messages.size());
+		}
+	}
+
+	for (size_t i = 0; i < count; ++i)
+	{
+		delete records[i].message_;
+		records[i].message_ = nullptr;
 	}
 }
 
 void LoggingSystem::process()
 {
 	processorID_ = std::this_thread::get_id();
+
+	DispatchBuffers buffers;
+	std::vector<LogRecord> batch;
+	batch.reserve(BATCH_SIZE);
+	LogRecord record;
+	int idleSpins = 0;
 	while (true)
 	{
-		bool isEmpty = true;
+		batch.swap(overflow_);
+		while (batch.size() < BATCH_SIZE && records_.try_pop(record))
 		{
-			tMessageLock guard(messageMutex_);
-			isEmpty = messages_.empty();
+			batch.push_back(record);
 		}
 
-		if (!isEmpty)
+		if (!batch.empty())
 		{
-			// Pop a message and broadcast it
-			ILogMessage* currentMessage = nullptr;
-			{
-				tMessageLock guard(messageMutex_);
-				currentMessage = messages_.front();
-			}
+			dispatch(batch.data(), batch.size(), buffers);
+			processed_.fetch_add(batch.size());
+			batch.clear();
+			notifyFlushWaiters();
+			idleSpins = 0;
+			continue;
+		}
 
-			if (currentMessage != nullptr)
-			{
-				{
-					std::lock_guard<std::mutex> guard(loggerMutex_);
-
-					for (auto& logger : loggers_)
-					{
-						TF_ASSERT(logger != nullptr);
-						logger->out(currentMessage);
-					}
-				}
-
-				delete currentMessage;
-				currentMessage = nullptr;
-			}
+		if (idleSpins < IDLE_SPIN_COUNT && running_)
+		{
+			++idleSpins;
+			std::this_thread::yield();
+			continue;
+		}
 
-			{
-				tMessageLock guard(messageMutex_);
-				messages_.pop();
-			}
+		tMessageLock lock(processorMutex_);
+		const bool pending = submitted_.load() != processed_.load();
+		if (!running_ && !pending)
+		{
+			break;
 		}
-		else
+		if (pending)
 		{
-			if (!running_)
-				break;
-			{
-				flushCV_.notify_all();
-				tMessageLock lock(messageMutex_);
-				processorCV_.wait(lock, [this]() { return !running_ || !messages_.empty(); });
-			}
+			// A record is counted but its push has not completed yet
+			lock.unlock();
+			std::this_thread::yield();
+			continue;
 		}
+
+		processorWaiting_.store(true, std::memory_order_relaxed);
+		std::atomic_thread_fence(std::memory_order_seq_cst);
+		processorCV_.wait(lock, [this]() { return !running_ || submitted_.load() != processed_.load(); });
+		processorWaiting_.store(false, std::memory_order_relaxed);
 	}
+
+	processorID_ = std::thread::id();
 }
 } // end namespace wgt
@@ -5,16 +5,25 @@
 #include "core_dependency_system/depends.hpp"
 #include "interfaces/i_logging_system.hpp"
 #include "log_level.hpp"
-#include <queue>
+#include "log_record.hpp"
+#include "core_common/wg_condition_variable.hpp"
+#include "core_common/wg_mpsc_queue.hpp"
+#include <atomic>
+#include <cstdint>
 #include <thread>
 #include <mutex>
-#include "core_common/wg_condition_variable.hpp"
+#include <vector>
 
 namespace wgt
 {
 class AlertManager;
 class BasicAlertLogger;
 
+/**
+ *	Logs are queued as fixed size records in a lock-free ring buffer and handed to
+ *	the loggers in batches by a processor thread. Arguments are captured rather than
+ *	formatted, the text is only built on the processor thread when a logger reads it.
+ */
 class LoggingSystem final
 	: public Implements<ILoggingSystem>
 	, public Depends<class IDefinitionManager>
@@ -38,25 +47,38 @@ public:
 	virtual void flush() override;
 
 private:
+	struct DispatchBuffers;
+
+	void submit(LogRecord& record);
+	void dispatch(LogRecord* records, size_t count, DispatchBuffers& buffers);
+	void notifyFlushWaiters();
+	bool isProcessorThread() const;
+
 	typedef std::vector<ILogger*> tLoggerList;
 	tLoggerList loggers_;
+	std::mutex loggerMutex_;
 
-	typedef std::queue<ILogMessage*> tMessageQueue;
-	tMessageQueue messages_;
+	wg_mpsc_queue<LogRecord> records_;
+	// Records logged by the loggers themselves while the queue was full, only used by the processor
+	std::vector<LogRecord> overflow_;
+	// Records submitted and records given to the loggers, flush waits for processed_ to catch up
+	std::atomic<uint64_t> submitted_;
+	std::atomic<uint64_t> processed_;
 
 	typedef std::unique_lock<std::mutex> tMessageLock;
 	std::thread* processor_;
-	std::thread::id processorID_;
-	std::mutex messageMutex_;
-	std::mutex loggerMutex_;
+	std::atomic<std::thread::id> processorID_;
+	std::mutex processorMutex_;
 	wg_condition_variable processorCV_;
-	wg_condition_variable flushCV_;	
+	wg_condition_variable flushCV_;
+	std::atomic<bool> processorWaiting_;
+	std::atomic<int> flushWaiters_;
 
 	AlertManager* alertManager_;
 	BasicAlertLogger* basicAlertLogger_;
 	bool hasAlertManagement_;
 
-	bool running_;
+	std::atomic<bool> running_;
 };
 } // end namespace wgt
 #endif // LOGGING_SYSTEM_HPP
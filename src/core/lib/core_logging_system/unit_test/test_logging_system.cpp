@@ -0,0 +1,125 @@
+#include "pch.hpp"
+
+#include "core_logging_system/logging_system.hpp"
+#include "core_logging_system/interfaces/i_logger.hpp"
+#include "core_logging_system/interfaces/i_log_message.hpp"
+#include "core_unit_test/test_framework.hpp"
+
+#include <cstdio>
+#include <cstring>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace wgt
+{
+namespace
+{
+class TestLogger : public ILogger
+{
+public:
+	virtual void out(ILogMessage* message) override
+	{
+		std::lock_guard<std::mutex> guard(mutex_);
+		lines_.push_back(message->str());
+	}
+
+	std::vector<std::string> lines()
+	{
+		std::lock_guard<std::mutex> guard(mutex_);
+		return lines_;
+	}
+
+private:
+	std::mutex mutex_;
+	std::vector<std::string> lines_;
+};
+
+// More records than the queue holds, so the processor hands them over in several batches
+const int RECORD_COUNT = 5000;
+
+bool inOrder(const std::vector<std::string>& lines, int count)
+{
+	if (lines.size() != static_cast<size_t>(count))
+	{
+		return false;
+	}
+
+	char expected[16];
+	for (int i = 0; i < count; ++i)
+	{
+		sprintf(expected, "%d", i);
+		if (lines[i] != expected)
+		{
+			return false;
+		}
+	}
+	return true;
+}
+}
+
+class TestLoggingSystemFixture
+{
+public:
+	TestLoggingSystemFixture()
+	{
+		loggingSystem_.registerLogger(&logger_);
+	}
+
+	~TestLoggingSystemFixture()
+	{
+		loggingSystem_.shutdown();
+		loggingSystem_.unregisterLogger(&logger_);
+	}
+
+protected:
+	// The logging system registers its model definition on construction
+	TestFramework framework_;
+	LoggingSystem loggingSystem_;
+	TestLogger logger_;
+};
+
+TEST_F(TestLoggingSystemFixture, logging_system_captures_arguments)
+{
+	char buffer[32];
+	strcpy(buffer, "before");
+	loggingSystem_.log(LOG_INFO, "%s %d", buffer, 5);
+
+	// The record is formatted later on the processor thread, so it must not read the caller's buffer
+	strcpy(buffer, "after");
+	loggingSystem_.flush();
+
+	auto lines = logger_.lines();
+	CHECK_EQUAL(1, lines.size());
+	if (!lines.empty())
+	{
+		CHECK_EQUAL(std::string("before 5"), lines[0]);
+	}
+}
+
+TEST_F(TestLoggingSystemFixture, logging_system_flush_order)
+{
+	for (int i = 0; i < RECORD_COUNT; ++i)
+	{
+		loggingSystem_.log(LOG_INFO, "%d", i);
+	}
+	loggingSystem_.flush();
+	CHECK(inOrder(logger_.lines(), RECORD_COUNT));
+}
+
+TEST_F(TestLoggingSystemFixture, logging_system_shutdown_order)
+{
+	for (int i = 0; i < RECORD_COUNT; ++i)
+	{
+		loggingSystem_.log(LOG_INFO, "%d", i);
+	}
+
+	// Shutting down drains everything still queued before the processor exits
+	loggingSystem_.shutdown();
+	CHECK(inOrder(logger_.lines(), RECORD_COUNT));
+
+	// Once the processor is gone records go straight to the loggers
+	loggingSystem_.log(LOG_INFO, "%d", RECORD_COUNT);
+	CHECK(inOrder(logger_.lines(), RECORD_COUNT + 1));
+}
+} // end namespace wgt
@@ -21,6 +21,8 @@
 
 
 #include <QMimeData>
+#include <QThread>
+#include <algorithm>
 #include <memory>
 #include <unordered_map>
 
@@ -222,10 +224,23 @@ public:
 private:
 
 	QModelIndex getCachedParentIndex(const QModelIndex& childIndex) const;
+	void flushPendingDataChanges();
+
+	// An item data change reported in a batch, to be merged with its neighbours
+	struct PendingDataChange
+	{
+		const AbstractItem* parent_;
+		int column_;
+		int row_;
+		int role_;
+	};
 
 	mutable std::unordered_map<QModelIndex, QModelIndex>	childToParentIndexCache_;
 	AbstractItemModel&										source_;
 	ConnectionHolder										connections_;
+	// Only used on the model's thread, which is where the source must report its changes
+	int														dataBatchDepth_;
+	std::vector<PendingDataChange>							pendingDataChanges_;
 
 	struct Dependencies : public Depends<IItemModelController, IQtHelpers>
 	{
@@ -270,6 +285,7 @@ template <class BaseModel>
 QtItemModel<BaseModel>::QtItemModel(SourceType& source)
 	: WGTInterfaceProvider( this )
 	, source_(source)
+	, dataBatchDepth_(0)
 {
 	registerInterface(*this);
 	auto changed = [this]() {
@@ -314,10 +330,20 @@ QtItemModel<BaseModel>::QtItemModel(SourceType& source)
 
 	auto postItemData = [this](const AbstractItemModel::ItemIndex& index, ItemRole::Id roleId,
 	                           const Variant& newValue) {
+		int encodedRole;
+		if (dataBatchDepth_ > 0)
+		{
+			if (encodeRole(roleId, encodedRole))
+			{
+				PendingDataChange change = { index.parent_, index.column_, index.row_, encodedRole };
+				pendingDataChanges_.push_back(change);
+			}
+			return;
+		}
+
 		auto item = source_.item(index);
 		const QModelIndex modelIndex = this->createIndex(index.row_, index.column_, item);
 
-		int encodedRole;
 		if (encodeRole(roleId, encodedRole))
 		{
 			const QModelIndex topLeft = modelIndex;
@@ -329,6 +355,22 @@ QtItemModel<BaseModel>::QtItemModel(SourceType& source)
 	};
 	connections_.add(source_.connectPostItemDataChanged(postItemData));
 
+	auto preItemDataBatch = [this]() {
+		TF_ASSERT(QThread::currentThread() == this->thread());
+		++dataBatchDepth_;
+	};
+	connections_.add(source_.connectPreItemDataBatch(preItemDataBatch));
+
+	auto postItemDataBatch = [this]() {
+		TF_ASSERT(QThread::currentThread() == this->thread());
+		TF_ASSERT(dataBatchDepth_ > 0);
+		if (--dataBatchDepth_ == 0)
+		{
+			this->flushPendingDataChanges();
+		}
+	};
+	connections_.add(source_.connectPostItemDataBatch(postItemDataBatch));
+
 	// @see AbstractItem::DataSignature
 	auto postModelData = [this](int row, int column, ItemRole::Id roleId, const Variant& value) {
 		bool validHorizontal = row == -1 && column >= 0 && column < source_.columnCount(nullptr);
@@ -400,6 +442,50 @@ QtItemModel<BaseModel>::~QtItemModel()
 {
 }
 
+template <class BaseModel>
+void QtItemModel<BaseModel>::flushPendingDataChanges()
+{
+	// Adjacent rows under the same parent and column become one dataChanged with all of their roles
+	std::sort(pendingDataChanges_.begin(), pendingDataChanges_.end(),
+	          [](const PendingDataChange& a, const PendingDataChange& b) {
+		          if (a.parent_ != b.parent_)
+		          {
+			          return std::less<const AbstractItem*>()(a.parent_, b.parent_);
+		          }
+		          if (a.column_ != b.column_)
+		          {
+			          return a.column_ < b.column_;
+		          }
+		          return a.row_ != b.row_ ? a.row_ < b.row_ : a.role_ < b.role_;
+		      });
+
+	auto it = pendingDataChanges_.begin();
+	const auto end = pendingDataChanges_.end();
+	QVector<int> encodedRoles;
+	while (it != end)
+	{
+		const auto first = it;
+		auto last = it;
+		encodedRoles.clear();
+		for (; it != end && it->parent_ == first->parent_ && it->column_ == first->column_ && it->row_ <= last->row_ + 1;
+		     ++it)
+		{
+			last = it;
+			if (!encodedRoles.contains(it->role_))
+			{
+				encodedRoles.append(it->role_);
+			}
+		}
+
+		const AbstractItemModel::ItemIndex topLeft(first->row_, first->column_, first->parent_);
+		const AbstractItemModel::ItemIndex bottomRight(last->row_, last->column_, last->parent_);
+		this->dataChanged(this->createIndex(topLeft.row_, topLeft.column_, source_.item(topLeft)),
+		                  this->createIndex(bottomRight.row_, bottomRight.column_, source_.item(bottomRight)),
+		                  encodedRoles);
+	}
+	pendingDataChanges_.clear();
+}
+
 template <class BaseModel>
 const typename QtItemModel<BaseModel>::SourceType& QtItemModel<BaseModel>::source() const
 {
@@ -3,40 +3,49 @@
 #include "models/role_provider.hpp"
 #include "core_common/assert.hpp"
 
+#include <algorithm>
+
 namespace wgt
 {
 ITEMROLE(multipleValues)
 
+int WGMultiEditProxy::Entry::sourceRow(int proxyRow) const
+{
+	return proxyRow >= 0 && proxyRow < static_cast<int>(rows_.size()) ? rows_[proxyRow] : -1;
+}
+
 WGMultiEditProxy::WGMultiEditProxy()
 	: multipleValuesRole_(RoleProvider::convertRole(ItemRole::multipleValuesName))
 {
 	roleNames_ = QAbstractItemModel::roleNames();
+	mappings_[QModelIndex()] = new Mapping;
 }
 
 WGMultiEditProxy::~WGMultiEditProxy()
 {
+	connections_.reset();
+	qDeleteAll(mappings_);
 }
 
 void WGMultiEditProxy::addModel(QAbstractItemModel* model)
 {
+	if (std::find(sourceModels_.begin(), sourceModels_.end(), model) != sourceModels_.end())
+	{
+		return;
+	}
+
 	beginResetModel();
 
-	// clear mappings
-	clearMapping();
+	// keep the merged root rows, the new model's rows are merged into them
+	auto root = mappings_.find(QModelIndex());
+	TF_ASSERT(root != mappings_.end());
+	deleteMappings(*root);
 
 	// add new model
 	sourceModels_.push_back(model);
-
-	// map root
-	auto mapping = new Mapping;
-	mappings_[QModelIndex()] = mapping;
-	for (auto sourceModel : sourceModels_)
-	{
-		mapping->entries_[sourceModel] = Entry();
-		create_role_mapping(sourceModel);
-		connections_ +=
-		QObject::connect(sourceModel, &QAbstractItemModel::dataChanged, this, &WGMultiEditProxy::onSourceDataChanged);
-	}
+	create_role_mapping(model);
+	connectModel(model);
+	addEntry(root, model, QModelIndex(), false);
 
 	endResetModel();
 }
@@ -47,24 +56,43 @@ void WGMultiEditProxy::removeModel(QAbstractItemModel* model)
 
 	// clear mappings
 	clearMapping();
+	connections_.reset();
+	roleMappings_.clear();
+	roleNames_ = QAbstractItemModel::roleNames();
 
 	// remove model
 	sourceModels_.erase(std::remove(sourceModels_.begin(), sourceModels_.end(), model), sourceModels_.end());
-
-	// map root
-	auto mapping = new Mapping;
-	mappings_[QModelIndex()] = mapping;
+	(*mappings_.find(QModelIndex()))->entries_.erase(model);
 	for (auto sourceModel : sourceModels_)
 	{
-		mapping->entries_[sourceModel] = Entry();
 		create_role_mapping(sourceModel);
-		connections_ +=
-		QObject::connect(sourceModel, &QAbstractItemModel::dataChanged, this, &WGMultiEditProxy::onSourceDataChanged);
+		connectModel(sourceModel);
 	}
 
 	endResetModel();
 }
 
+void WGMultiEditProxy::connectModel(QAbstractItemModel* model)
+{
+	connections_ += QObject::connect(
+	model, &QAbstractItemModel::dataChanged, this,
+	[this, model](const QModelIndex& topLeft, const QModelIndex& bottomRight, const QVector<int>& roles) {
+		onSourceDataChanged(model, topLeft, bottomRight, roles);
+	});
+	connections_ += QObject::connect(model, &QAbstractItemModel::rowsInserted, this,
+	                                 [this, model](const QModelIndex& parent, int first, int last) {
+		                                 onSourceRowsInserted(model, parent, first, last);
+		                             });
+	connections_ += QObject::connect(model, &QAbstractItemModel::rowsAboutToBeRemoved, this,
+	                                 [this, model](const QModelIndex& parent, int first, int last) {
+		                                 onSourceRowsAboutToBeRemoved(model, parent, first, last);
+		                             });
+	connections_ += QObject::connect(model, &QAbstractItemModel::rowsRemoved, this,
+	                                 [this, model](const QModelIndex& parent, int first, int last) {
+		                                 onSourceRowsRemoved(model, parent, first, last);
+		                             });
+}
+
 QList<QString> WGMultiEditProxy::getMergeKeys() const
 {
 	return mergeKeys_;
@@ -73,6 +101,7 @@ QList<QString> WGMultiEditProxy::getMergeKeys() const
 void WGMultiEditProxy::setMergeKeys(const QList<QString>& mergeKeys)
 {
 	beginResetModel();
+	clearMapping();
 	mergeKeys_ = mergeKeys;
 	mergeKeyRoleIds_.clear();
 	for (auto it = mergeKeys_.begin(); it != mergeKeys_.end(); ++it)
@@ -83,20 +112,17 @@ void WGMultiEditProxy::setMergeKeys(const QList<QString>& mergeKeys)
 	endResetModel();
 }
 
-void WGMultiEditProxy::onSourceDataChanged(const QModelIndex& topLeft, const QModelIndex& bottomRight,
-                                           const QVector<int>& roles)
+void WGMultiEditProxy::onSourceDataChanged(QAbstractItemModel* model, const QModelIndex& topLeft,
+                                           const QModelIndex& bottomRight, const QVector<int>& roles)
 {
-	QModelIndex proxy_index;
-	auto model = const_cast<QAbstractItemModel*>(topLeft.model());
-	TF_ASSERT(model != nullptr);
 	auto& mappedRole = roleMappings_[model];
 	auto proxy_roles = QVector<int>();
+	bool mergeKeyChanged = roles.isEmpty();
 	for (auto role : roles)
 	{
 		if (std::find(mergeKeyRoleIds_.begin(), mergeKeyRoleIds_.end(), role) != mergeKeyRoleIds_.end())
 		{
-			TF_ASSERT("not support for merge key role changes." && false);
-			return;
+			mergeKeyChanged = true;
 		}
 		for (auto roleIt = mappedRole.begin(); roleIt != mappedRole.end(); ++roleIt)
 		{
@@ -108,23 +134,104 @@ void WGMultiEditProxy::onSourceDataChanged(const QModelIndex& topLeft, const QMo
 		}
 	}
 
-	for (auto it = mappings_.begin(); it != mappings_.end(); ++it)
+	// no proxy indexes exist below a parent until its rows have been mapped
+	auto it = find_source_mapping(model, topLeft.parent());
+	if (it == mappings_.end() || !(*it)->mapped_)
 	{
-		auto findIt = (*it)->entries_.find(model);
-		if (findIt == (*it)->entries_.end())
+		return;
+	}
+
+	auto mapping = *it;
+	auto& entry = mapping->entries_[model];
+	TF_ASSERT(bottomRight.row() < static_cast<int>(entry.proxyRows_.size()));
+	MergedRow key;
+	for (int row = topLeft.row(); row <= bottomRight.row(); ++row)
+	{
+		if (mergeKeyChanged)
 		{
-			continue;
+			// move rows whose merge key changed to the row they now merge with
+			computeMergeKey(model, entry.sourceParent_, row, key);
+			const int proxyRow = entry.proxyRows_[row];
+			const auto& mergedRow = mapping->mergedRows_[proxyRow];
+			if (mergedRow.hash_ != key.hash_ || mergedRow.key_ != key.key_)
+			{
+				unmapSourceRow(it, model, row);
+				mapSourceRow(it, model, row, true);
+				continue;
+			}
 		}
-		if (topLeft != findIt->second.sourceParent_)
+
+		auto proxy_index = createIndex(entry.proxyRows_[row], 0, mapping);
+		emit dataChanged(proxy_index, proxy_index, proxy_roles);
+	}
+}
+
+void WGMultiEditProxy::onSourceRowsInserted(QAbstractItemModel* model, const QModelIndex& parent, int first, int last)
+{
+	auto it = find_source_mapping(model, parent);
+	if (it == mappings_.end() || !(*it)->mapped_)
+	{
+		return;
+	}
+
+	auto& entry = (*it)->entries_[model];
+	TF_ASSERT(first <= static_cast<int>(entry.proxyRows_.size()));
+	const int count = last - first + 1;
+	for (auto& row : entry.rows_)
+	{
+		if (row >= first)
 		{
-			continue;
+			row += count;
 		}
-		proxy_index = it.key();
-		emit dataChanged(proxy_index, proxy_index, proxy_roles);
-		break;
+	}
+	entry.proxyRows_.insert(entry.proxyRows_.begin() + first, count, -1);
+	updateChildSourceParents(*it, model);
+
+	for (int row = first; row <= last; ++row)
+	{
+		mapSourceRow(it, model, row, true);
+	}
+}
+
+void WGMultiEditProxy::onSourceRowsAboutToBeRemoved(QAbstractItemModel* model, const QModelIndex& parent, int first,
+                                                    int last)
+{
+	auto it = find_source_mapping(model, parent);
+	if (it == mappings_.end() || !(*it)->mapped_)
+	{
+		return;
+	}
+
+	// the source rows still exist, so merged rows can fall back to other rows of the model
+	for (int row = last; row >= first; --row)
+	{
+		unmapSourceRow(it, model, row);
 	}
 }
 
+void WGMultiEditProxy::onSourceRowsRemoved(QAbstractItemModel* model, const QModelIndex& parent, int first, int last)
+{
+	auto it = find_source_mapping(model, parent);
+	if (it == mappings_.end() || !(*it)->mapped_)
+	{
+		return;
+	}
+
+	auto& entry = (*it)->entries_[model];
+	TF_ASSERT(last < static_cast<int>(entry.proxyRows_.size()));
+	const int count = last - first + 1;
+	entry.proxyRows_.erase(entry.proxyRows_.begin() + first, entry.proxyRows_.begin() + last + 1);
+	for (auto& row : entry.rows_)
+	{
+		TF_ASSERT(row < first || row > last);
+		if (row > last)
+		{
+			row -= count;
+		}
+	}
+	updateChildSourceParents(*it, model);
+}
+
 void WGMultiEditProxy::create_role_mapping(QAbstractItemModel* sourceModel)
 {
 	auto roleNames = sourceModel->roleNames();
@@ -158,66 +265,34 @@ void WGMultiEditProxy::create_role_mapping(QAbstractItemModel* sourceModel)
 	}
 }
 
-QHash<QModelIndex, WGMultiEditProxy::Mapping*>::iterator WGMultiEditProxy::create_index_mapping(
-const QModelIndex& proxy_parent) const
+WGMultiEditProxy::MappingIterator WGMultiEditProxy::create_index_mapping(const QModelIndex& proxy_parent) const
 {
 	auto it = mappings_.find(proxy_parent);
 	TF_ASSERT(it != mappings_.end());
-	if ((*it)->mapped_)
+	auto mapping = *it;
+	if (mapping->mapped_)
 	{
 		return it;
 	}
 
-	std::vector<std::map<int, QVariant>> items;
-	for (auto& entry : (*it)->entries_)
+	mapping->mergedRows_.clear();
+	mapping->rowsByHash_.clear();
+	MergedRow key;
+	for (auto& entry : mapping->entries_)
 	{
 		auto& source_model = entry.first;
 		auto& source_parent = entry.second.sourceParent_;
 		int rowCount = source_model->rowCount(source_parent);
+		entry.second.rows_.clear();
+		entry.second.proxyRows_.assign(rowCount, -1);
 		for (int i = 0; i < rowCount; ++i)
 		{
-			auto pair = std::map<int, QVariant>();
-			for (auto roleId : mergeKeyRoleIds_)
-			{
-				auto entry = source_model->data(source_model->index(i, 0, source_parent), roleId);
-				pair[roleId] = entry;
-			}
-			bool merged = false;
-			int j = 0;
-			for (; j < static_cast<int>(items.size()); ++j)
-			{
-				auto& item = items[j];
-				// doing merge
-				merged = true;
-				for (auto roleId : mergeKeyRoleIds_)
-				{
-					auto left = item[roleId];
-					auto right = pair[roleId];
-					if (left != right)
-					{
-						merged = false;
-						break;
-					}
-				}
-				if (merged)
-				{
-					break;
-				}
-			}
-			if (!merged)
-			{
-				entry.second.rows_[static_cast<int>(items.size())] = i;
-				items.push_back(pair);
-			}
-			else
-			{
-				entry.second.rows_[j] = i;
-			}
+			computeMergeKey(source_model, source_parent, i, key);
+			addSourceRow(*mapping, entry.second, i, key, findMergedRow(*mapping, key));
 		}
 	}
-	(*it)->rowCount_ = static_cast<int>(items.size());
-	(*it)->mapIter_ = it;
-	(*it)->mapped_ = true;
+	mapping->mapIter_ = it;
+	mapping->mapped_ = true;
 	return it;
 }
 
@@ -232,14 +307,328 @@ const QModelIndex& proxy_index) const
 	return it;
 }
 
+WGMultiEditProxy::MappingIterator WGMultiEditProxy::find_source_mapping(QAbstractItemModel* model,
+                                                                        const QModelIndex& source_parent)
+{
+	for (auto it = mappings_.begin(); it != mappings_.end(); ++it)
+	{
+		auto findIt = (*it)->entries_.find(model);
+		if (findIt != (*it)->entries_.end() && findIt->second.sourceParent_ == source_parent)
+		{
+			return it;
+		}
+	}
+	return mappings_.end();
+}
+
 void WGMultiEditProxy::clearMapping()
 {
-	qDeleteAll(mappings_);
-	mappings_.clear();
-	connections_.reset();
-	roleMappings_.clear();
-	roleNames_.clear();
-	roleNames_ = QAbstractItemModel::roleNames();
+	for (auto it = mappings_.begin(); it != mappings_.end();)
+	{
+		if (it.key().isValid())
+		{
+			delete *it;
+			it = mappings_.erase(it);
+		}
+		else
+		{
+			++it;
+		}
+	}
+
+	auto root = *mappings_.find(QModelIndex());
+	root->mapped_ = false;
+	root->mergedRows_.clear();
+	root->rowsByHash_.clear();
+	for (auto& entry : root->entries_)
+	{
+		entry.second.rows_.clear();
+		entry.second.proxyRows_.clear();
+	}
+}
+
+void WGMultiEditProxy::computeMergeKey(QAbstractItemModel* model, const QModelIndex& sourceParent, int sourceRow,
+                                       MergedRow& o_Key) const
+{
+	// values which compare equal convert to the same string, so they hash the same
+	auto sourceIndex = model->index(sourceRow, 0, sourceParent);
+	uint hash = 0;
+	o_Key.key_.resize(static_cast<int>(mergeKeyRoleIds_.size()));
+	for (int i = 0; i < o_Key.key_.size(); ++i)
+	{
+		o_Key.key_[i] = model->data(sourceIndex, mergeKeyRoleIds_[i]);
+		hash = qHash(o_Key.key_[i].toString(), hash * 31);
+	}
+	o_Key.hash_ = hash;
+	o_Key.sourceRowCount_ = 0;
+}
+
+int WGMultiEditProxy::findMergedRow(const Mapping& mapping, const MergedRow& key) const
+{
+	auto range = mapping.rowsByHash_.equal_range(key.hash_);
+	for (auto it = range.first; it != range.second; ++it)
+	{
+		if (mapping.mergedRows_[it->second].key_ == key.key_)
+		{
+			return it->second;
+		}
+	}
+	return -1;
+}
+
+int WGMultiEditProxy::addSourceRow(Mapping& mapping, Entry& entry, int sourceRow, MergedRow& key, int proxyRow) const
+{
+	// a proxy row of -1 appends a new merged row for the key
+	if (proxyRow < 0)
+	{
+		proxyRow = static_cast<int>(mapping.mergedRows_.size());
+		mapping.rowsByHash_.emplace(key.hash_, proxyRow);
+		mapping.mergedRows_.push_back(key);
+	}
+	++mapping.mergedRows_[proxyRow].sourceRowCount_;
+
+	// if a model has several rows with the same key, the first one represents it
+	entry.proxyRows_[sourceRow] = proxyRow;
+	if (proxyRow >= static_cast<int>(entry.rows_.size()))
+	{
+		entry.rows_.resize(proxyRow + 1, -1);
+	}
+	if (entry.rows_[proxyRow] < 0)
+	{
+		entry.rows_[proxyRow] = sourceRow;
+	}
+	return proxyRow;
+}
+
+void WGMultiEditProxy::mapSourceRow(MappingIterator it, QAbstractItemModel* model, int sourceRow, bool notify)
+{
+	auto mapping = *it;
+	auto& entry = mapping->entries_[model];
+	MergedRow key;
+	computeMergeKey(model, entry.sourceParent_, sourceRow, key);
+	int proxyRow = findMergedRow(*mapping, key);
+	if (proxyRow < 0)
+	{
+		proxyRow = static_cast<int>(mapping->mergedRows_.size());
+		if (notify)
+		{
+			beginInsertRows(it.key(), proxyRow, proxyRow);
+		}
+		addSourceRow(*mapping, entry, sourceRow, key, -1);
+		if (notify)
+		{
+			endInsertRows();
+		}
+		return;
+	}
+
+	addSourceRow(*mapping, entry, sourceRow, key, proxyRow);
+	if (entry.rows_[proxyRow] != sourceRow)
+	{
+		return;
+	}
+
+	// merge the source row's children into the proxy row's children
+	auto proxy_index = createIndex(proxyRow, 0, mapping);
+	auto childIt = mappings_.find(proxy_index);
+	if (childIt != mappings_.end())
+	{
+		addEntry(childIt, model, model->index(sourceRow, 0, entry.sourceParent_), notify);
+	}
+	if (notify)
+	{
+		emit dataChanged(proxy_index, proxy_index);
+	}
+}
+
+void WGMultiEditProxy::unmapSourceRow(MappingIterator it, QAbstractItemModel* model, int sourceRow)
+{
+	auto mapping = *it;
+	auto& entry = mapping->entries_[model];
+	TF_ASSERT(sourceRow < static_cast<int>(entry.proxyRows_.size()));
+	const int proxyRow = entry.proxyRows_[sourceRow];
+	if (proxyRow < 0)
+	{
+		return;
+	}
+
+	entry.proxyRows_[sourceRow] = -1;
+	if (--mapping->mergedRows_[proxyRow].sourceRowCount_ == 0)
+	{
+		removeProxyRow(it, proxyRow);
+		return;
+	}
+	if (entry.rows_[proxyRow] != sourceRow)
+	{
+		return;
+	}
+
+	// fall back to another row of the model with the same key
+	auto found = std::find(entry.proxyRows_.begin(), entry.proxyRows_.end(), proxyRow);
+	entry.rows_[proxyRow] = found != entry.proxyRows_.end() ? static_cast<int>(found - entry.proxyRows_.begin()) : -1;
+
+	auto proxy_index = createIndex(proxyRow, 0, mapping);
+	auto childIt = mappings_.find(proxy_index);
+	if (childIt != mappings_.end())
+	{
+		removeEntry(childIt, model);
+		if (entry.rows_[proxyRow] >= 0)
+		{
+			addEntry(childIt, model, model->index(entry.rows_[proxyRow], 0, entry.sourceParent_), true);
+		}
+	}
+	emit dataChanged(proxy_index, proxy_index);
+}
+
+void WGMultiEditProxy::removeProxyRow(MappingIterator it, int proxyRow)
+{
+	auto mapping = *it;
+	beginRemoveRows(it.key(), proxyRow, proxyRow);
+
+	// delete the row's mappings and move the mappings of the rows after it up, in row order so that
+	// a moved mapping never replaces one which is still to be moved
+	auto children = childMappings(mapping);
+	std::sort(children.begin(), children.end(),
+	          [](const MappingIterator& a, const MappingIterator& b) { return a.key().row() < b.key().row(); });
+	for (auto& childIt : children)
+	{
+		const int row = childIt.key().row();
+		const int column = childIt.key().column();
+		if (row < proxyRow)
+		{
+			continue;
+		}
+		auto child = *childIt;
+		mappings_.erase(childIt);
+		if (row == proxyRow)
+		{
+			deleteMappings(child);
+			delete child;
+		}
+		else
+		{
+			child->mapIter_ = mappings_.insert(createIndex(row - 1, column, mapping), child);
+		}
+	}
+
+	auto range = mapping->rowsByHash_.equal_range(mapping->mergedRows_[proxyRow].hash_);
+	for (auto hashIt = range.first; hashIt != range.second; ++hashIt)
+	{
+		if (hashIt->second == proxyRow)
+		{
+			mapping->rowsByHash_.erase(hashIt);
+			break;
+		}
+	}
+	for (auto& pair : mapping->rowsByHash_)
+	{
+		if (pair.second > proxyRow)
+		{
+			--pair.second;
+		}
+	}
+	mapping->mergedRows_.erase(mapping->mergedRows_.begin() + proxyRow);
+	for (auto& entry : mapping->entries_)
+	{
+		auto& rows = entry.second.rows_;
+		if (proxyRow < static_cast<int>(rows.size()))
+		{
+			rows.erase(rows.begin() + proxyRow);
+		}
+		for (auto& row : entry.second.proxyRows_)
+		{
+			if (row > proxyRow)
+			{
+				--row;
+			}
+		}
+	}
+
+	endRemoveRows();
+}
+
+void WGMultiEditProxy::addEntry(MappingIterator it, QAbstractItemModel* model, const QModelIndex& sourceParent,
+                                bool notify)
+{
+	auto mapping = *it;
+	auto& entry = mapping->entries_[model];
+	entry.sourceParent_ = sourceParent;
+	entry.rows_.clear();
+	entry.proxyRows_.clear();
+	if (!mapping->mapped_)
+	{
+		return;
+	}
+
+	const int rowCount = model->rowCount(sourceParent);
+	entry.proxyRows_.assign(rowCount, -1);
+	for (int row = 0; row < rowCount; ++row)
+	{
+		mapSourceRow(it, model, row, notify);
+	}
+}
+
+void WGMultiEditProxy::removeEntry(MappingIterator it, QAbstractItemModel* model)
+{
+	auto mapping = *it;
+	auto findIt = mapping->entries_.find(model);
+	if (findIt == mapping->entries_.end())
+	{
+		return;
+	}
+
+	if (mapping->mapped_)
+	{
+		for (int row = static_cast<int>(findIt->second.proxyRows_.size()) - 1; row >= 0; --row)
+		{
+			unmapSourceRow(it, model, row);
+		}
+	}
+	mapping->entries_.erase(model);
+}
+
+void WGMultiEditProxy::updateChildSourceParents(Mapping* mapping, QAbstractItemModel* model) const
+{
+	auto findIt = mapping->entries_.find(model);
+	if (findIt == mapping->entries_.end())
+	{
+		return;
+	}
+
+	auto& entry = findIt->second;
+	for (auto& childIt : childMappings(mapping))
+	{
+		auto childEntry = (*childIt)->entries_.find(model);
+		const int sourceRow = entry.sourceRow(childIt.key().row());
+		if (childEntry != (*childIt)->entries_.end() && sourceRow >= 0)
+		{
+			childEntry->second.sourceParent_ = model->index(sourceRow, childIt.key().column(), entry.sourceParent_);
+		}
+	}
+}
+
+void WGMultiEditProxy::deleteMappings(Mapping* mapping)
+{
+	for (auto& childIt : childMappings(mapping))
+	{
+		auto child = *childIt;
+		deleteMappings(child);
+		mappings_.erase(childIt);
+		delete child;
+	}
+}
+
+std::vector<WGMultiEditProxy::MappingIterator> WGMultiEditProxy::childMappings(const Mapping* mapping) const
+{
+	std::vector<MappingIterator> children;
+	for (auto it = mappings_.begin(); it != mappings_.end(); ++it)
+	{
+		if (it.key().isValid() && it.key().internalPointer() == mapping)
+		{
+			children.push_back(it);
+		}
+	}
+	return children;
 }
 
 QModelIndex WGMultiEditProxy::index(int row, int column, const QModelIndex& parent) const
@@ -259,10 +648,9 @@ QModelIndex WGMultiEditProxy::index(int row, int column, const QModelIndex& pare
 		{
 			auto& source_model = entry.first;
 			auto& source_parent = entry.second.sourceParent_;
-			auto findSourceRow = entry.second.rows_.find(row);
-			if (findSourceRow != entry.second.rows_.end())
+			auto source_row = entry.second.sourceRow(row);
+			if (source_row >= 0)
 			{
-				auto source_row = findSourceRow->second;
 				auto source_index = source_model->index(source_row, column, source_parent);
 				mapping->entries_[source_model].sourceParent_ = source_index;
 			}
@@ -289,7 +677,7 @@ int WGMultiEditProxy::rowCount(const QModelIndex& parent) const
 	}
 	auto it = create_index_mapping(parent);
 	TF_ASSERT(it != mappings_.end());
-	return (*it)->rowCount_;
+	return static_cast<int>((*it)->mergedRows_.size());
 }
 
 int WGMultiEditProxy::columnCount(const QModelIndex& parent) const
@@ -320,11 +708,11 @@ QVariant WGMultiEditProxy::data(const QModelIndex& index, int role) const
 		auto& source_model = entry.first;
 		auto& source_parent = entry.second.sourceParent_;
 		QVariant sourceData;
-		auto findIt = entry.second.rows_.find(row);
+		auto source_row = entry.second.sourceRow(row);
 		auto roleMapping = roleMappings_.find(source_model);
 		TF_ASSERT(roleMapping != roleMappings_.end());
 		auto roleIt = roleMapping->second.find(role);
-		if (findIt == entry.second.rows_.end() || roleIt == roleMapping->second.end())
+		if (source_row < 0 || roleIt == roleMapping->second.end())
 		{
 			continue;
 		}
@@ -341,7 +729,6 @@ QVariant WGMultiEditProxy::data(const QModelIndex& index, int role) const
 		}
 		else
 		{
-			auto source_row = findIt->second;
 			auto source_index = source_model->index(source_row, column, source_parent);
 			sourceData = source_model->data(source_index, sourceRole);
 
@@ -384,13 +771,12 @@ bool WGMultiEditProxy::setData(const QModelIndex& index, const QVariant& value,
 	{
 		auto& source_model = entry.first;
 		auto& source_parent = entry.second.sourceParent_;
-		auto findSourceRow = entry.second.rows_.find(row);
+		auto source_row = entry.second.sourceRow(row);
 		auto roleIt = roleMappings_[source_model].find(role);
-		if (findSourceRow == entry.second.rows_.end() || roleIt == roleMappings_[source_model].end())
+		if (source_row < 0 || roleIt == roleMappings_[source_model].end())
 		{
 			continue;
 		}
-		auto source_row = findSourceRow->second;
 		auto source_index = source_model->index(source_row, column, source_parent);
 		ret = source_model->setData(source_index, value, roleIt->second) || ret;
 	}
@@ -19,7 +19,8 @@ namespace wgt
 * union between the sets of properties for all the items (one row for each unique property).
 * Properties are compared using the roles specified in the mergeKeys fields: two properties
 * belonging to different items are merged if they return the same values for all the roles
-* indicated in mergeKeys.
+* indicated in mergeKeys. Rows are merged by hashing these values, and are kept up to date as
+* rows are inserted into, removed from or change their merge keys in the input models.
 *
 * The proxy exposes a data role called multipleValues which is set to true for properties which
 * are shared between multiple input objects. For all other roles, the data() method behaves
@@ -61,32 +62,63 @@ private:
 
 	struct Entry
 	{
+		int sourceRow(int proxyRow) const;
+
 		QModelIndex sourceParent_;
-		std::map<int, int> rows_;
+		std::vector<int> rows_; // Source row for each proxy row, -1 where the model has no such row
+		std::vector<int> proxyRows_; // Proxy row for each source row
+	};
+
+	struct MergedRow
+	{
+		size_t hash_;
+		QVector<QVariant> key_;
+		int sourceRowCount_;
 	};
 
 	struct Mapping
 	{
-		Mapping() : mapped_(false), rowCount_(0)
+		Mapping() : mapped_(false)
 		{
 		}
 		bool mapped_;
-		int rowCount_;
 		QHash<QModelIndex, Mapping*>::iterator mapIter_;
 		std::map<QAbstractItemModel*, Entry> entries_;
+		std::vector<MergedRow> mergedRows_;
+		std::unordered_multimap<size_t, int> rowsByHash_;
 	};
+	typedef QHash<QModelIndex, Mapping*>::iterator MappingIterator;
 
 	QList<QString> getMergeKeys() const;
 	void setMergeKeys(const QList<QString>& mergeKeys);
 
-	void onSourceDataChanged(const QModelIndex& topLeft, const QModelIndex& bottomRight, const QVector<int>& roles);
+	void onSourceDataChanged(QAbstractItemModel* model, const QModelIndex& topLeft, const QModelIndex& bottomRight,
+	                         const QVector<int>& roles);
+	void onSourceRowsInserted(QAbstractItemModel* model, const QModelIndex& parent, int first, int last);
+	void onSourceRowsAboutToBeRemoved(QAbstractItemModel* model, const QModelIndex& parent, int first, int last);
+	void onSourceRowsRemoved(QAbstractItemModel* model, const QModelIndex& parent, int first, int last);
 
-	QHash<QModelIndex, Mapping*>::iterator create_index_mapping(const QModelIndex& proxy_parent) const;
+	MappingIterator create_index_mapping(const QModelIndex& proxy_parent) const;
 	QHash<QModelIndex, Mapping*>::const_iterator index_to_iterator(const QModelIndex& proxy_index) const;
+	MappingIterator find_source_mapping(QAbstractItemModel* model, const QModelIndex& source_parent);
 	void clearMapping();
+	void connectModel(QAbstractItemModel* model);
 
 	void create_role_mapping(QAbstractItemModel* sourceModel);
 
+	void computeMergeKey(QAbstractItemModel* model, const QModelIndex& sourceParent, int sourceRow,
+	                     MergedRow& o_Key) const;
+	int findMergedRow(const Mapping& mapping, const MergedRow& key) const;
+	int addSourceRow(Mapping& mapping, Entry& entry, int sourceRow, MergedRow& key, int proxyRow) const;
+	void mapSourceRow(MappingIterator it, QAbstractItemModel* model, int sourceRow, bool notify);
+	void unmapSourceRow(MappingIterator it, QAbstractItemModel* model, int sourceRow);
+	void removeProxyRow(MappingIterator it, int proxyRow);
+	void addEntry(MappingIterator it, QAbstractItemModel* model, const QModelIndex& sourceParent, bool notify);
+	void removeEntry(MappingIterator it, QAbstractItemModel* model);
+	void updateChildSourceParents(Mapping* mapping, QAbstractItemModel* model) const;
+	void deleteMappings(Mapping* mapping);
+	std::vector<MappingIterator> childMappings(const Mapping* mapping) const;
+
 	QList<QString> mergeKeys_;
 	std::vector<int> mergeKeyRoleIds_;
 	QHash<int, QByteArray> roleNames_;
@@ -11,6 +11,8 @@
 #include "core_ui_framework/i_preferences.hpp"
 #include "core_reflection/property_accessor.hpp"
 #include "core_logging/logging.hpp"
+#include "core_common/scoped_stop_watch.hpp"
+#include "core_common/trace_profiler.hpp"
 #include <thread>
 #include <chrono>
 #include <QQmlComponent>
@@ -382,15 +384,24 @@ void QmlWindow::setIcon(const char* path)
 
 void QmlWindow::show(bool wait /* = false */)
 {
-	impl_->mainWindow_->setWindowModality(impl_->modalityFlag_);
-	if (impl_->firstTimeShow_ && impl_->isMaximizedInPreference_)
 	{
-		impl_->mainWindow_->setWindowState(Qt::WindowMaximized);
+		TRACE_ZONE("Show window", "qt");
+		impl_->mainWindow_->setWindowModality(impl_->modalityFlag_);
+		if (impl_->firstTimeShow_ && impl_->isMaximizedInPreference_)
+		{
+			impl_->mainWindow_->setWindowState(Qt::WindowMaximized);
+		}
+		impl_->mainWindow_->show();
+		if (title())
+		{
+			impl_->mainWindow_->setWindowTitle(title());
+		}
 	}
-	impl_->mainWindow_->show();
-	if (title())
+
+	// Marked once the zone has ended, so that the zone is in the written trace
+	if (impl_->firstTimeShow_)
 	{
-		impl_->mainWindow_->setWindowTitle(title());
+		TraceProfiler::instance().markStartupComplete("First window shown");
 	}
 	impl_->firstTimeShow_ = false;
 	if (wait)
@@ -401,9 +412,17 @@ void QmlWindow::show(bool wait /* = false */)
 
 void QmlWindow::showMaximized(bool wait /* = false */)
 {
-	impl_->mainWindow_->setWindowModality(impl_->modalityFlag_);
+	{
+		TRACE_ZONE("Show window", "qt");
+		impl_->mainWindow_->setWindowModality(impl_->modalityFlag_);
+		impl_->mainWindow_->showMaximized();
+	}
 
-	impl_->mainWindow_->showMaximized();
+	// Marked once the zone has ended, so that the zone is in the written trace
+	if (impl_->firstTimeShow_)
+	{
+		TraceProfiler::instance().markStartupComplete("First window shown");
+	}
 	impl_->firstTimeShow_ = false;
 	if (wait)
 	{
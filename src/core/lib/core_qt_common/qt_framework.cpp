@@ -29,6 +29,7 @@
 
 #include "core_common/assert.hpp"
 #include "core_common/platform_env.hpp"
+#include "core_common/scoped_stop_watch.hpp"
 
 #include "core_generic_plugin/interfaces/i_component_context.hpp"
 #include "core_generic_plugin/interfaces/i_plugin_context_manager.hpp"
@@ -46,6 +47,7 @@
 
 #include "core_logging/logging.hpp"
 #include "core_logging_system/interfaces/i_logging_system.hpp"
+#include "editor_interaction/i_background_worker.hpp"
 
 #include "qt_action_manager.hpp"
 
@@ -64,6 +66,7 @@
 #include <thread>
 #include <array>
 #include <algorithm>
+#include <mutex>
 
 #include <QApplication>
 #include <QFile>
@@ -80,7 +83,9 @@
 #include <QClipboard>
 #include <QDesktopServices>
 #include <QSystemTrayIcon>
+#include <QStandardPaths>
 #include "core_serialization_xml/simple_api_for_xml.hpp"
+#include "qt_thumbnail_cache.hpp"
 #include "qt_thumbnail_provider.hpp"
 #include "core_ui_framework/i_thumbnail_provider.hpp"
 
@@ -191,6 +196,15 @@ std::string explorerPath()
 const std::string ROOT = "Icons";
 const std::string ICON = "icon";
 
+// Files that are decoded as images when no thumbnail provider serves them
+bool isImageFile(const char* filePath)
+{
+	auto extension = FilePath::getExtension(filePath);
+	std::transform(extension.begin(), extension.end(), extension.begin(), ::tolower);
+	static std::set<std::string> extensions = { "bmp", "gif", "jpg", "jpeg", "png", "pbm", "pgm", "ppm", "xbm", "xpm"};
+	return extensions.find(extension) != extensions.end();
+}
+
 struct IconData
 {
 	std::string id_;
@@ -267,10 +281,12 @@ enum ModelessDialogType
 	CONNECTION
 };
 
-struct QtFramework::Impl : public Depends<ICommandManager, IUIApplication, IViewCreator,
-                                          IPluginContextManager, IUIFramework, IDefinitionManager, ILoggingSystem>
+struct QtFramework::Impl : public Depends<ICommandManager, IUIApplication, IViewCreator, IPluginContextManager,
+                                          IUIFramework, IDefinitionManager, ILoggingSystem, IBackgroundWorker>
 	, public ContextCallBackHelper
 {
+	typedef std::vector<std::shared_ptr<IThumbnailProvider>> ThumbnailProviders;
+
 	Impl()
 	{
 		registerCallback([ this ](IDefinitionManager & defManager)
@@ -278,20 +294,65 @@ struct QtFramework::Impl : public Depends<ICommandManager, IUIApplication, IView
 			ReflectionAutoRegistration::initAutoRegistration(defManager);
 			actionManager_ = std::make_unique<QtActionManager>();
 		});
+
+		const QString cacheLocation = QStandardPaths::writableLocation(QStandardPaths::CacheLocation);
+		thumbnailCache_ = std::make_unique<QtThumbnailCache>(
+		[this](const QString& filePath, QImage& o_Image) { return loadImage(filePath, o_Image); },
+		[this]() { return get<IBackgroundWorker>(); },
+		cacheLocation.isEmpty() ? QString() : cacheLocation + "/thumbnails");
 	}
 
 	void finalise()
 	{
+		// Waits for the loads in flight, which use the thumbnail providers
+		thumbnailCache_->clear();
 		actionManager_.reset();
 		iconData_.clear();
+		std::lock_guard<std::mutex> lock(thumbnailProvidersMutex_);
 		thumbnailProviders_.clear();
-		thumbnailCache_.clear();
+	}
+
+	// Copied so providers are never called while holding the lock
+	ThumbnailProviders getThumbnailProviders() const
+	{
+		ThumbnailProviders providers;
+		std::lock_guard<std::mutex> lock(thumbnailProvidersMutex_);
+		for (auto& it : thumbnailProviders_)
+		{
+			if (auto provider = it.lock())
+			{
+				providers.push_back(provider);
+			}
+		}
+		return providers;
+	}
+
+	// Loads the full image on the calling thread, may be called from background threads
+	bool loadImage(const QString& filePath, QImage& o_Image) const
+	{
+		std::string path = filePath.toUtf8().constData();
+		for (auto& provider : getThumbnailProviders())
+		{
+			int width, height, rowPitch;
+			BinaryBlock imageBlock;
+			if (provider->getThumbnailData(path.c_str(), &width, &height, &rowPitch, &imageBlock))
+			{
+				// Copied as the image doesn't own the block's data
+				o_Image = QImage(reinterpret_cast<const uchar*>(imageBlock.data()), width, height, rowPitch,
+				                 QImage::Format_RGB32).copy();
+				return true;
+			}
+		}
+
+		// Fails for files that no longer exist
+		return QtFramework_Locals::isImageFile(path.c_str()) && o_Image.load(filePath);
 	}
 
 	std::unique_ptr<ActionManager> actionManager_;
 	std::unordered_map<std::string, std::unique_ptr<QtFramework_Locals::IconData>> iconData_;
+	mutable std::mutex thumbnailProvidersMutex_;
 	std::set<std::weak_ptr<IThumbnailProvider>, std::owner_less<std::weak_ptr<IThumbnailProvider>>> thumbnailProviders_;
-	QHash<QString, QImage> thumbnailCache_;
+	std::unique_ptr<QtThumbnailCache> thumbnailCache_;
 };
 
 //// Ensure the QtFileDialogOptions enumeration matches so we can do a simple cast
@@ -316,8 +377,12 @@ static_assert(IUIFramework::QtFileDialogOptions::DontUseCustomDirectoryIcons ==
 QtFramework::QtFramework(IComponentContext& contextManager)
     : impl_(new Impl()), qmlWatcher_(new QFileSystemWatcher()), context_(contextManager), worker_(new QtUIWorker())
 {
-	qtFrameworkBase_.reset(new QtFrameworkCommon(std::make_unique<QQmlEngine>(), std::make_unique<QtScriptingEngine>(),
-	                                             impl_->get<IDefinitionManager>()));
+	{
+		TRACE_ZONE("Create QML engine", "qt");
+		qtFrameworkBase_.reset(new QtFrameworkCommon(std::make_unique<QQmlEngine>(),
+		                                             std::make_unique<QtScriptingEngine>(),
+		                                             impl_->get<IDefinitionManager>()));
+	}
 
 	interfaces_.push_back(contextManager.registerInterface(new QtHelpers));
 	interfaces_.push_back(contextManager.registerInterface(impl_->actionManager_.get(), false));
@@ -351,6 +416,8 @@ void QtFramework::initialise(IComponentContext& contextManager)
 	qmlEngine()->addImageProvider(QtImageProvider::providerId(), new QtImageProvider());
 	qmlEngine()->addImageProvider(QtImageProviderOld::providerId(), new QtImageProviderOld());
 	qmlEngine()->addImageProvider(QtThumbnailProvider::providerId(), new QtThumbnailProvider(*this));
+	qmlEngine()->addImageProvider(QtThumbnailProvider::previewProviderId(),
+	                              new QtThumbnailProvider(*this, QtThumbnailProvider::Mode::Preview));
 
 #if defined( _WIN32 )
 	// QQmlEngine::addImageProvider takes ownership
@@ -444,6 +511,7 @@ void QtFramework::finalise()
 	unregisterResources();
 	impl_->actionManager_->fini();
 	shortcutDialog_ = nullptr;
+	qmlEngine()->removeImageProvider(QtThumbnailProvider::previewProviderId());
 	qmlEngine()->removeImageProvider(QtThumbnailProvider::providerId());
 	qmlEngine()->removeImageProvider(QtImageProviderOld::providerId());
 	qmlEngine()->removeImageProvider(QtImageProvider::providerId());
@@ -467,42 +535,22 @@ void QtFramework::finalise()
 
 QImage QtFramework::requestThumbnail(const QString& filePath, const QSize& requestedSize)
 {
-	auto&& it = impl_->thumbnailCache_.find(filePath);
-	if (it != impl_->thumbnailCache_.end())
+	// Models only show thumbnails once loadThumbnail has them in memory, so this rarely has to load
+	QImage image = impl_->thumbnailCache_->get(filePath);
+	if (image.isNull())
 	{
-		return requestedSize.isValid() ? it.value().scaled(requestedSize) : it.value();
+		return QImage(requestedSize.width(), requestedSize.height(), QImage::Format_ARGB32);
 	}
-	
+	return requestedSize.isValid() ? image.scaled(requestedSize) : image;
+}
+
+QImage QtFramework::requestPreviewImage(const QString& filePath, const QSize& requestedSize)
+{
 	QImage image;
-	std::string path = filePath.toUtf8().constData();
-	bool bOk = false;
-	for (auto&& it : impl_->thumbnailProviders_)
-	{
-		if (it.expired())
-		{
-			continue;
-		}
-		auto provider = it.lock();
-		TF_ASSERT(provider != nullptr);
-		int width, height, rowPitch;
-		BinaryBlock imageBlock;
-		if (provider->getThumbnailData(path.c_str(), &width, &height, &rowPitch, &imageBlock))
-		{
-			bOk = true;
-			QImage img(reinterpret_cast<const uchar*>(imageBlock.data()), width, height, rowPitch, QImage::Format_RGB32);
-			image.swap(img);
-			break;
-		}
-	}
-	if (!bOk)
-	{
-		bOk = image.load(filePath);
-	}
-	if (!bOk)
+	if (!impl_->loadImage(filePath, image))
 	{
 		return QImage(requestedSize.width(), requestedSize.height(), QImage::Format_ARGB32);
 	}
-	impl_->thumbnailCache_[filePath] = image;
 	return requestedSize.isValid() ? image.scaled(requestedSize) : image;
 }
 
@@ -1662,6 +1710,7 @@ Connection QtFramework::connectPaletteThemeChanged(PaletteThemeChangedCallback c
 
 void QtFramework::registerThumbnailProvider(std::shared_ptr<IThumbnailProvider> thumbnailProvider)
 {
+	std::lock_guard<std::mutex> lock(impl_->thumbnailProvidersMutex_);
 	if (impl_->thumbnailProviders_.find(thumbnailProvider) != impl_->thumbnailProviders_.end())
 	{
 		return;
@@ -1671,28 +1720,25 @@ void QtFramework::registerThumbnailProvider(std::shared_ptr<IThumbnailProvider>
 
 bool QtFramework::hasThumbnail(const char* filePath) const
 {
-	for (auto&& it : impl_->thumbnailProviders_)
+	for (auto& provider : impl_->getThumbnailProviders())
 	{
-		if (it.expired())
-		{
-			continue;
-		}
-		auto provider = it.lock();
-		TF_ASSERT(provider != nullptr);
 		if (provider->getThumbnailData(filePath))
 		{
 			return true;
 		}
 	}
 
-	auto extension = FilePath::getExtension(filePath);
-	std::transform(extension.begin(), extension.end(), extension.begin(), ::tolower);
-	static std::set<std::string> extensions = { "bmp", "gif", "jpg", "jpeg", "png", "pbm", "pgm", "ppm", "xbm", "xpm"};
-	if (extensions.find(extension) == extensions.end())
-	{
-		return false;
-	}
-	return QFile::exists(filePath);
+	return QtFramework_Locals::isImageFile(filePath) && QFile::exists(filePath);
+}
+
+bool QtFramework::loadThumbnail(const char* filePath, uint64_t modified, uint64_t size)
+{
+	return impl_->thumbnailCache_->request(QString::fromUtf8(filePath), QtThumbnailCache::FileVersion(modified, size));
+}
+
+Connection QtFramework::connectThumbnailLoaded(ThumbnailLoadedCallback callback)
+{
+	return impl_->thumbnailCache_->connectThumbnailLoaded(callback);
 }
 
 void QtFramework::makeFakeMouseRelease()
@@ -57,6 +57,7 @@ public:
 	void finalise();
 
 	QImage requestThumbnail(const QString& filePath, const QSize& requestedSize);
+	QImage requestPreviewImage(const QString& filePath, const QSize& requestedSize);
 
 	// IQtFramework
 	QQmlEngine* qmlEngine() const override;
@@ -233,6 +234,8 @@ public:
 	virtual const char* getIconUrlFromImageProvider(const char* key) const override;
 	virtual void registerThumbnailProvider(std::shared_ptr<IThumbnailProvider> thumbnailProvider) override;
 	virtual bool hasThumbnail(const char* filePath) const override;
+	virtual bool loadThumbnail(const char* filePath, uint64_t modified = 0, uint64_t size = 0) override;
+	virtual Connection connectThumbnailLoaded(ThumbnailLoadedCallback callback) override;
 	virtual void iterateDialogs(std::function<void(const IDialog& dialog)> fn) override;
 
 	virtual Connection connectPaletteThemeChanged(PaletteThemeChangedCallback cb) override;
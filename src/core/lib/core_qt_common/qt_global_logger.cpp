@@ -42,7 +42,7 @@ void QtGlobalLogger::messageHandler(QtMsgType type, const QMessageLogContext &co
 	}
 	if (loggingSystem_)
 	{
-		loggingSystem_->log(LOG_DEBUG, msg.toUtf8().constData());
+		loggingSystem_->log(LOG_DEBUG, "%s", msg.toUtf8().constData());
 	}
 }
 
@@ -0,0 +1,365 @@
+#include "qt_thumbnail_cache.hpp"
+
+#include "editor_interaction/i_background_worker.hpp"
+
+#include <QCryptographicHash>
+#include <QDateTime>
+#include <QDir>
+#include <QFileInfo>
+#include <QHash>
+#include <QSaveFile>
+#include <list>
+#include <mutex>
+
+namespace wgt
+{
+namespace
+{
+// Loads that haven't started are cancelled past this many, the oldest first,
+// so scrolling through a large folder only decodes what was requested last.
+const int MAX_PENDING_LOADS = 256;
+
+const char* DISK_CACHE_FORMAT = "PNG";
+
+size_t getByteCount(const QImage& image)
+{
+	return static_cast<size_t>(image.byteCount());
+}
+}
+
+//==============================================================================
+struct QtThumbnailCache::Impl : public std::enable_shared_from_this<Impl>
+{
+	struct Entry
+	{
+		QString filePath_;
+		FileVersion version_;
+		QImage image_;
+	};
+	typedef std::list<Entry> Entries;
+	typedef std::list<QString> PendingOrder;
+
+	struct PendingLoad
+	{
+		BackgroundJobPtr job_;
+		PendingOrder::iterator order_;
+		FileVersion version_;
+	};
+
+	Impl(LoadFunction loadFunction, WorkerGetter workerGetter, const QString& cacheDirectory, size_t memoryBudget)
+		: loadFunction_(loadFunction)
+		, workerGetter_(workerGetter)
+		, cacheDirectory_(cacheDirectory)
+		, memoryBudget_(memoryBudget)
+		, memoryUsage_(0)
+	{
+		if (!cacheDirectory_.isEmpty())
+		{
+			QDir().mkpath(cacheDirectory_);
+		}
+	}
+
+	// Called while holding mutex_. A thumbnail of another version of the file is not found, unless version is null.
+	bool find(const QString& filePath, const FileVersion* version, QImage* o_Image)
+	{
+		auto it = entriesByPath_.find(filePath);
+		if (it == entriesByPath_.end() || (version != nullptr && it.value()->version_ != *version))
+		{
+			return false;
+		}
+		entries_.splice(entries_.begin(), entries_, it.value());
+		if (o_Image != nullptr)
+		{
+			*o_Image = it.value()->image_;
+		}
+		return true;
+	}
+
+	// Called while holding mutex_
+	void remove(const QString& filePath)
+	{
+		auto it = entriesByPath_.find(filePath);
+		if (it != entriesByPath_.end())
+		{
+			memoryUsage_ -= getByteCount(it.value()->image_);
+			entries_.erase(it.value());
+			entriesByPath_.erase(it);
+		}
+	}
+
+	// Called while holding mutex_. Replaces the thumbnail of any other version of the file.
+	void insert(const QString& filePath, const FileVersion& version, const QImage& image)
+	{
+		remove(filePath);
+		failed_.remove(filePath);
+		entries_.push_front(Entry{ filePath, version, image });
+		entriesByPath_.insert(filePath, entries_.begin());
+		memoryUsage_ += getByteCount(image);
+
+		while (memoryUsage_ > memoryBudget_ && entries_.size() > 1)
+		{
+			auto& last = entries_.back();
+			memoryUsage_ -= getByteCount(last.image_);
+			entriesByPath_.remove(last.filePath_);
+			entries_.pop_back();
+		}
+	}
+
+	// Called while holding mutex_
+	void removePending(const QString& filePath, bool cancel)
+	{
+		auto it = pending_.find(filePath);
+		if (it == pending_.end())
+		{
+			return;
+		}
+		if (cancel)
+		{
+			it.value().job_->cancel();
+		}
+		pendingOrder_.erase(it.value().order_);
+		pending_.erase(it);
+	}
+
+	QString getDiskCachePath(const QString& filePath) const
+	{
+		if (cacheDirectory_.isEmpty())
+		{
+			return QString();
+		}
+
+		// Thumbnail providers may serve paths that aren't files, those are only cached in memory
+		QFileInfo info(filePath);
+		if (!info.exists())
+		{
+			return QString();
+		}
+
+		const QString key = info.absoluteFilePath() + '|' + QString::number(info.lastModified().toMSecsSinceEpoch()) +
+		'|' + QString::number(info.size());
+		return cacheDirectory_ + '/' + QCryptographicHash::hash(key.toUtf8(), QCryptographicHash::Md5).toHex() + ".png";
+	}
+
+	// Reads the disk cache or decodes the file, without touching the memory cache
+	bool load(const QString& filePath, QImage& o_Image) const
+	{
+		const QString diskCachePath = getDiskCachePath(filePath);
+		if (!diskCachePath.isEmpty() && o_Image.load(diskCachePath, DISK_CACHE_FORMAT))
+		{
+			return true;
+		}
+
+		QImage image;
+		if (!loadFunction_(filePath, image) || image.isNull())
+		{
+			return false;
+		}
+		if (image.width() > THUMBNAIL_SIZE || image.height() > THUMBNAIL_SIZE)
+		{
+			image = image.scaled(THUMBNAIL_SIZE, THUMBNAIL_SIZE, Qt::KeepAspectRatio, Qt::SmoothTransformation);
+		}
+
+		if (!diskCachePath.isEmpty())
+		{
+			// Only replaces the file once it is complete, other editors may share the cache
+			QSaveFile file(diskCachePath);
+			if (file.open(QIODevice::WriteOnly) && image.save(&file, DISK_CACHE_FORMAT))
+			{
+				file.commit();
+			}
+		}
+
+		o_Image = image;
+		return true;
+	}
+
+	// Loads the thumbnail, or its failure, into memory
+	QImage loadVersion(const QString& filePath, const FileVersion& version)
+	{
+		QImage image;
+		const bool loaded = load(filePath, image);
+		std::lock_guard<std::mutex> lock(mutex_);
+		if (loaded)
+		{
+			insert(filePath, version, image);
+		}
+		else
+		{
+			remove(filePath);
+			failed_.insert(filePath, version);
+		}
+		return image;
+	}
+
+	QImage get(const QString& filePath)
+	{
+		{
+			QImage image;
+			std::lock_guard<std::mutex> lock(mutex_);
+			if (find(filePath, nullptr, &image) || failed_.contains(filePath))
+			{
+				return image;
+			}
+		}
+		return loadVersion(filePath, FileVersion());
+	}
+
+	bool request(const QString& filePath, const FileVersion& version)
+	{
+		{
+			std::lock_guard<std::mutex> lock(mutex_);
+			if (find(filePath, &version, nullptr))
+			{
+				return true;
+			}
+
+			auto failedIt = failed_.find(filePath);
+			if (failedIt != failed_.end() && failedIt.value() == version)
+			{
+				return false;
+			}
+
+			auto pendingIt = pending_.find(filePath);
+			if (pendingIt != pending_.end())
+			{
+				if (pendingIt.value().version_ == version)
+				{
+					return false;
+				}
+				removePending(filePath, true);
+			}
+		}
+
+		auto worker = workerGetter_ ? workerGetter_() : nullptr;
+		if (worker == nullptr)
+		{
+			return !loadVersion(filePath, version).isNull();
+		}
+
+		auto self = shared_from_this();
+		auto loadJob = worker->queueJob([self, filePath, version](const IBackgroundJob&) {
+			self->loadVersion(filePath, version);
+		}, IBackgroundWorker::JobPriority::Low);
+
+		// Skipped along with the load if it is cancelled
+		worker->queueForegroundJob(
+		[self, filePath, version](const IBackgroundJob&) { self->loaded(filePath, version); },
+		IBackgroundWorker::JobDependencies(1, loadJob));
+
+		std::lock_guard<std::mutex> lock(mutex_);
+		PendingLoad pendingLoad = { loadJob, pendingOrder_.insert(pendingOrder_.end(), filePath), version };
+		pending_.insert(filePath, pendingLoad);
+		while (pending_.size() > MAX_PENDING_LOADS)
+		{
+			removePending(pendingOrder_.front(), true);
+		}
+		return false;
+	}
+
+	void loaded(const QString& filePath, const FileVersion& version)
+	{
+		{
+			std::lock_guard<std::mutex> lock(mutex_);
+			auto pendingIt = pending_.find(filePath);
+			if (pendingIt != pending_.end() && pendingIt.value().version_ == version)
+			{
+				removePending(filePath, false);
+			}
+
+			// Nothing to show if it failed, was evicted already or another version has replaced it
+			if (!find(filePath, &version, nullptr))
+			{
+				return;
+			}
+		}
+
+		const QByteArray path = filePath.toUtf8();
+		thumbnailLoaded_(path.constData());
+	}
+
+	void clear()
+	{
+		std::vector<BackgroundJobPtr> jobs;
+		{
+			std::lock_guard<std::mutex> lock(mutex_);
+			for (auto& pendingLoad : pending_)
+			{
+				pendingLoad.job_->cancel();
+				jobs.push_back(pendingLoad.job_);
+			}
+			pending_.clear();
+			pendingOrder_.clear();
+		}
+
+		// Loads that already started still call loadFunction_, which may not outlive this
+		for (auto& job : jobs)
+		{
+			job->wait();
+		}
+
+		std::lock_guard<std::mutex> lock(mutex_);
+		entriesByPath_.clear();
+		entries_.clear();
+		failed_.clear();
+		memoryUsage_ = 0;
+	}
+
+	const LoadFunction loadFunction_;
+	const WorkerGetter workerGetter_;
+	const QString cacheDirectory_;
+	const size_t memoryBudget_;
+	Signal<ThumbnailLoaded> thumbnailLoaded_;
+
+	mutable std::mutex mutex_;
+	Entries entries_; // Most recently used first
+	QHash<QString, Entries::iterator> entriesByPath_;
+	size_t memoryUsage_;
+	QHash<QString, FileVersion> failed_;
+	QHash<QString, PendingLoad> pending_;
+	PendingOrder pendingOrder_; // Oldest first
+};
+
+//==============================================================================
+QtThumbnailCache::QtThumbnailCache(LoadFunction loadFunction, WorkerGetter workerGetter,
+                                   const QString& cacheDirectory, size_t memoryBudget)
+	: impl_(std::make_shared<Impl>(loadFunction, workerGetter, cacheDirectory, memoryBudget))
+{
+}
+
+//==============================================================================
+QtThumbnailCache::~QtThumbnailCache()
+{
+	impl_->clear();
+}
+
+//==============================================================================
+bool QtThumbnailCache::request(const QString& filePath, const FileVersion& version)
+{
+	return impl_->request(filePath, version);
+}
+
+//==============================================================================
+QImage QtThumbnailCache::get(const QString& filePath)
+{
+	return impl_->get(filePath);
+}
+
+//==============================================================================
+void QtThumbnailCache::clear()
+{
+	impl_->clear();
+}
+
+//==============================================================================
+size_t QtThumbnailCache::getMemoryUsage() const
+{
+	std::lock_guard<std::mutex> lock(impl_->mutex_);
+	return impl_->memoryUsage_;
+}
+
+//==============================================================================
+Connection QtThumbnailCache::connectThumbnailLoaded(ThumbnailLoadedCallback callback)
+{
+	return impl_->thumbnailLoaded_.connect(callback);
+}
+} // end namespace wgt
@@ -0,0 +1,80 @@
+#ifndef QT_THUMBNAIL_CACHE_HPP
+#define QT_THUMBNAIL_CACHE_HPP
+
+#include "core_common/signal.hpp"
+
+#include <QImage>
+#include <QString>
+#include <cstdint>
+#include <functional>
+#include <memory>
+
+namespace wgt
+{
+class IBackgroundWorker;
+
+/**
+* Caches thumbnails in memory, bounded by a budget in bytes and evicting the least recently used,
+* and on disk, keyed by the file's path, modification time and size.
+* Memory holds one version of each file, the one it was last requested for.
+* Thumbnails that aren't cached are decoded on background workers.
+*/
+class QtThumbnailCache
+{
+public:
+	/** Decodes the full image for a file, called on background threads. */
+	typedef std::function<bool(const QString& filePath, QImage& o_Image)> LoadFunction;
+	typedef std::function<IBackgroundWorker*()> WorkerGetter;
+	typedef void ThumbnailLoaded(const char* filePath);
+	typedef std::function<ThumbnailLoaded> ThumbnailLoadedCallback;
+
+	static const int THUMBNAIL_SIZE = 256;
+
+	/** The modification time and size of a file, as the caller knows them. */
+	struct FileVersion
+	{
+		FileVersion(uint64_t modified = 0, uint64_t size = 0) : modified_(modified), size_(size)
+		{
+		}
+
+		bool operator==(const FileVersion& other) const
+		{
+			return modified_ == other.modified_ && size_ == other.size_;
+		}
+
+		bool operator!=(const FileVersion& other) const
+		{
+			return !(*this == other);
+		}
+
+		uint64_t modified_;
+		uint64_t size_;
+	};
+
+	/** An empty cacheDirectory disables the disk cache. Without a worker thumbnails are loaded on the calling thread. */
+	QtThumbnailCache(LoadFunction loadFunction, WorkerGetter workerGetter, const QString& cacheDirectory,
+	                 size_t memoryBudget = 64 * 1024 * 1024);
+	~QtThumbnailCache();
+
+	/** Returns true if the thumbnail of this version of the file is in memory, without blocking.
+	Otherwise queues it to load and calls the loaded callbacks on the foreground thread once it has,
+	unless the file has no thumbnail. A thumbnail held for another version is replaced once it loads. */
+	bool request(const QString& filePath, const FileVersion& version = FileVersion());
+
+	/** Returns the thumbnail last requested for the file, loading it on the calling thread if it isn't in memory.
+	Returns a null image if the file has no thumbnail. Safe to call from any thread. */
+	QImage get(const QString& filePath);
+
+	/** Forgets the thumbnails held in memory and cancels pending loads, keeping the disk cache. */
+	void clear();
+
+	size_t getMemoryUsage() const;
+
+	Connection connectThumbnailLoaded(ThumbnailLoadedCallback callback);
+
+private:
+	struct Impl;
+	std::shared_ptr<Impl> impl_;
+};
+} // end namespace wgt
+#endif
@@ -3,9 +3,10 @@
 
 namespace wgt
 {
-QtThumbnailProvider::QtThumbnailProvider(QtFramework& qtFramework)
+QtThumbnailProvider::QtThumbnailProvider(QtFramework& qtFramework, Mode mode)
 	: QQuickImageProvider(ImageType::Image)
 	, qtFramework_(qtFramework)
+	, mode_(mode)
 {
 }
 
@@ -15,11 +16,17 @@ QImage QtThumbnailProvider::requestImage(const QString& id, QSize* size, const Q
 	{
 		*size = requestedSize;
 	}
-	return qtFramework_.requestThumbnail(id, requestedSize);
+	return mode_ == Mode::Preview ? qtFramework_.requestPreviewImage(id, requestedSize) :
+	                                qtFramework_.requestThumbnail(id, requestedSize);
 }
 
 const char* QtThumbnailProvider::providerId()
 {
 	return "QtThumbnailProvider";
 }
+
+const char* QtThumbnailProvider::previewProviderId()
+{
+	return "QtImagePreviewProvider";
+}
 } // end namespace wgt
@@ -11,12 +11,20 @@ class QtFramework;
 class QtThumbnailProvider : public QQuickImageProvider
 {
 public:
-	QtThumbnailProvider(QtFramework& qtFramework);
+	enum class Mode
+	{
+		Thumbnail, // Cached and bounded to QtThumbnailCache::THUMBNAIL_SIZE
+		Preview // The full image, loaded on request
+	};
+
+	QtThumbnailProvider(QtFramework& qtFramework, Mode mode = Mode::Thumbnail);
 	QImage requestImage(const QString& id, QSize* size, const QSize& requestedSize) override;
 
 	static const char* providerId();
+	static const char* previewProviderId();
 private:
 	QtFramework& qtFramework_;
+	const Mode mode_;
 };
 } // end namespace wgt
 #endif
@@ -1,6 +1,8 @@
 #include "qt_window.hpp"
 
 #include "core_common/assert.hpp"
+#include "core_common/scoped_stop_watch.hpp"
+#include "core_common/trace_profiler.hpp"
 #include "core_qt_common/qt_palette.hpp"
 #include "core_logging/logging.hpp"
 #include "core_reflection/property_accessor.hpp"
@@ -577,16 +579,25 @@ struct QtWindow::Impl : Depends<IQtFramework, IUIApplication>
 		{
 			return;
 		}
-		mainWindow_->setWindowModality(modalityFlag_);
-		if (firstTimeShow_ && isMaximizedInPreference_)
 		{
-			mainWindow_->setWindowState(Qt::WindowMaximized);
+			TRACE_ZONE("Show window", "qt");
+			mainWindow_->setWindowModality(modalityFlag_);
+			if (firstTimeShow_ && isMaximizedInPreference_)
+			{
+				mainWindow_->setWindowState(Qt::WindowMaximized);
+			}
+			mainWindow_->show();
+
+			if (firstTimeShow_)
+			{
+				emit window_.windowReady();
+			}
 		}
-		mainWindow_->show();
 
+		// Marked once the zone has ended, so that the zone is in the written trace
 		if (firstTimeShow_)
 		{
-			emit window_.windowReady();
+			TraceProfiler::instance().markStartupComplete("First window shown");
 		}
 		firstTimeShow_ = false;
 		if (wait)
@@ -601,13 +612,22 @@ struct QtWindow::Impl : Depends<IQtFramework, IUIApplication>
 		{
 			return;
 		}
-		mainWindow_->setWindowModality(modalityFlag_);
+		{
+			TRACE_ZONE("Show window", "qt");
+			mainWindow_->setWindowModality(modalityFlag_);
 
-		mainWindow_->showMaximized();
+			mainWindow_->showMaximized();
 
+			if (firstTimeShow_)
+			{
+				emit window_.windowReady();
+			}
+		}
+
+		// Marked once the zone has ended, so that the zone is in the written trace
 		if (firstTimeShow_)
 		{
-			emit window_.windowReady();
+			TraceProfiler::instance().markStartupComplete("First window shown");
 		}
 		firstTimeShow_ = false;
 		if (wait)
@@ -0,0 +1,335 @@
+#include "pch.hpp"
+
+#include "core_unit_test/unit_test.hpp"
+#include "core_qt_common/models/wg_multi_edit_proxy.hpp"
+#include "core_qt_common/models/role_provider.hpp"
+
+#include <map>
+#include <memory>
+#include <random>
+#include <set>
+#include <string>
+#include <vector>
+#include <QStandardItemModel>
+
+namespace wgt
+{
+namespace
+{
+typedef std::vector<QStandardItem*> Items;
+
+struct ProxyRoles
+{
+	ProxyRoles(const WGMultiEditProxy& proxy) : key_(-1), value_(-1), multipleValues_(-1)
+	{
+		// The proxy gives the source roles its own ids, so look them up by name
+		auto names = proxy.roleNames();
+		for (auto it = names.begin(); it != names.end(); ++it)
+		{
+			if (it.value() == "key")
+			{
+				key_ = it.key();
+			}
+			else if (it.value() == "value")
+			{
+				value_ = it.key();
+			}
+			else if (it.value() == "multipleValues")
+			{
+				multipleValues_ = it.key();
+			}
+		}
+	}
+
+	int key_;
+	int value_;
+	int multipleValues_;
+};
+
+int keyRole()
+{
+	return RoleProvider::convertRole("key");
+}
+
+int valueRole()
+{
+	return RoleProvider::convertRole("value");
+}
+
+QStandardItemModel* createModel()
+{
+	auto model = new QStandardItemModel();
+	QHash<int, QByteArray> roleNames;
+	roleNames[keyRole()] = "key";
+	roleNames[valueRole()] = "value";
+	roleNames[RoleProvider::convertRole("multipleValues")] = "multipleValues";
+	model->setItemRoleNames(roleNames);
+	return model;
+}
+
+QStandardItem* createItem(const std::string& key, const std::string& value)
+{
+	auto item = new QStandardItem();
+	item->setData(QString::fromStdString(key), keyRole());
+	item->setData(QString::fromStdString(value), valueRole());
+	return item;
+}
+
+std::string getKey(const QStandardItem* item)
+{
+	return item->data(keyRole()).toString().toStdString();
+}
+
+void setMergeKey(WGMultiEditProxy& proxy)
+{
+	QList<QString> mergeKeys;
+	mergeKeys.push_back("key");
+	proxy.setProperty("mergeKeys", QVariant::fromValue(mergeKeys));
+}
+
+// Merges the children of the source parents by brute force and compares them with the proxy's rows below the
+// proxy parent, down to the given depth. A model's first row with a key represents it in the merged row.
+bool matchesMerge(WGMultiEditProxy& proxy, const ProxyRoles& roles, const QModelIndex& proxyParent,
+                  const Items& sourceParents, int depth)
+{
+	std::map<std::string, Items> expected;
+	for (auto parent : sourceParents)
+	{
+		std::set<std::string> keys;
+		for (int row = 0; row < parent->rowCount(); ++row)
+		{
+			auto child = parent->child(row);
+			if (keys.insert(getKey(child)).second)
+			{
+				expected[getKey(child)].push_back(child);
+			}
+		}
+	}
+
+	const int rowCount = proxy.rowCount(proxyParent);
+	if (rowCount != static_cast<int>(expected.size()))
+	{
+		return false;
+	}
+
+	std::set<std::string> seen;
+	for (int row = 0; row < rowCount; ++row)
+	{
+		auto index = proxy.index(row, 0, proxyParent);
+		if (proxy.parent(index) != proxyParent)
+		{
+			return false;
+		}
+
+		const std::string key = proxy.data(index, roles.key_).toString().toStdString();
+		auto found = expected.find(key);
+		if (found == expected.end() || !seen.insert(key).second)
+		{
+			return false;
+		}
+
+		auto& items = found->second;
+		QVariant value = items.front()->data(valueRole());
+		for (auto item : items)
+		{
+			if (item->data(valueRole()) != value)
+			{
+				value = QVariant();
+			}
+		}
+		if (proxy.data(index, roles.value_) != value ||
+		    proxy.data(index, roles.multipleValues_) != QVariant(items.size() > 1))
+		{
+			return false;
+		}
+
+		if (depth > 0 && !matchesMerge(proxy, roles, index, items, depth - 1))
+		{
+			return false;
+		}
+	}
+	return true;
+}
+
+class RandomTrees
+{
+public:
+	RandomTrees(unsigned int seed) : random_(seed)
+	{
+	}
+
+	int next(int count)
+	{
+		return static_cast<int>(random_() % count);
+	}
+
+	// A key that none of the parent's children use
+	std::string freshKey(QStandardItem* parent)
+	{
+		for (int attempt = 0;; ++attempt)
+		{
+			const std::string key = "k" + std::to_string(next(8 + attempt));
+			bool used = false;
+			for (int row = 0; row < parent->rowCount(); ++row)
+			{
+				used = used || getKey(parent->child(row)) == key;
+			}
+			if (!used)
+			{
+				return key;
+			}
+		}
+	}
+
+	void addChildren(QStandardItem* parent, int depth)
+	{
+		const int count = depth > 0 ? next(5) : 0;
+		for (int i = 0; i < count; ++i)
+		{
+			auto child = createItem(freshKey(parent), std::to_string(next(2)));
+			addChildren(child, depth - 1);
+			parent->appendRow(child);
+		}
+	}
+
+	QStandardItem* pickItem(QStandardItemModel& model)
+	{
+		auto item = model.invisibleRootItem();
+		while (item->rowCount() > 0 && next(2) != 0)
+		{
+			item = item->child(next(item->rowCount()));
+		}
+		return item;
+	}
+
+private:
+	std::mt19937 random_;
+};
+}
+
+TEST(multi_edit_proxy_duplicate_keys)
+{
+	std::unique_ptr<QStandardItemModel> first(createModel());
+	first->appendRow(createItem("a", "1"));
+	first->appendRow(createItem("a", "2"));
+	first->appendRow(createItem("b", "1"));
+	std::unique_ptr<QStandardItemModel> second(createModel());
+	second->appendRow(createItem("a", "1"));
+
+	WGMultiEditProxy proxy;
+	setMergeKey(proxy);
+	proxy.addModel(first.get());
+	ProxyRoles roles(proxy);
+
+	// The first row with a key represents its model
+	CHECK_EQUAL(2, proxy.rowCount());
+	CHECK(proxy.data(proxy.index(0, 0), roles.value_) == QVariant(QString("1")));
+	CHECK(proxy.data(proxy.index(0, 0), roles.multipleValues_) == QVariant(false));
+
+	proxy.addModel(second.get());
+	CHECK_EQUAL(2, proxy.rowCount());
+	CHECK(proxy.data(proxy.index(0, 0), roles.value_) == QVariant(QString("1")));
+	CHECK(proxy.data(proxy.index(0, 0), roles.multipleValues_) == QVariant(true));
+
+	// Removing the representative row falls back to the model's next row with the key
+	first->removeRow(0);
+	CHECK_EQUAL(2, proxy.rowCount());
+	CHECK(proxy.data(proxy.index(0, 0), roles.value_) == QVariant());
+	CHECK(proxy.data(proxy.index(0, 0), roles.multipleValues_) == QVariant(true));
+}
+
+TEST(multi_edit_proxy_random_changes)
+{
+	const int ITERATION_COUNT = 100;
+	const int CHANGE_COUNT = 60;
+	const int DEPTH = 3;
+
+	RandomTrees random(1);
+	for (int iteration = 0; iteration < ITERATION_COUNT; ++iteration)
+	{
+		std::vector<std::unique_ptr<QStandardItemModel>> models;
+		WGMultiEditProxy proxy;
+		setMergeKey(proxy);
+
+		const int modelCount = 1 + random.next(3);
+		for (int i = 0; i < modelCount; ++i)
+		{
+			models.emplace_back(createModel());
+			random.addChildren(models.back()->invisibleRootItem(), DEPTH);
+			proxy.addModel(models.back().get());
+		}
+		ProxyRoles roles(proxy);
+
+		auto sourceRoots = [&models]() {
+			Items roots;
+			for (auto& model : models)
+			{
+				roots.push_back(model->invisibleRootItem());
+			}
+			return roots;
+		};
+
+		// Mapping every row first checks that the proxy updates mapped rows in place
+		const bool mapAll = random.next(4) != 0;
+		if (mapAll)
+		{
+			CHECK(matchesMerge(proxy, roles, QModelIndex(), sourceRoots(), DEPTH));
+		}
+
+		bool matches = true;
+		for (int change = 0; change < CHANGE_COUNT && matches; ++change)
+		{
+			auto& model = *models[random.next(static_cast<int>(models.size()))];
+			auto item = random.pickItem(model);
+			auto parent = item->parent() != nullptr ? item->parent() : model.invisibleRootItem();
+			switch (random.next(5))
+			{
+			case 0:
+			case 1:
+			{
+				auto child = createItem(random.freshKey(item), std::to_string(random.next(2)));
+				random.addChildren(child, random.next(2));
+				item->insertRow(random.next(item->rowCount() + 1), child);
+				break;
+			}
+
+			case 2:
+				if (item->rowCount() > 0)
+				{
+					const int first = random.next(item->rowCount());
+					item->removeRows(first, 1 + random.next(item->rowCount() - first));
+				}
+				break;
+
+			case 3:
+				if (item != model.invisibleRootItem())
+				{
+					item->setData(QString::fromStdString(random.freshKey(parent)), keyRole());
+				}
+				break;
+
+			case 4:
+				if (item != model.invisibleRootItem())
+				{
+					item->setData(QString::fromStdString(std::to_string(random.next(2))), valueRole());
+				}
+				break;
+			}
+
+			if (mapAll || random.next(3) == 0)
+			{
+				matches = matchesMerge(proxy, roles, QModelIndex(), sourceRoots(), DEPTH + 1);
+			}
+		}
+		CHECK(matches);
+		CHECK(matchesMerge(proxy, roles, QModelIndex(), sourceRoots(), DEPTH + 2));
+
+		if (models.size() > 1)
+		{
+			proxy.removeModel(models.back().get());
+			models.pop_back();
+			CHECK(matchesMerge(proxy, roles, QModelIndex(), sourceRoots(), DEPTH + 2));
+		}
+	}
+}
+} // end namespace wgt
@@ -0,0 +1,192 @@
+#include "pch.hpp"
+
+#include "core_unit_test/unit_test.hpp"
+#include "core_qt_common/models/qt_item_model.hpp"
+#include "core_data_model/abstract_item_model.hpp"
+
+#include <algorithm>
+#include <vector>
+
+namespace wgt
+{
+namespace
+{
+// A flat model whose data signals are raised by the test
+class MockItemModel : public AbstractItemModel
+{
+public:
+	MockItemModel(int rowCount) : items_(rowCount)
+	{
+	}
+
+	void dataChanged(int row, ItemRole::Id roleId)
+	{
+		postItemDataChanged_(ItemIndex(row, 0), roleId, Variant());
+	}
+
+	void beginBatch()
+	{
+		preItemDataBatch_();
+	}
+
+	void endBatch()
+	{
+		postItemDataBatch_();
+	}
+
+	virtual AbstractItem* item(const ItemIndex& index) const override
+	{
+		const bool valid = index.parent_ == nullptr && index.row_ >= 0 && index.row_ < rowCount(nullptr);
+		return valid ? const_cast<AbstractItem*>(&items_[index.row_]) : nullptr;
+	}
+
+	virtual void index(const AbstractItem* item, ItemIndex& o_Index) const override
+	{
+		for (size_t row = 0; row < items_.size(); ++row)
+		{
+			if (&items_[row] == item)
+			{
+				o_Index = ItemIndex(static_cast<int>(row), 0);
+				return;
+			}
+		}
+		o_Index = ItemIndex();
+	}
+
+	virtual int rowCount(const AbstractItem* item) const override
+	{
+		return item == nullptr ? static_cast<int>(items_.size()) : 0;
+	}
+
+	virtual int columnCount(const AbstractItem* item) const override
+	{
+		return 1;
+	}
+
+	virtual void iterateRoles(const std::function<void(const char*)>& iterFunc) const override
+	{
+		iterFunc("value");
+	}
+
+	virtual Connection connectPostItemDataChanged(DataCallback callback) override
+	{
+		return postItemDataChanged_.connect(callback);
+	}
+
+	virtual Connection connectPreItemDataBatch(VoidCallback callback) override
+	{
+		return preItemDataBatch_.connect(callback);
+	}
+
+	virtual Connection connectPostItemDataBatch(VoidCallback callback) override
+	{
+		return postItemDataBatch_.connect(callback);
+	}
+
+private:
+	std::vector<AbstractItem> items_;
+	Signal<DataSignature> postItemDataChanged_;
+	Signal<VoidSignature> preItemDataBatch_;
+	Signal<VoidSignature> postItemDataBatch_;
+};
+
+struct DataChange
+{
+	int first_;
+	int last_;
+	QVector<int> roles_;
+};
+
+bool sameRoles(QVector<int> a, QVector<int> b)
+{
+	std::sort(a.begin(), a.end());
+	std::sort(b.begin(), b.end());
+	return a == b;
+}
+}
+
+class TestQtItemModelFixture
+{
+public:
+	TestQtItemModelFixture() : source_(8), model_(source_), valueId_(ItemRole::compute("value")), valueRole_(-1)
+	{
+		// Roles are only registered once the views ask for their names
+		auto names = model_.roleNames();
+		for (auto it = names.begin(); it != names.end(); ++it)
+		{
+			if (it.value() == "value")
+			{
+				valueRole_ = it.key();
+			}
+		}
+
+		QObject::connect(&model_, &QAbstractItemModel::dataChanged,
+		                 [this](const QModelIndex& topLeft, const QModelIndex& bottomRight, const QVector<int>& roles) {
+			                 DataChange change = { topLeft.row(), bottomRight.row(), roles };
+			                 changes_.push_back(change);
+			             });
+	}
+
+protected:
+	MockItemModel source_;
+	QtItemModel<QtAbstractItemModel> model_;
+	const ItemRole::Id valueId_;
+	int valueRole_;
+	std::vector<DataChange> changes_;
+};
+
+TEST_F(TestQtItemModelFixture, qt_item_model_coalesce_batch)
+{
+	CHECK(valueRole_ != -1);
+
+	source_.beginBatch();
+	source_.dataChanged(0, valueId_);
+	source_.dataChanged(1, valueId_);
+	source_.dataChanged(2, valueId_);
+	source_.dataChanged(2, ItemRole::displayId);
+	source_.dataChanged(5, valueId_);
+	source_.dataChanged(1, valueId_);
+	CHECK_EQUAL(0, changes_.size());
+	source_.endBatch();
+
+	// Adjacent rows are reported together with all of their roles, the rest on their own
+	CHECK_EQUAL(2, changes_.size());
+	if (changes_.size() == 2)
+	{
+		CHECK_EQUAL(0, changes_[0].first_);
+		CHECK_EQUAL(2, changes_[0].last_);
+		CHECK(sameRoles(changes_[0].roles_, QVector<int>() << valueRole_ << Qt::DisplayRole));
+		CHECK_EQUAL(5, changes_[1].first_);
+		CHECK_EQUAL(5, changes_[1].last_);
+		CHECK(sameRoles(changes_[1].roles_, QVector<int>() << valueRole_));
+	}
+}
+
+TEST_F(TestQtItemModelFixture, qt_item_model_nested_batches)
+{
+	source_.beginBatch();
+	source_.dataChanged(3, valueId_);
+	source_.beginBatch();
+	source_.dataChanged(4, valueId_);
+	source_.endBatch();
+
+	// Only the outermost batch reports its changes
+	CHECK_EQUAL(0, changes_.size());
+	source_.endBatch();
+	CHECK_EQUAL(1, changes_.size());
+	if (changes_.size() == 1)
+	{
+		CHECK_EQUAL(3, changes_[0].first_);
+		CHECK_EQUAL(4, changes_[0].last_);
+	}
+
+	// Changes outside of a batch are reported straight away
+	source_.dataChanged(6, valueId_);
+	CHECK_EQUAL(2, changes_.size());
+	if (changes_.size() == 2)
+	{
+		CHECK_EQUAL(6, changes_[1].first_);
+		CHECK_EQUAL(6, changes_[1].last_);
+	}
+}
+} // end namespace wgt
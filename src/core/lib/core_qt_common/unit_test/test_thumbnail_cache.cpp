@@ -0,0 +1,297 @@
+#include "pch.hpp"
+
+#include "core_unit_test/unit_test.hpp"
+#include "core_qt_common/qt_thumbnail_cache.hpp"
+#include "editor_interaction/i_background_worker.hpp"
+
+#include <atomic>
+#include <string>
+#include <thread>
+#include <vector>
+#include <QFileInfo>
+#include <QImage>
+#include <QTemporaryDir>
+
+namespace wgt
+{
+namespace
+{
+QtThumbnailCache::FileVersion getFileVersion(const QString& filePath)
+{
+	QFileInfo info(filePath);
+	return QtThumbnailCache::FileVersion(info.lastModified().toMSecsSinceEpoch(), info.size());
+}
+
+bool saveImage(const QString& filePath, int width, int height)
+{
+	QImage image(width, height, QImage::Format_RGB32);
+	image.fill(Qt::red);
+	return image.save(filePath);
+}
+
+class TestJob : public IBackgroundJob
+{
+public:
+	TestJob(IBackgroundWorker::CancellableJobFunction function, const IBackgroundWorker::JobDependencies& dependencies)
+	    : function_(function), dependencies_(dependencies), started_(false), cancelled_(false), done_(false)
+	{
+	}
+
+	virtual void cancel() override
+	{
+		cancelled_ = true;
+
+		// Jobs that haven't started are skipped straight away
+		bool started = false;
+		if (started_.compare_exchange_strong(started, true))
+		{
+			done_ = true;
+		}
+	}
+
+	virtual bool isCancelled() const override
+	{
+		return cancelled_;
+	}
+
+	virtual bool isDone() const override
+	{
+		return done_;
+	}
+
+	virtual void wait() const override
+	{
+		while (!done_)
+		{
+			std::this_thread::yield();
+		}
+	}
+
+	void run()
+	{
+		bool started = false;
+		if (!started_.compare_exchange_strong(started, true))
+		{
+			return;
+		}
+
+		bool skip = false;
+		for (auto& dependency : dependencies_)
+		{
+			skip |= dependency->isCancelled();
+		}
+		if (skip)
+		{
+			cancelled_ = true;
+		}
+		else
+		{
+			function_(*this);
+		}
+		done_ = true;
+	}
+
+private:
+	IBackgroundWorker::CancellableJobFunction function_;
+	IBackgroundWorker::JobDependencies dependencies_;
+	std::atomic<bool> started_;
+	std::atomic<bool> cancelled_;
+	std::atomic<bool> done_;
+};
+
+// Only runs the queued jobs when the test asks it to
+class TestBackgroundWorker : public IBackgroundWorker
+{
+public:
+	virtual void queueBackgroundJob(JobFunction job) override
+	{
+		queueJob([job](const IBackgroundJob&) { job(); });
+	}
+
+	virtual void queueForegroundJob(JobFunction job) override
+	{
+		queueForegroundJob([job](const IBackgroundJob&) { job(); }, JobDependencies());
+	}
+
+	virtual BackgroundJobPtr queueJob(CancellableJobFunction job, JobPriority priority,
+	                                  const JobDependencies& dependencies) override
+	{
+		auto testJob = std::make_shared<TestJob>(job, dependencies);
+		backgroundJobs_.push_back(testJob);
+		return testJob;
+	}
+
+	virtual BackgroundJobPtr queueForegroundJob(CancellableJobFunction job,
+	                                            const JobDependencies& dependencies) override
+	{
+		auto testJob = std::make_shared<TestJob>(job, dependencies);
+		foregroundJobs_.push_back(testJob);
+		return testJob;
+	}
+
+	size_t getBackgroundJobCount() const
+	{
+		return backgroundJobs_.size();
+	}
+
+	// Runs the queued background jobs on another thread and waits for them
+	void runBackgroundJobs()
+	{
+		std::vector<std::shared_ptr<TestJob>> jobs;
+		jobs.swap(backgroundJobs_);
+		std::thread thread([&jobs]() {
+			for (auto& job : jobs)
+			{
+				job->run();
+			}
+		});
+		thread.join();
+	}
+
+	void runForegroundJobs()
+	{
+		std::vector<std::shared_ptr<TestJob>> jobs;
+		jobs.swap(foregroundJobs_);
+		for (auto& job : jobs)
+		{
+			job->run();
+		}
+	}
+
+private:
+	std::vector<std::shared_ptr<TestJob>> backgroundJobs_;
+	std::vector<std::shared_ptr<TestJob>> foregroundJobs_;
+};
+}
+
+TEST(thumbnail_cache)
+{
+	QTemporaryDir directory;
+	CHECK(directory.isValid());
+	auto filePath = [&directory](const QString& name) { return directory.path() + "/" + name; };
+
+	const int imageCount = 20;
+	for (int i = 0; i < imageCount; ++i)
+	{
+		CHECK(saveImage(filePath(QString("image%1.png").arg(i)), 1024, 512));
+	}
+
+	std::atomic<int> decodeCount(0);
+	auto loadFunction = [&decodeCount](const QString& path, QImage& o_Image) {
+		++decodeCount;
+		return o_Image.load(path);
+	};
+	auto noWorker = []() -> IBackgroundWorker* { return nullptr; };
+	const QString cacheDirectory = filePath("cache");
+	const QString firstImage = filePath("image0.png");
+
+	// Without a background worker thumbnails load on the calling thread, bounded to THUMBNAIL_SIZE
+	const int thumbnailSize = QtThumbnailCache::THUMBNAIL_SIZE;
+	const size_t thumbnailBytes = thumbnailSize * thumbnailSize / 2 * 4;
+	{
+		QtThumbnailCache cache(loadFunction, noWorker, cacheDirectory, thumbnailBytes * 4);
+		CHECK(cache.request(firstImage));
+		QImage thumbnail = cache.get(firstImage);
+		CHECK_EQUAL(thumbnailSize, thumbnail.width());
+		CHECK_EQUAL(thumbnailSize / 2, thumbnail.height());
+		CHECK_EQUAL(1, decodeCount.load());
+
+		// The least recently used thumbnails are evicted past the memory budget
+		for (int i = 0; i < imageCount; ++i)
+		{
+			CHECK(cache.request(filePath(QString("image%1.png").arg(i))));
+		}
+		CHECK_EQUAL(thumbnailBytes * 4, cache.getMemoryUsage());
+		CHECK_EQUAL(imageCount, decodeCount.load());
+
+		CHECK(cache.get(filePath("missing.png")).isNull());
+		CHECK(!cache.request(filePath("missing.png")));
+	}
+
+	// A new cache reads the thumbnails back from disk without decoding the images
+	decodeCount = 0;
+	QtThumbnailCache cache(loadFunction, noWorker, cacheDirectory);
+	CHECK(cache.request(firstImage, getFileVersion(firstImage)));
+	CHECK_EQUAL(thumbnailSize, cache.get(firstImage).width());
+	CHECK_EQUAL(0, decodeCount.load());
+
+	// The thumbnail held in memory is only reused for the version of the file it was loaded for
+	CHECK(saveImage(firstImage, 64, 32));
+	CHECK(cache.request(firstImage, getFileVersion(firstImage)));
+	CHECK_EQUAL(64, cache.get(firstImage).width());
+	CHECK_EQUAL(1, decodeCount.load());
+	CHECK(cache.request(firstImage, getFileVersion(firstImage)));
+	CHECK_EQUAL(1, decodeCount.load());
+}
+
+TEST(thumbnail_cache_background_load)
+{
+	QTemporaryDir directory;
+	CHECK(directory.isValid());
+	const QString image = directory.path() + "/image.png";
+	const QString missing = directory.path() + "/missing.png";
+	CHECK(saveImage(image, 1024, 512));
+
+	std::atomic<int> decodeCount(0);
+	std::thread::id decodeThread;
+	auto loadFunction = [&decodeCount, &decodeThread](const QString& path, QImage& o_Image) {
+		++decodeCount;
+		decodeThread = std::this_thread::get_id();
+		return o_Image.load(path);
+	};
+	TestBackgroundWorker worker;
+	auto getWorker = [&worker]() -> IBackgroundWorker* { return &worker; };
+
+	QtThumbnailCache cache(loadFunction, getWorker, QString());
+	std::vector<std::string> loaded;
+	auto connection = cache.connectThumbnailLoaded([&loaded](const char* filePath) { loaded.push_back(filePath); });
+
+	// Requests never load on the calling thread, and a pending load is only queued once
+	const auto firstVersion = getFileVersion(image);
+	CHECK(!cache.request(image, firstVersion));
+	CHECK(!cache.request(image, firstVersion));
+	CHECK(!cache.request(missing));
+	CHECK_EQUAL(2, worker.getBackgroundJobCount());
+	CHECK_EQUAL(0, decodeCount.load());
+
+	// Loaded callbacks are only called on the foreground thread, and not for files without a thumbnail
+	worker.runBackgroundJobs();
+	CHECK_EQUAL(2, decodeCount.load());
+	CHECK(decodeThread != std::this_thread::get_id());
+	CHECK(loaded.empty());
+	worker.runForegroundJobs();
+	CHECK_EQUAL(1, loaded.size());
+	if (loaded.size() == 1)
+	{
+		CHECK(QString::fromUtf8(loaded[0].c_str()) == image);
+	}
+	CHECK(cache.request(image, firstVersion));
+	CHECK_EQUAL(QtThumbnailCache::THUMBNAIL_SIZE, cache.get(image).width());
+
+	// Files without a thumbnail aren't loaded again
+	CHECK(!cache.request(missing));
+	CHECK_EQUAL(0, worker.getBackgroundJobCount());
+
+	// A new version of the file is loaded in the background, the old thumbnail is shown until it has
+	CHECK(saveImage(image, 64, 32));
+	const auto secondVersion = getFileVersion(image);
+	CHECK(!cache.request(image, secondVersion));
+	CHECK_EQUAL(QtThumbnailCache::THUMBNAIL_SIZE, cache.get(image).width());
+	worker.runBackgroundJobs();
+	worker.runForegroundJobs();
+	CHECK_EQUAL(2, loaded.size());
+	CHECK(cache.request(image, secondVersion));
+	CHECK_EQUAL(64, cache.get(image).width());
+
+	// Loads that haven't started are cancelled when the cache is cleared
+	decodeCount = 0;
+	CHECK(!cache.request(image, firstVersion));
+	cache.clear();
+	worker.runBackgroundJobs();
+	worker.runForegroundJobs();
+	CHECK_EQUAL(0, decodeCount.load());
+	CHECK_EQUAL(2, loaded.size());
+
+	connection.disconnect();
+}
+} // end namespace wgt
@@ -131,11 +131,21 @@ struct ClassDefinition::Impl
 
 		// Otherwise, perform a search
 		auto nameHash = path->getHash();
+		auto & lookupCache = ReflectionPrivate::getPropertyLookupCache();
+		auto cachedProperty = lookupCache.find(&self_, nameHash);
+		if (cachedProperty != nullptr)
+		{
+			return cachedProperty;
+		}
 		auto properties = allProperties();
 		for (auto it = properties.begin(); it != properties.end(); ++it)
 		{
 			if (it->getNameHash() == nameHash)
 			{
+				if (!details_->isGeneric())
+				{
+					lookupCache.insert(&self_, nameHash, *it);
+				}
 				return *it;
 			}
 		}
@@ -214,13 +224,11 @@ PropertyAccessor ClassDefinition::Impl::bindProperty(
 		return PropertyAccessor();
 	}
 
-	auto cache = ReflectionPrivate::s_Cache
-		? &(ReflectionPrivate::s_Cache->propCache_[&definition][base])
+	auto batchCache = ReflectionPrivate::getBatchCache();
+	auto cache = batchCache
+		? &(batchCache->propCache_[&definition][base])
 		: nullptr;
 
-	auto paCache = ReflectionPrivate::s_Cache
-		? &(ReflectionPrivate::s_Cache->valueCache_) : nullptr;
-
 	auto propertyId = cache ? path->getRecursiveHash() : 0;
 
 	PropertyAccessor accessor;
@@ -332,8 +340,9 @@ PropertyAccessor ClassDefinition::Impl::bindProperty(
 			return PropertyAccessor();
 		}
 
-		auto cache = ReflectionPrivate::s_Cache
-			? &(ReflectionPrivate::s_Cache->propCache_[currentDef][handle.getRecursiveHash()])
+		auto batchCache = ReflectionPrivate::getBatchCache();
+		auto cache = batchCache
+			? &(batchCache->propCache_[currentDef][handle.getRecursiveHash()])
 			: nullptr;
 
 		auto propertyId = cache ? component->getRecursiveHash() : 0;
@@ -387,8 +396,9 @@ PropertyAccessor ClassDefinition::Impl::bindProperty(
 			collection = *collectionPointer;
 		}
 
-		auto cache = ReflectionPrivate::s_Cache
-			? &(ReflectionPrivate::s_Cache->propCache_[o_ParentDefinition][collection])
+		auto batchCache = ReflectionPrivate::getBatchCache();
+		auto cache = batchCache
+			? &(batchCache->propCache_[o_ParentDefinition][collection])
 			: nullptr;
 
 		auto propertyId = cache ? component->getRecursiveHash() : 0;
@@ -456,8 +466,9 @@ void ClassDefinition::Impl::bindProperty(
 	}
 
 	auto hashCode = base.getHashCode();
-	auto cache = ReflectionPrivate::s_Cache
-		? &( ReflectionPrivate::s_Cache->propCache_[ &definition ][ base ] )
+	auto batchCache = ReflectionPrivate::getBatchCache();
+	auto cache = batchCache
+		? &( batchCache->propCache_[ &definition ][ base ] )
 		: nullptr;
 
 	auto propertyId = cache ? ReflectionPrivate::computePropertyId(path) : 0;
@@ -470,6 +481,24 @@ void ClassDefinition::Impl::bindProperty(
 			return;
 		}
 	}
+	// Plain property names resolve to the same property for every object of a
+	// definition, so skip parsing the path entirely if it has been seen before
+	if (*path != Collection::getIndexOpen() && !definition.isGeneric())
+	{
+		auto pathId = cache ? propertyId : ReflectionPrivate::computePropertyId(path);
+		auto property = ReflectionPrivate::getPropertyLookupCache().find(&definition, pathId);
+		if (property != nullptr)
+		{
+			o_PropertyAccessor.setBaseProperty(property);
+			o_PropertyAccessor.setPath(std::string(o_PropertyAccessor.getPath()) + path);
+			if (cache)
+			{
+				(*cache)[propertyId] = o_PropertyAccessor.getData();
+			}
+			return;
+		}
+	}
+
 	IBasePropertyPtr property;
 	bool continueLooking;
 	std::string propertyName;
@@ -569,8 +598,21 @@ std::shared_ptr<ObjectReference> ClassDefinition::getChildReference(
 //==============================================================================
 IBasePropertyPtr ClassDefinition::findProperty(const char* name, size_t length) const
 {
-	// Some definitions allow you to lookup by name directly
+	// Generic definitions can add and remove properties at any time so are never cached
 	auto & details = getDetails();
+	auto & lookupCache = ReflectionPrivate::getPropertyLookupCache();
+	const bool cacheable = !details.isGeneric();
+	auto nameHash = HashUtilities::compute(name, length);
+	if (cacheable)
+	{
+		auto cachedProperty = lookupCache.find(this, nameHash);
+		if (cachedProperty != nullptr)
+		{
+			return cachedProperty;
+		}
+	}
+
+	// Some definitions allow you to lookup by name directly
 	if (details.canDirectLookupProperty())
 	{
 		std::string propName(name, length);
@@ -579,6 +621,10 @@ IBasePropertyPtr ClassDefinition::findProperty(const char* name, size_t length)
 		IBasePropertyPtr prop = details.directLookupProperty(propName.c_str());
 		if (prop != nullptr)
 		{
+			if (cacheable)
+			{
+				lookupCache.insert(this, nameHash, prop);
+			}
 			return prop;
 		}
 		const auto & parentNames = getParentNames();
@@ -594,6 +640,10 @@ IBasePropertyPtr ClassDefinition::findProperty(const char* name, size_t length)
 			prop = parentDef->findProperty(propName.c_str());
 			if (prop != nullptr)
 			{
+				if (cacheable)
+				{
+					lookupCache.insert(this, nameHash, prop);
+				}
 				return prop;
 			}
 		}
@@ -601,12 +651,15 @@ IBasePropertyPtr ClassDefinition::findProperty(const char* name, size_t length)
 	}
 
 	// Otherwise, perform a search
-	auto nameHash = HashUtilities::compute(name, length);
 	auto properties = allProperties();
 	for (auto it = properties.begin(); it != properties.end(); ++it)
 	{
 		if (it->getNameHash() == nameHash)
 		{
+			if (cacheable)
+			{
+				lookupCache.insert(this, nameHash, *it);
+			}
 			return *it;
 		}
 	}
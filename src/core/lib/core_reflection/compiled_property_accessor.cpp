@@ -0,0 +1,414 @@
+#include "compiled_property_accessor.hpp"
+
+#include "interfaces/i_base_property.hpp"
+#include "interfaces/i_class_definition.hpp"
+#include "i_definition_manager.hpp"
+#include "i_object_manager.hpp"
+#include "property_accessor.hpp"
+#include "object_handle.hpp"
+#include "metadata/meta_base.hpp"
+#include "metadata/meta_impl.hpp"
+#include "utilities/object_handle_reflection_utils.hpp"
+
+#include "core_common/assert.hpp"
+#include "core_variant/collection.hpp"
+#include "core_variant/variant.hpp"
+
+#include <cctype>
+#include <cstdlib>
+#include <string>
+#include <vector>
+
+namespace wgt
+{
+namespace
+{
+//------------------------------------------------------------------------------
+struct Step
+{
+	enum Type
+	{
+		TYPE_PROPERTY,
+		TYPE_COLLECTION_ITEM
+	};
+
+	Type type_;
+	// Property name or collection key as written in the path
+	std::string name_;
+	// Type of the object the property was resolved against
+	TypeId ownerType_;
+	IBasePropertyPtr property_;
+	ObjectHandleT<MetaCallbackObj> callback_;
+	Variant key_;
+};
+
+//------------------------------------------------------------------------------
+Variant parseKey(const std::string& key)
+{
+	if (key.size() >= 2 && key.front() == '"' && key.back() == '"')
+	{
+		return key.substr(1, key.size() - 2);
+	}
+
+	for (auto c : key)
+	{
+		if (!isdigit(static_cast<unsigned char>(c)))
+		{
+			return key;
+		}
+	}
+	return static_cast<uint64_t>(strtoull(key.c_str(), nullptr, 10));
+}
+}
+
+//==============================================================================
+struct CompiledPropertyAccessor::Impl
+{
+	Impl(const IClassDefinition& definition, const char* path)
+		: definition_(&definition)
+		, definitionManager_(definition.getDefinitionManager())
+		, path_(path ? path : "")
+	{
+	}
+
+	const IClassDefinition* definition_;
+	const IDefinitionManager* definitionManager_;
+	std::string path_;
+	std::vector<Step> steps_;
+
+	bool compile();
+	bool resolve(const Step& step, const Variant& base, ObjectHandle& o_Handle, IBasePropertyPtr& o_Property,
+	             ObjectHandleT<MetaCallbackObj>& o_Callback) const;
+	bool get(size_t index, const Variant& base, Variant& o_Value) const;
+	bool set(size_t index, Variant& base, const Variant& value) const;
+};
+
+//------------------------------------------------------------------------------
+bool CompiledPropertyAccessor::Impl::compile()
+{
+	TF_ASSERT(definitionManager_ != nullptr);
+
+	static const char INDEX_OPEN = Collection::getIndexOpen();
+	static const char INDEX_CLOSE = Collection::getIndexClose();
+	static const char DOT_OPERATOR = IClassDefinition::DOT_OPERATOR;
+
+	// Definition of the object the next property is looked up on, null if only known per object
+	const IClassDefinition* current = definition_;
+	auto pathPosition = path_.c_str();
+	while (*pathPosition)
+	{
+		Step step;
+		if (*pathPosition == INDEX_OPEN)
+		{
+			if (steps_.empty())
+			{
+				// index operator is applicable to collections only
+				return false;
+			}
+
+			auto keyBegin = ++pathPosition;
+			for (; *pathPosition && *pathPosition != INDEX_CLOSE; ++pathPosition)
+				;
+			if (*pathPosition != INDEX_CLOSE || pathPosition == keyBegin)
+			{
+				return false;
+			}
+
+			step.type_ = Step::TYPE_COLLECTION_ITEM;
+			step.name_.assign(keyBegin, pathPosition);
+			step.key_ = parseKey(step.name_);
+			++pathPosition;
+
+			// Collections can hold any derived type, resolve elements per object
+			current = nullptr;
+		}
+		else
+		{
+			if (!steps_.empty())
+			{
+				if (*pathPosition != DOT_OPERATOR)
+				{
+					return false;
+				}
+				++pathPosition;
+			}
+
+			auto nameBegin = pathPosition;
+			for (; *pathPosition && *pathPosition != INDEX_OPEN && *pathPosition != DOT_OPERATOR; ++pathPosition)
+				;
+			if (pathPosition == nameBegin)
+			{
+				return false;
+			}
+
+			step.type_ = Step::TYPE_PROPERTY;
+			step.name_.assign(nameBegin, pathPosition);
+
+			if (current != nullptr)
+			{
+				auto property = current->findProperty(step.name_.c_str(), step.name_.length());
+				if (property == nullptr)
+				{
+					return false;
+				}
+
+				// Generic definitions can lose properties at any time so are resolved per object
+				if (!current->isGeneric())
+				{
+					step.ownerType_ = TypeId(current->getName());
+					step.property_ = property;
+					step.callback_ = findFirstMetaData<MetaCallbackObj>(*property, *definitionManager_);
+				}
+
+				current = property->isCollection() ?
+					nullptr : definitionManager_->getDefinition(property->getType().getName());
+			}
+		}
+		steps_.push_back(std::move(step));
+	}
+	return !steps_.empty();
+}
+
+//------------------------------------------------------------------------------
+bool CompiledPropertyAccessor::Impl::resolve(const Step& step, const Variant& base, ObjectHandle& o_Handle,
+                                             IBasePropertyPtr& o_Property,
+                                             ObjectHandleT<MetaCallbackObj>& o_Callback) const
+{
+	static const TypeId s_ObjectType = TypeId::getType<ObjectHandle>();
+	if (base.type()->typeId() == s_ObjectType)
+	{
+		// property is a link
+		base.tryCast(o_Handle);
+	}
+	else
+	{
+		// Structures returned by value need temporary storage, as PropertyAccessor::getValue does
+		auto objectManager = definitionManager_->getObjectManager();
+		TF_ASSERT(objectManager != nullptr);
+		o_Handle = ObjectHandle(objectManager->createObjectStorage(base));
+	}
+
+	if (!o_Handle.isValid())
+	{
+		return false;
+	}
+
+	if (step.property_ != nullptr && o_Handle.type() == step.ownerType_)
+	{
+		o_Property = step.property_;
+		o_Callback = step.callback_;
+		return true;
+	}
+
+	// Slow path, the object is of a different type than the one compiled against
+	o_Handle = reflectedRoot(o_Handle, *definitionManager_);
+	auto definition = definitionManager_->getDefinition(o_Handle);
+	if (definition == nullptr)
+	{
+		// Fail: not a reflected type
+		return false;
+	}
+
+	o_Property = definition->findProperty(step.name_.c_str(), step.name_.length());
+	if (o_Property == nullptr)
+	{
+		// Fail: could not find property
+		return false;
+	}
+	o_Callback = findFirstMetaData<MetaCallbackObj>(*o_Property, *definitionManager_);
+	return true;
+}
+
+//------------------------------------------------------------------------------
+bool CompiledPropertyAccessor::Impl::get(size_t index, const Variant& base, Variant& o_Value) const
+{
+	const auto& step = steps_[index];
+	const bool isLast = index + 1 == steps_.size();
+
+	Variant value;
+	if (step.type_ == Step::TYPE_PROPERTY)
+	{
+		ObjectHandle handle;
+		IBasePropertyPtr property;
+		ObjectHandleT<MetaCallbackObj> callback;
+		if (!resolve(step, base, handle, property, callback) || !property->isValue())
+		{
+			return false;
+		}
+		value = property->get(handle, *definitionManager_);
+	}
+	else
+	{
+		Collection collection;
+		if (!base.tryCast(collection))
+		{
+			return false;
+		}
+
+		auto it = collection.find(step.key_);
+		if (it == collection.end())
+		{
+			return false;
+		}
+		value = it.value();
+	}
+
+	if (isLast)
+	{
+		o_Value = std::move(value);
+		return true;
+	}
+	return get(index + 1, value, o_Value);
+}
+
+//------------------------------------------------------------------------------
+bool CompiledPropertyAccessor::Impl::set(size_t index, Variant& base, const Variant& value) const
+{
+	const auto& step = steps_[index];
+	const bool isLast = index + 1 == steps_.size();
+
+	if (step.type_ == Step::TYPE_PROPERTY)
+	{
+		ObjectHandle handle;
+		IBasePropertyPtr property;
+		ObjectHandleT<MetaCallbackObj> callback;
+		if (!resolve(step, base, handle, property, callback))
+		{
+			return false;
+		}
+
+		if (isLast)
+		{
+			if (property->readOnly(handle) || !property->set(handle, value, *definitionManager_))
+			{
+				return false;
+			}
+		}
+		else
+		{
+			Variant child = property->get(handle, *definitionManager_);
+			if (!set(index + 1, child, value))
+			{
+				return false;
+			}
+
+			// Set the parent object to support properties returned by value
+			if (!property->isByReference())
+			{
+				property->set(handle, child, *definitionManager_);
+			}
+
+			if (callback != nullptr)
+			{
+				callback->invoke(handle);
+			}
+		}
+
+		// Hand the possibly temporary storage back so our caller can write it to its owner
+		base = handle;
+		return true;
+	}
+
+	Collection collection;
+	if (!base.tryCast(collection))
+	{
+		return false;
+	}
+
+	auto it = collection.find(step.key_);
+	if (it == collection.end())
+	{
+		return false;
+	}
+
+	if (isLast)
+	{
+		return it.setValue(value);
+	}
+
+	Variant child = it.value();
+	if (!set(index + 1, child, value))
+	{
+		return false;
+	}
+	it.setValue(child);
+	return true;
+}
+
+//==============================================================================
+CompiledPropertyAccessor::CompiledPropertyAccessor()
+{
+}
+
+//------------------------------------------------------------------------------
+CompiledPropertyAccessor::CompiledPropertyAccessor(const IClassDefinition& definition, const char* path)
+{
+	auto impl = std::make_shared<Impl>(definition, path);
+	if (impl->compile())
+	{
+		impl_ = impl;
+	}
+}
+
+//------------------------------------------------------------------------------
+CompiledPropertyAccessor::~CompiledPropertyAccessor()
+{
+}
+
+//------------------------------------------------------------------------------
+bool CompiledPropertyAccessor::isValid() const
+{
+	return impl_ != nullptr;
+}
+
+//------------------------------------------------------------------------------
+const char* CompiledPropertyAccessor::getPath() const
+{
+	return impl_ != nullptr ? impl_->path_.c_str() : "";
+}
+
+//------------------------------------------------------------------------------
+const IClassDefinition* CompiledPropertyAccessor::getDefinition() const
+{
+	return impl_ != nullptr ? impl_->definition_ : nullptr;
+}
+
+//------------------------------------------------------------------------------
+IBasePropertyPtr CompiledPropertyAccessor::getProperty() const
+{
+	return impl_ != nullptr ? impl_->steps_.back().property_ : nullptr;
+}
+
+//------------------------------------------------------------------------------
+Variant CompiledPropertyAccessor::getValue(const ObjectHandle& object) const
+{
+	Variant value;
+	if (impl_ == nullptr || !impl_->get(0, object, value))
+	{
+		return Variant();
+	}
+	return value;
+}
+
+//------------------------------------------------------------------------------
+bool CompiledPropertyAccessor::setValue(const ObjectHandle& object, const Variant& value) const
+{
+	if (impl_ == nullptr)
+	{
+		return false;
+	}
+
+	Variant base = object;
+	return impl_->set(0, base, value);
+}
+
+//------------------------------------------------------------------------------
+PropertyAccessor CompiledPropertyAccessor::bind(const ObjectHandle& object) const
+{
+	if (impl_ == nullptr)
+	{
+		return PropertyAccessor();
+	}
+	return impl_->definition_->bindProperty(impl_->path_.c_str(), object);
+}
+} // end namespace wgt
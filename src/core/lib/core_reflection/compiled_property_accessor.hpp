@@ -0,0 +1,58 @@
+#ifndef COMPILED_PROPERTY_ACCESSOR_HPP
+#define COMPILED_PROPERTY_ACCESSOR_HPP
+
+#include <memory>
+#include "reflection_dll.hpp"
+
+namespace wgt
+{
+class IClassDefinition;
+class ObjectHandle;
+class PropertyAccessor;
+class Variant;
+typedef std::shared_ptr<class IBaseProperty> IBasePropertyPtr;
+
+/**
+ *	A property path resolved once against a class definition.
+ *
+ *	The path is parsed and every property along it is looked up at construction.
+ *	The resulting program is immutable and can be run against any number of
+ *	objects of the definition without string parsing, ObjectReference lookups or
+ *	PropertyAccessor allocations.
+ *
+ *	Steps below links, collection elements or generic definitions cannot be
+ *	typed ahead of time and are resolved against each object's definition when run.
+ *	Values are read and written directly, no PropertyAccessorListeners are
+ *	notified; use bind() where undo/redo and change notification are required.
+ */
+class REFLECTION_DLL CompiledPropertyAccessor
+{
+public:
+	CompiledPropertyAccessor();
+	CompiledPropertyAccessor(const IClassDefinition& definition, const char* path);
+	~CompiledPropertyAccessor();
+
+	bool isValid() const;
+	const char* getPath() const;
+	const IClassDefinition* getDefinition() const;
+
+	/**
+	 *	The property of the last path step, or null if the path ends in a
+	 *	collection element or could not be resolved ahead of time.
+	 */
+	IBasePropertyPtr getProperty() const;
+
+	Variant getValue(const ObjectHandle& object) const;
+	bool setValue(const ObjectHandle& object, const Variant& value) const;
+
+	/**
+	 *	Bind a full PropertyAccessor for the compiled path on the given object.
+	 */
+	PropertyAccessor bind(const ObjectHandle& object) const;
+
+private:
+	struct Impl;
+	std::shared_ptr<const Impl> impl_;
+};
+} // end namespace wgt
+#endif // COMPILED_PROPERTY_ACCESSOR_HPP
@@ -8,6 +8,7 @@
 #include "interfaces/i_definition_helper.hpp"
 #include "generic/generic_definition.hpp"
 #include "generic/generic_definition_helper.hpp"
+#include "private/reflection_cache.hpp"
 
 #include "core_common/assert.hpp"
 
@@ -108,6 +109,8 @@ IClassDefinition* DefinitionManager::registerDefinition(std::unique_ptr<IClassDe
 	TF_ASSERT(result.second && "Duplicate definition overwritten in map.");
 	definition->setDefinitionManager(this);
 
+	// A new definition may reuse the address of one previously deregistered
+	ReflectionPrivate::getPropertyLookupCache().invalidate(definition);
 	return definition;
 }
 
@@ -122,6 +125,8 @@ bool DefinitionManager::deregisterDefinition(const IClassDefinition* definition)
 	{
 		return false;
 	}
+	// Derived definitions cache properties found through their parents
+	ReflectionPrivate::getPropertyLookupCache().clear();
     delete it->second;
 	definitions_.erase(it);
 	return true;
@@ -131,6 +136,7 @@ bool DefinitionManager::deregisterDefinition(const IClassDefinition* definition)
 void DefinitionManager::deregisterDefinitions()
 {
 	wg_write_lock_guard writeGuard(lock_);
+	ReflectionPrivate::getPropertyLookupCache().clear();
 	for (ClassDefCollection::const_iterator it = definitions_.begin(); it != definitions_.end(); ++it)
     {
         delete it->second;
@@ -104,6 +104,7 @@ private:
 	friend class ManagedObjectBase;
 	friend class XMLReader;
 	friend class PropertyAccessor;
+	friend class CompiledPropertyAccessor;
 };
 
 //==============================================================================
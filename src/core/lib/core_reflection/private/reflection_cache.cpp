@@ -11,10 +11,94 @@ namespace ReflectionPrivate
 		return HashUtilities::compute(path);
 	}
 
-	std::unique_ptr< ReflectionCache > s_Cache;
+	THREAD_LOCAL(ReflectionCache*) s_Cache;
 
-	int s_CacheBatchRefs = 0;
-}
+	THREAD_LOCAL(int) s_CacheBatchRefs;
+
+	//--------------------------------------------------------------------------
+	ReflectionCache * getBatchCache()
+	{
+		return THREAD_LOCAL_GET(s_Cache);
+	}
+
+	//--------------------------------------------------------------------------
+	size_t PropertyLookupCache::KeyHash::operator()( const Key & key ) const
+	{
+		uint64_t seed = key.propertyId_;
+		HashUtilities::directCombine(seed, reinterpret_cast< uintptr_t >(key.definition_));
+		return static_cast< size_t >(seed);
+	}
+
+	//--------------------------------------------------------------------------
+	const PropertyLookupCache::Shard & PropertyLookupCache::getShard( const Key & key ) const
+	{
+		// Low bits of the property id are well mixed by FNV, pointers are not
+		return shards_[ (key.propertyId_ ^ (reinterpret_cast< uintptr_t >(key.definition_) >> 4)) % SHARD_COUNT ];
+	}
+
+	//--------------------------------------------------------------------------
+	PropertyLookupCache::Shard & PropertyLookupCache::getShard( const Key & key )
+	{
+		return const_cast< Shard & >(static_cast< const PropertyLookupCache & >(*this).getShard(key));
+	}
+
+	//--------------------------------------------------------------------------
+	IBasePropertyPtr PropertyLookupCache::find(
+		const IClassDefinition * definition, PropertyId propertyId ) const
+	{
+		const Key key = { definition, propertyId };
+		auto & shard = getShard(key);
+		wg_read_lock_guard readGuard(shard.lock_);
+		auto findIt = shard.properties_.find(key);
+		return findIt != shard.properties_.end() ? findIt->second : nullptr;
+	}
+
+	//--------------------------------------------------------------------------
+	void PropertyLookupCache::insert(
+		const IClassDefinition * definition, PropertyId propertyId, const IBasePropertyPtr & property )
+	{
+		const Key key = { definition, propertyId };
+		auto & shard = getShard(key);
+		wg_write_lock_guard writeGuard(shard.lock_);
+		shard.properties_[key] = property;
+	}
+
+	//--------------------------------------------------------------------------
+	void PropertyLookupCache::invalidate( const IClassDefinition * definition )
+	{
+		for (auto & shard : shards_)
+		{
+			wg_write_lock_guard writeGuard(shard.lock_);
+			for (auto it = shard.properties_.begin(); it != shard.properties_.end();)
+			{
+				if (it->first.definition_ == definition)
+				{
+					it = shard.properties_.erase(it);
+				}
+				else
+				{
+					++it;
+				}
+			}
+		}
+	}
+
+	//--------------------------------------------------------------------------
+	void PropertyLookupCache::clear()
+	{
+		for (auto & shard : shards_)
+		{
+			wg_write_lock_guard writeGuard(shard.lock_);
+			shard.properties_.clear();
+		}
+	}
 
+	//--------------------------------------------------------------------------
+	PropertyLookupCache & getPropertyLookupCache()
+	{
+		static PropertyLookupCache s_PropertyLookupCache;
+		return s_PropertyLookupCache;
+	}
 }
 
+}
@@ -2,6 +2,8 @@
 #define REFLECTION_CACHE_HPP
 
 #include "property_accessor_data.hpp"
+#include "core_common/thread_local_value.hpp"
+#include "core_common/wg_read_write_lock.hpp"
 #include <unordered_map>
 #include <map>
 
@@ -14,7 +16,7 @@ namespace ReflectionPrivate
 {
 	typedef uint64_t PropertyId;
 
-	//Need to use a concrete type instead of typedef because it goes past the maximum decorated 
+	//Need to use a concrete type instead of typedef because it goes past the maximum decorated
 	//length
 	struct PropertyDataMap
 		: public std::unordered_map< PropertyId, std::shared_ptr< PropertyAccessorPrivate::Data > >
@@ -32,17 +34,71 @@ namespace ReflectionPrivate
 
 	uint64_t computePropertyId(const char * path);
 
+	/**
+	 * Per object accessor cache, only alive for the duration of a ReflectionBatchQuery.
+	 * Entries hold references to the objects they were bound against, so it is owned by
+	 * the thread that opened the batch and is never seen by other threads.
+	 */
 	struct ReflectionCache
 	{
 		PropertyCache propCache_;
 		PropertyAccessorValueCache valueCache_;
 	};
 
-	extern std::unique_ptr< ReflectionCache > s_Cache;
+	extern THREAD_LOCAL(ReflectionCache*) s_Cache;
 
-	extern int s_CacheBatchRefs;
+	extern THREAD_LOCAL(int) s_CacheBatchRefs;
+
+	ReflectionCache * getBatchCache();
+
+	/**
+	 * Persistent, thread safe cache of resolved properties keyed by definition and
+	 * property name hash. Holds no object references so it stays alive across batches;
+	 * entries are dropped when definitions are registered or deregistered.
+	 */
+	class PropertyLookupCache
+	{
+	public:
+		IBasePropertyPtr find( const IClassDefinition * definition, PropertyId propertyId ) const;
+		void insert( const IClassDefinition * definition, PropertyId propertyId, const IBasePropertyPtr & property );
+
+		void invalidate( const IClassDefinition * definition );
+		void clear();
+
+	private:
+		struct Key
+		{
+			const IClassDefinition * definition_;
+			PropertyId propertyId_;
+
+			bool operator==( const Key & other ) const
+			{
+				return definition_ == other.definition_ && propertyId_ == other.propertyId_;
+			}
+		};
+
+		struct KeyHash
+		{
+			size_t operator()( const Key & key ) const;
+		};
+
+		struct Shard
+		{
+			mutable wg_read_write_lock lock_;
+			std::unordered_map< Key, IBasePropertyPtr, KeyHash > properties_;
+		};
+
+		static const size_t SHARD_COUNT = 16;
+
+		const Shard & getShard( const Key & key ) const;
+		Shard & getShard( const Key & key );
+
+		Shard shards_[ SHARD_COUNT ];
+	};
+
+	PropertyLookupCache & getPropertyLookupCache();
 }
 
 }
 
-#endif //REFLECTION_CACHE_HPP
\ No newline at end of file
+#endif //REFLECTION_CACHE_HPP
@@ -174,11 +174,11 @@ BinaryStream& operator<<(BinaryStream& stream, const RefObjectId& v)
 
 BinaryStream& operator>>(BinaryStream& stream, RefObjectId& v)
 {
-	ResizingMemoryStream dataStream;
-	stream.deserializeBuffer(dataStream);
+	std::string id;
+	stream >> id;
 	if (!stream.fail())
 	{
-		v = dataStream.buffer();
+		v = id;
 	}
 	return stream;
 }
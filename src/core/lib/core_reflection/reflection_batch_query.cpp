@@ -7,19 +7,22 @@ namespace wgt
 //------------------------------------------------------------------------------
 ReflectionBatchQuery::ReflectionBatchQuery()
 {
-	if (ReflectionPrivate::s_CacheBatchRefs++ == 0)
+	// Batches are tracked per thread so concurrent batches never share object caches
+	if (THREAD_LOCAL_GET(ReflectionPrivate::s_CacheBatchRefs) == 0)
 	{
-		ReflectionPrivate::s_Cache.reset(new ReflectionPrivate::ReflectionCache());
+		THREAD_LOCAL_SET(ReflectionPrivate::s_Cache, new ReflectionPrivate::ReflectionCache());
 	}
+	THREAD_LOCAL_INC(ReflectionPrivate::s_CacheBatchRefs);
 }
 
 
 //------------------------------------------------------------------------------
 ReflectionBatchQuery::~ReflectionBatchQuery()
 {
-	if (--ReflectionPrivate::s_CacheBatchRefs == 0)
+	if (THREAD_LOCAL_DEC(ReflectionPrivate::s_CacheBatchRefs) == 0)
 	{
-		ReflectionPrivate::s_Cache = nullptr;
+		delete THREAD_LOCAL_GET(ReflectionPrivate::s_Cache);
+		THREAD_LOCAL_SET(ReflectionPrivate::s_Cache, nullptr);
 	}
 }
 
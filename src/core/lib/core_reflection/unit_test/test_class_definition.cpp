@@ -7,6 +7,8 @@
 #include "core_reflection/metadata/meta_types.hpp"
 #include "core_reflection/utilities/reflection_function_utilities.hpp"
 #include "core_reflection/definition_manager.hpp"
+#include "core_reflection/reflection_batch_query.hpp"
+#include "core_reflection/compiled_property_accessor.hpp"
 #include "core_object/managed_object.hpp"
 #include "core_unit_test/test_framework.hpp"
 
@@ -15,6 +17,8 @@
 
 #include "core_variant/collection.hpp"
 #include <numeric>
+#include <atomic>
+#include <thread>
 
 #include "test_class_definition.hpp"
 
@@ -967,6 +971,85 @@ TEST_F(TestDefinitionFixture, successive_bind)
 	CHECK(take1 == take2);
 }
 
+TEST_F(TestDefinitionFixture, compiled_accessor)
+{
+	CompiledPropertyAccessor counter(*klass_, "counter");
+	CHECK(counter.isValid());
+	CHECK(counter.getProperty() != nullptr);
+	CHECK(!CompiledPropertyAccessor(*klass_, "counter.").isValid());
+	CHECK(!CompiledPropertyAccessor(*klass_, "[0]").isValid());
+	CHECK(!CompiledPropertyAccessor(*klass_, "not a property").isValid());
+
+	std::vector<TestDefinitionObject> data(8);
+	for (size_t i = 0; i < data.size(); ++i)
+	{
+		ManagedObject<TestDefinitionObject> object(&data[i]);
+		CHECK(counter.setValue(object.getHandle(), static_cast<int>(i)));
+		CHECK_EQUAL(static_cast<int>(i), data[i].counter_);
+
+		int value = -1;
+		CHECK(counter.getValue(object.getHandle()).tryCast(value));
+		CHECK_EQUAL(static_cast<int>(i), value);
+	}
+
+	TestDefinitionObject collectionData;
+	ManagedObject<TestDefinitionObject> object(&collectionData);
+	Collection collection;
+	CHECK(klass_->bindProperty("floats", object.getHandleT()).getValue().tryCast(collection));
+	fillValuesWithNumbers(collection);
+
+	CompiledPropertyAccessor element(*klass_, "floats[2]");
+	CHECK(element.isValid());
+	CHECK(element.getProperty() == nullptr);
+
+	float value = 0.0f;
+	CHECK(element.getValue(object.getHandle()).tryCast(value));
+	CHECK_EQUAL(10.75f, value);
+
+	CHECK(element.setValue(object.getHandle(), 2.5f));
+	CHECK(element.getValue(object.getHandle()).tryCast(value));
+	CHECK_EQUAL(2.5f, value);
+	CHECK(CompiledPropertyAccessor(*klass_, "floats[10]").getValue(object.getHandle()).isVoid());
+}
+
+TEST_F(TestDefinitionFixture, concurrent_bind)
+{
+	PropertyAccessor expected;
+	{
+		TestDefinitionObject data;
+		ManagedObject<TestDefinitionObject> object(data);
+		expected = klass_->bindProperty("counter", object.getHandleT());
+	}
+	CHECK(expected.isValid());
+
+	std::atomic<int> failures(0);
+	std::vector<std::thread> threads;
+	for (int i = 0; i < 4; ++i)
+	{
+		threads.emplace_back([&, i] {
+			// Half of the threads run inside their own batch
+			std::unique_ptr<ReflectionBatchQuery> batchQuery(i % 2 ? new ReflectionBatchQuery() : nullptr);
+			for (int j = 0; j < 100; ++j)
+			{
+				TestDefinitionObject data;
+				ManagedObject<TestDefinitionObject> object(data);
+				ObjectHandleT<TestDefinitionObject> handle = object.getHandleT();
+				PropertyAccessor counter = klass_->bindProperty("counter", handle);
+				if (!counter.isValid() || counter.getProperty() != expected.getProperty() ||
+				    !counter.setValue(j))
+				{
+					++failures;
+				}
+			}
+		});
+	}
+	for (auto& thread : threads)
+	{
+		thread.join();
+	}
+	CHECK_EQUAL(0, failures.load());
+}
+
 
 
 class TestDerivationFixture: public TestReflectionFixture
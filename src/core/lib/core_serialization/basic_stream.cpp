@@ -241,6 +241,23 @@ std::streamsize BasicStream::readHard(void* destination, std::streamsize size)
 	return total;
 }
 
+const void* BasicStream::readView(std::streamsize size)
+{
+	if (size < 0 || !resetReadBuffer())
+	{
+		return nullptr;
+	}
+
+	auto view = dataStream_.readView(size);
+	if (view != nullptr)
+	{
+		readPos_ = readBuffer_;
+		readEnd_ = readBuffer_;
+	}
+
+	return view;
+}
+
 std::streamsize BasicStream::writeHard(const void* source, std::streamsize size)
 {
 	std::streamsize total = 0;
@@ -179,6 +179,17 @@ public:
 	*/
 	std::streamsize readHard(void* destination, std::streamsize size);
 
+	/**
+	Wrapper for IDataStream::readView().
+
+	Buffered input is given back to the data stream first, so the view starts at
+	the current read position. Unget area is discarded on success.
+
+	@return @c nullptr if the data stream doesn't support direct access, no state
+	bits are set in this case.
+	*/
+	const void* readView(std::streamsize size);
+
 	/**
 	Write stream until source buffer is sent or error occurred.
 
@@ -29,38 +29,96 @@ void BinaryStream::serializeBuffer(const void* buffer, std::streamsize size)
 	copyFrom(src);
 }
 
-void BinaryStream::deserializeBuffer(IDataStream& destination, std::streamsize maximumSize)
+bool BinaryStream::deserializeBufferSize(std::streamsize& size, std::streamsize maximumSize)
 {
-	size_type size = 0;
-	(*this) >> size;
+	size_type s = 0;
+	(*this) >> s;
 	if (fail())
 	{
-		return;
+		return false;
 	}
 
-	auto s = static_cast<std::streamsize>(size);
-	if (s < 0)
+	size = static_cast<std::streamsize>(s);
+	if (size < 0)
 	{
 		// negative size is not OK
 		setState(std::ios_base::failbit);
-		return;
+		return false;
 	}
 
-	if (static_cast<size_type>(s) != size)
+	if (static_cast<size_type>(size) != s)
 	{
 		// overflow
 		setState(std::ios_base::failbit);
-		return;
+		return false;
 	}
 
-	if (maximumSize > 0 && s > maximumSize)
+	if (maximumSize > 0 && size > maximumSize)
 	{
 		// size limit is exceeded
 		setState(std::ios_base::failbit);
+		return false;
+	}
+
+	return true;
+}
+
+void BinaryStream::deserializeBuffer(IDataStream& destination, std::streamsize maximumSize)
+{
+	std::streamsize s = 0;
+	if (!deserializeBufferSize(s, maximumSize))
+	{
+		return;
+	}
+
+	auto view = s > 0 ? static_cast<const char*>(readView(s)) : nullptr;
+	if (view == nullptr)
+	{
+		copyTo(destination, s);
 		return;
 	}
 
-	copyTo(destination, s);
+	// single write straight from the source storage
+	std::streamsize written = 0;
+	while (written < s)
+	{
+		auto r = destination.write(view + written, s - written);
+		if (r <= 0)
+		{
+			setState(std::ios_base::badbit);
+			break;
+		}
+
+		written += r;
+	}
+}
+
+void BinaryStream::deserializeBuffer(const void*& data, std::streamsize& size, ResizingMemoryStream& fallback,
+                                     std::streamsize maximumSize)
+{
+	data = nullptr;
+	size = 0;
+
+	std::streamsize s = 0;
+	if (!deserializeBufferSize(s, maximumSize) || s == 0)
+	{
+		return;
+	}
+
+	data = readView(s);
+	if (data == nullptr)
+	{
+		fallback.clear();
+		copyTo(fallback, s);
+		if (static_cast<std::streamsize>(fallback.buffer().size()) != s)
+		{
+			setState(std::ios_base::failbit);
+			return;
+		}
+		data = fallback.buffer().data();
+	}
+
+	size = s;
 }
 
 BinaryStream& operator<<(BinaryStream& stream, const std::string& value)
@@ -77,11 +135,20 @@ BinaryStream& operator<<(BinaryStream& stream, const char* value)
 
 BinaryStream& operator>>(BinaryStream& stream, std::string& value)
 {
-	ResizingMemoryStream dst;
-	stream.deserializeBuffer(dst);
+	ResizingMemoryStream fallback;
+	const void* data = nullptr;
+	std::streamsize size = 0;
+	stream.deserializeBuffer(data, size, fallback);
 	if (!stream.fail())
 	{
-		value = dst.takeBuffer();
+		if (size > 0 && data != fallback.buffer().data())
+		{
+			value.assign(static_cast<const char*>(data), static_cast<size_t>(size));
+		}
+		else
+		{
+			value = fallback.takeBuffer();
+		}
 	}
 	return stream;
 }
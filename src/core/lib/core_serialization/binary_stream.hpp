@@ -9,6 +9,8 @@
 
 namespace wgt
 {
+class ResizingMemoryStream;
+
 class SERIALIZATION_DLL BinaryStream : public BasicStream
 {
 	typedef BasicStream base;
@@ -42,6 +44,22 @@ public:
 	size) only on trusted data sources.
 	*/
 	void deserializeBuffer(IDataStream& destination, std::streamsize maximumSize = -1);
+
+	/**
+	Deserialize buffer without copying it when possible.
+
+	If the underlying data stream supports IDataStream::readView() then @a data
+	points into its storage and stays valid as long as that storage does.
+	Otherwise the buffer is copied to @a fallback and @a data points into it.
+	@a data is @c nullptr for an empty buffer.
+
+	@see deserializeBuffer(IDataStream&, std::streamsize) for @a maximumSize.
+	*/
+	void deserializeBuffer(const void*& data, std::streamsize& size, ResizingMemoryStream& fallback,
+	                       std::streamsize maximumSize = -1);
+
+private:
+	bool deserializeBufferSize(std::streamsize& size, std::streamsize maximumSize);
 };
 
 // generic simple types serialization
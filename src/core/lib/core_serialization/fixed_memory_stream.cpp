@@ -79,6 +79,18 @@ std::streamsize FixedMemoryStream::write(const void* source, std::streamsize siz
 	return toWrite;
 }
 
+const void* FixedMemoryStream::readView(std::streamsize size)
+{
+	if (size < 0 || size > size_ - pos_)
+	{
+		return nullptr;
+	}
+
+	const char* view = buffer_ + pos_;
+	pos_ += size;
+	return view;
+}
+
 bool FixedMemoryStream::sync()
 {
 	return true;
@@ -16,6 +16,7 @@ public:
 	std::streamoff seek(std::streamoff offset, std::ios_base::seekdir dir = std::ios_base::beg) override;
 	std::streamsize read(void* destination, std::streamsize size) override;
 	std::streamsize write(const void* source, std::streamsize size) override;
+	const void* readView(std::streamsize size) override;
 	bool sync() override;
 
 private:
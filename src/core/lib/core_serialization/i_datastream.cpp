@@ -20,6 +20,11 @@ std::streamsize IDataStream::write(const void* source, std::streamsize size)
 	return writeRaw(source, static_cast<size_t>(size));
 }
 
+const void* IDataStream::readView(std::streamsize size)
+{
+	return nullptr;
+}
+
 size_t IDataStream::pos() const
 {
 	const auto pos = const_cast<IDataStream*>(this)->seek(0, std::ios_base::cur);
@@ -73,6 +73,20 @@ public:
 	*/
 	virtual std::streamsize write(const void* source, std::streamsize size);
 
+	/**
+	Get direct access to data at current position and advance past it.
+
+	Streams that keep their data in memory can hand out a view into their storage
+	instead of copying it through read(). The view stays valid until the stream is
+	written to or destroyed.
+
+	@param size - amount of data to access
+
+	@return pointer to @a size bytes of data, @c nullptr if the stream doesn't support
+	direct access or less than @a size bytes remain, the position is unchanged then.
+	*/
+	virtual const void* readView(std::streamsize size);
+
 	/**
 	Synchronize the data stream with underlying storage backend.
 
@@ -0,0 +1,516 @@
+//-------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+//
+//  file_system.cpp
+//
+//-------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+//  Copyright (c) Wargaming.net. All rights reserved.
+//-------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+
+#include "core_serialization/file_system.hpp"
+#include "core_serialization/file_info.hpp"
+#include "core_serialization/file_data_stream.hpp"
+#include "core_serialization/mapped_file_stream.hpp"
+#include "core_logging/logging.hpp"
+#include "core_common/signal.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <climits>
+#include <cstdint>
+#include <cstring>
+#include <mutex>
+#include <set>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+#include <fcntl.h>
+#include <poll.h>
+#include <stdlib.h>
+#include <sys/inotify.h>
+#include <sys/sendfile.h>
+#include <sys/stat.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+namespace wgt
+{
+using namespace FileAttributes;
+
+namespace
+{
+// Size of the buffer directory entries are read into, one getdents64 call fills it with many entries
+const size_t ENUMERATE_BUFFER_SIZE = 64 * 1024;
+
+// Files opened for reading at least this large are mapped rather than read through a filebuf
+const off_t MAPPED_READ_THRESHOLD = 256 * 1024;
+
+const uint32_t WATCH_MASK = IN_CREATE | IN_DELETE | IN_MODIFY | IN_ATTRIB | IN_CLOSE_WRITE | IN_MOVED_FROM |
+                            IN_MOVED_TO | IN_DELETE_SELF | IN_MOVE_SELF;
+
+// Layout of the records returned by the getdents64 system call
+struct LinuxDirent64
+{
+	uint64_t d_ino;
+	int64_t d_off;
+	unsigned short d_reclen;
+	unsigned char d_type;
+	char d_name[1];
+};
+
+IFileInfoPtr CreateFileInfo()
+{
+	return std::make_shared<FileInfo>(0, 0, 0, 0, "", "", None);
+}
+
+IFileInfoPtr CreateFileInfo(const struct stat& fileStat, const std::string& path, const std::string& absolutePath,
+                            const char* name)
+{
+	unsigned int attributes = FileAttributes::None;
+
+	if (S_ISDIR(fileStat.st_mode))
+		attributes |= FileAttributes::Directory;
+
+	if (S_ISREG(fileStat.st_mode))
+		attributes |= FileAttribute::Normal;
+
+	if ((fileStat.st_mode & (S_IWUSR | S_IWGRP | S_IWOTH)) == 0)
+		attributes |= FileAttribute::ReadOnly;
+
+	if (name[0] == '.' && name[1] != '\0' && !(name[1] == '.' && name[2] == '\0'))
+		attributes |= FileAttribute::Hidden;
+
+	return std::make_shared<FileInfo>(fileStat.st_size, fileStat.st_ctim.tv_sec, fileStat.st_mtim.tv_sec,
+	                                  fileStat.st_atim.tv_sec, path, absolutePath,
+	                                  static_cast<FileAttribute>(attributes));
+}
+
+std::string AbsolutePath(const char* path)
+{
+	char absolutePath[PATH_MAX];
+	if (realpath(path, absolutePath) == nullptr)
+		return path;
+	return absolutePath;
+}
+
+const char* FileName(const std::string& path)
+{
+	auto end = path.find_last_not_of(FilePath::kDirectorySeparator);
+	auto separator = path.find_last_of(FilePath::kDirectorySeparator, end);
+	return separator == std::string::npos ? path.c_str() : path.c_str() + separator + 1;
+}
+} // namespace
+
+struct FileSystem::Implementation
+{
+	Implementation(FileSystem& self)
+		: self_(self)
+		, inotify_(-1)
+		, wakeRead_(-1)
+		, wakeWrite_(-1)
+	{
+	}
+
+	~Implementation()
+	{
+		stopWatching();
+	}
+
+	void startWatching();
+	void stopWatching();
+	void watchDirectory(const char* dir, const std::string& absolutePath);
+	void watcherThread();
+
+	FileSystem& self_;
+	Signal<IFileSystem::PathChangedSignature> pathChangedSignal_;
+	std::mutex pathChangedMutex_;
+
+	// inotify is only set up once someone listens for changes, directories are watched as they are enumerated
+	std::mutex watchMutex_;
+	std::atomic<int> inotify_;
+	int wakeRead_;
+	int wakeWrite_;
+	std::thread watcher_;
+	struct WatchedDirectory
+	{
+		std::string path_;
+		std::string absolutePath_;
+	};
+	std::unordered_map<int, WatchedDirectory> watchedPaths_;
+	std::set<std::string> watchedDirectories_;
+};
+
+void FileSystem::Implementation::startWatching()
+{
+	std::lock_guard<std::mutex> lock(watchMutex_);
+	if (inotify_ >= 0)
+	{
+		return;
+	}
+
+	int fd = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+	if (fd < 0)
+	{
+		NGT_WARNING_MSG("inotify_init1 failed (%s), file system changes will not be detected\n", strerror(errno));
+		return;
+	}
+
+	int wake[2];
+	if (pipe2(wake, O_NONBLOCK | O_CLOEXEC) != 0)
+	{
+		NGT_WARNING_MSG("pipe2 failed (%s), file system changes will not be detected\n", strerror(errno));
+		close(fd);
+		return;
+	}
+
+	wakeRead_ = wake[0];
+	wakeWrite_ = wake[1];
+	inotify_ = fd;
+	watcher_ = std::thread(&Implementation::watcherThread, this);
+}
+
+void FileSystem::Implementation::stopWatching()
+{
+	if (watcher_.joinable())
+	{
+		const char wake = 0;
+		ssize_t written = write(wakeWrite_, &wake, 1);
+		(void)written;
+		watcher_.join();
+	}
+
+	std::lock_guard<std::mutex> lock(watchMutex_);
+	if (inotify_ >= 0)
+	{
+		close(inotify_);
+		close(wakeRead_);
+		close(wakeWrite_);
+		inotify_ = -1;
+		wakeRead_ = -1;
+		wakeWrite_ = -1;
+	}
+	watchedPaths_.clear();
+	watchedDirectories_.clear();
+}
+
+void FileSystem::Implementation::watchDirectory(const char* dir, const std::string& absolutePath)
+{
+	if (inotify_ < 0)
+	{
+		return;
+	}
+
+	std::lock_guard<std::mutex> lock(watchMutex_);
+	if (inotify_ < 0 || watchedDirectories_.find(absolutePath) != watchedDirectories_.end())
+	{
+		return;
+	}
+
+	int wd = inotify_add_watch(inotify_, absolutePath.c_str(), WATCH_MASK | IN_ONLYDIR);
+	if (wd < 0)
+	{
+		NGT_WARNING_MSG("Failed to watch %s for changes (%s)\n", dir, strerror(errno));
+		return;
+	}
+
+	// Changes are reported with the path the directory was enumerated with
+	WatchedDirectory& watched = watchedPaths_[wd];
+	watched.path_ = dir;
+	watched.absolutePath_ = absolutePath;
+	watchedDirectories_.insert(absolutePath);
+}
+
+void FileSystem::Implementation::watcherThread()
+{
+	alignas(struct inotify_event) char buffer[16 * 1024];
+	std::vector<std::string> changedPaths;
+
+	for (;;)
+	{
+		pollfd fds[2] = { { inotify_, POLLIN, 0 }, { wakeRead_, POLLIN, 0 } };
+		if (poll(fds, 2, -1) < 0)
+		{
+			if (errno == EINTR)
+				continue;
+			NGT_ERROR_MSG("poll failed (%s), no longer watching for file system changes\n", strerror(errno));
+			return;
+		}
+
+		if (fds[1].revents != 0)
+		{
+			return;
+		}
+
+		// Drain everything pending and report each changed path once per batch
+		changedPaths.clear();
+		ssize_t length;
+		while ((length = read(inotify_, buffer, sizeof(buffer))) > 0)
+		{
+			std::lock_guard<std::mutex> lock(watchMutex_);
+			for (char* ptr = buffer; ptr < buffer + length;)
+			{
+				auto event = reinterpret_cast<const struct inotify_event*>(ptr);
+				ptr += sizeof(struct inotify_event) + event->len;
+
+				auto it = watchedPaths_.find(event->wd);
+				if (it == watchedPaths_.end())
+					continue;
+
+				std::string path = it->second.path_;
+				if (event->len > 0)
+				{
+					path.append(1, FilePath::kDirectorySeparator).append(event->name);
+				}
+
+				if (event->mask & IN_IGNORED)
+				{
+					watchedDirectories_.erase(it->second.absolutePath_);
+					watchedPaths_.erase(it);
+				}
+
+				if (std::find(changedPaths.begin(), changedPaths.end(), path) == changedPaths.end())
+				{
+					changedPaths.push_back(std::move(path));
+				}
+			}
+		}
+
+		for (auto& path : changedPaths)
+		{
+			self_.pathChanged(path.c_str());
+		}
+	}
+}
+
+FileSystem::FileSystem()
+	: impl_(new Implementation(*this))
+{
+}
+
+FileSystem::~FileSystem()
+{
+	// The watcher thread reports changes through impl_, so it must stop before impl_ is released
+	impl_->stopWatching();
+	impl_.reset();
+}
+
+bool FileSystem::copy(const char* path, const char* new_path)
+{
+	int source = open(path, O_RDONLY | O_CLOEXEC);
+	if (source < 0)
+		return false;
+
+	struct stat fileStat;
+	if (fstat(source, &fileStat) != 0)
+	{
+		close(source);
+		return false;
+	}
+
+	// Matches the other platforms, copying never replaces an existing file
+	int destination = open(new_path, O_WRONLY | O_CREAT | O_EXCL | O_CLOEXEC, fileStat.st_mode & 0777);
+	if (destination < 0)
+	{
+		close(source);
+		return false;
+	}
+
+	off_t remaining = fileStat.st_size;
+	while (remaining > 0)
+	{
+		ssize_t copied = sendfile(destination, source, nullptr, static_cast<size_t>(remaining));
+		if (copied <= 0)
+		{
+			if (copied < 0 && errno == EINTR)
+				continue;
+			break;
+		}
+		remaining -= copied;
+	}
+
+	close(source);
+	close(destination);
+	if (remaining != 0)
+	{
+		unlink(new_path);
+		return false;
+	}
+	return true;
+}
+
+bool FileSystem::remove(const char* path)
+{
+	return unlink(path) == 0;
+}
+
+bool FileSystem::exists(const char* path) const
+{
+	struct stat fileStat;
+	return stat(path, &fileStat) == 0;
+}
+
+void FileSystem::enumerate(const char* dir, EnumerateCallback callback) const
+{
+	int directory = open(dir, O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+	if (directory < 0)
+		return;
+
+	std::string absoluteDir = AbsolutePath(dir);
+	impl_->watchDirectory(dir, absoluteDir);
+
+	std::string filePath = dir;
+	if (filePath.empty() || filePath.back() != FilePath::kDirectorySeparator)
+		filePath.append(1, FilePath::kDirectorySeparator);
+	const size_t dirLength = filePath.size();
+	if (absoluteDir.empty() || absoluteDir.back() != FilePath::kDirectorySeparator)
+		absoluteDir.append(1, FilePath::kDirectorySeparator);
+	const size_t absoluteDirLength = absoluteDir.size();
+
+	// Entries are fetched in large batches and stat'ed relative to the open directory,
+	// avoiding a readdir call and a full path lookup per file
+	std::unique_ptr<char[]> buffer(new char[ENUMERATE_BUFFER_SIZE]);
+	bool done = false;
+	while (!done)
+	{
+		long length = syscall(SYS_getdents64, directory, buffer.get(), ENUMERATE_BUFFER_SIZE);
+		if (length <= 0)
+			break;
+
+		for (long offset = 0; offset < length;)
+		{
+			auto entry = reinterpret_cast<const LinuxDirent64*>(buffer.get() + offset);
+			offset += entry->d_reclen;
+
+			struct stat fileStat;
+			if (fstatat(directory, entry->d_name, &fileStat, 0) != 0)
+				continue;
+
+			filePath.resize(dirLength);
+			filePath.append(entry->d_name);
+			absoluteDir.resize(absoluteDirLength);
+			absoluteDir.append(entry->d_name);
+			if (callback(CreateFileInfo(fileStat, filePath, absoluteDir, entry->d_name)) == false)
+			{
+				done = true;
+				break;
+			}
+		}
+	}
+
+	close(directory);
+}
+
+IFileSystem::FileType FileSystem::getFileType(const char* path) const
+{
+	struct stat fileStat;
+	if (stat(path, &fileStat) < 0)
+		return IFileSystem::NotFound;
+
+	if (S_ISDIR(fileStat.st_mode))
+		return IFileSystem::Directory;
+
+	return IFileSystem::File;
+}
+
+IFileInfoPtr FileSystem::getFileInfo(const char* path) const
+{
+	struct stat fileStat;
+	if (stat(path, &fileStat) < 0)
+		return CreateFileInfo();
+
+	std::string fullPath = path;
+	return CreateFileInfo(fileStat, fullPath, AbsolutePath(path), FileName(fullPath));
+}
+
+bool FileSystem::move(const char* path, const char* new_path)
+{
+	return ::rename(path, new_path) == 0;
+}
+
+IFileSystem::IStreamPtr FileSystem::readFile(const char* path, std::ios::openmode mode) const
+{
+	struct stat fileStat;
+	if ((mode & (std::ios::out | std::ios::app | std::ios::trunc)) == 0 && stat(path, &fileStat) == 0 &&
+	    S_ISREG(fileStat.st_mode) && fileStat.st_size >= MAPPED_READ_THRESHOLD)
+	{
+		std::unique_ptr<MappedFileStream> stream(new MappedFileStream(path));
+		if (stream->isOpen())
+		{
+			return IStreamPtr(stream.release());
+		}
+	}
+
+	return IStreamPtr(new FileDataStream(path, mode));
+}
+
+bool FileSystem::writeFile(const char* path, const void* data, size_t len, std::ios::openmode mode)
+{
+	std::fstream stream(path, mode);
+	if (!stream.bad())
+	{
+		stream.write(reinterpret_cast<const char*>(data), len);
+		stream.close();
+		return true;
+	}
+	return false;
+}
+
+bool FileSystem::createDirectory(const char* path)
+{
+	bool success = mkdir(path, S_IRWXU | S_IRWXG | S_IROTH | S_IXOTH) == 0 || errno == EEXIST;
+
+	if (!success)
+	{
+		return false;
+	}
+
+	pathChanged(path);
+	return true;
+}
+
+bool FileSystem::removeDirectory(const char* path)
+{
+	if (rmdir(path) != 0)
+	{
+		return false;
+	}
+
+	pathChanged(path);
+	return true;
+}
+
+bool FileSystem::makeWritable(const char* path)
+{
+	struct stat fileStat;
+
+	if (stat(path, &fileStat) != 0)
+	{
+		return false;
+	}
+
+	chmod(path, fileStat.st_mode | S_IWUSR);
+	pathChanged(path);
+	return true;
+}
+
+void FileSystem::invalidateFileInfo(const char* path)
+{
+	pathChanged(path);
+}
+
+Connection FileSystem::listenForChanges(PathChangedCallback& callback)
+{
+	impl_->startWatching();
+	std::lock_guard<std::mutex> lock(impl_->pathChangedMutex_);
+	return impl_->pathChangedSignal_.connect(callback);
+}
+
+void FileSystem::pathChanged(const char* path) const
+{
+	IFileInfoPtr info = getFileInfo(path);
+	std::lock_guard<std::mutex> lock(impl_->pathChangedMutex_);
+	impl_->pathChangedSignal_(path, info);
+}
+} // end namespace wgt
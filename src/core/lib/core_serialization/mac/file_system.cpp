@@ -10,6 +10,7 @@
 #include "core_serialization/file_system.hpp"
 #include "core_serialization/file_info.hpp"
 #include "core_serialization/file_data_stream.hpp"
+#include "core_serialization/mapped_file_stream.hpp"
 
 #include <stdio.h>
 #include <stdlib.h>
@@ -144,6 +145,19 @@ bool FileSystem::move(const char* path, const char* new_path)
 
 IFileSystem::IStreamPtr FileSystem::readFile(const char* path, std::ios::openmode mode) const
 {
+	// Large files opened for reading are mapped rather than copied through a filebuf
+	const off_t mappedReadThreshold = 256 * 1024;
+	struct stat fileStat;
+	if ((mode & (std::ios::out | std::ios::app | std::ios::trunc)) == 0 && stat(path, &fileStat) == 0 &&
+	    S_ISREG(fileStat.st_mode) && fileStat.st_size >= mappedReadThreshold)
+	{
+		std::unique_ptr<MappedFileStream> stream(new MappedFileStream(path));
+		if (stream->isOpen())
+		{
+			return IStreamPtr(stream.release());
+		}
+	}
+
 	return IStreamPtr(new FileDataStream(path, mode));
 }
 
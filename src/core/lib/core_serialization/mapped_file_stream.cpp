@@ -0,0 +1,193 @@
+#include "mapped_file_stream.hpp"
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+
+#if defined(_WIN32)
+#include "core_common/ngt_windows.hpp"
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace wgt
+{
+MappedFileStream::MappedFileStream(const char* path, MapMode mode)
+    : data_(nullptr), size_(0), pos_(0), mode_(mode), open_(false)
+{
+#if defined(_WIN32)
+	HANDLE file = CreateFileA(path, GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, NULL);
+	if (file == INVALID_HANDLE_VALUE)
+	{
+		return;
+	}
+
+	LARGE_INTEGER fileSize;
+	if (!GetFileSizeEx(file, &fileSize))
+	{
+		CloseHandle(file);
+		return;
+	}
+
+	if (fileSize.QuadPart == 0)
+	{
+		open_ = true;
+	}
+	else if (fileSize.QuadPart > 0 && static_cast<unsigned long long>(fileSize.QuadPart) <= SIZE_MAX)
+	{
+		// The view keeps the mapping alive, both handles can be closed straight away
+		HANDLE mapping =
+		CreateFileMappingA(file, NULL, mode == COPY_ON_WRITE ? PAGE_WRITECOPY : PAGE_READONLY, 0, 0, NULL);
+		if (mapping != NULL)
+		{
+			data_ = static_cast<char*>(
+			MapViewOfFile(mapping, mode == COPY_ON_WRITE ? FILE_MAP_COPY : FILE_MAP_READ, 0, 0, 0));
+			CloseHandle(mapping);
+		}
+		if (data_ != nullptr)
+		{
+			size_ = static_cast<std::streamsize>(fileSize.QuadPart);
+			open_ = true;
+		}
+	}
+	CloseHandle(file);
+#else
+	int file = open(path, O_RDONLY | O_CLOEXEC);
+	if (file < 0)
+	{
+		return;
+	}
+
+	struct stat fileStat;
+	if (fstat(file, &fileStat) == 0 && S_ISREG(fileStat.st_mode))
+	{
+		if (fileStat.st_size == 0)
+		{
+			open_ = true;
+		}
+		else
+		{
+			// Private mappings never write back to the file, so copy on write only needs PROT_WRITE
+			const int protection = mode == COPY_ON_WRITE ? PROT_READ | PROT_WRITE : PROT_READ;
+			void* data = mmap(nullptr, static_cast<size_t>(fileStat.st_size), protection, MAP_PRIVATE, file, 0);
+			if (data != MAP_FAILED)
+			{
+				data_ = static_cast<char*>(data);
+				size_ = static_cast<std::streamsize>(fileStat.st_size);
+				open_ = true;
+			}
+		}
+	}
+	close(file);
+#endif
+}
+
+MappedFileStream::~MappedFileStream()
+{
+	if (data_ == nullptr)
+	{
+		return;
+	}
+
+#if defined(_WIN32)
+	UnmapViewOfFile(data_);
+#else
+	munmap(data_, static_cast<size_t>(size_));
+#endif
+}
+
+bool MappedFileStream::isOpen() const
+{
+	return open_;
+}
+
+const void* MappedFileStream::data() const
+{
+	return data_;
+}
+
+std::streamsize MappedFileStream::length() const
+{
+	return size_;
+}
+
+std::streamoff MappedFileStream::seek(std::streamoff offset, std::ios_base::seekdir dir)
+{
+	std::streamoff pos;
+	switch (dir)
+	{
+	case std::ios_base::beg:
+		pos = offset;
+		break;
+
+	case std::ios_base::cur:
+		pos = pos_ + offset;
+		break;
+
+	case std::ios_base::end:
+		pos = size_ + offset;
+		break;
+
+	default:
+		return -1;
+	}
+
+	if (pos < 0 || pos > size_)
+	{
+		return -1;
+	}
+
+	pos_ = pos;
+
+	return pos_;
+}
+
+std::streamsize MappedFileStream::read(void* destination, std::streamsize size)
+{
+	const auto toRead = std::min<std::streamsize>(size, size_ - pos_);
+	if (toRead > 0)
+	{
+		std::memcpy(destination, data_ + pos_, static_cast<size_t>(toRead));
+		pos_ += toRead;
+	}
+
+	return toRead;
+}
+
+std::streamsize MappedFileStream::write(const void* source, std::streamsize size)
+{
+	if (mode_ != COPY_ON_WRITE)
+	{
+		return 0;
+	}
+
+	const auto toWrite = std::min<std::streamsize>(size, size_ - pos_);
+	if (toWrite > 0)
+	{
+		std::memcpy(data_ + pos_, source, static_cast<size_t>(toWrite));
+		pos_ += toWrite;
+	}
+
+	return toWrite;
+}
+
+const void* MappedFileStream::readView(std::streamsize size)
+{
+	if (data_ == nullptr || size < 0 || size > size_ - pos_)
+	{
+		return nullptr;
+	}
+
+	const char* view = data_ + pos_;
+	pos_ += size;
+	return view;
+}
+
+bool MappedFileStream::sync()
+{
+	return true;
+}
+} // end namespace wgt
@@ -0,0 +1,57 @@
+#ifndef MAPPED_FILE_STREAM_HPP
+#define MAPPED_FILE_STREAM_HPP
+
+#include "i_datastream.hpp"
+#include "serialization_dll.hpp"
+
+namespace wgt
+{
+/**
+Data stream over a memory mapped file.
+
+Reading costs page faults instead of copies, and readView() hands out pointers
+straight into the mapping. The file is never modified: READ_ONLY streams
+reject writes, COPY_ON_WRITE streams accept writes within the file size into
+private copies of the touched pages.
+*/
+class SERIALIZATION_DLL MappedFileStream : public IDataStream
+{
+public:
+	enum MapMode
+	{
+		READ_ONLY,
+		COPY_ON_WRITE
+	};
+
+	explicit MappedFileStream(const char* path, MapMode mode = READ_ONLY);
+	~MappedFileStream();
+
+	/**
+	Check whether the file was mapped, empty files are open but have no data.
+	*/
+	bool isOpen() const;
+
+	/**
+	Start of the mapping, valid for the lifetime of the stream.
+	*/
+	const void* data() const;
+	std::streamsize length() const;
+
+	std::streamoff seek(std::streamoff offset, std::ios_base::seekdir dir = std::ios_base::beg) override;
+	std::streamsize read(void* destination, std::streamsize size) override;
+	std::streamsize write(const void* source, std::streamsize size) override;
+	const void* readView(std::streamsize size) override;
+	bool sync() override;
+
+private:
+	MappedFileStream(const MappedFileStream&);
+	MappedFileStream& operator=(const MappedFileStream&);
+
+	char* data_;
+	std::streamsize size_;
+	std::streamoff pos_;
+	MapMode mode_;
+	bool open_;
+};
+} // end namespace wgt
+#endif // MAPPED_FILE_STREAM_HPP
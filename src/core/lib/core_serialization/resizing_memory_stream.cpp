@@ -111,6 +111,18 @@ std::streamsize ResizingMemoryStream::write(const void* source, std::streamsize
 	return size;
 }
 
+const void* ResizingMemoryStream::readView(std::streamsize size)
+{
+	if (size < 0 || size > static_cast<std::streamoff>(buffer_.size()) - pos_)
+	{
+		return nullptr;
+	}
+
+	const char* view = buffer_.c_str() + static_cast<size_t>(pos_);
+	pos_ += size;
+	return view;
+}
+
 bool ResizingMemoryStream::sync()
 {
 	return true;
@@ -0,0 +1,168 @@
+#include "../pch.hpp"
+
+#include "core_serialization/file_system.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <climits>
+#include <condition_variable>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <mutex>
+#include <string>
+#include <vector>
+#include <unistd.h>
+#include <sys/stat.h>
+
+namespace wgt
+{
+TEST(file_sytem)
+{
+	FileSystem fileSystem;
+
+	char const* filePath = "TestFile.txt";
+	char const* testData = "Uni, arch toressful, Could insits bervit of a pren, Abutio, yethis tassion, \
+													to to les wity winet uponeus, licitly of be act it, Hiss, is himent the God's \
+													joyalti-datche imusin a forine), ways knoth ne caught not rience, wer reat meorin \
+													Here of ses of con ch conses our mandif Pal to expeat usives takescie infata he of \
+													scup who . – generated by Just Another Test Text Generator";
+
+	size_t testDataLength = strlen(testData);
+	if (fileSystem.exists(filePath))
+		fileSystem.remove(filePath);
+
+	char wdir[PATH_MAX];
+	CHECK(getcwd(wdir, PATH_MAX) != nullptr);
+	CHECK(fileSystem.exists(wdir) == true);
+	CHECK(fileSystem.getFileInfo(wdir)->isDirectory());
+	CHECK(fileSystem.getFileType(wdir) == IFileSystem::Directory);
+
+	CHECK(fileSystem.exists(filePath) == false);
+	CHECK(fileSystem.writeFile(filePath, testData, testDataLength, std::ios::trunc | std::ios::out));
+	CHECK(fileSystem.exists(filePath) == true);
+
+	IFileSystem::IStreamPtr stream = fileSystem.readFile(filePath, std::ios::in);
+	CHECK(stream->size() == testDataLength);
+	char* readedData = (char*)malloc(stream->size());
+	size_t readedSize = stream->readRaw(readedData, stream->size());
+	CHECK(readedSize == stream->size());
+	stream = nullptr;
+
+	CHECK(memcmp(testData, readedData, testDataLength) == 0);
+
+	CHECK(fileSystem.getFileType(filePath) == IFileSystem::FileType::File);
+	CHECK(fileSystem.getFileType("dummy") == IFileSystem::FileType::NotFound);
+
+	char const* movedFilePath = "MovedTestFile.txt";
+	CHECK(fileSystem.move(filePath, movedFilePath));
+	CHECK(fileSystem.exists(filePath) == false);
+	CHECK(fileSystem.exists(movedFilePath) == true);
+
+	CHECK(fileSystem.copy(movedFilePath, filePath));
+	CHECK(fileSystem.exists(filePath) == true);
+	CHECK(fileSystem.exists(movedFilePath) == true);
+	CHECK(!fileSystem.copy(movedFilePath, filePath));
+
+	CHECK(fileSystem.remove(movedFilePath));
+	CHECK(fileSystem.exists(filePath) == true);
+	CHECK(fileSystem.exists(movedFilePath) == false);
+
+	IFileInfoPtr info = fileSystem.getFileInfo(filePath);
+	CHECK(fileSystem.exists(info->fullPath()->c_str()) == true);
+
+	int counter = 0;
+	fileSystem.enumerate(wdir, [&](IFileInfoPtr&& info) {
+		CHECK(fileSystem.exists(info->fullPath()->c_str()));
+		CHECK(fileSystem.getFileInfo(info->fullPath()->c_str())->size() == info->size());
+		++counter;
+		return true;
+	});
+
+	CHECK(counter != 0);
+
+	CHECK(fileSystem.remove(filePath));
+
+	std::string toolsPath = wdir;
+	toolsPath += FilePath::kNativeDirectorySeparator;
+	toolsPath += "wgtools_testing";
+
+	if (fileSystem.exists(toolsPath.c_str()))
+	{
+		rmdir(toolsPath.c_str());
+	}
+
+	CHECK(!fileSystem.exists(toolsPath.c_str()));
+	CHECK(fileSystem.createDirectory(toolsPath.c_str()));
+	CHECK(fileSystem.exists(toolsPath.c_str()));
+	CHECK(fileSystem.createDirectory(toolsPath.c_str())); // Ensure multiple calls return true
+	CHECK(fileSystem.removeDirectory(toolsPath.c_str()));
+	CHECK(!fileSystem.exists(toolsPath.c_str()));
+
+	free(readedData);
+}
+
+TEST(file_system_mapped_read)
+{
+	FileSystem fileSystem;
+
+	char const* filePath = "LargeTestFile.bin";
+	std::string testData(1024 * 1024, '\0');
+	for (size_t i = 0; i < testData.size(); ++i)
+	{
+		testData[i] = static_cast<char>(i * 31);
+	}
+	CHECK(fileSystem.writeFile(filePath, testData.data(), testData.size(),
+	                           std::ios::trunc | std::ios::out | std::ios::binary));
+
+	IFileSystem::IStreamPtr stream = fileSystem.readFile(filePath, std::ios::in | std::ios::binary);
+	CHECK(stream->size() == testData.size());
+	std::string readData(testData.size(), '\0');
+	CHECK(stream->readRaw(&readData[0], readData.size()) == readData.size());
+	CHECK(readData == testData);
+	stream = nullptr;
+
+	CHECK(fileSystem.remove(filePath));
+}
+
+TEST(file_system_listen_for_changes)
+{
+	FileSystem fileSystem;
+
+	char const* dirPath = "wgtools_watch_testing";
+	char const* filePath = "wgtools_watch_testing/Changed.txt";
+	fileSystem.remove(filePath);
+	CHECK(fileSystem.createDirectory(dirPath));
+
+	std::mutex mutex;
+	std::condition_variable changed;
+	std::vector<std::string> changedPaths;
+	IFileSystem::PathChangedCallback callback = [&](const char* path, const IFileInfoPtr) {
+		std::lock_guard<std::mutex> lock(mutex);
+		changedPaths.push_back(path);
+		changed.notify_all();
+	};
+	Connection connection = fileSystem.listenForChanges(callback);
+
+	// Directories are watched once they have been enumerated
+	fileSystem.enumerate(dirPath, [](IFileInfoPtr&&) { return true; });
+
+	// Written behind the file system's back, only inotify can report it
+	FILE* file = fopen(filePath, "w");
+	CHECK(file != nullptr);
+	fputs("changed", file);
+	fclose(file);
+
+	{
+		std::unique_lock<std::mutex> lock(mutex);
+		changed.wait_for(lock, std::chrono::seconds(5), [&] {
+			return std::find(changedPaths.begin(), changedPaths.end(), filePath) != changedPaths.end();
+		});
+		CHECK(std::find(changedPaths.begin(), changedPaths.end(), filePath) != changedPaths.end());
+	}
+
+	connection.disconnect();
+	CHECK(fileSystem.remove(filePath));
+	CHECK(fileSystem.removeDirectory(dirPath));
+}
+} // end namespace wgt
@@ -0,0 +1,88 @@
+#include "pch.hpp"
+
+#include "CppUnitLite2/src/CppUnitLite2.h"
+#include "core_serialization/binary_stream.hpp"
+#include "core_serialization/file_data_stream.hpp"
+#include "core_serialization/mapped_file_stream.hpp"
+#include "core_serialization/resizing_memory_stream.hpp"
+#include <cstdio>
+#include <fstream>
+#include <string>
+
+namespace wgt
+{
+TEST(mapped_file_stream_views)
+{
+	char const* filePath = "MappedFileStreamTest.bin";
+	const std::string payload(4096, 'x');
+	{
+		ResizingMemoryStream dataStream;
+		BinaryStream stream(dataStream);
+		stream << std::string("header") << payload << 42;
+		std::ofstream file(filePath, std::ios::out | std::ios::binary | std::ios::trunc);
+		file.write(dataStream.buffer().data(), dataStream.buffer().size());
+	}
+
+	{
+		MappedFileStream mapped(filePath);
+		CHECK(mapped.isOpen());
+		const char* begin = static_cast<const char*>(mapped.data());
+		const char* end = begin + mapped.length();
+
+		BinaryStream stream(mapped);
+		std::string header;
+		stream >> header;
+		CHECK_EQUAL(std::string("header"), header);
+
+		// The payload is handed out straight from the mapping
+		ResizingMemoryStream fallback;
+		const void* data = nullptr;
+		std::streamsize size = 0;
+		stream.deserializeBuffer(data, size, fallback);
+		CHECK(!stream.fail());
+		CHECK_EQUAL(static_cast<std::streamsize>(payload.size()), size);
+		CHECK(data >= begin && static_cast<const char*>(data) + size <= end);
+		CHECK(fallback.buffer().empty());
+		CHECK(std::string(static_cast<const char*>(data), static_cast<size_t>(size)) == payload);
+
+		int value = 0;
+		stream >> value;
+		CHECK_EQUAL(42, value);
+
+		// Read only mappings reject writes
+		CHECK_EQUAL(0, mapped.seek(0));
+		CHECK_EQUAL(0, mapped.write("y", 1));
+	}
+
+	{
+		// Copy on write changes the mapped pages but never the file
+		MappedFileStream mapped(filePath, MappedFileStream::COPY_ON_WRITE);
+		CHECK(mapped.isOpen());
+		CHECK_EQUAL(1, mapped.write("y", 1));
+		CHECK_EQUAL('y', static_cast<const char*>(mapped.data())[0]);
+
+		MappedFileStream original(filePath);
+		CHECK(static_cast<const char*>(original.data())[0] != 'y');
+	}
+
+	{
+		// Streams without direct access fall back to copying
+		FileDataStream file(filePath, std::ios::in | std::ios::binary);
+		BinaryStream stream(file);
+		std::string header;
+		stream >> header;
+		CHECK_EQUAL(std::string("header"), header);
+
+		ResizingMemoryStream fallback;
+		const void* data = nullptr;
+		std::streamsize size = 0;
+		stream.deserializeBuffer(data, size, fallback);
+		CHECK(!stream.fail());
+		CHECK(data == fallback.buffer().data());
+		CHECK(fallback.buffer() == payload);
+	}
+
+	CHECK(MappedFileStream("MappedFileStreamMissing.bin").isOpen() == false);
+	std::remove(filePath);
+}
+} // end namespace wgt
@@ -13,11 +13,13 @@ BinaryStream& operator<<(BinaryStream& stream, const BinaryBlock& v)
 
 BinaryStream& operator>>(BinaryStream& stream, BinaryBlock& v)
 {
-	ResizingMemoryStream dataStream;
-	stream.deserializeBuffer(dataStream);
+	ResizingMemoryStream fallback;
+	const void* data = nullptr;
+	std::streamsize size = 0;
+	stream.deserializeBuffer(data, size, fallback);
 	if (!stream.fail())
 	{
-		v = BinaryBlock(dataStream.buffer().c_str(), dataStream.buffer().length(), false);
+		v = BinaryBlock(data != nullptr ? data : "", static_cast<size_t>(size), false);
 	}
 	return stream;
 }
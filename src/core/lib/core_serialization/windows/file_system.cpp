@@ -10,6 +10,7 @@
 #include "core_serialization/file_system.hpp"
 #include "core_serialization/file_info.hpp"
 #include "core_serialization/file_data_stream.hpp"
+#include "core_serialization/mapped_file_stream.hpp"
 #include "core_logging/logging.hpp"
 #include "core_string_utils/string_utils.hpp"
 #include "core_common/signal.hpp"
@@ -180,6 +181,20 @@ bool FileSystem::move(const char* path, const char* new_path)
 }
 IFileSystem::IStreamPtr FileSystem::readFile(const char* path, std::ios::openmode mode) const
 {
+	// Large binary files opened for reading are mapped rather than copied through a filebuf,
+	// text mode reads still need the filebuf's newline translation
+	const __int64 mappedReadThreshold = 256 * 1024;
+	struct _stat64 fileStat;
+	if ((mode & (std::ios::out | std::ios::app | std::ios::trunc)) == 0 && (mode & std::ios::binary) != 0 &&
+	    _stat64(path, &fileStat) == 0 && (fileStat.st_mode & _S_IFREG) != 0 && fileStat.st_size >= mappedReadThreshold)
+	{
+		std::unique_ptr<MappedFileStream> stream(new MappedFileStream(path));
+		if (stream->isOpen())
+		{
+			return IStreamPtr(stream.release());
+		}
+	}
+
 	return IStreamPtr(new FileDataStream(path, mode));
 }
 bool FileSystem::writeFile(const char* path, const void* data, size_t len, std::ios::openmode mode)
@@ -0,0 +1,539 @@
+#include "binaryserializationdocument.hpp"
+#include "binaryserializationnode.hpp"
+#include "../../../lib/core_serialization/i_datastream.hpp"
+#include <algorithm>
+#include <cstring>
+
+namespace wgt
+{
+namespace
+{
+const char FORMAT_MAGIC[4] = { 'W', 'G', 'S', 'B' };
+const uint32_t FORMAT_VERSION = 1;
+const char* const ROOT_NAME = "Root";
+
+struct FileHeader
+{
+	char magic_[4];
+	uint32_t version_;
+	uint32_t nodeCount_;
+	uint32_t stringCount_; // Followed by stringCount_ + 1 offsets into the string data
+	uint32_t stringBytes_;
+	uint32_t valueBytes_;
+};
+
+// Nodes are stored in document order, so children and following siblings always have a higher index
+struct NodeRecord
+{
+	uint32_t name_;
+	uint32_t type_;
+	uint32_t handlerName_;
+	uint32_t firstChild_;
+	uint32_t nextSibling_;
+	uint32_t kind_;
+	uint64_t value_;
+};
+
+bool readAll(IDataStream* stream, char* destination, size_t size)
+{
+	while (size > 0)
+	{
+		std::streamsize readSize = stream->read(destination, static_cast<std::streamsize>(size));
+		if (readSize <= 0)
+		{
+			return false;
+		}
+		destination += readSize;
+		size -= static_cast<size_t>(readSize);
+	}
+	return true;
+}
+
+// Reads size bytes, growing the buffer as the data arrives so a corrupt size can't allocate more than the stream holds
+bool readBody(IDataStream* stream, std::vector<char>& buffer, size_t size)
+{
+	const size_t CHUNK_SIZE = 1 << 20;
+	buffer.clear();
+	while (buffer.size() < size)
+	{
+		const size_t offset = buffer.size();
+		buffer.resize(offset + std::min(CHUNK_SIZE, size - offset));
+		if (!readAll(stream, buffer.data() + offset, buffer.size() - offset))
+		{
+			return false;
+		}
+	}
+	return true;
+}
+
+// Bytes left after the current position, negative if the stream can't seek
+std::streamoff remainingSize(IDataStream* stream)
+{
+	const std::streamoff pos = stream->seek(0, std::ios_base::cur);
+	if (pos < 0)
+	{
+		return -1;
+	}
+
+	const std::streamoff end = stream->seek(0, std::ios_base::end);
+	stream->seek(pos);
+	return end >= pos ? end - pos : -1;
+}
+
+bool writeAll(IDataStream* stream, const void* source, size_t size)
+{
+	if (size == 0)
+	{
+		return true;
+	}
+	std::streamsize writeSize = static_cast<std::streamsize>(size);
+	return stream->write(source, writeSize) == writeSize;
+}
+}
+
+const uint32_t BinarySerializationDocument::NO_INDEX;
+const BinarySerializationDocument::NodeIndex BinarySerializationDocument::ROOT_INDEX;
+
+BinarySerializationDocument::BinarySerializationDocument(SerializerNew* serializer)
+    : SerializationDocument(SerializationFormat::BINARY, serializer), formatVersion_("1")
+{
+}
+
+BinarySerializationDocument::~BinarySerializationDocument()
+{
+}
+
+bool BinarySerializationDocument::readFromStream(IDataStream* stream)
+{
+	this->clear();
+	error_.clear();
+
+	FileHeader header;
+	if (!readAll(stream, reinterpret_cast<char*>(&header), sizeof(header)) ||
+	    memcmp(header.magic_, FORMAT_MAGIC, sizeof(FORMAT_MAGIC)) != 0)
+	{
+		return fail("Not a binary serialization document");
+	}
+
+	if (header.version_ != FORMAT_VERSION)
+	{
+		return fail("Unsupported binary serialization format version");
+	}
+
+	if (header.nodeCount_ == 0 || header.stringCount_ == 0)
+	{
+		return fail("Binary serialization document has no root node");
+	}
+
+	const size_t nodeBytes = size_t(header.nodeCount_) * sizeof(NodeRecord);
+	const size_t offsetBytes = (size_t(header.stringCount_) + 1) * sizeof(uint32_t);
+	const size_t bodySize = nodeBytes + offsetBytes + header.stringBytes_ + header.valueBytes_;
+
+	// The sizes come from the file, so don't trust them further than the stream goes
+	const std::streamoff remaining = remainingSize(stream);
+	if (remaining >= 0 && static_cast<uint64_t>(remaining) < bodySize)
+	{
+		return fail("Binary serialization document is truncated");
+	}
+
+	// Use the stream's storage directly if it allows, a mapped file is then only copied once into the document
+	std::vector<char> buffer;
+	const char* body = static_cast<const char*>(stream->readView(static_cast<std::streamsize>(bodySize)));
+	if (body == nullptr)
+	{
+		if (!readBody(stream, buffer, bodySize))
+		{
+			return fail("Binary serialization document is truncated");
+		}
+		body = buffer.data();
+	}
+
+	const char* nodeData = body;
+	const char* offsetData = nodeData + nodeBytes;
+	const char* stringData = offsetData + offsetBytes;
+	const char* valueData = stringData + header.stringBytes_;
+
+	// String table
+	std::vector<uint32_t> offsets(header.stringCount_ + 1);
+	memcpy(offsets.data(), offsetData, offsetBytes);
+	strings_.reserve(header.stringCount_);
+	for (uint32_t i = 0; i < header.stringCount_; ++i)
+	{
+		if (offsets[i] > offsets[i + 1] || offsets[i + 1] > header.stringBytes_)
+		{
+			return fail("Binary serialization document has a corrupt string table");
+		}
+		strings_.emplace_back(stringData + offsets[i], offsets[i + 1] - offsets[i]);
+		stringIds_.emplace(strings_.back(), i);
+	}
+
+	if (!strings_.front().empty())
+	{
+		return fail("Binary serialization document has a corrupt string table");
+	}
+
+	values_.assign(valueData, valueData + header.valueBytes_);
+
+	// Nodes
+	nodes_.resize(header.nodeCount_);
+	for (uint32_t i = 0; i < header.nodeCount_; ++i)
+	{
+		NodeRecord record;
+		memcpy(&record, nodeData + i * sizeof(NodeRecord), sizeof(NodeRecord));
+
+		if (record.name_ >= header.stringCount_ || record.type_ >= header.stringCount_ ||
+		    record.handlerName_ >= header.stringCount_ || record.kind_ > uint32_t(ValueKind::CHAR))
+		{
+			return fail("Binary serialization document has a corrupt node");
+		}
+
+		Node& node = nodes_[i];
+		node.name_ = record.name_;
+		node.type_ = record.type_;
+		node.handlerName_ = record.handlerName_;
+		node.firstChild_ = record.firstChild_;
+		node.nextSibling_ = record.nextSibling_;
+		node.kind_ = ValueKind(record.kind_);
+		node.value_ = record.value_;
+
+		if (node.kind_ == ValueKind::TEXT && (node.value_ & UINT32_MAX) + (node.value_ >> 32) > header.valueBytes_)
+		{
+			return fail("Binary serialization document has a corrupt node");
+		}
+	}
+
+	// Restore the parent and last child links, checking that every node but the root has exactly one parent
+	for (uint32_t i = 0; i < header.nodeCount_; ++i)
+	{
+		uint32_t previous = i;
+		for (uint32_t child = nodes_[i].firstChild_; child != NO_INDEX; child = nodes_[child].nextSibling_)
+		{
+			if (child <= previous || child >= header.nodeCount_ || nodes_[child].parent_ != NO_INDEX)
+			{
+				return fail("Binary serialization document has a corrupt node hierarchy");
+			}
+			nodes_[child].parent_ = i;
+			nodes_[i].lastChild_ = child;
+			previous = child;
+		}
+	}
+
+	for (uint32_t i = 1; i < header.nodeCount_; ++i)
+	{
+		if (nodes_[i].parent_ == NO_INDEX)
+		{
+			return fail("Binary serialization document has a corrupt node hierarchy");
+		}
+	}
+
+	if (nodes_.front().nextSibling_ != NO_INDEX)
+	{
+		return fail("Binary serialization document has a corrupt node hierarchy");
+	}
+
+	stream->seek(0, std::ios_base::beg);
+
+	return true;
+}
+
+bool BinarySerializationDocument::writeToStream(IDataStream* stream)
+{
+	if (nodes_.empty())
+	{
+		this->initDocument();
+	}
+
+	// Collect the nodes reachable from the root in document order, dropping deleted nodes and replaced values
+	std::vector<uint32_t> order;
+	std::vector<uint32_t> remap(nodes_.size(), NO_INDEX);
+	order.reserve(nodes_.size());
+	uint32_t index = 0;
+	while (index != NO_INDEX)
+	{
+		remap[index] = static_cast<uint32_t>(order.size());
+		order.push_back(index);
+
+		if (nodes_[index].firstChild_ != NO_INDEX)
+		{
+			index = nodes_[index].firstChild_;
+			continue;
+		}
+
+		while (index != 0 && nodes_[index].nextSibling_ == NO_INDEX)
+		{
+			index = nodes_[index].parent_;
+		}
+		index = index == 0 ? NO_INDEX : nodes_[index].nextSibling_;
+	}
+
+	std::vector<NodeRecord> records(order.size());
+	std::vector<char> values;
+	values.reserve(values_.size());
+	for (size_t i = 0; i < order.size(); ++i)
+	{
+		const Node& node = nodes_[order[i]];
+		NodeRecord& record = records[i];
+		record.name_ = node.name_;
+		record.type_ = node.type_;
+		record.handlerName_ = node.handlerName_;
+		record.firstChild_ = node.firstChild_ != NO_INDEX ? remap[node.firstChild_] : NO_INDEX;
+		record.nextSibling_ = node.nextSibling_ != NO_INDEX ? remap[node.nextSibling_] : NO_INDEX;
+		record.kind_ = uint32_t(node.kind_);
+		record.value_ = node.value_;
+
+		if (node.kind_ == ValueKind::TEXT)
+		{
+			const uint64_t offset = values.size();
+			const size_t size = static_cast<size_t>(node.value_ >> 32);
+			const char* text = values_.data() + (node.value_ & UINT32_MAX);
+			values.insert(values.end(), text, text + size);
+			record.value_ = offset | (node.value_ & ~uint64_t(UINT32_MAX));
+		}
+	}
+
+	std::vector<uint32_t> offsets;
+	offsets.reserve(strings_.size() + 1);
+	std::string strings;
+	for (auto& string : strings_)
+	{
+		offsets.push_back(static_cast<uint32_t>(strings.size()));
+		strings += string;
+	}
+	offsets.push_back(static_cast<uint32_t>(strings.size()));
+
+	FileHeader header;
+	memcpy(header.magic_, FORMAT_MAGIC, sizeof(FORMAT_MAGIC));
+	header.version_ = FORMAT_VERSION;
+	header.nodeCount_ = static_cast<uint32_t>(records.size());
+	header.stringCount_ = static_cast<uint32_t>(strings_.size());
+	header.stringBytes_ = static_cast<uint32_t>(strings.size());
+	header.valueBytes_ = static_cast<uint32_t>(values.size());
+
+	if (!writeAll(stream, &header, sizeof(header)) ||
+	    !writeAll(stream, records.data(), records.size() * sizeof(NodeRecord)) ||
+	    !writeAll(stream, offsets.data(), offsets.size() * sizeof(uint32_t)) ||
+	    !writeAll(stream, strings.data(), strings.size()) || !writeAll(stream, values.data(), values.size()))
+	{
+		return false;
+	}
+
+	stream->seek(0, std::ios_base::beg);
+
+	return true;
+}
+
+void BinarySerializationDocument::clear()
+{
+	nodes_.clear();
+	strings_.clear();
+	stringIds_.clear();
+	values_.clear();
+}
+
+std::unique_ptr<SerializationNode> BinarySerializationDocument::findNode(const char* name)
+{
+	if (name == nullptr || nodes_.empty())
+	{
+		return nullptr;
+	}
+
+	uint32_t nameId = this->findString(name, strlen(name));
+	if (nameId == NO_INDEX)
+	{
+		return nullptr;
+	}
+
+	for (uint32_t child = nodes_.front().firstChild_; child != NO_INDEX; child = nodes_[child].nextSibling_)
+	{
+		if (nodes_[child].name_ == nameId)
+		{
+			return this->getNode(child);
+		}
+	}
+
+	return nullptr;
+}
+
+std::unique_ptr<SerializationNode> BinarySerializationDocument::getRootNode()
+{
+	if (nodes_.empty())
+	{
+		this->initDocument();
+	}
+
+	return this->getNode(0);
+}
+
+std::string BinarySerializationDocument::getError() const
+{
+	return error_;
+}
+
+const char* BinarySerializationDocument::getVersion() const
+{
+	return formatVersion_;
+}
+
+BinarySerializationDocument::NodeIndex BinarySerializationDocument::appendNode(NodeIndex parent, const char* name,
+                                                                              size_t nameSize)
+{
+	if (nodes_.empty())
+	{
+		this->initDocument();
+	}
+
+	return this->createNode(parent, this->internString(name, nameSize));
+}
+
+void BinarySerializationDocument::setNodeType(NodeIndex node, const char* type, size_t typeSize)
+{
+	nodes_[node].type_ = this->internString(type, typeSize);
+}
+
+void BinarySerializationDocument::setNodeHandlerName(NodeIndex node, const char* handlerName, size_t handlerNameSize)
+{
+	nodes_[node].handlerName_ = this->internString(handlerName, handlerNameSize);
+}
+
+void BinarySerializationDocument::setNodeText(NodeIndex node, const char* text, size_t textSize)
+{
+	this->setText(node, text, textSize);
+}
+
+void BinarySerializationDocument::initDocument()
+{
+	// The empty string is always the first, so nodes without a type or handler name refer to it
+	if (strings_.empty())
+	{
+		this->internString("", 0);
+	}
+
+	if (nodes_.empty())
+	{
+		this->createNode(NO_INDEX, this->internString(ROOT_NAME, strlen(ROOT_NAME)));
+	}
+}
+
+std::unique_ptr<SerializationNode> BinarySerializationDocument::getNode(NodeIndex node)
+{
+	return std::unique_ptr<SerializationNode>(new BinarySerializationNode(this, node));
+}
+
+uint32_t BinarySerializationDocument::createNode(uint32_t parent, uint32_t name)
+{
+	const uint32_t index = static_cast<uint32_t>(nodes_.size());
+	nodes_.emplace_back();
+	nodes_.back().name_ = name;
+	nodes_.back().parent_ = parent;
+
+	if (parent != NO_INDEX)
+	{
+		Node& parentNode = nodes_[parent];
+		if (parentNode.lastChild_ == NO_INDEX)
+		{
+			parentNode.firstChild_ = index;
+		}
+		else
+		{
+			nodes_[parentNode.lastChild_].nextSibling_ = index;
+		}
+		parentNode.lastChild_ = index;
+	}
+
+	return index;
+}
+
+void BinarySerializationDocument::unlinkNode(uint32_t parent, uint32_t child)
+{
+	Node& parentNode = nodes_[parent];
+	uint32_t previous = NO_INDEX;
+	for (uint32_t current = parentNode.firstChild_; current != NO_INDEX; current = nodes_[current].nextSibling_)
+	{
+		if (current != child)
+		{
+			previous = current;
+			continue;
+		}
+
+		Node& childNode = nodes_[child];
+		if (previous == NO_INDEX)
+		{
+			parentNode.firstChild_ = childNode.nextSibling_;
+		}
+		else
+		{
+			nodes_[previous].nextSibling_ = childNode.nextSibling_;
+		}
+
+		if (parentNode.lastChild_ == child)
+		{
+			parentNode.lastChild_ = previous;
+		}
+
+		childNode.parent_ = NO_INDEX;
+		childNode.nextSibling_ = NO_INDEX;
+		return;
+	}
+}
+
+uint32_t BinarySerializationDocument::internString(const char* data, size_t size)
+{
+	lookupKey_.assign(data, size);
+	auto found = stringIds_.find(lookupKey_);
+	if (found != stringIds_.end())
+	{
+		return found->second;
+	}
+
+	const uint32_t id = static_cast<uint32_t>(strings_.size());
+	strings_.push_back(lookupKey_);
+	stringIds_.emplace(lookupKey_, id);
+	return id;
+}
+
+uint32_t BinarySerializationDocument::findString(const char* data, size_t size) const
+{
+	lookupKey_.assign(data, size);
+	auto found = stringIds_.find(lookupKey_);
+	return found != stringIds_.end() ? found->second : NO_INDEX;
+}
+
+const std::string& BinarySerializationDocument::getString(uint32_t id) const
+{
+	return strings_[id];
+}
+
+void BinarySerializationDocument::clearNodes()
+{
+	// Keeps the string table, for documents whose nodes are replaced with others of the same names
+	nodes_.clear();
+	values_.clear();
+}
+
+void BinarySerializationDocument::setText(uint32_t node, const char* data, size_t size)
+{
+	// Replaced values are left in place until the document is written
+	const uint64_t offset = values_.size();
+	values_.insert(values_.end(), data, data + size);
+	nodes_[node].kind_ = ValueKind::TEXT;
+	nodes_[node].value_ = offset | (uint64_t(size) << 32);
+}
+
+std::string BinarySerializationDocument::getText(const Node& node) const
+{
+	if (node.kind_ != ValueKind::TEXT)
+	{
+		return std::string();
+	}
+
+	return std::string(values_.data() + (node.value_ & UINT32_MAX), static_cast<size_t>(node.value_ >> 32));
+}
+
+bool BinarySerializationDocument::fail(const char* error)
+{
+	this->clear();
+	error_ = error;
+	return false;
+}
+
+} // end namespace wgt
@@ -0,0 +1,106 @@
+#pragma once
+
+#include "../serializationdocument.hpp"
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace wgt
+{
+/**
+* BinarySerializationDocument keeps its nodes in a flat table, with names, types and handler names interned in a
+* string table, so looking up a child compares integers instead of strings.
+* The stream format is the same layout: a header, fixed size node records in document order, the string table and
+* the value data. Reading it is a handful of bulk copies, and takes a view of the stream's data when the stream
+* supports readView, such as a MappedFileStream.
+* Values are written in the byte order of the machine, the format is meant for fast local caches and not for
+* exchanging data, use copyFrom to convert a document to XML for inspection.
+*/
+class BinarySerializationDocument : public SerializationDocument
+{
+	friend class BinarySerializationNode;
+
+public:
+	typedef uint32_t NodeIndex;
+	static const NodeIndex ROOT_INDEX = 0;
+
+	BinarySerializationDocument(SerializerNew* serializer);
+	~BinarySerializationDocument();
+
+	bool readFromStream(IDataStream* stream) override;
+	bool writeToStream(IDataStream* stream) override;
+	void clear() override;
+
+	NodePtr findNode(const char* name) override;
+	NodePtr getRootNode() override;
+
+	std::string getError() const override;
+
+	const char* getVersion() const override;
+
+	/**Appends a node after the existing children of its parent, for readers that build the document while parsing
+	another format. The root node is created first if the document is empty.
+	@return the index of the new node, for the setters below and getNode.*/
+	NodeIndex appendNode(NodeIndex parent, const char* name, size_t nameSize);
+	void setNodeType(NodeIndex node, const char* type, size_t typeSize);
+	void setNodeHandlerName(NodeIndex node, const char* handlerName, size_t handlerNameSize);
+	void setNodeText(NodeIndex node, const char* text, size_t textSize);
+	NodePtr getNode(NodeIndex node);
+
+	/**Drops the nodes but keeps the string table, for documents whose nodes are replaced with others of the same
+	names.*/
+	void clearNodes();
+
+protected:
+	void initDocument() override;
+
+private:
+	static const uint32_t NO_INDEX = UINT32_MAX;
+
+	enum class ValueKind : uint8_t
+	{
+		NONE,
+		TEXT, // Strings, wide strings as UTF-8 and raw data, offset and size into values_
+		INT,
+		UINT,
+		DOUBLE,
+		BOOL,
+		CHAR
+	};
+
+	struct Node
+	{
+		uint32_t name_ = 0;
+		uint32_t type_ = 0;
+		uint32_t handlerName_ = 0;
+		uint32_t parent_ = NO_INDEX;
+		uint32_t firstChild_ = NO_INDEX;
+		uint32_t lastChild_ = NO_INDEX;
+		uint32_t nextSibling_ = NO_INDEX;
+		ValueKind kind_ = ValueKind::NONE;
+		uint64_t value_ = 0; // Scalar bits, or the offset and size of TEXT values
+	};
+
+	uint32_t createNode(uint32_t parent, uint32_t name);
+	void unlinkNode(uint32_t parent, uint32_t child);
+
+	uint32_t internString(const char* data, size_t size);
+	uint32_t findString(const char* data, size_t size) const;
+	const std::string& getString(uint32_t id) const;
+
+	void setText(uint32_t node, const char* data, size_t size);
+	std::string getText(const Node& node) const;
+
+	bool fail(const char* error);
+
+	std::vector<Node> nodes_;
+	std::vector<std::string> strings_;
+	std::unordered_map<std::string, uint32_t> stringIds_;
+	std::vector<char> values_;
+	mutable std::string lookupKey_;
+	std::string error_;
+	const char* formatVersion_;
+};
+
+} // end namespace wgt
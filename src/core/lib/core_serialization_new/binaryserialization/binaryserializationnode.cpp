@@ -0,0 +1,461 @@
+#include "binaryserializationnode.hpp"
+#include <codecvt>
+#include <cstring>
+#include <locale>
+#include <sstream>
+
+namespace wgt
+{
+namespace
+{
+// Text is read with the same stream extraction as XMLSerializationNode, so both formats convert values alike
+template <typename T>
+T parseText(const std::string& text)
+{
+	std::stringstream s(text);
+	T value = T();
+	s >> value;
+	return value;
+}
+
+double toDouble(uint64_t bits)
+{
+	double value;
+	memcpy(&value, &bits, sizeof(value));
+	return value;
+}
+}
+
+BinarySerializationNode::~BinarySerializationNode()
+{
+}
+
+std::unique_ptr<SerializationNode> BinarySerializationNode::createEmptyChildInternal(const char* childName,
+                                                                                     size_t nameSize)
+{
+	if (childName == nullptr)
+	{
+		return nullptr;
+	}
+
+	auto doc = this->getDocumentInternal();
+	return this->createNodeInternal(doc->createNode(index_, doc->internString(childName, nameSize)));
+}
+
+std::unique_ptr<SerializationNode> BinarySerializationNode::createEmptyChildInternal(const SStringRef& childName)
+{
+	return this->createEmptyChildInternal(childName.data(), childName.size());
+}
+
+std::unique_ptr<SerializationNode> BinarySerializationNode::getChildNode(const char* childName, size_t nameSize)
+{
+	if (childName == nullptr)
+	{
+		return nullptr;
+	}
+
+	auto doc = this->getDocumentInternal();
+	uint32_t nameId = doc->findString(childName, nameSize);
+	if (nameId == BinarySerializationDocument::NO_INDEX)
+	{
+		return nullptr;
+	}
+
+	for (uint32_t child = this->getNode().firstChild_; child != BinarySerializationDocument::NO_INDEX;
+	     child = doc->nodes_[child].nextSibling_)
+	{
+		if (doc->nodes_[child].name_ == nameId)
+		{
+			return this->createNodeInternal(child);
+		}
+	}
+
+	return nullptr;
+}
+
+std::unique_ptr<SerializationNode> BinarySerializationNode::getChildNode(const SStringRef& childName)
+{
+	return this->getChildNode(childName.data(), childName.size());
+}
+
+std::vector<std::unique_ptr<SerializationNode>> BinarySerializationNode::getAllChildren(const char* childName,
+                                                                                        size_t nameSize)
+{
+	std::vector<std::unique_ptr<SerializationNode>> childNodes;
+	if (childName == nullptr)
+	{
+		return childNodes;
+	}
+
+	// An empty name gets all children
+	auto doc = this->getDocumentInternal();
+	uint32_t nameId = BinarySerializationDocument::NO_INDEX;
+	if (nameSize > 0)
+	{
+		nameId = doc->findString(childName, nameSize);
+		if (nameId == BinarySerializationDocument::NO_INDEX)
+		{
+			return childNodes;
+		}
+	}
+
+	for (uint32_t child = this->getNode().firstChild_; child != BinarySerializationDocument::NO_INDEX;
+	     child = doc->nodes_[child].nextSibling_)
+	{
+		if (nameSize == 0 || doc->nodes_[child].name_ == nameId)
+		{
+			childNodes.push_back(this->createNodeInternal(child));
+		}
+	}
+
+	return childNodes;
+}
+
+std::vector<std::unique_ptr<SerializationNode>> BinarySerializationNode::getAllChildren(const SStringRef& childName)
+{
+	return this->getAllChildren(childName.data(), childName.size());
+}
+
+bool BinarySerializationNode::isNull() const
+{
+	return index_ >= this->getDocumentInternal()->nodes_.size();
+}
+
+std::string BinarySerializationNode::getName() const
+{
+	return this->getDocumentInternal()->getString(this->getNode().name_);
+}
+
+std::string BinarySerializationNode::getType() const
+{
+	return this->getDocumentInternal()->getString(this->getNode().type_);
+}
+
+std::string BinarySerializationNode::getHandlerName() const
+{
+	return this->getDocumentInternal()->getString(this->getNode().handlerName_);
+}
+
+std::string BinarySerializationNode::getValueString() const
+{
+	const Node& node = this->getNode();
+	switch (node.kind_)
+	{
+	case ValueKind::TEXT:
+		return this->getDocumentInternal()->getText(node);
+	case ValueKind::INT:
+		return std::to_string(static_cast<intmax_t>(node.value_));
+	case ValueKind::UINT:
+		return std::to_string(static_cast<uintmax_t>(node.value_));
+	case ValueKind::DOUBLE:
+	{
+		std::stringstream ss;
+		ss << toDouble(node.value_);
+		return ss.str();
+	}
+	case ValueKind::BOOL:
+		return node.value_ != 0 ? "1" : "0";
+	case ValueKind::CHAR:
+		return std::string(1, static_cast<char>(node.value_));
+	default:
+		return std::string();
+	}
+}
+
+std::wstring BinarySerializationNode::getValueWString() const
+{
+	// Convert, handling UTF-8 correctly.
+	std::wstring_convert<std::codecvt_utf8<wchar_t>> converter;
+	return converter.from_bytes(this->getValueString());
+}
+
+double BinarySerializationNode::getValueDouble() const
+{
+	const Node& node = this->getNode();
+	switch (node.kind_)
+	{
+	case ValueKind::DOUBLE:
+		return toDouble(node.value_);
+	case ValueKind::INT:
+		return static_cast<double>(static_cast<intmax_t>(node.value_));
+	case ValueKind::UINT:
+	case ValueKind::BOOL:
+		return static_cast<double>(node.value_);
+	case ValueKind::NONE:
+		return double(0);
+	default:
+		return parseText<double>(this->getValueString());
+	}
+}
+
+intmax_t BinarySerializationNode::getValueInt() const
+{
+	const Node& node = this->getNode();
+	switch (node.kind_)
+	{
+	case ValueKind::INT:
+	case ValueKind::UINT:
+	case ValueKind::BOOL:
+		return static_cast<intmax_t>(node.value_);
+	case ValueKind::DOUBLE:
+		return static_cast<intmax_t>(toDouble(node.value_));
+	case ValueKind::NONE:
+		return intmax_t(0);
+	default:
+		return parseText<intmax_t>(this->getValueString());
+	}
+}
+
+uintmax_t BinarySerializationNode::getValueUint() const
+{
+	const Node& node = this->getNode();
+	switch (node.kind_)
+	{
+	case ValueKind::INT:
+	case ValueKind::UINT:
+	case ValueKind::BOOL:
+		return static_cast<uintmax_t>(node.value_);
+	case ValueKind::DOUBLE:
+		return static_cast<uintmax_t>(toDouble(node.value_));
+	case ValueKind::NONE:
+		return uintmax_t(0);
+	default:
+		return parseText<uintmax_t>(this->getValueString());
+	}
+}
+
+char BinarySerializationNode::getValueChar() const
+{
+	const Node& node = this->getNode();
+	if (node.kind_ == ValueKind::CHAR)
+	{
+		return static_cast<char>(node.value_);
+	}
+
+	return parseText<char>(this->getValueString());
+}
+
+wchar_t BinarySerializationNode::getValueWChar() const
+{
+	std::wstring wText = this->getValueWString();
+	return wText.empty() ? wchar_t(0) : wText.front();
+}
+
+bool BinarySerializationNode::getValueBool() const
+{
+	const Node& node = this->getNode();
+	if (node.kind_ == ValueKind::BOOL)
+	{
+		return node.value_ != 0;
+	}
+
+	return parseText<bool>(this->getValueString());
+}
+
+void BinarySerializationNode::setNameInternal(const char* name, size_t nameSize)
+{
+	if (name == nullptr)
+	{
+		return;
+	}
+
+	auto doc = this->getDocumentInternal();
+	doc->nodes_[index_].name_ = doc->internString(name, nameSize);
+}
+
+void BinarySerializationNode::setNameInternal(const SStringRef& name)
+{
+	this->setNameInternal(name.data(), name.size());
+}
+
+void BinarySerializationNode::setValueString(const char* value, size_t valueSize, bool setType)
+{
+	this->setPrimitiveType(this->getDocument()->getPrimitiveNames().stringName, setType);
+	this->getDocumentInternal()->setText(index_, value, valueSize);
+}
+
+void BinarySerializationNode::setValueString(const SStringRef& value, bool setType)
+{
+	this->setValueString(value.data(), value.size(), setType);
+}
+
+void BinarySerializationNode::setValueWString(const wchar_t* value, size_t valueSize, bool setType)
+{
+	this->setPrimitiveType(this->getDocument()->getPrimitiveNames().wstringName, setType);
+
+	// Wide strings are stored as UTF-8, like XMLSerializationNode does
+	std::wstring_convert<std::codecvt_utf8<wchar_t>> converter;
+	std::string narrowValue = converter.to_bytes(value, value + valueSize);
+	this->getDocumentInternal()->setText(index_, narrowValue.data(), narrowValue.size());
+}
+
+void BinarySerializationNode::setValueWString(const WSStringRef& value, bool setType)
+{
+	this->setValueWString(value.data(), value.size(), setType);
+}
+
+void BinarySerializationNode::setValueDouble(double value, bool setType)
+{
+	this->setPrimitiveType(this->getDocument()->getPrimitiveNames().doubleName, setType);
+
+	uint64_t bits;
+	memcpy(&bits, &value, sizeof(bits));
+	this->setScalar(ValueKind::DOUBLE, bits);
+}
+
+void BinarySerializationNode::setValueInt(intmax_t value, bool setType)
+{
+	this->setPrimitiveType(this->getDocument()->getPrimitiveNames().intName, setType);
+	this->setScalar(ValueKind::INT, static_cast<uint64_t>(value));
+}
+
+void BinarySerializationNode::setValueUint(uintmax_t value, bool setType)
+{
+	this->setPrimitiveType(this->getDocument()->getPrimitiveNames().uintName, setType);
+	this->setScalar(ValueKind::UINT, static_cast<uint64_t>(value));
+}
+
+void BinarySerializationNode::setValueChar(char value, bool setType)
+{
+	this->setPrimitiveType(this->getDocument()->getPrimitiveNames().charName, setType);
+	this->setScalar(ValueKind::CHAR, static_cast<uint8_t>(value));
+}
+
+void BinarySerializationNode::setValueWChar(wchar_t value, bool setType)
+{
+	// Typed as a wide string, as XMLSerializationNode does
+	this->setPrimitiveType(this->getDocument()->getPrimitiveNames().wstringName, setType);
+
+	std::wstring_convert<std::codecvt_utf8<wchar_t>> converter;
+	std::string narrowValue = converter.to_bytes(value);
+	this->getDocumentInternal()->setText(index_, narrowValue.data(), narrowValue.size());
+}
+
+void BinarySerializationNode::setValueBool(bool value, bool setType)
+{
+	this->setPrimitiveType(this->getDocument()->getPrimitiveNames().boolName, setType);
+	this->setScalar(ValueKind::BOOL, value ? 1 : 0);
+}
+
+void BinarySerializationNode::setValueRawData(const char* value, size_t valueSize, const char* typeName,
+                                              size_t typeNameSize)
+{
+	if (typeName != nullptr)
+	{
+		this->setType(typeName, typeNameSize);
+	}
+
+	this->getDocumentInternal()->setText(index_, value, valueSize);
+}
+
+void BinarySerializationNode::setValueRawData(const char* value, size_t valueSize, const SStringRef& typeName)
+{
+	this->setValueRawData(value, valueSize, typeName.data(), typeName.size());
+}
+
+void BinarySerializationNode::setHandlerName(const char* handlerName, size_t handlerNameSize)
+{
+	if (handlerNameSize == size_t(0))
+	{
+		return;
+	}
+
+	auto doc = this->getDocumentInternal();
+	doc->nodes_[index_].handlerName_ = doc->internString(handlerName, handlerNameSize);
+}
+
+void BinarySerializationNode::setHandlerName(const SStringRef& value)
+{
+	this->setHandlerName(value.data(), value.size());
+}
+
+void BinarySerializationNode::setType(const char* typeName, size_t typeNameSize)
+{
+	auto doc = this->getDocumentInternal();
+	doc->nodes_[index_].type_ = doc->internString(typeName, typeNameSize);
+}
+
+void BinarySerializationNode::setType(const SStringRef& typeName)
+{
+	this->setType(typeName.data(), typeName.size());
+}
+
+void BinarySerializationNode::deleteChild(const char* childName, size_t nameSize)
+{
+	auto targetChild = this->getChildNode(childName, nameSize);
+	if (targetChild == nullptr)
+	{
+		return;
+	}
+
+	auto doc = this->getDocumentInternal();
+	doc->unlinkNode(index_, static_cast<BinarySerializationNode*>(targetChild.get())->index_);
+}
+
+void BinarySerializationNode::deleteChild(const SStringRef& childName)
+{
+	this->deleteChild(childName.data(), childName.size());
+}
+
+void BinarySerializationNode::deleteChild(std::unique_ptr<SerializationNode>& childNode)
+{
+	// Ensure that we have the same document (and must therefore be of the same type)
+	if (childNode == nullptr || childNode->getDocument() != this->getDocument())
+	{
+		return;
+	}
+
+	// childNode isn't actually a child
+	auto doc = this->getDocumentInternal();
+	uint32_t childIndex = static_cast<BinarySerializationNode*>(childNode.get())->index_;
+	if (doc->nodes_[childIndex].parent_ != index_)
+	{
+		return;
+	}
+
+	doc->unlinkNode(index_, childIndex);
+	childNode.reset();
+}
+
+void BinarySerializationNode::deleteChildren()
+{
+	auto doc = this->getDocumentInternal();
+	Node& node = doc->nodes_[index_];
+	while (node.firstChild_ != BinarySerializationDocument::NO_INDEX)
+	{
+		doc->unlinkNode(index_, node.firstChild_);
+	}
+}
+
+BinarySerializationDocument* BinarySerializationNode::getDocumentInternal() const
+{
+	// BinaryNodes are only created by a BinaryDocument or other BinaryNodes, so this should always be valid.
+	return static_cast<BinarySerializationDocument*>(this->getDocument());
+}
+
+const BinarySerializationNode::Node& BinarySerializationNode::getNode() const
+{
+	return this->getDocumentInternal()->nodes_[index_];
+}
+
+std::unique_ptr<SerializationNode> BinarySerializationNode::createNodeInternal(uint32_t index) const
+{
+	return std::unique_ptr<SerializationNode>(new BinarySerializationNode(this->getDocumentInternal(), index));
+}
+
+void BinarySerializationNode::setPrimitiveType(const char* typeName, bool setType)
+{
+	if (setType)
+	{
+		this->setType(typeName, strlen(typeName));
+	}
+}
+
+void BinarySerializationNode::setScalar(ValueKind kind, uint64_t value)
+{
+	Node& node = this->getDocumentInternal()->nodes_[index_];
+	node.kind_ = kind;
+	node.value_ = value;
+}
+
+} // end namespace wgt
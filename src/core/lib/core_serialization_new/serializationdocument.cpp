@@ -26,4 +26,49 @@ const SerializationDocument::SerializationPrimitiveNames& SerializationDocument:
 	return primitiveNames_;
 }
 
+namespace
+{
+bool copyNode(SerializationNode& source, SerializationNode& target)
+{
+	const std::string value = source.getValueString();
+	if (!value.empty())
+	{
+		target.setValueRawData(value.data(), value.size(), nullptr, 0);
+	}
+
+	const std::string type = source.getType();
+	if (!type.empty())
+	{
+		target.setType(type.data(), type.size());
+	}
+
+	const std::string handlerName = source.getHandlerName();
+	target.setHandlerName(handlerName.data(), handlerName.size());
+
+	for (auto& sourceChild : source.getAllChildren())
+	{
+		const std::string name = sourceChild->getName();
+		auto targetChild = target.createEmptyChild(name.data(), name.size());
+		if (targetChild == nullptr || !copyNode(*sourceChild, *targetChild))
+		{
+			return false;
+		}
+	}
+
+	return true;
+}
+}
+
+bool SerializationDocument::copyFrom(SerializationDocument& source)
+{
+	this->clear();
+
+	auto sourceRoot = source.getRootNode();
+	auto targetRoot = this->getRootNode();
+	const std::string rootName = sourceRoot->getName();
+	targetRoot->setName(rootName.data(), rootName.size());
+
+	return copyNode(*sourceRoot, *targetRoot);
+}
+
 } // end namespace wgt
\ No newline at end of file
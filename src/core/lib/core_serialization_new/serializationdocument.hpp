@@ -49,6 +49,10 @@ public:
 
 	const SerializationPrimitiveNames& getPrimitiveNames() const;
 
+	/**Replaces the contents of this document with the nodes of another, which may be of a different format.
+	Values are copied as text, so a binary document can be copied to an XML document to inspect it.*/
+	bool copyFrom(SerializationDocument& source);
+
 protected:
 	virtual void initDocument() = 0;
 
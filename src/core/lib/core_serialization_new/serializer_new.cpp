@@ -4,6 +4,9 @@
 #include "../../lib/core_variant/variant.hpp"
 #include "../../lib/core_serialization/resizing_memory_stream.hpp"
 #include "xmlserialization/xmlserializationdocument.hpp"
+#include "binaryserialization/binaryserializationdocument.hpp"
+#include "xmlserialization/xmlserializationreader.hpp"
+#include "core_serialization/text_stream.hpp"
 #include "serializationnode.hpp"
 #include <string>
 #include <cstring>
@@ -24,6 +27,9 @@ std::unique_ptr<SerializationDocument> SerializerNew::getDocument(SerializationF
 	case wgt::XML:
 		doc = static_cast<SerializationDocument*>(new XMLSerializationDocument(this));
 		break;
+	case wgt::BINARY:
+		doc = static_cast<SerializationDocument*>(new BinarySerializationDocument(this));
+		break;
 	case wgt::END:
 		break;
 	default:
@@ -83,14 +89,51 @@ bool SerializerNew::deserializeFromStream(Variant& v, IDataStream* stream, Seria
 	if (stream == nullptr)
 		return false;
 
-	auto doc = getDocument(format);
+	// Deserialize the first object node without building the rest of the document
+	bool found = false;
+	bool success = readEachFromStream(stream, format, [this, &v, &found](const NodePtr& node) {
+		if (node->getName() != "object")
+		{
+			return true;
+		}
+
+		found = deserializeObject(v, node);
+		return false;
+	});
+
+	return success && found;
+}
 
-	if (!doc->readFromStream(stream))
+bool SerializerNew::readEachFromStream(IDataStream* stream, SerializationFormat format,
+                                       const std::function<bool(const NodePtr&)>& callback)
+{
+	if (stream == nullptr)
+		return false;
+
+	if (format == wgt::DEFAULT || format == wgt::XML)
+	{
+		TextStream textStream(*stream);
+		XMLSerializationReader reader(textStream, this);
+		bool success = reader.read(callback);
+		textStream.seek(0, std::ios_base::beg);
+		return success;
+	}
+
+	auto doc = getDocument(format);
+	if (doc == nullptr || !doc->readFromStream(stream))
 	{
 		return false;
 	}
 
-	return deserializeFromDocument(v, doc.get());
+	for (auto& child : doc->getRootNode()->getAllChildren())
+	{
+		if (!callback(child))
+		{
+			break;
+		}
+	}
+
+	return true;
 }
 
 bool SerializerNew::serializeObject(const Variant& v, const NodePtr& node, bool setType)
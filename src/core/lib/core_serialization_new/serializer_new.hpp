@@ -34,6 +34,11 @@ public:
 	bool deserializeFromDocument(Variant& v, SerializationDocument* doc) override;
 	bool deserializeFromStream(Variant& v, IDataStream* stream, SerializationFormat format) override;
 
+	/**Calls the callback with each child of the document's root node in turn, stopping if it returns false.
+	XML is parsed as a stream, so only the current child's nodes are in memory, rather than the whole document.*/
+	bool readEachFromStream(IDataStream* stream, SerializationFormat format,
+	                        const std::function<bool(const NodePtr&)>& callback) override;
+
 protected:
 	// Handler serialization - these are the functions that will be called recursively.
 	bool serializeObject(const Variant& v, const NodePtr& node, bool setType = true);
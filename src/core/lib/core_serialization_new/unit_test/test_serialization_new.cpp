@@ -705,4 +705,310 @@ TEST(Serializer_New_Collection_Handler_XML)
 	bool ummEqual = ummapContainer == ummapCollectionOut.cast<std::unordered_multimap<char, double>>();
 	CHECK(ummEqual);
 }
+
+namespace
+{
+NSTestBigClass makeBigObject(int index)
+{
+	NSTestBigClass object;
+	object.setCondition(index % 2 == 0);
+	object.setCount(index * 37 - 1000);
+	object.setName("Object" + std::to_string(index));
+	object.setPoint(double(index % 1000) + 0.25);
+	object.setString("asdfghjkl");
+
+	NSTestSmallClass& preferenceObject = object.getChild();
+	preferenceObject.setFirstPref("CoolFeatureEnabled = true");
+	preferenceObject.setSecondPref(("Volume = " + std::to_string(index % 100)).c_str());
+	preferenceObject.setThirdPref("Language = Pirate");
+	return object;
+}
+
+// Reads through to another stream without being able to seek, like a network or pipe stream
+class ForwardOnlyStream : public IDataStream
+{
+public:
+	ForwardOnlyStream(IDataStream& stream) : stream_(stream)
+	{
+	}
+
+	std::streamoff seek(std::streamoff offset, std::ios_base::seekdir dir = std::ios_base::beg) override
+	{
+		return -1;
+	}
+
+	std::streamsize read(void* destination, std::streamsize size) override
+	{
+		return stream_.read(destination, size);
+	}
+
+	std::streamsize write(const void* source, std::streamsize size) override
+	{
+		return 0;
+	}
+
+	bool sync() override
+	{
+		return false;
+	}
+
+private:
+	IDataStream& stream_;
+};
+
+// Sets one of the header's 32 bit fields, which follow the 4 byte magic
+std::string patchHeader(std::string data, size_t field, uint32_t value)
+{
+	memcpy(&data[4 + field * sizeof(uint32_t)], &value, sizeof(value));
+	return data;
+}
+}
+
+TEST(Serializer_New_Handlers_Binary)
+{
+	SerializationHandlerManager handlerManager(definitionManager());
+	SerializerNew serializer(&handlerManager);
+
+	std::shared_ptr<NSTestBigClassHandler> bigHandler = std::make_shared<NSTestBigClassHandler>();
+	handlerManager.registerHandler(bigHandler);
+	std::shared_ptr<NSTestSmallClassHandler> smallHandler = std::make_shared<NSTestSmallClassHandler>();
+	handlerManager.registerHandler(smallHandler);
+
+	NSTestBigClass valuesObject = makeBigObject(42);
+	valuesObject.setPoint(59251.123456789);
+	Variant a = valuesObject;
+	Variant b;
+
+	// Write the document to a stream and read it back
+	ResizingMemoryStream rs;
+	{
+		auto document = serializer.getDocument(SerializationFormat::BINARY);
+		CHECK(document->getRootNode()->createChildVariant("object", a) != nullptr);
+		auto extraNode = document->getRootNode()->createChildInt("deleted", -370);
+		document->getRootNode()->deleteChild(extraNode);
+		CHECK(extraNode == nullptr);
+		CHECK(document->writeToStream(&rs));
+	}
+
+	auto document = serializer.getDocument(SerializationFormat::BINARY);
+	CHECK(document->readFromStream(&rs));
+	auto primNames = document->getPrimitiveNames();
+	auto rootNode = document->getRootNode();
+	CHECK(strcmp(rootNode->getName().c_str(), "Root") == 0);
+	CHECK(rootNode->getAllChildren().size() == 1);
+	CHECK(rootNode->getChildNode("deleted") == nullptr);
+
+	auto objectNode = document->findNode("object");
+	CHECK(objectNode != nullptr);
+	if (objectNode != nullptr)
+	{
+		CHECK(strcmp(objectNode->getChildNode("name")->getType().c_str(), primNames.stringName) == 0);
+		CHECK(strcmp(objectNode->getChildNode("count")->getType().c_str(), primNames.intName) == 0);
+		CHECK(strcmp(objectNode->getChildNode("condition")->getType().c_str(), primNames.boolName) == 0);
+		CHECK(strcmp(objectNode->getChildNode("point")->getType().c_str(), primNames.doubleName) == 0);
+
+		// Values are converted like XML values when read as another type
+		CHECK(objectNode->getChildNode("count")->getValueString() == std::to_string(42 * 37 - 1000));
+		CHECK(objectNode->getChildNode("point")->getValueString() == "59251.1");
+
+		// Binary values aren't rounded to text
+		CHECK(objectNode->getValueVariant(b));
+		NSTestBigClass deserializedObject = b.cast<NSTestBigClass>();
+		CHECK(deserializedObject == valuesObject);
+	}
+
+	// Streams in other formats are rejected
+	std::string xmlString("<Root><object>7</object></Root>");
+	ResizingMemoryStream xmlStream(xmlString);
+	CHECK(!document->readFromStream(&xmlStream));
+	CHECK(!document->getError().empty());
+
+	bigHandler.reset();
+	smallHandler.reset();
+}
+
+TEST(Serializer_New_Binary_XML_Copy)
+{
+	SerializationHandlerManager handlerManager(definitionManager());
+	SerializerNew serializer(&handlerManager);
+
+	std::shared_ptr<NSTestBigClassHandler> bigHandler = std::make_shared<NSTestBigClassHandler>();
+	handlerManager.registerHandler(bigHandler);
+	std::shared_ptr<NSTestSmallClassHandler> smallHandler = std::make_shared<NSTestSmallClassHandler>();
+	handlerManager.registerHandler(smallHandler);
+
+	NSTestBigClass valuesObject = makeBigObject(7);
+	std::wstring wstringA = L"UTF-8 string \U00000400 \U0000040A \U00000449 \U00000452 \U00000607 \U00000778";
+
+	auto binaryDocument = serializer.getDocument(SerializationFormat::BINARY);
+	{
+		auto rootNode = binaryDocument->getRootNode();
+		rootNode->createChildVariant("object", valuesObject);
+		rootNode->createChildWString("wstring", wstringA);
+		rootNode->createChildChar("char", '&');
+		rootNode->createChildUint("uint", 183765);
+	}
+
+	// Copy to XML, which can be written out to inspect the binary document
+	auto xmlDocument = serializer.getDocument(SerializationFormat::XML);
+	CHECK(xmlDocument->copyFrom(*binaryDocument));
+	ResizingMemoryStream rs;
+	CHECK(xmlDocument->writeToStream(&rs));
+	xmlDocument->clear();
+	CHECK(xmlDocument->readFromStream(&rs));
+
+	// And back to binary
+	auto copiedDocument = serializer.getDocument(SerializationFormat::BINARY);
+	CHECK(copiedDocument->copyFrom(*xmlDocument));
+	auto rootNode = copiedDocument->getRootNode();
+
+	Variant b;
+	auto objectNode = rootNode->getChildNode("object");
+	CHECK(objectNode != nullptr && objectNode->getValueVariant(b));
+	NSTestBigClass deserializedObject = b.cast<NSTestBigClass>();
+	CHECK(deserializedObject == valuesObject);
+
+	CHECK(rootNode->getChildNode("wstring")->getValueWString() == wstringA);
+	CHECK(rootNode->getChildNode("char")->getValueChar() == '&');
+	CHECK(rootNode->getChildNode("uint")->getValueUint() == 183765);
+	CHECK(strcmp(rootNode->getChildNode("uint")->getType().c_str(), copiedDocument->getPrimitiveNames().uintName) ==
+	      0);
+
+	bigHandler.reset();
+	smallHandler.reset();
+}
+
+TEST(Serializer_New_Binary_Corrupt_Header)
+{
+	SerializationHandlerManager handlerManager(definitionManager());
+	SerializerNew serializer(&handlerManager);
+
+	ResizingMemoryStream rs;
+	{
+		auto document = serializer.getDocument(SerializationFormat::BINARY);
+		document->getRootNode()->createChildString("name", "Corrupt header");
+		document->getRootNode()->createChildInt("count", 12);
+		CHECK(document->writeToStream(&rs));
+	}
+	const std::string data = rs.buffer();
+
+	auto document = serializer.getDocument(SerializationFormat::BINARY);
+	ResizingMemoryStream valid(data);
+	CHECK(document->readFromStream(&valid));
+
+	// Sizes larger than the stream fail before anything is allocated for them
+	const size_t NODE_COUNT = 1;
+	const size_t VALUE_BYTES = 4;
+	ResizingMemoryStream hugeNodeCount(patchHeader(data, NODE_COUNT, 0x7FFFFFFF));
+	CHECK(!document->readFromStream(&hugeNodeCount));
+	CHECK(!document->getError().empty());
+	ResizingMemoryStream hugeValueBytes(patchHeader(data, VALUE_BYTES, 0xFFFFFFFF));
+	CHECK(!document->readFromStream(&hugeValueBytes));
+	CHECK(!document->getError().empty());
+
+	ResizingMemoryStream truncated(data.substr(0, data.size() - 1));
+	CHECK(!document->readFromStream(&truncated));
+
+	// Streams that can't seek are read as far as they go
+	ResizingMemoryStream hugeValueSource(patchHeader(data, VALUE_BYTES, 0xFFFFFFFF));
+	ForwardOnlyStream hugeValueForward(hugeValueSource);
+	CHECK(!document->readFromStream(&hugeValueForward));
+	CHECK(!document->getError().empty());
+
+	ResizingMemoryStream validSource(data);
+	ForwardOnlyStream validForward(validSource);
+	CHECK(document->readFromStream(&validForward));
+	CHECK(document->getRootNode()->getChildNode("count")->getValueInt() == 12);
+}
+
+TEST(Serializer_New_Streaming_XML)
+{
+	SerializationHandlerManager handlerManager(definitionManager());
+	SerializerNew serializer(&handlerManager);
+
+	std::shared_ptr<NSTestBigClassHandler> bigHandler = std::make_shared<NSTestBigClassHandler>();
+	handlerManager.registerHandler(bigHandler);
+	std::shared_ptr<NSTestSmallClassHandler> smallHandler = std::make_shared<NSTestSmallClassHandler>();
+	handlerManager.registerHandler(smallHandler);
+
+	const int objectCount = 50;
+	std::vector<NSTestBigClass> objects;
+	ResizingMemoryStream rs;
+	{
+		auto document = serializer.getDocument(SerializationFormat::XML);
+		auto rootNode = document->getRootNode();
+		rootNode->createChildString("description", "Objects\nand a string");
+		for (int i = 0; i < objectCount; ++i)
+		{
+			objects.push_back(makeBigObject(i));
+			rootNode->createChildVariant("object", objects.back());
+		}
+		CHECK(document->writeToStream(&rs));
+	}
+
+	// Read the whole document into the DOM
+	std::vector<std::string> domNames;
+	std::vector<Variant> domValues;
+	{
+		auto document = serializer.getDocument(SerializationFormat::XML);
+		CHECK(document->readFromStream(&rs));
+		for (auto& child : document->getRootNode()->getAllChildren())
+		{
+			Variant v;
+			CHECK(child->getValueVariant(v));
+			domNames.push_back(child->getName());
+			domValues.push_back(v);
+		}
+	}
+	CHECK_EQUAL(size_t(objectCount + 1), domNames.size());
+
+	// Streaming the same document gives the same nodes in the same order, with only one in memory at a time
+	std::vector<std::string> names;
+	std::vector<Variant> values;
+	CHECK(serializer.readEachFromStream(&rs, SerializationFormat::XML, [&](const SerializerNew::NodePtr& node) {
+		Variant v;
+		CHECK(node->getValueVariant(v));
+		names.push_back(node->getName());
+		values.push_back(v);
+		return true;
+	}));
+	CHECK(names == domNames);
+	CHECK_EQUAL(domValues.size(), values.size());
+	for (size_t i = 0; i < values.size() && i < domValues.size(); ++i)
+	{
+		if (names[i] == "object")
+		{
+			NSTestBigClass object = values[i].cast<NSTestBigClass>();
+			NSTestBigClass domObject = domValues[i].cast<NSTestBigClass>();
+			CHECK(object == domObject);
+			CHECK(i > 0 && i <= objects.size() && object == objects[i - 1]);
+		}
+		else
+		{
+			CHECK(values[i] == domValues[i]);
+		}
+	}
+	CHECK(!values.empty() && values.front() == std::string("Objects\nand a string"));
+
+	// The callback can stop reading
+	size_t count = 0;
+	CHECK(serializer.readEachFromStream(&rs, SerializationFormat::XML, [&count](const SerializerNew::NodePtr& node) {
+		return ++count < 10;
+	}));
+	CHECK_EQUAL(size_t(10), count);
+
+	// A single object is read without building the rest of the document
+	Variant first;
+	CHECK(serializer.deserializeFromStream(first, &rs, SerializationFormat::XML));
+	NSTestBigClass firstObject = first.cast<NSTestBigClass>();
+	CHECK(firstObject == objects.front());
+
+	std::string badXMLString("<Root><object>7</object><<othernode>7</othernode></Root>");
+	ResizingMemoryStream badStream(badXMLString);
+	CHECK(!serializer.readEachFromStream(&badStream, SerializationFormat::XML,
+	                                     [](const SerializerNew::NodePtr& node) { return true; }));
+
+	bigHandler.reset();
+	smallHandler.reset();
+}
 }
\ No newline at end of file
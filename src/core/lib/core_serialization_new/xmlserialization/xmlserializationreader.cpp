@@ -0,0 +1,142 @@
+#include "xmlserializationreader.hpp"
+#include <algorithm>
+#include <cctype>
+#include <cstring>
+
+namespace wgt
+{
+namespace
+{
+// tinyxml2 only creates a text node for character data that isn't all whitespace
+bool hasText(const std::string& characterData)
+{
+	return std::any_of(characterData.begin(), characterData.end(), [](char c) {
+		return static_cast<unsigned char>(c) >= 128 || !isspace(static_cast<unsigned char>(c));
+	});
+}
+}
+
+XMLSerializationReader::XMLSerializationReader(TextStream& stream, SerializerNew* serializer)
+    : base(stream), document_(serializer), callback_(nullptr), depth_(0), finished_(false)
+{
+}
+
+XMLSerializationReader::~XMLSerializationReader()
+{
+}
+
+bool XMLSerializationReader::read(const NodeCallback& callback)
+{
+	callback_ = &callback;
+	depth_ = 0;
+	finished_ = false;
+
+	bool success = base::parse();
+
+	callback_ = nullptr;
+	document_.clear();
+
+	return success || finished_;
+}
+
+void XMLSerializationReader::elementStart(const char* elementName, const char* const* attributes)
+{
+	++depth_;
+
+	// The root node only holds the format version
+	if (depth_ == 1)
+	{
+		return;
+	}
+
+	const size_t level = depth_ - 2;
+	if (stack_.size() <= level)
+	{
+		stack_.emplace_back();
+	}
+
+	// Element names were validated by the parser, build the nodes directly instead of through createEmptyChild
+	BinarySerializationDocument::NodeIndex parentNode = BinarySerializationDocument::ROOT_INDEX;
+	if (level > 0)
+	{
+		// Only character data before the first child is the node's value, like XMLElement::GetText
+		StackItem& parent = stack_[level - 1];
+		this->flushCharacterData(parent);
+		parent.hasChildren = true;
+		parentNode = parent.node;
+	}
+
+	const auto node = document_.appendNode(parentNode, elementName, strlen(elementName));
+
+	for (auto attribute = attributes; *attribute != nullptr; attribute += 2)
+	{
+		if (strcmp(attribute[0], formatData_.typeTag) == 0)
+		{
+			document_.setNodeType(node, attribute[1], strlen(attribute[1]));
+		}
+		else if (strcmp(attribute[0], formatData_.handlerNameTag) == 0)
+		{
+			document_.setNodeHandlerName(node, attribute[1], strlen(attribute[1]));
+		}
+	}
+
+	StackItem& item = stack_[level];
+	item.node = node;
+	item.characterData.clear();
+	item.hasChildren = false;
+}
+
+void XMLSerializationReader::elementEnd(const char* elementName)
+{
+	// XMLSerializationDocument writes a null terminator after the root node, stop at its end like tinyxml2 does
+	if (depth_ == 1)
+	{
+		--depth_;
+		finished_ = true;
+		abortParsing();
+		return;
+	}
+
+	const size_t level = depth_ - 2;
+	StackItem& item = stack_[level];
+	this->flushCharacterData(item);
+
+	if (level == 0)
+	{
+		// The child of the root is complete, hand it over and drop it before reading the next one
+		bool proceed = (*callback_)(document_.getNode(item.node));
+		document_.clearNodes();
+		if (!proceed)
+		{
+			finished_ = true;
+			abortParsing();
+		}
+	}
+
+	--depth_;
+}
+
+void XMLSerializationReader::characterData(const char* data, size_t length)
+{
+	if (depth_ < 2)
+	{
+		return;
+	}
+
+	StackItem& item = stack_[depth_ - 2];
+	if (!item.hasChildren)
+	{
+		item.characterData.append(data, length);
+	}
+}
+
+void XMLSerializationReader::flushCharacterData(StackItem& item)
+{
+	if (!item.hasChildren && hasText(item.characterData))
+	{
+		document_.setNodeText(item.node, item.characterData.data(), item.characterData.size());
+	}
+	item.characterData.clear();
+}
+
+} // end namespace wgt
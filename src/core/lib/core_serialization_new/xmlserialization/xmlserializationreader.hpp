@@ -0,0 +1,60 @@
+#pragma once
+
+#include "xmlserializationdocument.hpp"
+#include "../binaryserialization/binaryserializationdocument.hpp"
+#include "core_serialization_xml/simple_api_for_xml.hpp"
+#include <cstdint>
+#include <functional>
+#include <vector>
+
+namespace wgt
+{
+/**
+* XMLSerializationReader reads documents written by XMLSerializationDocument without building the whole DOM.
+* The stream is parsed in fixed size chunks, and each child of the root node is handed to a callback as soon as its
+* end tag has been read. Only the current child's nodes are kept, in a compact BinarySerializationDocument whose nodes
+* are dropped once the callback returns, so memory use is bounded by the largest child instead of the whole document.
+* Its string table is kept between children, the names repeat from one to the next.
+* Node values and attributes are read the same way XMLSerializationDocument reads them, so handlers deserialize the
+* nodes as if they came from the DOM.
+*/
+class XMLSerializationReader : private SimpleApiForXml
+{
+	typedef SimpleApiForXml base;
+
+public:
+	typedef std::unique_ptr<SerializationNode> NodePtr;
+
+	/**Return false to stop reading.*/
+	typedef std::function<bool(const NodePtr& node)> NodeCallback;
+
+	XMLSerializationReader(TextStream& stream, SerializerNew* serializer);
+	~XMLSerializationReader();
+
+	/**Parses the stream, calling the callback with each child of the root node in document order.
+	@return false if the stream isn't well formed XML, true if the document was read or the callback stopped it.*/
+	bool read(const NodeCallback& callback);
+
+private:
+	struct StackItem
+	{
+		BinarySerializationDocument::NodeIndex node;
+		std::string characterData;
+		bool hasChildren;
+	};
+
+	void elementStart(const char* elementName, const char* const* attributes) override;
+	void elementEnd(const char* elementName) override;
+	void characterData(const char* data, size_t length) override;
+
+	void flushCharacterData(StackItem& item);
+
+	BinarySerializationDocument document_;
+	XMLSerializationDocument::FormatData formatData_;
+	const NodeCallback* callback_;
+	std::vector<StackItem> stack_;
+	size_t depth_;
+	bool finished_;
+};
+
+} // end namespace wgt
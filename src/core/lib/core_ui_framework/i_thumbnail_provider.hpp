@@ -12,6 +12,8 @@ public:
 	virtual ~IThumbnailProvider()
 	{
 	}
+	/** Returns true if the provider has a thumbnail for the file, and fills in any of the image data requested.
+	The image is 32 bit RGB. Called from background threads, so it must be thread safe. */
 	virtual bool getThumbnailData(const char* filePath, int* width = nullptr, int* height = nullptr, int* pitch = nullptr, BinaryBlock* imageData = nullptr) const = 0;
 
 };
@@ -11,6 +11,7 @@
 #include "core_ui_framework/i_dialog.hpp"
 #include "core_ui_framework/i_system_tray_icon.hpp"
 
+#include <cstdint>
 #include <memory>
 
 #define DefaultProgressCancelText "Cancel"
@@ -370,6 +371,15 @@ public:
 	virtual const char* getIconUrlFromImageProvider(const char* key) const = 0;
 	virtual void registerThumbnailProvider(std::shared_ptr<IThumbnailProvider> thumbnailProvider) = 0;
 	virtual bool hasThumbnail(const char* filePath) const = 0;
+
+	typedef void ThumbnailLoaded(const char* filePath);
+	typedef std::function<ThumbnailLoaded> ThumbnailLoadedCallback;
+	/** Returns true if the file's thumbnail is in memory and can be shown without blocking.
+	Otherwise it is loaded in the background, and the thumbnail loaded callbacks are called on the UI thread once it is.
+	Files that have no thumbnail are only found out in the background, and return false.
+	A thumbnail loaded for another modification time or size of the file is reloaded. */
+	virtual bool loadThumbnail(const char* filePath, uint64_t modified = 0, uint64_t size = 0) = 0;
+	virtual Connection connectThumbnailLoaded(ThumbnailLoadedCallback callback) = 0;
 	virtual void makeFakeMouseRelease() = 0;
 
 	typedef void PaletteThemeChanged(Palette::Theme);
@@ -0,0 +1,91 @@
+#include "CppUnitLite2/src/CppUnitLite2.h"
+#include "core_variant/variant.hpp"
+#include "wg_types/string_ref.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+namespace wgt
+{
+namespace
+{
+const char* const s_lookupNames[] = { "int", "uint", "int64", "uint64", "real", "string", "Vector3", "BinaryBlock" };
+
+template <typename Lookup>
+double lookupsPerSecond(int threadCount, int lookupsPerThread, Lookup lookup)
+{
+	std::atomic<size_t> found(0);
+	std::vector<std::thread> threads;
+	auto start = std::chrono::high_resolution_clock::now();
+	for (int i = 0; i < threadCount; ++i)
+	{
+		threads.emplace_back([&] {
+			size_t hits = 0;
+			for (int n = 0; n < lookupsPerThread; ++n)
+			{
+				hits += lookup(n) != nullptr ? 1 : 0;
+			}
+			found += hits;
+		});
+	}
+	for (auto& thread : threads)
+	{
+		thread.join();
+	}
+	std::chrono::duration<double> elapsed = std::chrono::high_resolution_clock::now() - start;
+	return threadCount * lookupsPerThread / std::max(elapsed.count(), 1e-9);
+}
+}
+
+TEST(meta_type_lookup_benchmark)
+{
+	const size_t nameCount = sizeof(s_lookupNames) / sizeof(s_lookupNames[0]);
+	std::vector<std::string> names(s_lookupNames, s_lookupNames + nameCount);
+	const TypeId* typeIds[] = { &TypeId::getType<int32_t>(), &TypeId::getType<uint64_t>(), &TypeId::getType<float>(),
+		                        &TypeId::getType<std::string>() };
+
+	// The previous index, hash maps keyed by name and TypeId
+	std::unordered_map<StringRef, const MetaType*> mapIndex;
+	for (auto& name : names)
+	{
+		mapIndex.emplace(name, MetaType::find(name.c_str()));
+	}
+	std::unordered_map<const TypeId, const MetaType*> typeIdMapIndex;
+	for (auto typeId : typeIds)
+	{
+		typeIdMapIndex.emplace(*typeId, MetaType::find(*typeId));
+	}
+
+	const int lookupsPerThread = 1000000;
+	for (int threadCount : { 1, 4 })
+	{
+		const double byName = lookupsPerSecond(threadCount, lookupsPerThread, [&](int n) {
+			return MetaType::find(names[n % nameCount].c_str());
+		});
+		const double byMap = lookupsPerSecond(threadCount, lookupsPerThread, [&](int n) {
+			auto it = mapIndex.find(names[n % nameCount].c_str());
+			return it != mapIndex.end() ? it->second : nullptr;
+		});
+		const double byTypeId = lookupsPerSecond(threadCount, lookupsPerThread, [&](int n) {
+			return MetaType::find(*typeIds[n % 4]);
+		});
+		const double byTypeIdMap = lookupsPerSecond(threadCount, lookupsPerThread, [&](int n) {
+			auto it = typeIdMapIndex.find(*typeIds[n % 4]);
+			return it != typeIdMapIndex.end() ? it->second : nullptr;
+		});
+		const double byGet =
+		lookupsPerSecond(threadCount, lookupsPerThread, [&](int n) { return MetaType::get<int32_t>(); });
+
+		printf("MetaType lookups/s with %d threads: name %.0f (unordered_map %.0f), TypeId %.0f (unordered_map %.0f), "
+		       "get<T> %.0f\n",
+		       threadCount, byName, byMap, byTypeId, byTypeIdMap, byGet);
+		CHECK(byName > 0.0);
+	}
+}
+} // end namespace wgt
@@ -1,34 +1,183 @@
 #include "meta_type.hpp"
 
 #include "variant.hpp"
-#include "wg_types/string_ref.hpp"
 #include "core_common/assert.hpp"
 #include "core_serialization/fixed_memory_stream.hpp"
 #include "core_serialization/resizing_memory_stream.hpp"
 #include "core_serialization/text_stream.hpp"
 
+#include <atomic>
 #include <cstring>
 #include <cstdint>
-#include <unordered_map>
 #include <memory>
+#include <mutex>
+#include <utility>
+#include <vector>
 
 namespace wgt
 {
 namespace
 {
+// Names of MetaTypes in old data formats
+const std::pair<const char*, const char*> s_nameAliases[] = {
+	{ "blob", "BinaryBlock" }, { "vector2", "Vector2" },      { "vector3", "Vector3" },
+	{ "vector4", "Vector4" },  { "collection", "Collection" },
+};
+
+// Hashes a word at a time, names are hashed on every lookup
+uint64_t hashName(const char* name)
+{
+	const uint64_t multiplier = 0xff51afd7ed558ccdull;
+	const size_t length = std::strlen(name);
+	uint64_t hash = 0x9e3779b97f4a7c15ull ^ length;
+	size_t offset = 0;
+	for (; offset + sizeof(uint64_t) <= length; offset += sizeof(uint64_t))
+	{
+		uint64_t word;
+		std::memcpy(&word, name + offset, sizeof(word));
+		hash = (hash ^ word) * multiplier;
+		hash ^= hash >> 32;
+	}
+	uint64_t tail = 0;
+	for (; offset < length; ++offset)
+	{
+		tail = (tail << 8) | static_cast<uint8_t>(name[offset]);
+	}
+	hash = (hash ^ tail) * multiplier;
+	return hash ^ (hash >> 29);
+}
+
+/**
+Read-only open addressed lookup tables built from the registered MetaTypes.
+Rebuilt on the first lookup after a MetaType is added or removed, so once plugins
+are loaded every lookup is lock-free.
+*/
 struct MetaTypeIndex
 {
-	std::unordered_map<wgt::StringRef, const MetaType*> nameIndex_;
-	std::unordered_map<const TypeId, const MetaType*> typeIdIndex_;
+	struct Entry
+	{
+		uint64_t hash_;
+		const char* name_;
+		const MetaType* type_;
+	};
+
+	explicit MetaTypeIndex(size_t count)
+	{
+		size_t capacity = 16;
+		while (capacity < count * 2)
+		{
+			capacity <<= 1;
+		}
+		mask_ = capacity - 1;
+		names_.resize(capacity, Entry{ 0, nullptr, nullptr });
+		typeIds_.resize(capacity, Entry{ 0, nullptr, nullptr });
+	}
+
+	// The first type added for a key wins
+	void addName(const char* name, const MetaType* type)
+	{
+		const uint64_t hash = hashName(name);
+		for (size_t i = hash & mask_;; i = (i + 1) & mask_)
+		{
+			auto& entry = names_[i];
+			if (entry.type_ == nullptr)
+			{
+				entry = Entry{ hash, name, type };
+				return;
+			}
+			if (entry.hash_ == hash && std::strcmp(entry.name_, name) == 0)
+			{
+				return;
+			}
+		}
+	}
+
+	void addTypeId(const TypeId& typeId, const MetaType* type)
+	{
+		const uint64_t hash = typeId.getHashcode();
+		for (size_t i = hash & mask_;; i = (i + 1) & mask_)
+		{
+			auto& entry = typeIds_[i];
+			if (entry.type_ == nullptr)
+			{
+				entry = Entry{ hash, nullptr, type };
+				return;
+			}
+			if (entry.hash_ == hash)
+			{
+				return;
+			}
+		}
+	}
+
+	const MetaType* findName(const char* name) const
+	{
+		const uint64_t hash = hashName(name);
+		for (size_t i = hash & mask_;; i = (i + 1) & mask_)
+		{
+			const auto& entry = names_[i];
+			if (entry.type_ == nullptr)
+			{
+				return nullptr;
+			}
+			if (entry.hash_ == hash && (entry.name_ == name || std::strcmp(entry.name_, name) == 0))
+			{
+				return entry.type_;
+			}
+		}
+	}
+
+	const MetaType* findTypeId(const TypeId& typeId) const
+	{
+		// TypeIds compare by hash code
+		const uint64_t hash = typeId.getHashcode();
+		for (size_t i = hash & mask_;; i = (i + 1) & mask_)
+		{
+			const auto& entry = typeIds_[i];
+			if (entry.type_ == nullptr || entry.hash_ == hash)
+			{
+				return entry.type_;
+			}
+		}
+	}
+
+	size_t mask_;
+	std::vector<Entry> names_;
+	std::vector<Entry> typeIds_;
+};
+
+struct MetaTypeRegistry
+{
+	~MetaTypeRegistry();
+
+	std::mutex mutex_;
+	DLink metaTypes_;
+	// Indices replaced while lookups may still be reading them, freed on exit
+	std::vector<std::unique_ptr<const MetaTypeIndex>> retired_;
 };
 
-DLink& s_metaTypes()
+MetaTypeRegistry& s_registry()
 {
-	static DLink inst;
+	static MetaTypeRegistry inst;
 	return inst;
 }
 
-std::unique_ptr<MetaTypeIndex> s_index;
+// Constant initialised, so lookups work before and after the registry's lifetime
+std::atomic<const MetaTypeIndex*> s_index(nullptr);
+
+MetaTypeRegistry::~MetaTypeRegistry()
+{
+	delete s_index.exchange(nullptr);
+}
+
+// Must be called with the registry locked
+void invalidateIndex(MetaTypeRegistry& registry)
+{
+	if (auto index = s_index.exchange(nullptr, std::memory_order_acq_rel))
+	{
+		registry.retired_.emplace_back(index);
+	}
+}
 
 bool convertFromString(const MetaType* toType, void* to, const MetaType* fromType, const void* from)
 {
@@ -61,13 +210,18 @@ MetaType::MetaType(const char* name, const Data& data)
 		qualified_[i].type_ = this;
 	}
 
-	s_metaTypes().prepend(&link_);
-	s_index.reset();
+	auto& registry = s_registry();
+	std::lock_guard<std::mutex> lock(registry.mutex_);
+	registry.metaTypes_.prepend(&link_);
+	invalidateIndex(registry);
 }
 
 MetaType::~MetaType()
 {
-	s_index.reset();
+	auto& registry = s_registry();
+	std::lock_guard<std::mutex> lock(registry.mutex_);
+	link_.unlink();
+	invalidateIndex(registry);
 }
 
 const MetaType::Qualified* MetaType::qualified(int qualifiers) const
@@ -146,63 +300,57 @@ bool MetaType::operator==(const MetaType& other) const
 
 const MetaType* MetaType::find(const char* name)
 {
-	validateIndex();
-	// support old data format
-	if (strcmp("blob", name) == 0)
+	auto index = s_index.load(std::memory_order_acquire);
+	while (index == nullptr)
 	{
-		name = "BinaryBlock";
+		validateIndex();
+		index = s_index.load(std::memory_order_acquire);
 	}
-	else if (strcmp("vector2", name) == 0)
-	{
-		name = "Vector2";
-	}
-	else if (strcmp("vector3", name) == 0)
-	{
-		name = "Vector3";
-	}
-	else if (strcmp("vector4", name) == 0)
-	{
-		name = "Vector4";
-	}
-	else if (strcmp("collection", name) == 0)
-	{
-		name = "Collection";
-	}
-	auto it = s_index->nameIndex_.find(name);
-	if (it != s_index->nameIndex_.end())
-	{
-		return it->second;
-	}
-
-	return nullptr;
+	return index->findName(name);
 }
 
 const MetaType* MetaType::find(const TypeId& typeId)
 {
-	validateIndex();
-
-	auto it = s_index->typeIdIndex_.find(typeId);
-	if (it != s_index->typeIdIndex_.end())
+	auto index = s_index.load(std::memory_order_acquire);
+	while (index == nullptr)
 	{
-		return it->second;
+		validateIndex();
+		index = s_index.load(std::memory_order_acquire);
 	}
-
-	return nullptr;
+	return index->findTypeId(typeId);
 }
 
 void MetaType::validateIndex()
 {
-	if (!s_index)
+	auto& registry = s_registry();
+	std::lock_guard<std::mutex> lock(registry.mutex_);
+	if (s_index.load(std::memory_order_acquire) != nullptr)
 	{
-		auto index = new MetaTypeIndex();
-		for (auto link = s_metaTypes().next(); link != &s_metaTypes(); link = link->next())
+		return;
+	}
+
+	size_t count = sizeof(s_nameAliases) / sizeof(s_nameAliases[0]);
+	for (auto link = registry.metaTypes_.next(); link != &registry.metaTypes_; link = link->next())
+	{
+		++count;
+	}
+
+	auto index = new MetaTypeIndex(count);
+	for (auto link = registry.metaTypes_.next(); link != &registry.metaTypes_; link = link->next())
+	{
+		auto metaType = dlink_holder(MetaType, link_, link);
+		index->addName(metaType->name(), metaType);
+		index->addTypeId(metaType->typeId(), metaType);
+	}
+	for (const auto& alias : s_nameAliases)
+	{
+		if (auto metaType = index->findName(alias.second))
 		{
-			auto metaType = dlink_holder(MetaType, link_, link);
-			index->nameIndex_.emplace(metaType->name(), metaType);
-			index->typeIdIndex_.emplace(metaType->typeId(), metaType);
+			index->addName(alias.first, metaType);
 		}
-		s_index.reset(index);
 	}
+
+	s_index.store(index, std::memory_order_release);
 }
 
 } // end namespace wgt
\ No newline at end of file
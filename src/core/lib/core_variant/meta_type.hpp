@@ -6,6 +6,7 @@
 
 #include "core_common/wg_dlink.hpp"
 
+#include <atomic>
 #include <type_traits>
 #include <cstddef>
 
@@ -52,6 +53,19 @@ struct StaticInstantiator
 
 template <typename T>
 StaticInstantiator<T> StaticInstantiator<T>::instantiator;
+
+/**
+Per type cache of the MetaType instance, constant initialised so it can be read
+at any time. Saves MetaType::get going through the function local static guard.
+*/
+template <typename T>
+struct StaticCache
+{
+	static std::atomic<const T*> instance;
+};
+
+template <typename T>
+std::atomic<const T*> StaticCache<T>::instance(nullptr);
 }
 
 template <typename T>
@@ -209,10 +223,21 @@ public:
 	template <typename T>
 	static const MetaType* get()
 	{
-		return &meta_type_details::StaticInstantiator<MetaTypeImpl<typename std::decay<T>::type>>::instantiator
-		        .instance();
+		typedef MetaTypeImpl<typename std::decay<T>::type> Impl;
+		auto& cache = meta_type_details::StaticCache<Impl>::instance;
+		const Impl* type = cache.load(std::memory_order_acquire);
+		if (type == nullptr)
+		{
+			type = &meta_type_details::StaticInstantiator<Impl>::instantiator.instance();
+			cache.store(type, std::memory_order_release);
+		}
+		return type;
 	}
 
+	/**
+	Lookups are lock-free, from a read-only table rebuilt on the first lookup
+	after MetaTypes are added or removed.
+	*/
 	static const MetaType* find(const char* name);
 	static const MetaType* find(const TypeId& typeId);
 
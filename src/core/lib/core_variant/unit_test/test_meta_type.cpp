@@ -0,0 +1,102 @@
+#include "pch.hpp"
+
+#include "core_variant/variant.hpp"
+
+#include <atomic>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace wgt
+{
+namespace
+{
+struct LateType
+{
+	int value = 0;
+
+	bool operator==(const LateType& other) const
+	{
+		return value == other.value;
+	}
+};
+
+TextStream& operator<<(TextStream& stream, const LateType& v)
+{
+	stream << v.value;
+	return stream;
+}
+
+TextStream& operator>>(TextStream& stream, LateType& v)
+{
+	stream >> v.value;
+	return stream;
+}
+}
+
+TEST(meta_type_find)
+{
+	CHECK(MetaType::find("int") == MetaType::get<int32_t>());
+	CHECK(MetaType::find(TypeId::getType<int32_t>()) == MetaType::get<int32_t>());
+	CHECK(MetaType::find(MetaType::get<std::string>()->name()) == MetaType::get<std::string>());
+	CHECK(MetaType::find("no_such_meta_type") == nullptr);
+
+	// Names from old data formats
+	auto vectorType = MetaType::get<Vector3>();
+	CHECK(MetaType::find("vector3") == vectorType);
+	CHECK(MetaType::find("Vector3") == vectorType);
+}
+
+TEST(meta_type_late_registration)
+{
+	CHECK(MetaType::find("LateType") == nullptr);
+	CHECK(MetaType::find(TypeId::getType<LateType>()) == nullptr);
+
+	// As registered by a plugin loaded after the index has been built
+	std::unique_ptr<MetaType> lateType(new DefaultMetaTypeImpl<LateType>("LateType"));
+	CHECK(MetaType::find("LateType") == lateType.get());
+	CHECK(MetaType::find(TypeId::getType<LateType>()) == lateType.get());
+	CHECK(MetaType::find("int") == MetaType::get<int32_t>());
+
+	lateType.reset();
+	CHECK(MetaType::find("LateType") == nullptr);
+	CHECK(MetaType::find(TypeId::getType<LateType>()) == nullptr);
+}
+
+TEST(meta_type_concurrent_find_and_register)
+{
+	std::atomic<bool> done(false);
+	std::atomic<int> failures(0);
+	std::vector<std::thread> readers;
+	for (int i = 0; i < 4; ++i)
+	{
+		readers.emplace_back([&] {
+			while (!done)
+			{
+				if (MetaType::find("int") != MetaType::get<int32_t>() ||
+				    MetaType::find(TypeId::getType<std::string>()) != MetaType::get<std::string>())
+				{
+					++failures;
+				}
+			}
+		});
+	}
+
+	for (int i = 0; i < 200; ++i)
+	{
+		DefaultMetaTypeImpl<LateType> lateType("LateType");
+		if (MetaType::find("LateType") != &lateType)
+		{
+			++failures;
+		}
+	}
+	done = true;
+	for (auto& reader : readers)
+	{
+		reader.join();
+	}
+
+	CHECK_EQUAL(0, failures.load());
+}
+} // end namespace wgt
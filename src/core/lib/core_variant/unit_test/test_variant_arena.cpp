@@ -0,0 +1,83 @@
+#include "pch.hpp"
+
+#include "core_variant/variant.hpp"
+#include "core_variant/variant_arena.hpp"
+
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace wgt
+{
+TEST(variant_arena_scope)
+{
+	CHECK(VariantArena::current() == nullptr);
+	{
+		VariantArena::Scope outer;
+		VariantArena* outerArena = VariantArena::current();
+		CHECK(outerArena != nullptr);
+
+		Variant first(std::string("first"));
+		Variant copy = first;
+		CHECK_EQUAL(1, outerArena->liveAllocations());
+
+		{
+			VariantArena::Scope inner;
+			CHECK(VariantArena::current() != outerArena);
+
+			// Detaching a shared payload takes the new one from the innermost arena
+			copy = std::string("second");
+			CHECK_EQUAL(1, VariantArena::current()->liveAllocations());
+			CHECK_EQUAL(1, outerArena->liveAllocations());
+		}
+		CHECK(VariantArena::current() == outerArena);
+		CHECK(copy == std::string("second"));
+		CHECK(first == std::string("first"));
+
+		copy = Variant();
+		first = Variant();
+		CHECK_EQUAL(0, outerArena->liveAllocations());
+	}
+	CHECK(VariantArena::current() == nullptr);
+}
+
+TEST(variant_arena_payloads_recycled)
+{
+	VariantArena::Scope scope;
+	const void* firstPayload;
+	{
+		Variant value(std::string("recycled"));
+		firstPayload = value.value<const void*>();
+	}
+
+	// The freed payload is reused by the next one of the same size
+	Variant value(std::string("again"));
+	CHECK(value.value<const void*>() == firstPayload);
+	CHECK(value == std::string("again"));
+}
+
+TEST(variant_arena_outlives_scope)
+{
+	std::vector<Variant> escaped;
+	{
+		VariantArena::Scope scope;
+		for (int i = 0; i < 1000; ++i)
+		{
+			escaped.emplace_back(std::to_string(i));
+		}
+	}
+
+	// Values created in the scope stay valid and are released from another thread
+	CHECK(escaped[42] == std::string("42"));
+	std::thread releaser([&escaped] {
+		for (size_t i = 0; i < escaped.size(); ++i)
+		{
+			Variant copy = escaped[i];
+			copy = std::string("changed");
+		}
+		escaped.clear();
+	});
+	releaser.join();
+	CHECK(escaped.empty());
+}
+} // end namespace wgt
@@ -1,4 +1,5 @@
 #include "variant.hpp"
+#include "variant_arena.hpp"
 
 #include "core_common/assert.hpp"
 #include "core_string_utils/string_utils.hpp"
@@ -75,12 +76,20 @@ bool downcast(std::wstring* v, const std::string& storage)
 
 Variant::COWData* Variant::COWData::allocate(size_t payloadSize)
 {
+	if (auto arena = VariantArena::current())
+	{
+		if (void* data = arena->allocate(sizeof(COWData) + payloadSize))
+		{
+			return new (data) COWData(arena);
+		}
+	}
+
 	char* data = new char[sizeof(COWData) + payloadSize];
-	return new (data) COWData();
+	return new (data) COWData(nullptr);
 }
 
 //------------------------------------------------------------------------------
-Variant::COWData::COWData() : refs_(0)
+Variant::COWData::COWData(VariantArena* arena) : refs_(0), arena_(arena)
 {
 }
 
@@ -115,8 +124,16 @@ void Variant::COWData::decRef(const MetaType* type)
 	{
 		TF_ASSERT(type);
 		type->destroy(payload());
+		VariantArena* arena = arena_;
 		this->~COWData();
-		delete[] reinterpret_cast<char*>(this);
+		if (arena != nullptr)
+		{
+			arena->deallocate(this, sizeof(COWData) + type->size());
+		}
+		else
+		{
+			delete[] reinterpret_cast<char*>(this);
+		}
 	}
 }
 
@@ -581,6 +598,7 @@ void Variant::detach(bool copy)
 	// allocate and initialize new payload copy
 	auto thisType = type();
 	COWData* newCow = COWData::allocate(thisType->size());
+	newCow->incRef();
 	thisType->init(newCow->payload());
 	if (copy)
 	{
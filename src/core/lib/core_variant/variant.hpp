@@ -23,6 +23,15 @@
 
 #include "variant_dll.hpp"
 
+/**
+ *	Size in bytes of the buffer holding small values inside a Variant, set through the
+ *	WG_VARIANT_INLINE_PAYLOAD_SIZE CMake option. Larger values are held in a shared payload.
+ *	It can't be smaller than a shared_ptr, which is also the default.
+ */
+#ifndef WG_VARIANT_INLINE_PAYLOAD_SIZE
+#define WG_VARIANT_INLINE_PAYLOAD_SIZE 0
+#endif
+
 #if _MSC_VER < 1900
 class QObject;
 namespace wgt
@@ -35,6 +44,7 @@ class Signal;
 namespace wgt
 {
 class Variant;
+class VariantArena;
 
 /**
 This namespace contains Variant type internal stuff.
@@ -1262,7 +1272,10 @@ public:
 
 	uint64_t getHashCode() const;
 private:
-	static const size_t INLINE_PAYLOAD_SIZE = sizeof(std::shared_ptr<void>);
+	// Values up to this size are held inside the Variant, larger ones in a copy-on-write payload
+	static const size_t INLINE_PAYLOAD_SIZE =
+	(WG_VARIANT_INLINE_PAYLOAD_SIZE > sizeof(std::shared_ptr<void>)) ? WG_VARIANT_INLINE_PAYLOAD_SIZE :
+	                                                                   sizeof(std::shared_ptr<void>);
 	static const uintptr_t STORAGE_KIND_MASK = 0x03;
 
 	enum StorageKind
@@ -1295,8 +1308,10 @@ private:
 		const void* payload() const;
 
 	private:
-		COWData();
+		explicit COWData(VariantArena* arena);
 		std::atomic<int> refs_;
+		// Arena the payload was taken from, null for heap payloads. Also aligns the payload.
+		VariantArena* arena_;
 	};
 
 	union Data {
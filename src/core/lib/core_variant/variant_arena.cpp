@@ -0,0 +1,126 @@
+#include "variant_arena.hpp"
+
+#include "core_common/assert.hpp"
+#include "core_common/thread_local_value.hpp"
+
+#include <algorithm>
+#include <new>
+
+namespace wgt
+{
+namespace
+{
+THREAD_LOCAL(VariantArena*)
+s_CurrentArena(nullptr);
+
+// Each block starts with a pointer to the previously allocated block
+const size_t BLOCK_HEADER_SIZE = 16;
+}
+
+//==============================================================================
+VariantArena::Scope::Scope(size_t blockSize)
+    : arena_(new VariantArena(blockSize)), previous_(THREAD_LOCAL_GET(s_CurrentArena))
+{
+	THREAD_LOCAL_SET(s_CurrentArena, arena_);
+}
+
+//------------------------------------------------------------------------------
+VariantArena::Scope::~Scope()
+{
+	TF_ASSERT(THREAD_LOCAL_GET(s_CurrentArena) == arena_);
+	THREAD_LOCAL_SET(s_CurrentArena, previous_);
+	arena_->release();
+}
+
+//==============================================================================
+VariantArena* VariantArena::current()
+{
+	return THREAD_LOCAL_GET(s_CurrentArena);
+}
+
+//------------------------------------------------------------------------------
+VariantArena::VariantArena(size_t blockSize)
+    : blockSize_(std::max(blockSize, MAX_SIZE + BLOCK_HEADER_SIZE)), owner_(std::this_thread::get_id()), refs_(1),
+      blocks_(nullptr), cursor_(nullptr), end_(nullptr)
+{
+	std::fill(freeLists_, freeLists_ + SIZE_CLASS_COUNT, nullptr);
+}
+
+//------------------------------------------------------------------------------
+VariantArena::~VariantArena()
+{
+	while (blocks_ != nullptr)
+	{
+		char* previous = *reinterpret_cast<char**>(blocks_);
+		::operator delete(blocks_);
+		blocks_ = previous;
+	}
+}
+
+//------------------------------------------------------------------------------
+void* VariantArena::allocate(size_t size)
+{
+	TF_ASSERT(std::this_thread::get_id() == owner_);
+	if (size == 0 || size > MAX_SIZE)
+	{
+		return nullptr;
+	}
+
+	const size_t index = (size - 1) / GRANULARITY;
+	void* ptr = freeLists_[index];
+	if (ptr != nullptr)
+	{
+		freeLists_[index] = freeLists_[index]->next_;
+	}
+	else
+	{
+		const size_t rounded = (index + 1) * GRANULARITY;
+		ptr = static_cast<size_t>(end_ - cursor_) >= rounded ? cursor_ : grow();
+		cursor_ = static_cast<char*>(ptr) + rounded;
+	}
+
+	refs_.fetch_add(1, std::memory_order_relaxed);
+	return ptr;
+}
+
+//------------------------------------------------------------------------------
+void VariantArena::deallocate(void* ptr, size_t size)
+{
+	TF_ASSERT(ptr != nullptr && size > 0 && size <= MAX_SIZE);
+	if (std::this_thread::get_id() == owner_)
+	{
+		const size_t index = (size - 1) / GRANULARITY;
+		FreeBlock* block = static_cast<FreeBlock*>(ptr);
+		block->next_ = freeLists_[index];
+		freeLists_[index] = block;
+	}
+	release();
+}
+
+//------------------------------------------------------------------------------
+size_t VariantArena::liveAllocations() const
+{
+	// Not counting the reference held by the scope
+	return refs_.load(std::memory_order_relaxed) - 1;
+}
+
+//------------------------------------------------------------------------------
+char* VariantArena::grow()
+{
+	// The tail of the previous block is too small for the payload and given up
+	char* block = static_cast<char*>(::operator new(blockSize_));
+	*reinterpret_cast<char**>(block) = blocks_;
+	blocks_ = block;
+	end_ = block + blockSize_;
+	return block + BLOCK_HEADER_SIZE;
+}
+
+//------------------------------------------------------------------------------
+void VariantArena::release()
+{
+	if (refs_.fetch_sub(1, std::memory_order_acq_rel) == 1)
+	{
+		delete this;
+	}
+}
+} // end namespace wgt
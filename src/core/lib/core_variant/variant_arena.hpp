@@ -0,0 +1,99 @@
+#ifndef VARIANT_ARENA_HPP
+#define VARIANT_ARENA_HPP
+
+#include "variant_dll.hpp"
+
+#include <atomic>
+#include <cstddef>
+#include <thread>
+
+namespace wgt
+{
+/**
+ *	Pool for the copy-on-write payloads of Variants which do not fit inline.
+ *
+ *	While a VariantArena::Scope is alive on a thread, Variants created or detached on
+ *	that thread take their payload from the scope's arena instead of the heap. Payloads
+ *	are carved from large blocks and recycled through per size free lists, so code which
+ *	builds and throws away many Variants, such as a model refresh or an undo operation,
+ *	stops hitting the system allocator for each of them.
+ *
+ *	Variants may outlive the scope and be copied or destroyed on any thread, the arena's
+ *	blocks are released once the scope has ended and its last payload is destroyed.
+ *	Payloads which escape keep their whole arena alive, so scopes should wrap operations
+ *	whose Variants are mostly temporary.
+ */
+class VARIANT_DLL VariantArena
+{
+public:
+	static const size_t DEFAULT_BLOCK_SIZE = 64 * 1024;
+
+	/**
+	 *	Route the calling thread's payload allocations to a new arena until destroyed.
+	 *	Scopes nest, the previous arena is restored when the inner scope ends.
+	 */
+	class VARIANT_DLL Scope
+	{
+	public:
+		explicit Scope(size_t blockSize = DEFAULT_BLOCK_SIZE);
+		~Scope();
+
+	private:
+		Scope(const Scope&);
+		Scope& operator=(const Scope&);
+
+		VariantArena* arena_;
+		VariantArena* previous_;
+	};
+
+	/**
+	 *	@return the arena of the innermost scope on the calling thread, null outside of any scope.
+	 */
+	static VariantArena* current();
+
+	/**
+	 *	@return null if the size is too large to be pooled, the caller should use the heap.
+	 *		Must be called on the thread owning the arena.
+	 */
+	void* allocate(size_t size);
+
+	/**
+	 *	Return a payload allocated with the same size, may be called from any thread.
+	 *	Only the owning thread recycles payloads, others release them with the arena.
+	 */
+	void deallocate(void* ptr, size_t size);
+
+	/**
+	 *	@return the number of payloads allocated from the arena and not yet deallocated,
+	 *		only valid while the arena's scope is alive.
+	 */
+	size_t liveAllocations() const;
+
+private:
+	struct FreeBlock
+	{
+		FreeBlock* next_;
+	};
+
+	static const size_t GRANULARITY = 16;
+	static const size_t MAX_SIZE = 512;
+	static const size_t SIZE_CLASS_COUNT = MAX_SIZE / GRANULARITY;
+
+	explicit VariantArena(size_t blockSize);
+	~VariantArena();
+	VariantArena(const VariantArena&);
+	VariantArena& operator=(const VariantArena&);
+
+	char* grow();
+	void release();
+
+	const size_t blockSize_;
+	const std::thread::id owner_;
+	std::atomic<size_t> refs_;
+	char* blocks_;
+	char* cursor_;
+	char* end_;
+	FreeBlock* freeLists_[SIZE_CLASS_COUNT];
+};
+} // end namespace wgt
+#endif // VARIANT_ARENA_HPP
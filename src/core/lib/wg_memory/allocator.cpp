@@ -12,7 +12,10 @@
 #include "core_common/thread_local_value.hpp"
 
 #include "allocator.hpp"
+#include "slab_allocator.hpp"
 #include <algorithm>
+#include <atomic>
+#include <cstring>
 #include <cwchar>
 #include <string>
 #include <thread>
@@ -29,6 +32,50 @@ static NGTAllocator::allocateFn ALLOCATOR_FN = nullptr;
 static NGTAllocator::deallocateFn DEALLOCATOR_FN = nullptr;
 static NGTAllocator::allocateFn UNTRACKED_ALLOCATOR_FN = nullptr;
 static NGTAllocator::deallocateFn UNTRACKED_DEALLOCATOR_FN = nullptr;
+#else
+// -1 until resolved from the environment on first use
+static std::atomic<int> ALLOCATOR_BACKEND(-1);
+
+//------------------------------------------------------------------------------
+static NGTAllocator::Backend backend()
+{
+	int backend = ALLOCATOR_BACKEND.load(std::memory_order_relaxed);
+	if (backend < 0)
+	{
+		const char* value = ::getenv("WG_MEMORY_BACKEND");
+		const bool slab = value != nullptr && strcmp(value, "slab") == 0;
+		int expected = -1;
+		backend = static_cast<int>(slab ? NGTAllocator::Backend::SLAB : NGTAllocator::Backend::SYSTEM);
+		if (!ALLOCATOR_BACKEND.compare_exchange_strong(expected, backend, std::memory_order_relaxed))
+		{
+			backend = expected;
+		}
+	}
+	return static_cast<NGTAllocator::Backend>(backend);
+}
+
+//------------------------------------------------------------------------------
+static void* backendMalloc(size_t size)
+{
+	if (backend() == NGTAllocator::Backend::SLAB)
+	{
+		if (void* ptr = SlabAllocator::allocate(size))
+		{
+			return ptr;
+		}
+	}
+	return ::malloc(size);
+}
+
+//------------------------------------------------------------------------------
+static void backendFree(void* ptr)
+{
+	// Slab pointers are recognised regardless of the current backend
+	if (ptr != nullptr && !SlabAllocator::deallocate(ptr))
+	{
+		::free(ptr);
+	}
+}
 #endif
 
 // Windows stack helper function definitions
@@ -50,7 +97,7 @@ void* malloc(size_t size)
 #ifdef HAVE_CUSTOM_ALLOCATOR
 	return ALLOCATOR_FN(size);
 #else
-	return ::malloc(size);
+	return backendMalloc(size);
 #endif
 }
 
@@ -59,7 +106,7 @@ void free(void* ptr)
 #ifdef HAVE_CUSTOM_ALLOCATOR
 	DEALLOCATOR_FN(ptr);
 #else
-	::free(ptr);
+	backendFree(ptr);
 #endif
 }
 
@@ -68,7 +115,7 @@ void* untracked_malloc(size_t size)
 #ifdef HAVE_CUSTOM_ALLOCATOR
 	return UNTRACKED_ALLOCATOR_FN(size);
 #else
-	return ::malloc(size);
+	return backendMalloc(size);
 #endif
 }
 
@@ -77,7 +124,7 @@ void untracked_free(void* ptr)
 #ifdef HAVE_CUSTOM_ALLOCATOR
 	UNTRACKED_DEALLOCATOR_FN(ptr);
 #else
-	::free(ptr);
+	backendFree(ptr);
 #endif
 }
 }
@@ -299,7 +346,11 @@ public:
 			NGT_MSG("deallocate: failed to find memory context for %#zx\n", (size_t)ptr);
 		}
 
+#ifdef HAVE_CUSTOM_ALLOCATOR
 		::free(ptr);
+#else
+		backendFree(ptr);
+#endif
 	}
 
 	void printCallstack(size_t framesToSkip, size_t framesToCapture, PrintFn fn)
@@ -861,6 +912,30 @@ void enableLeakDetection(bool enable)
 	ALLOCATOR_LEAK_DETECTION = enable;
 }
 
+//------------------------------------------------------------------------------
+void setBackend(Backend backend)
+{
+#ifndef HAVE_CUSTOM_ALLOCATOR
+	ALLOCATOR_BACKEND = static_cast<int>(backend);
+#endif
+}
+
+//------------------------------------------------------------------------------
+Backend getBackend()
+{
+#ifdef HAVE_CUSTOM_ALLOCATOR
+	return Backend::SYSTEM;
+#else
+	return backend();
+#endif
+}
+
+//------------------------------------------------------------------------------
+void flushThreadCache()
+{
+	SlabAllocator::flushThreadCache();
+}
+
 //------------------------------------------------------------------------------
 void printCallstack(size_t framesToSkip, PrintFn fn)
 {
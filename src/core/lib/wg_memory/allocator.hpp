@@ -25,6 +25,27 @@ WG_MEMORY_DLL void enableStackTraces(bool enable);
 WG_MEMORY_DLL void enableLeakDetection(bool enable);
 WG_MEMORY_DLL void enableLogging(bool enable);
 
+/**
+ *	Backend the tracked and untracked allocations are served from.
+ *	SYSTEM forwards to malloc/free, SLAB serves allocations up to 8KB from size class slabs
+ *	with per thread caches. The initial backend is SLAB if the WG_MEMORY_BACKEND environment
+ *	variable is set to "slab". Switching is safe at any time, memory is always returned to
+ *	the backend it came from. Ignored when custom handles are compiled in.
+ */
+enum class Backend
+{
+	SYSTEM,
+	SLAB
+};
+WG_MEMORY_DLL void setBackend(Backend backend);
+WG_MEMORY_DLL Backend getBackend();
+
+/**
+ *	Return the blocks cached by the calling thread to the shared slab lists.
+ *	Threads do this when they exit, call it to release the blocks of a thread that goes idle.
+ */
+WG_MEMORY_DLL void flushThreadCache();
+
 typedef std::function<void(const char*)> PrintFn;
 WG_MEMORY_DLL void printCallstack(size_t framesToSkip, PrintFn fn);
 
@@ -0,0 +1,469 @@
+#include "slab_allocator.hpp"
+
+#include "core_common/thread_local_value.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <cstdlib>
+#include <mutex>
+#include <thread>
+
+#ifdef _WIN32
+#include "core_common/ngt_windows.hpp"
+#include <malloc.h>
+#else
+#include <pthread.h>
+#endif
+
+#if defined(_M_IX86) || defined(_M_X64) || defined(__i386__) || defined(__x86_64__)
+#include <immintrin.h>
+#define SLAB_CPU_PAUSE() _mm_pause()
+#else
+#define SLAB_CPU_PAUSE()
+#endif
+
+namespace wgt
+{
+namespace SlabAllocator
+{
+namespace
+{
+const size_t SLAB_SHIFT = 16;
+const size_t SLAB_SIZE = size_t(1) << SLAB_SHIFT;
+
+// Slabs are found from their address >> SLAB_SHIFT, split into two levels covering a 48 bit address space
+const size_t PAGE_MAP_BITS = 48 - SLAB_SHIFT;
+const size_t PAGE_MAP_LEAF_BITS = PAGE_MAP_BITS / 2;
+const size_t PAGE_MAP_LEAF_SIZE = size_t(1) << PAGE_MAP_LEAF_BITS;
+const size_t PAGE_MAP_ROOT_SIZE = size_t(1) << (PAGE_MAP_BITS - PAGE_MAP_LEAF_BITS);
+
+// Roughly 25% spacing between classes, anything larger goes to the system allocator
+const size_t SIZE_CLASSES[] = { 16,   32,   48,   64,   80,   96,   112,  128,  160,  192,  224,
+	                            256,  320,  384,  448,  512,  640,  768,  896,  1024, 1280, 1536,
+	                            1792, 2048, 2560, 3072, 3584, 4096, 5120, 6144, 7168, 8192 };
+const size_t SIZE_CLASS_COUNT = sizeof(SIZE_CLASSES) / sizeof(SIZE_CLASSES[0]);
+const size_t MAX_SIZE = SIZE_CLASSES[SIZE_CLASS_COUNT - 1];
+
+// Blocks moved between a thread cache and the shared lists at once
+const size_t BATCH_BYTES = 8 * 1024;
+const size_t MIN_BATCH = 2;
+const size_t MAX_BATCH = 32;
+
+// Spins before a waiting thread gives up its time slice
+const int SPINS_BEFORE_YIELD = 64;
+
+//------------------------------------------------------------------------------
+// Only held to move a batch of blocks, so waiting threads spin briefly before yielding
+class SpinLock
+{
+public:
+	void lock()
+	{
+		for (int spins = 0; flag_.test_and_set(std::memory_order_acquire); ++spins)
+		{
+			if (spins < SPINS_BEFORE_YIELD)
+			{
+				SLAB_CPU_PAUSE();
+			}
+			else
+			{
+				std::this_thread::yield();
+			}
+		}
+	}
+
+	void unlock()
+	{
+		flag_.clear(std::memory_order_release);
+	}
+
+private:
+	std::atomic_flag flag_ = ATOMIC_FLAG_INIT;
+};
+
+struct FreeBlock
+{
+	FreeBlock* next_;
+};
+
+struct FreeList
+{
+	FreeBlock* head_;
+	size_t count_;
+
+	void push(FreeBlock* block)
+	{
+		block->next_ = head_;
+		head_ = block;
+		++count_;
+	}
+
+	FreeBlock* pop()
+	{
+		FreeBlock* block = head_;
+		head_ = block->next_;
+		--count_;
+		return block;
+	}
+};
+
+struct CentralList
+{
+	SpinLock lock_;
+	FreeList blocks_;
+};
+
+struct ThreadCache
+{
+	FreeList lists_[SIZE_CLASS_COUNT];
+};
+
+// All of the state below is zero initialised before any constructor runs, so the allocator
+// can be used by static initialisers of other translation units
+std::atomic<uint8_t*> s_PageMap[PAGE_MAP_ROOT_SIZE];
+SpinLock s_PageMapLock;
+CentralList s_CentralLists[SIZE_CLASS_COUNT];
+std::atomic<bool> s_ThreadCachesReady;
+
+#ifdef WIN32
+#pragma warning(disable : 4073)
+#pragma init_seg(lib) // Ensure we get constructed first
+#endif // WIN32
+
+THREAD_LOCAL(ThreadCache*)
+s_ThreadCache(nullptr);
+
+void releaseThreadCache(ThreadCache* cache);
+
+// Also holds each thread's cache, so the system calls onThreadExit with it when the thread exits
+#ifdef _WIN32
+DWORD s_ThreadExitKey = FLS_OUT_OF_INDEXES;
+
+void NTAPI onThreadExit(void* cache)
+#else
+pthread_key_t s_ThreadExitKey;
+bool s_ThreadExitKeyCreated;
+
+void onThreadExit(void* cache)
+#endif
+{
+	// Caches of threads still running when the process exits are left to the system
+	if (cache != nullptr && s_ThreadCachesReady.load(std::memory_order_acquire))
+	{
+		THREAD_LOCAL_SET(s_ThreadCache, nullptr);
+		releaseThreadCache(static_cast<ThreadCache*>(cache));
+	}
+}
+
+void setThreadExitCache(ThreadCache* cache)
+{
+#ifdef _WIN32
+	if (s_ThreadExitKey != FLS_OUT_OF_INDEXES)
+	{
+		FlsSetValue(s_ThreadExitKey, cache);
+	}
+#else
+	if (s_ThreadExitKeyCreated)
+	{
+		pthread_setspecific(s_ThreadExitKey, cache);
+	}
+#endif
+}
+
+// Declared after s_ThreadCache so the caches are only used between its construction and destruction
+struct ThreadCachesReady
+{
+	ThreadCachesReady()
+	{
+#ifdef _WIN32
+		s_ThreadExitKey = FlsAlloc(&onThreadExit);
+#else
+		s_ThreadExitKeyCreated = pthread_key_create(&s_ThreadExitKey, &onThreadExit) == 0;
+#endif
+		s_ThreadCachesReady = true;
+	}
+
+	~ThreadCachesReady()
+	{
+		// The exit key is never freed, threads may still exit after this
+		s_ThreadCachesReady = false;
+	}
+} s_ThreadCachesReadyGuard;
+
+//------------------------------------------------------------------------------
+size_t sizeClass(size_t size)
+{
+	if (size <= 128)
+	{
+		return size == 0 ? 0 : (size - 1) / 16;
+	}
+
+	// Above 128 bytes each power of two range is split into four classes
+	const size_t last = size - 1;
+	size_t log2 = 7;
+	while ((last >> (log2 + 1)) != 0)
+	{
+		++log2;
+	}
+	return 8 + (log2 - 7) * 4 + ((last - (size_t(1) << log2)) >> (log2 - 2));
+}
+
+//------------------------------------------------------------------------------
+size_t batchSize(size_t sizeClass)
+{
+	return std::min(std::max(BATCH_BYTES / SIZE_CLASSES[sizeClass], MIN_BATCH), MAX_BATCH);
+}
+
+//------------------------------------------------------------------------------
+bool pageMapIndices(const void* ptr, size_t& root, size_t& leaf)
+{
+	const uint64_t page = static_cast<uint64_t>(reinterpret_cast<uintptr_t>(ptr)) >> SLAB_SHIFT;
+	root = static_cast<size_t>(page >> PAGE_MAP_LEAF_BITS);
+	leaf = static_cast<size_t>(page & (PAGE_MAP_LEAF_SIZE - 1));
+	return root < PAGE_MAP_ROOT_SIZE;
+}
+
+//------------------------------------------------------------------------------
+// @return the size class + 1 of the slab owning ptr, 0 if ptr is not in a slab
+size_t lookupSlab(const void* ptr)
+{
+	size_t root, leaf;
+	if (!pageMapIndices(ptr, root, leaf))
+	{
+		return 0;
+	}
+
+	const uint8_t* leaves = s_PageMap[root].load(std::memory_order_acquire);
+	return leaves != nullptr ? leaves[leaf] : 0;
+}
+
+//------------------------------------------------------------------------------
+bool registerSlab(const void* slab, size_t sizeClass)
+{
+	size_t root, leaf;
+	if (!pageMapIndices(slab, root, leaf))
+	{
+		return false;
+	}
+
+	uint8_t* leaves = s_PageMap[root].load(std::memory_order_acquire);
+	if (leaves == nullptr)
+	{
+		std::lock_guard<SpinLock> guard(s_PageMapLock);
+		leaves = s_PageMap[root].load(std::memory_order_relaxed);
+		if (leaves == nullptr)
+		{
+			leaves = static_cast<uint8_t*>(::calloc(PAGE_MAP_LEAF_SIZE, 1));
+			if (leaves == nullptr)
+			{
+				return false;
+			}
+			s_PageMap[root].store(leaves, std::memory_order_release);
+		}
+	}
+
+	// Published to other threads along with the slab's blocks through the central list lock
+	leaves[leaf] = static_cast<uint8_t>(sizeClass + 1);
+	return true;
+}
+
+//------------------------------------------------------------------------------
+void* allocateSlab()
+{
+#ifdef _WIN32
+	return _aligned_malloc(SLAB_SIZE, SLAB_SIZE);
+#else
+	void* slab = nullptr;
+	return posix_memalign(&slab, SLAB_SIZE, SLAB_SIZE) == 0 ? slab : nullptr;
+#endif
+}
+
+//------------------------------------------------------------------------------
+void freeSlab(void* slab)
+{
+#ifdef _WIN32
+	_aligned_free(slab);
+#else
+	::free(slab);
+#endif
+}
+
+//------------------------------------------------------------------------------
+// Must be called with the central list locked
+bool growCentralList(size_t sizeClass)
+{
+	// Slabs are kept for the lifetime of the process, blocks are recycled through the free lists
+	char* slab = static_cast<char*>(allocateSlab());
+	if (slab == nullptr)
+	{
+		return false;
+	}
+
+	if (!registerSlab(slab, sizeClass))
+	{
+		freeSlab(slab);
+		return false;
+	}
+
+	const size_t blockSize = SIZE_CLASSES[sizeClass];
+	auto& blocks = s_CentralLists[sizeClass].blocks_;
+	for (size_t offset = SLAB_SIZE - SLAB_SIZE % blockSize; offset >= blockSize; offset -= blockSize)
+	{
+		blocks.push(reinterpret_cast<FreeBlock*>(slab + offset - blockSize));
+	}
+	return true;
+}
+
+//------------------------------------------------------------------------------
+void* allocateCentral(size_t sizeClass)
+{
+	auto& central = s_CentralLists[sizeClass];
+	std::lock_guard<SpinLock> guard(central.lock_);
+	if (central.blocks_.head_ == nullptr && !growCentralList(sizeClass))
+	{
+		return nullptr;
+	}
+	return central.blocks_.pop();
+}
+
+//------------------------------------------------------------------------------
+void deallocateCentral(void* ptr, size_t sizeClass)
+{
+	auto& central = s_CentralLists[sizeClass];
+	std::lock_guard<SpinLock> guard(central.lock_);
+	central.blocks_.push(static_cast<FreeBlock*>(ptr));
+}
+
+//------------------------------------------------------------------------------
+void refill(FreeList& list, size_t sizeClass)
+{
+	const size_t batch = batchSize(sizeClass);
+	auto& central = s_CentralLists[sizeClass];
+	std::lock_guard<SpinLock> guard(central.lock_);
+	while (list.count_ < batch)
+	{
+		if (central.blocks_.head_ == nullptr && !growCentralList(sizeClass))
+		{
+			return;
+		}
+		list.push(central.blocks_.pop());
+	}
+}
+
+//------------------------------------------------------------------------------
+void release(FreeList& list, size_t sizeClass, size_t count)
+{
+	auto& central = s_CentralLists[sizeClass];
+	std::lock_guard<SpinLock> guard(central.lock_);
+	while (count-- > 0 && list.head_ != nullptr)
+	{
+		central.blocks_.push(list.pop());
+	}
+}
+
+//------------------------------------------------------------------------------
+ThreadCache* getThreadCache()
+{
+	if (!s_ThreadCachesReady.load(std::memory_order_acquire))
+	{
+		return nullptr;
+	}
+
+	ThreadCache* cache = THREAD_LOCAL_GET(s_ThreadCache);
+	if (cache == nullptr)
+	{
+		// Allocated from the system so creating a cache never recurses into the allocator
+		cache = static_cast<ThreadCache*>(::calloc(1, sizeof(ThreadCache)));
+		THREAD_LOCAL_SET(s_ThreadCache, cache);
+		setThreadExitCache(cache);
+	}
+	return cache;
+}
+
+//------------------------------------------------------------------------------
+void releaseThreadCache(ThreadCache* cache)
+{
+	for (size_t i = 0; i < SIZE_CLASS_COUNT; ++i)
+	{
+		release(cache->lists_[i], i, cache->lists_[i].count_);
+	}
+	::free(cache);
+}
+}
+
+//==============================================================================
+void* allocate(size_t size)
+{
+	if (size > MAX_SIZE)
+	{
+		return nullptr;
+	}
+
+	const size_t index = sizeClass(size);
+	ThreadCache* cache = getThreadCache();
+	if (cache == nullptr)
+	{
+		return allocateCentral(index);
+	}
+
+	auto& list = cache->lists_[index];
+	if (list.head_ == nullptr)
+	{
+		refill(list, index);
+		if (list.head_ == nullptr)
+		{
+			return nullptr;
+		}
+	}
+	return list.pop();
+}
+
+//------------------------------------------------------------------------------
+bool deallocate(void* ptr)
+{
+	const size_t slab = lookupSlab(ptr);
+	if (slab == 0)
+	{
+		return false;
+	}
+
+	// Blocks freed by a thread other than the allocating one simply join the freeing thread's cache
+	const size_t index = slab - 1;
+	ThreadCache* cache = getThreadCache();
+	if (cache == nullptr)
+	{
+		deallocateCentral(ptr, index);
+		return true;
+	}
+
+	auto& list = cache->lists_[index];
+	list.push(static_cast<FreeBlock*>(ptr));
+	const size_t batch = batchSize(index);
+	if (list.count_ > batch * 2)
+	{
+		release(list, index, batch);
+	}
+	return true;
+}
+
+//------------------------------------------------------------------------------
+void flushThreadCache()
+{
+	if (!s_ThreadCachesReady.load(std::memory_order_acquire))
+	{
+		return;
+	}
+
+	ThreadCache* cache = THREAD_LOCAL_GET(s_ThreadCache);
+	if (cache == nullptr)
+	{
+		return;
+	}
+
+	THREAD_LOCAL_SET(s_ThreadCache, nullptr);
+	setThreadExitCache(nullptr);
+	releaseThreadCache(cache);
+}
+}
+} // end namespace wgt
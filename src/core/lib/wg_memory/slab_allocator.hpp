@@ -0,0 +1,40 @@
+#ifndef NGT_SLAB_ALLOCATOR_HPP
+#define NGT_SLAB_ALLOCATOR_HPP
+
+#include "wg_memory_dll.hpp"
+#include <cstddef>
+
+namespace wgt
+{
+/**
+ *	Size class allocator used as the NGTAllocator SLAB backend.
+ *
+ *	Small allocations are carved from 64KB slabs holding blocks of a single size class.
+ *	Each thread keeps a free list per size class, so most allocations and frees, including
+ *	frees of blocks allocated by other threads, take no locks. A thread only locks the
+ *	shared per class list, with a spin lock held while a batch of blocks is moved, when its
+ *	cache runs empty or grows too large. A thread's cache is flushed when the thread exits.
+ *	Slabs are looked up from a page map, so blocks carry no header and any pointer can
+ *	be tested for ownership.
+ */
+namespace SlabAllocator
+{
+/**
+ *	@return null if the size is too large for a size class or no slab could be created,
+ *		the caller should fall back to the system allocator.
+ */
+WG_MEMORY_DLL void* allocate(size_t size);
+
+/**
+ *	@return false if the pointer was not allocated by the slab allocator.
+ */
+WG_MEMORY_DLL bool deallocate(void* ptr);
+
+/**
+ *	Return the calling thread's cached blocks to the shared lists.
+ *	This happens automatically when a thread exits.
+ */
+WG_MEMORY_DLL void flushThreadCache();
+}
+} // end namespace wgt
+#endif // NGT_SLAB_ALLOCATOR_HPP
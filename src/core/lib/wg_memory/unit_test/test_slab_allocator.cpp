@@ -0,0 +1,120 @@
+#include "pch.hpp"
+
+#include "wg_memory/slab_allocator.hpp"
+
+#include <cstdlib>
+#include <cstring>
+#include <thread>
+#include <vector>
+
+namespace wgt
+{
+TEST(slab_allocator_size_classes)
+{
+	const size_t sizes[] = { 0, 1, 16, 17, 100, 128, 129, 200, 1000, 1025, 4096, 5000, 8192 };
+	std::vector<void*> blocks;
+	for (auto size : sizes)
+	{
+		void* block = SlabAllocator::allocate(size);
+		CHECK(block != nullptr);
+		if (block != nullptr)
+		{
+			memset(block, static_cast<int>(size & 0xFF), size);
+			blocks.push_back(block);
+		}
+	}
+
+	// Every block is its own, so none were overwritten by a neighbour
+	for (size_t i = 0; i < blocks.size(); ++i)
+	{
+		const unsigned char* bytes = static_cast<const unsigned char*>(blocks[i]);
+		for (size_t j = 0; j < sizes[i]; ++j)
+		{
+			CHECK_EQUAL(sizes[i] & 0xFF, bytes[j]);
+		}
+	}
+
+	for (auto block : blocks)
+	{
+		CHECK(SlabAllocator::deallocate(block));
+	}
+
+	// A freed block is reused by the next allocation of its size class on the same thread
+	void* block = SlabAllocator::allocate(64);
+	CHECK(SlabAllocator::deallocate(block));
+	CHECK(SlabAllocator::allocate(60) == block);
+	CHECK(SlabAllocator::deallocate(block));
+
+	// Larger sizes and memory from elsewhere are left to the system allocator
+	CHECK(SlabAllocator::allocate(8193) == nullptr);
+	void* systemBlock = ::malloc(32);
+	CHECK(!SlabAllocator::deallocate(systemBlock));
+	::free(systemBlock);
+	SlabAllocator::flushThreadCache();
+}
+
+TEST(slab_allocator_cross_thread_free)
+{
+	const size_t BLOCK_COUNT = 10000;
+	const size_t THREAD_COUNT = 4;
+
+	std::vector<std::vector<void*>> blocks(THREAD_COUNT);
+	std::vector<std::thread> threads;
+	for (size_t i = 0; i < THREAD_COUNT; ++i)
+	{
+		threads.emplace_back([&blocks, i, BLOCK_COUNT]() {
+			for (size_t j = 0; j < BLOCK_COUNT; ++j)
+			{
+				const size_t size = 16 + (j % 64) * 8;
+				void* block = SlabAllocator::allocate(size);
+				if (block != nullptr)
+				{
+					memset(block, static_cast<int>(i), size);
+				}
+				blocks[i].push_back(block);
+			}
+		});
+	}
+	for (auto& thread : threads)
+	{
+		thread.join();
+	}
+	threads.clear();
+
+	// Each thread frees the blocks another thread allocated, then exits with them in its cache
+	std::vector<int> freed(THREAD_COUNT, 0);
+	for (size_t i = 0; i < THREAD_COUNT; ++i)
+	{
+		threads.emplace_back([&blocks, &freed, i, THREAD_COUNT]() {
+			int result = 1;
+			for (auto block : blocks[(i + 1) % THREAD_COUNT])
+			{
+				result &= block != nullptr && SlabAllocator::deallocate(block) ? 1 : 0;
+			}
+			freed[i] = result;
+		});
+	}
+	for (auto& thread : threads)
+	{
+		thread.join();
+	}
+	for (size_t i = 0; i < THREAD_COUNT; ++i)
+	{
+		CHECK(freed[i]);
+	}
+
+	// The blocks cached by the exited threads are available to this one
+	std::vector<void*> reused;
+	for (size_t j = 0; j < BLOCK_COUNT; ++j)
+	{
+		void* block = SlabAllocator::allocate(16 + (j % 64) * 8);
+		CHECK(block != nullptr);
+		reused.push_back(block);
+	}
+	for (auto block : reused)
+	{
+		CHECK(SlabAllocator::deallocate(block));
+	}
+	SlabAllocator::flushThreadCache();
+}
+} // end namespace wgt
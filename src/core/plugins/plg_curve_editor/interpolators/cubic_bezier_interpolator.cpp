@@ -86,6 +86,23 @@ float CubicBezierInterpolator::timeAtX(float x, const BezierPoint& p1, const Bez
 	return t;
 }
 
+CurveSegment CubicBezierInterpolator::getSegment(const BezierPoint& p1, const BezierPoint& p2)
+{
+	const auto& pos1 = *p1.pos();
+	const auto& cp2 = *p1.cp2();
+	const auto& pos2 = *p2.pos();
+	const auto& cp1 = *p2.cp1();
+	const float px1 = pos1.getX(), py1 = pos1.getY();
+	const float cx1 = px1 + cp2.getX(), cy1 = py1 + cp2.getY();
+	const float px2 = pos2.getX(), py2 = pos2.getY();
+	const float cx2 = px2 + cp1.getX(), cy2 = py2 + cp1.getY();
+
+	// Expanding (1-t)^3 * P1 + 3(1-t)^2 * t * C1 + 3*(1-t)*t^2*C2 + t^3*P2 in powers of t
+	CurveSegment segment = { { px1, 3.f * (cx1 - px1), 3.f * (px1 - 2.f * cx1 + cx2), px2 - px1 + 3.f * (cx1 - cx2) },
+		                     { py1, 3.f * (cy1 - py1), 3.f * (py1 - 2.f * cy1 + cy2), py2 - py1 + 3.f * (cy1 - cy2) } };
+	return segment;
+}
+
 void CubicBezierInterpolator::updateControlPoints(BezierPoint& point, BezierPoint* prevPoint, BezierPoint* nextPoint)
 {
 	if (prevPoint)
@@ -31,6 +31,14 @@ float LinearInterpolator::timeAtX(float x, const BezierPoint& p1, const BezierPo
 	return (x - p1.pos()->getX()) / (p2.pos()->getX() - p1.pos()->getX());
 }
 
+CurveSegment LinearInterpolator::getSegment(const BezierPoint& p1, const BezierPoint& p2)
+{
+	const float x = p1.pos()->getX();
+	const float y = p1.pos()->getY();
+	CurveSegment segment = { { x, p2.pos()->getX() - x, 0.f, 0.f }, { y, p2.pos()->getY() - y, 0.f, 0.f } };
+	return segment;
+}
+
 void LinearInterpolator::updateControlPoints(BezierPoint& point, BezierPoint* prevPoint, BezierPoint* nextPoint)
 {
 	if (prevPoint)
@@ -22,6 +22,8 @@ public:
 
 	virtual float timeAtX(float x, const BezierPoint& p1, const BezierPoint& p2) override;
 
+	virtual CurveSegment getSegment(const BezierPoint& p1, const BezierPoint& p2) override;
+
 	virtual void updateControlPoints(BezierPoint& point, BezierPoint* prevPoint, BezierPoint* nextPoint) override;
 };
 } // end namespace wgt
@@ -19,6 +19,8 @@
 #include <core_reflection/type_class_definition.hpp>
 #include "core_logging/logging.hpp"
 
+#include <algorithm>
+
 namespace wgt
 {
 static const float EPSILON = 0.0005f;
@@ -27,8 +29,10 @@ Curve::Curve(ICurveInterpolatorPtr interpolator)
     : currentState_(-1)
     , showControlPoints_(false), dirty_(false)
     , interpolator_(std::move(interpolator))
+    , segmentsDirty_(false)
 {
 	pointsModel_.setSource(Collection(points_));
+	updateSegments();
 }
 
 Curve::~Curve()
@@ -52,31 +56,97 @@ void Curve::addAt(float x, bool triggerCallback)
 	insertPoint(data, true, triggerCallback);
 }
 
-float Curve::at(const float& time)
+namespace
 {
-    wg_read_lock_guard guard(pointsLock_);
+const size_t SAMPLE_BLOCK_SIZE = 64;
+const int SOLVE_ITERATIONS = 8;
+
+/*! Samples up to SAMPLE_BLOCK_SIZE times on the curve.
+    The segments are looked up and copied into arrays first, so that the curves are then solved for every
+    sample together in loops without branches, which the compiler can vectorise.
+    @param io_Segment the segment of the previous sample, as consecutive samples usually share one
+*/
+void sampleBlock(const std::vector<float>& keyTimes, const std::vector<CurveSegment>& segments, const float* times,
+                 float* o_Values, size_t count, size_t& io_Segment)
+{
+	TF_ASSERT(count <= SAMPLE_BLOCK_SIZE);
+	TF_ASSERT(segments.size() == keyTimes.size() + 1);
+	const size_t keyCount = keyTimes.size();
+	const float* keys = keyTimes.data();
+
+	// Segment i is the curve up to the first point at or after the time
+	const CurveSegment* blockSegments[SAMPLE_BLOCK_SIZE];
+	float x0[SAMPLE_BLOCK_SIZE], x1[SAMPLE_BLOCK_SIZE], x2[SAMPLE_BLOCK_SIZE], x3[SAMPLE_BLOCK_SIZE];
+	size_t segment = io_Segment;
+	for (size_t i = 0; i < count; ++i)
+	{
+		const float time = times[i];
+		if (!((segment == 0 || keys[segment - 1] < time) && (segment == keyCount || time <= keys[segment])))
+		{
+			segment = std::lower_bound(keys, keys + keyCount, time) - keys;
+		}
+		blockSegments[i] = &segments[segment];
+		x0[i] = segments[segment].x[0] - time;
+		x1[i] = segments[segment].x[1];
+		x2[i] = segments[segment].x[2];
+		x3[i] = segments[segment].x[3];
+	}
+	io_Segment = segment;
 
-	BezierPoint* prevPoint = nullptr;
-	for (auto iter = std::begin(points_); iter != std::end(points_); ++iter)
+	// Newton's method for x(t) = time, bisecting instead when a step leaves the bracket around t
+	float t[SAMPLE_BLOCK_SIZE], lo[SAMPLE_BLOCK_SIZE], hi[SAMPLE_BLOCK_SIZE];
+	for (size_t i = 0; i < count; ++i)
 	{
-		auto& point = *(*iter);
-		if (point.pos()->getX() >= time)
+		const float guess = -x0[i] / (x1[i] + x2[i] + x3[i]);
+		t[i] = guess > 0.f ? (guess < 1.f ? guess : 1.f) : 0.f;
+		lo[i] = 0.f;
+		hi[i] = 1.f;
+	}
+	for (int iteration = 0; iteration < SOLVE_ITERATIONS; ++iteration)
+	{
+		for (size_t i = 0; i < count; ++i)
 		{
-			if (prevPoint)
-			{
-				auto localTime = interpolator_->timeAtX(time, *prevPoint, point);
-				return interpolator_->interpolate(localTime, *prevPoint, point).pos.y;
-			}
-			else
-			{
-				return point.pos()->getY();
-			}
-			break;
+			const float ti = t[i];
+			const float error = ((x3[i] * ti + x2[i]) * ti + x1[i]) * ti + x0[i];
+			const float slope = (3.f * x3[i] * ti + 2.f * x2[i]) * ti + x1[i];
+			const bool below = error < 0.f;
+			const float low = below ? ti : lo[i];
+			const float high = below ? hi[i] : ti;
+
+			// Written as separate selects, which also reject a NaN step, so the loop stays vectorisable
+			const float next = ti - error / slope;
+			const float middle = 0.5f * (low + high);
+			const float aboveLow = next >= low ? next : middle;
+			lo[i] = low;
+			hi[i] = high;
+			t[i] = next <= high ? aboveLow : middle;
 		}
-		prevPoint = &point;
 	}
 
-	return prevPoint ? prevPoint->pos()->getY() : 0.0f;
+	for (size_t i = 0; i < count; ++i)
+	{
+		const auto& y = blockSegments[i]->y;
+		o_Values[i] = ((y[3] * t[i] + y[2]) * t[i] + y[1]) * t[i] + y[0];
+	}
+}
+}
+
+float Curve::at(const float& time)
+{
+	float value;
+	sample(&time, &value, 1);
+	return value;
+}
+
+void Curve::sample(const float* times, float* o_Values, size_t count)
+{
+	auto segments = getSegments();
+	size_t segment = 0;
+	for (size_t i = 0; i < count; i += SAMPLE_BLOCK_SIZE)
+	{
+		sampleBlock(segments->keyTimes_, segments->segments_, times + i, o_Values + i,
+		            std::min(count - i, SAMPLE_BLOCK_SIZE), segment);
+	}
 }
 
 BezierPointData Curve::at(unsigned int index)
@@ -206,6 +276,7 @@ unsigned int Curve::findIndex(const BezierPointData& value) const
 void Curve::addListeners(ObjectHandleT<BezierPoint> bezierPoint)
 {
 	bezierPoint->pos()->xChanged.connect([=](float oldX, float newX) {
+		segmentsDirty_ = true;
 		BezierPointData oldData = { { oldX, bezierPoint->pos()->getY() },
 			                        { bezierPoint->cp1()->getX(), bezierPoint->cp1()->getY() },
 			                        { bezierPoint->cp2()->getX(), bezierPoint->cp2()->getY() } };
@@ -225,6 +296,7 @@ void Curve::addListeners(ObjectHandleT<BezierPoint> bezierPoint)
 	});
 
 	bezierPoint->pos()->yChanged.connect([=](float oldY, float newY) {
+		segmentsDirty_ = true;
 		BezierPointData oldData = { { bezierPoint->pos()->getX(), oldY },
 			                        { bezierPoint->cp1()->getX(), bezierPoint->cp1()->getY() },
 			                        { bezierPoint->cp2()->getX(), bezierPoint->cp2()->getY() } };
@@ -243,6 +315,7 @@ void Curve::addListeners(ObjectHandleT<BezierPoint> bezierPoint)
 	});
 
 	bezierPoint->cp1()->xChanged.connect([=](float oldX, float newX) {
+		segmentsDirty_ = true;
 		BezierPointData oldData = { { bezierPoint->pos()->getX(), bezierPoint->pos()->getY() },
 			                        { oldX, bezierPoint->cp1()->getY() },
 			                        { bezierPoint->cp2()->getX(), bezierPoint->cp2()->getY() } };
@@ -261,6 +334,7 @@ void Curve::addListeners(ObjectHandleT<BezierPoint> bezierPoint)
 	});
 
 	bezierPoint->cp1()->yChanged.connect([=](float oldY, float newY) {
+		segmentsDirty_ = true;
 		BezierPointData oldData = { { bezierPoint->pos()->getX(), bezierPoint->pos()->getY() },
 			                        { bezierPoint->cp1()->getX(), oldY },
 			                        { bezierPoint->cp2()->getX(), bezierPoint->cp2()->getY() } };
@@ -279,6 +353,7 @@ void Curve::addListeners(ObjectHandleT<BezierPoint> bezierPoint)
 	});
 
 	bezierPoint->cp2()->xChanged.connect([=](float oldX, float newX) {
+		segmentsDirty_ = true;
 		BezierPointData oldData = {
 			{ bezierPoint->pos()->getX(), bezierPoint->pos()->getY() },
 			{ bezierPoint->cp1()->getX(), bezierPoint->cp1()->getY() },
@@ -301,6 +376,7 @@ void Curve::addListeners(ObjectHandleT<BezierPoint> bezierPoint)
 	});
 
 	bezierPoint->cp2()->yChanged.connect([=](float oldY, float newY) {
+		segmentsDirty_ = true;
 		BezierPointData oldData = {
 			{ bezierPoint->pos()->getX(), bezierPoint->pos()->getY() },
 			{ bezierPoint->cp1()->getX(), bezierPoint->cp1()->getY() },
@@ -351,6 +427,7 @@ void Curve::insertPoint(int index, ManagedObject<BezierPoint> bezierPoint, bool
         TF_ASSERT(newObjItr != pointObjects_.end());
 
         addListeners(handle);
+        segmentsDirty_ = true;
     }
 
     if (triggerCallback)
@@ -384,6 +461,7 @@ void Curve::removePoint(int index, bool triggerCallback)
 
         points.erase(pointsIter);
         pointObjects_.erase(objItr);
+        segmentsDirty_ = true;
     }
 
     if (triggerCallback)
@@ -514,6 +592,54 @@ void Curve::insertPoint(BezierPointData data, bool updateYPos, bool triggerCallb
 	pushModification(std::move(executeFunc), std::move(undoFunc));
 }
 
+std::shared_ptr<const Curve::Segments> Curve::getSegments()
+{
+	// Only the first sample after a change rebuilds the segments, concurrent samples keep reading the previous ones
+	if (segmentsDirty_)
+	{
+		std::lock_guard<std::mutex> segmentsGuard(segmentsMutex_);
+		if (segmentsDirty_.exchange(false))
+		{
+			updateSegments();
+		}
+	}
+	return std::atomic_load(&segments_);
+}
+
+void Curve::updateSegments()
+{
+	auto segments = std::make_shared<Segments>();
+	auto& keyTimes = segments->keyTimes_;
+	auto& curveSegments = segments->segments_;
+
+	// Before the first point and after the last the curve keeps the value of that point
+	auto constantSegment = [](float y) {
+		CurveSegment segment = { { 0.f, 1.f, 0.f, 0.f }, { y, 0.f, 0.f, 0.f } };
+		return segment;
+	};
+
+	{
+		wg_read_lock_guard guard(pointsLock_);
+		keyTimes.reserve(points_.size());
+		curveSegments.reserve(points_.size() + 1);
+		curveSegments.push_back(constantSegment(points_.empty() ? 0.f : points_.front()->pos()->getY()));
+		for (size_t i = 0; i < points_.size(); ++i)
+		{
+			keyTimes.push_back(points_[i]->pos()->getX());
+			if (i > 0)
+			{
+				curveSegments.push_back(interpolator_->getSegment(*points_[i - 1], *points_[i]));
+			}
+		}
+		if (!points_.empty())
+		{
+			curveSegments.push_back(constantSegment(points_.back()->pos()->getY()));
+		}
+	}
+
+	std::atomic_store(&segments_, std::shared_ptr<const Segments>(std::move(segments)));
+}
+
 void Curve::pushModification(ModificationFunction&& executeFunc, ModificationFunction&& undoFunc)
 {
 	while (currentState_ < modificationStack_.size() - 1)
@@ -9,19 +9,22 @@
 #pragma once
 
 #include "curve_editor/i_curve.hpp"
+#include "curve_editor/i_curve_interpolator.hpp"
 #include "core_common/signal.hpp"
 #include "core_dependency_system/i_interface.hpp"
 #include "core_data_model/collection_model.hpp"
 #include "core_object/managed_object.hpp"
 #include "core_common/wg_read_write_lock.hpp"
 
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <vector>
+
 namespace wgt
 {
-class ICurveInterpolator;
 class BezierPoint;
 
-typedef std::unique_ptr<ICurveInterpolator> ICurveInterpolatorPtr;
-
 class Curve : public Implements<ICurve>
 {
 	typedef Signal<void(PointUpdateData)> PointSignal;
@@ -50,6 +53,13 @@ public:
 	*/
 	virtual BezierPointData at(unsigned int index) override;
 
+	/*! Gets the values on the curve at each of the specified times
+	    @param times the points in time between 0.0 and 1.0, sampling is fastest when they are in increasing order
+	    @param o_Values receives the value at each time
+	    @param count the number of times to sample
+	*/
+	virtual void sample(const float* times, float* o_Values, size_t count) override;
+
 	/*! Enumerate the bezier points in this curve
 	*/
 	virtual void enumerate(PointCallback callback) override;
@@ -158,6 +168,15 @@ private:
     void insertPoint(int index, ManagedObject<BezierPoint> bezierPoint, bool triggerCallback);
     void removePoint(int index, bool triggerCallback);
 	void pushModification(ModificationFunction&& executeFunc, ModificationFunction&& undoFunc);
+
+	// The point times, and the curve in polynomial form from before the first point to after the last
+	struct Segments
+	{
+		std::vector<float> keyTimes_;
+		std::vector<CurveSegment> segments_;
+	};
+	std::shared_ptr<const Segments> getSegments();
+	void updateSegments();
     unsigned int findIndex(const BezierPointData& value) const;
     unsigned int findIndex(const std::string& id) const;
     ObjectHandleT<BezierPoint> findPoint(const std::string& id) const;
@@ -175,5 +194,11 @@ private:
 	bool showControlPoints_;
 	bool dirty_;
 	ICurveInterpolatorPtr interpolator_;
+
+	// Samples read an immutable snapshot of the segments without locking. The snapshot is rebuilt under the
+	// mutex on the next sample after the points change, and swapped in atomically.
+	std::mutex segmentsMutex_;
+	std::atomic<bool> segmentsDirty_;
+	std::shared_ptr<const Segments> segments_;
 };
 } // end namespace wgt
\ No newline at end of file
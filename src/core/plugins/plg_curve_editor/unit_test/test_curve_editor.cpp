@@ -133,4 +133,60 @@ TEST(testCurve)
     CHECK(areSame(handle->at(1U), data1));
 }
 
+TEST(testCurveSampling)
+{
+    TestFramework framework;
+    ManagedObject<TestCurveEditor> curveEditor = createCurveEditor(framework);
+
+    // Test the value between linear points, and before and after them
+    auto linear = curveEditor->addCurve(CurveTypes::Linear);
+    CHECK(linear != nullptr);
+    CHECK_CLOSE(0.0f, linear->at(0.5f), 1e-6f);
+
+    BezierPointData linear0 = { 0.0f, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f };
+    BezierPointData linear1 = { 0.5f, 1.0f, 0.0f, 0.0f, 0.0f, 0.0f };
+    linear->add(linear0, false);
+    linear->add(linear1, false);
+    CHECK_CLOSE(0.5f, linear->at(0.25f), 1e-5f);
+    CHECK_CLOSE(0.0f, linear->at(-1.0f), 1e-6f);
+    CHECK_CLOSE(1.0f, linear->at(2.0f), 1e-6f);
+
+    // Test the curve passes through its points
+    auto bezier = curveEditor->addCurve(CurveTypes::CubicBezier);
+    BezierPointData bezier0 = { 0.0f, 0.0f, 0.0f, 0.0f, 0.2f, 0.5f };
+    BezierPointData bezier1 = { 0.5f, 1.0f, -0.2f, 0.0f, 0.2f, 0.0f };
+    BezierPointData bezier2 = { 1.0f, 0.5f, -0.2f, -0.5f, 0.0f, 0.0f };
+    bezier->add(bezier0, false);
+    bezier->add(bezier1, false);
+    bezier->add(bezier2, false);
+    CHECK(bezier->getNumPoints() == 3);
+    for (unsigned int i = 0; i < bezier->getNumPoints(); ++i)
+    {
+        auto point = bezier->at(i);
+        CHECK_CLOSE(point.pos.y, bezier->at(point.pos.x), 1e-4f);
+    }
+
+    // Test sampling many times in one call matches sampling them one at a time, in and out of order
+    const size_t sampleCount = 300;
+    std::vector<float> times;
+    for (size_t i = 0; i < sampleCount; ++i)
+    {
+        times.push_back(-0.1f + 1.2f * i / sampleCount);
+    }
+    times.insert(times.end(), times.rbegin(), times.rend());
+    std::vector<float> values(times.size());
+    bezier->sample(times.data(), values.data(), times.size());
+    for (size_t i = 0; i < times.size(); ++i)
+    {
+        CHECK_CLOSE(bezier->at(times[i]), values[i], 1e-6f);
+    }
+
+    // Test modified points are sampled
+    bezier1.pos.y = 3.0f;
+    bezier->modify(1U, bezier1);
+    CHECK_CLOSE(3.0f, bezier->at(0.5f), 1e-4f);
+    bezier->removeAt(1.0f, false);
+    CHECK_CLOSE(3.0f, bezier->at(2.0f), 1e-6f);
+}
+
 } // end namespace wgt
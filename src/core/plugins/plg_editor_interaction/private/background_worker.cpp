@@ -1,26 +1,295 @@
 #include "background_worker.hpp"
 
+#include "core_common/thread_local_value.hpp"
+
+#include <algorithm>
 #include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <deque>
 #include <mutex>
 #include <thread>
-#include <list>
 
 
 namespace wgt
 {
+namespace
+{
+const size_t PRIORITY_COUNT = 3;
+const size_t MIN_THREADS = 1;
+
+// Threads above the minimum retire after waiting this long for a job
+const std::chrono::seconds IDLE_THREAD_TIMEOUT(10);
+}
+
+//------------------------------------------------------------------------------
+class BackgroundWorker::Job : public IBackgroundJob
+{
+public:
+	Job(CancellableJobFunction function, JobPriority priority, bool foreground)
+		: function_(function)
+		, priority_(priority)
+		, foreground_(foreground)
+		, cancelled_(false)
+		, done_(false)
+		, skipped_(false)
+		, remainingDependencies_(1)
+	{
+	}
+
+	void cancel() override
+	{
+		cancelled_ = true;
+	}
+
+	bool isCancelled() const override
+	{
+		return cancelled_;
+	}
+
+	bool isDone() const override
+	{
+		return done_;
+	}
+
+	void wait() const override
+	{
+		std::unique_lock<std::mutex> lock(mutex_);
+		doneCondition_.wait(lock, [this] { return done_.load(); });
+	}
+
+	CancellableJobFunction function_;
+	const JobPriority priority_;
+	const bool foreground_;
+	std::atomic<bool> cancelled_;
+	std::atomic<bool> done_;
 
+	// Guarded by mutex_
+	mutable std::mutex mutex_;
+	mutable std::condition_variable doneCondition_;
+	bool skipped_;
+	std::vector<std::shared_ptr<Job>> dependents_;
+
+	// Starts at one so the job can't be scheduled while its dependencies are being added
+	std::atomic<int> remainingDependencies_;
+};
+
+//------------------------------------------------------------------------------
 struct BackgroundWorker::Impl
 {
+	typedef std::shared_ptr<Job> JobPtr;
+
+	struct WorkQueue
+	{
+		std::mutex mutex_;
+		std::deque<JobPtr> jobs_;
+	};
+
+	// Each thread pushes the jobs it queues onto its own queues and pops them from the back,
+	// idle threads steal from the front of the other threads' queues.
+	struct Worker
+	{
+		Worker() : running_(false)
+		{
+		}
+
+		WorkQueue queues_[PRIORITY_COUNT];
+		std::thread thread_;
+		bool running_; // Guarded by threadMutex_
+	};
+
+	static bool popFront(WorkQueue& queue, JobPtr& o_Job)
+	{
+		std::lock_guard<std::mutex> lock(queue.mutex_);
+		if (queue.jobs_.empty())
+		{
+			return false;
+		}
+		o_Job = std::move(queue.jobs_.front());
+		queue.jobs_.pop_front();
+		return true;
+	}
+
+	static bool popBack(WorkQueue& queue, JobPtr& o_Job)
+	{
+		std::lock_guard<std::mutex> lock(queue.mutex_);
+		if (queue.jobs_.empty())
+		{
+			return false;
+		}
+		o_Job = std::move(queue.jobs_.back());
+		queue.jobs_.pop_back();
+		return true;
+	}
+
+	JobPtr findJob(size_t workerIndex)
+	{
+		JobPtr job;
+		for (size_t priority = 0; priority < PRIORITY_COUNT; ++priority)
+		{
+			if (popBack(workers_[workerIndex].queues_[priority], job) || popFront(sharedQueues_[priority], job))
+			{
+				return job;
+			}
+			for (size_t i = 1; i < workers_.size(); ++i)
+			{
+				if (popFront(workers_[(workerIndex + i) % workers_.size()].queues_[priority], job))
+				{
+					return job;
+				}
+			}
+		}
+		return nullptr;
+	}
+
+	void schedule(const JobPtr& job)
+	{
+		if (job->foreground_)
+		{
+			std::lock_guard<std::mutex> lock(foregroundJobMutex_);
+			foregroundJobs_.push_back(job);
+			return;
+		}
+
+		Worker* worker = THREAD_LOCAL_GET(currentWorker_);
+		WorkQueue& queue = worker != nullptr ? worker->queues_[static_cast<size_t>(job->priority_)] :
+		                                       sharedQueues_[static_cast<size_t>(job->priority_)];
+		{
+			std::lock_guard<std::mutex> lock(queue.mutex_);
+			queue.jobs_.push_back(job);
+		}
+		++pendingJobs_;
+		wakeWorker();
+	}
+
+	void wakeWorker()
+	{
+		// Only take the thread lock when a thread is waiting or the pool can grow
+		if (idleWorkers_ == 0 && runningThreads_ == workers_.size())
+		{
+			return;
+		}
+
+		std::lock_guard<std::mutex> lock(threadMutex_);
+		if (exit_)
+		{
+			return;
+		}
+		if (idleWorkers_ > 0)
+		{
+			jobWaiter_.notify_one();
+			return;
+		}
+
+		// Every thread is busy, so grow the pool
+		for (size_t i = 0; i < workers_.size(); ++i)
+		{
+			auto& worker = workers_[i];
+			if (!worker.running_)
+			{
+				startThread(i);
+				return;
+			}
+		}
+	}
+
+	// Called while holding threadMutex_
+	void startThread(size_t workerIndex)
+	{
+		auto& worker = workers_[workerIndex];
+		if (worker.thread_.joinable())
+		{
+			// The thread has retired and is only returning from backgroundUpdate
+			worker.thread_.join();
+		}
+		worker.running_ = true;
+		++runningThreads_;
+		worker.thread_ = std::thread([this, workerIndex] { backgroundUpdate(workerIndex); });
+	}
+
+	void run(const JobPtr& job)
+	{
+		const bool skipped = job->cancelled_;
+		if (!skipped)
+		{
+			job->function_(*job);
+		}
+		finish(job, skipped);
+	}
+
+	void finish(const JobPtr& job, bool skipped)
+	{
+		std::vector<JobPtr> dependents;
+		{
+			std::lock_guard<std::mutex> lock(job->mutex_);
+			job->skipped_ = skipped;
+			job->done_ = true;
+			dependents.swap(job->dependents_);
+		}
+		job->doneCondition_.notify_all();
+		job->function_ = nullptr;
+
+		for (auto& dependent : dependents)
+		{
+			if (skipped)
+			{
+				dependent->cancelled_ = true;
+			}
+			if (--dependent->remainingDependencies_ == 0)
+			{
+				schedule(dependent);
+			}
+		}
+	}
+
+	JobPtr queue(CancellableJobFunction function, JobPriority priority, bool foreground,
+	             const IBackgroundWorker::JobDependencies& dependencies)
+	{
+		auto job = std::make_shared<Job>(function, priority, foreground);
+		if (exit_)
+		{
+			job->cancelled_ = true;
+			finish(job, true);
+			return job;
+		}
+
+		for (auto& dependency : dependencies)
+		{
+			auto dependencyJob = std::dynamic_pointer_cast<Job>(dependency);
+			if (dependencyJob == nullptr)
+			{
+				continue;
+			}
+
+			std::lock_guard<std::mutex> lock(dependencyJob->mutex_);
+			if (!dependencyJob->done_)
+			{
+				dependencyJob->dependents_.push_back(job);
+				++job->remainingDependencies_;
+			}
+			else if (dependencyJob->skipped_)
+			{
+				job->cancelled_ = true;
+			}
+		}
+
+		if (--job->remainingDependencies_ == 0)
+		{
+			schedule(job);
+		}
+		return job;
+	}
+
 	void foregroundUpdate()
 	{
 		while (exit_ == false)
 		{
-			IBackgroundWorker::JobFunction job;
+			JobPtr job;
 			{
 				std::lock_guard<std::mutex> lock(foregroundJobMutex_);
 				if (!foregroundJobs_.empty())
 				{
-					job = foregroundJobs_.front();
+					job = std::move(foregroundJobs_.front());
 					foregroundJobs_.pop_front();
 				}
 			}
@@ -28,63 +297,122 @@ struct BackgroundWorker::Impl
 			{
 				break;
 			}
-			job();
+			run(job);
 		}
 	}
 
-	void backgroundUpdate()
+	void backgroundUpdate(size_t workerIndex)
 	{
+		THREAD_LOCAL_SET(currentWorker_, &workers_[workerIndex]);
 		while (exit_ == false)
 		{
-			BackgroundWorker::JobFunction  job;
+			JobPtr job = findJob(workerIndex);
+			if (job)
 			{
-				std::unique_lock<std::mutex> lock(backgroundJobMutex_);
-				jobWaiter_.wait(lock, [this]
-				{
-					return exit_ || !backgroundJobs_.empty();
-				});
+				--pendingJobs_;
+				run(job);
+				continue;
+			}
 
-				if (exit_)
-				{
-					return;
-				}
+			std::unique_lock<std::mutex> lock(threadMutex_);
+			++idleWorkers_;
+			const bool hasJobs =
+			jobWaiter_.wait_for(lock, IDLE_THREAD_TIMEOUT, [this] { return exit_ || pendingJobs_ > 0; });
+			--idleWorkers_;
+			if (!hasJobs && runningThreads_ > MIN_THREADS)
+			{
+				workers_[workerIndex].running_ = false;
+				--runningThreads_;
+				return;
+			}
+		}
+	}
 
-				if (!backgroundJobs_.empty())
-				{
-					job = backgroundJobs_.front();
-					backgroundJobs_.pop_front();
-				}
+	// Only used once the threads have exited
+	bool popAbandonedJob(JobPtr& o_Job)
+	{
+		for (auto& queue : sharedQueues_)
+		{
+			if (popFront(queue, o_Job))
+			{
+				return true;
 			}
-			if (job)
+		}
+		for (auto& worker : workers_)
+		{
+			for (auto& queue : worker.queues_)
 			{
-				job();
+				if (popFront(queue, o_Job))
+				{
+					return true;
+				}
 			}
 		}
+
+		std::lock_guard<std::mutex> lock(foregroundJobMutex_);
+		if (foregroundJobs_.empty())
+		{
+			return false;
+		}
+		o_Job = std::move(foregroundJobs_.front());
+		foregroundJobs_.pop_front();
+		return true;
 	}
 
 	Impl(IApplication& application)
 		: exit_(false)
+		, pendingJobs_(0)
+		, idleWorkers_(0)
+		, runningThreads_(0)
+		, workers_(std::max<size_t>(MIN_THREADS, std::max(std::thread::hardware_concurrency(), 2u) - 1))
 	{
 		foregroundUpdateConnection_ = application.signalUpdate.connect([this] { foregroundUpdate(); });
 
-		//TODO: Grow / retire threads from this thread pool
-		unsigned int nThreads = std::thread::hardware_concurrency() / 2;
-		for (unsigned int i = 0; i < nThreads; ++i)
+		// Threads are added as jobs are queued while every thread is busy, and retire when idle
+		std::lock_guard<std::mutex> lock(threadMutex_);
+		for (size_t i = 0; i < MIN_THREADS; ++i)
 		{
-			backgroundThreads_.emplace_back( std::make_unique< std::thread>([this]
+			startThread(i);
+		}
+	}
+
+	~Impl()
+	{
+		{
+			std::lock_guard<std::mutex> lock(threadMutex_);
+			exit_ = true;
+			jobWaiter_.notify_all();
+		}
+		for (auto& worker : workers_)
+		{
+			if (worker.thread_.joinable())
 			{
-				backgroundUpdate();
-			}));
+				worker.thread_.join();
+			}
+		}
+
+		// Release anything waiting on the jobs that never ran. Skipping a job schedules its dependents,
+		// possibly onto a queue that was already emptied, so look through every queue again after each one
+		JobPtr job;
+		while (popAbandonedJob(job))
+		{
+			finish(job, true);
 		}
 	}
 
+	std::atomic<bool> exit_;
+	std::atomic<int> pendingJobs_;
+	std::atomic<size_t> idleWorkers_;
+	std::atomic<size_t> runningThreads_;
+
+	std::mutex threadMutex_;
 	std::condition_variable jobWaiter_;
-	std::atomic< bool > exit_;
-	std::mutex backgroundJobMutex_;
-	std::list< IBackgroundWorker::JobFunction > backgroundJobs_;
+	std::vector<Worker> workers_;
+	WorkQueue sharedQueues_[PRIORITY_COUNT];
+	THREAD_LOCAL(Worker*) currentWorker_;
+
 	std::mutex foregroundJobMutex_;
-	std::list< IBackgroundWorker::JobFunction > foregroundJobs_;
-	std::vector< std::unique_ptr< std::thread > > backgroundThreads_;
+	std::deque<JobPtr> foregroundJobs_;
 	Connection foregroundUpdateConnection_;
 };
 
@@ -98,39 +426,31 @@ BackgroundWorker::BackgroundWorker()
 //------------------------------------------------------------------------------
 BackgroundWorker::~BackgroundWorker()
 {
-	{
-		std::lock_guard< std::mutex > holder(impl_->backgroundJobMutex_);
-		impl_->exit_ = true;
-		impl_->jobWaiter_.notify_all();
-	}
-	for (size_t i = 0; i < impl_->backgroundThreads_.size(); ++i)
-	{
-		impl_->backgroundThreads_[ i ]->join();
-	}
+	impl_.reset();
 }
 
 //------------------------------------------------------------------------------
 void BackgroundWorker::queueBackgroundJob(IBackgroundWorker::JobFunction job)
 {
-	if (impl_->exit_)
-	{
-		return;
-	}
-	{
-		std::lock_guard< std::mutex > holder(impl_->backgroundJobMutex_);
-		impl_->backgroundJobs_.emplace_back(job);
-	}
-	impl_->jobWaiter_.notify_one();
+	impl_->queue([job](const IBackgroundJob&) { job(); }, JobPriority::Normal, false, JobDependencies());
 }
 
 //------------------------------------------------------------------------------
 void BackgroundWorker::queueForegroundJob(IBackgroundWorker::JobFunction job)
 {
-	if (impl_->exit_)
-	{
-		return;
-	}
-	std::lock_guard< std::mutex > holder(impl_->foregroundJobMutex_);
-	impl_->foregroundJobs_.emplace_back(job);
+	impl_->queue([job](const IBackgroundJob&) { job(); }, JobPriority::Normal, true, JobDependencies());
+}
+
+//------------------------------------------------------------------------------
+BackgroundJobPtr BackgroundWorker::queueJob(CancellableJobFunction job, JobPriority priority,
+                                            const JobDependencies& dependencies)
+{
+	return impl_->queue(job, priority, false, dependencies);
+}
+
+//------------------------------------------------------------------------------
+BackgroundJobPtr BackgroundWorker::queueForegroundJob(CancellableJobFunction job, const JobDependencies& dependencies)
+{
+	return impl_->queue(job, JobPriority::Normal, true, dependencies);
+}
 }
-}
\ No newline at end of file
@@ -19,8 +19,12 @@ public:
 	~BackgroundWorker();
 	void queueBackgroundJob(IBackgroundWorker::JobFunction job) override;
 	void queueForegroundJob(IBackgroundWorker::JobFunction job) override;
+	BackgroundJobPtr queueJob(CancellableJobFunction job, JobPriority priority,
+	                          const JobDependencies& dependencies) override;
+	BackgroundJobPtr queueForegroundJob(CancellableJobFunction job, const JobDependencies& dependencies) override;
 
 private:
+	class Job;
 	struct Impl;
 	std::unique_ptr< Impl > impl_;
 };
@@ -0,0 +1,197 @@
+#include "CppUnitLite2/src/CppUnitLite2.h"
+#include "core_unit_test/unit_test.hpp"
+#include "core_unit_test/test_application.hpp"
+#include "core_unit_test/test_global_context.hpp"
+#include "private/background_worker.hpp"
+
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace wgt
+{
+namespace
+{
+typedef IBackgroundWorker::JobPriority JobPriority;
+
+// Records the order jobs ran in from any thread
+class JobLog
+{
+public:
+	void add(const std::string& name)
+	{
+		std::lock_guard<std::mutex> lock(mutex_);
+		names_.push_back(name);
+	}
+
+	int indexOf(const std::string& name)
+	{
+		std::lock_guard<std::mutex> lock(mutex_);
+		for (size_t i = 0; i < names_.size(); ++i)
+		{
+			if (names_[i] == name)
+			{
+				return static_cast<int>(i);
+			}
+		}
+		return -1;
+	}
+
+private:
+	std::mutex mutex_;
+	std::vector<std::string> names_;
+};
+
+IBackgroundWorker::CancellableJobFunction logJob(JobLog& log, const char* name)
+{
+	return [&log, name](const IBackgroundJob&) { log.add(name); };
+}
+}
+
+class TestBackgroundWorkerFixture
+{
+public:
+	TestBackgroundWorkerFixture()
+	{
+		applicationHolder_ = registerInterface<IApplication>(&application_);
+		worker_.reset(new BackgroundWorker());
+	}
+
+	~TestBackgroundWorkerFixture()
+	{
+		worker_.reset();
+		deregisterInterface(applicationHolder_.get());
+	}
+
+	IBackgroundWorker& worker()
+	{
+		return *worker_;
+	}
+
+	// Runs the foreground jobs as the application's update would
+	void update()
+	{
+		application_.signalUpdate();
+	}
+
+	// A job is done before its dependents are queued, so a foreground dependent may need a few updates
+	void updateUntilDone(const BackgroundJobPtr& job)
+	{
+		while (!job->isDone())
+		{
+			update();
+			std::this_thread::yield();
+		}
+	}
+
+protected:
+	TestApplication application_;
+	InterfacePtr applicationHolder_;
+	std::unique_ptr<BackgroundWorker> worker_;
+};
+
+TEST_F(TestBackgroundWorkerFixture, background_worker_dependency_order)
+{
+	JobLog log;
+
+	// Foreground jobs only run on the application's update, so this one holds back everything after it
+	auto first = worker().queueForegroundJob(logJob(log, "first"), IBackgroundWorker::JobDependencies());
+	auto second = worker().queueJob(logJob(log, "second"), JobPriority::High, { first });
+	auto last = worker().queueJob(logJob(log, "last"), JobPriority::Low, { first, second });
+	auto foreground = worker().queueForegroundJob(logJob(log, "foreground"), { last });
+
+	auto independent = worker().queueJob(logJob(log, "independent"));
+	independent->wait();
+	CHECK(!first->isDone() && !second->isDone() && !last->isDone());
+
+	update();
+	last->wait();
+	CHECK(log.indexOf("first") < log.indexOf("second"));
+	CHECK(log.indexOf("second") < log.indexOf("last"));
+
+	updateUntilDone(foreground);
+	CHECK(log.indexOf("last") < log.indexOf("foreground"));
+}
+
+TEST_F(TestBackgroundWorkerFixture, background_worker_cancel_propagation)
+{
+	JobLog log;
+	auto blocker = worker().queueForegroundJob(logJob(log, "blocker"), IBackgroundWorker::JobDependencies());
+	auto cancelled = worker().queueJob(logJob(log, "cancelled"), JobPriority::Normal, { blocker });
+	auto dependent = worker().queueJob(logJob(log, "dependent"), JobPriority::Normal, { cancelled });
+	auto foreground = worker().queueForegroundJob(logJob(log, "foreground"), { dependent });
+
+	cancelled->cancel();
+	update();
+	updateUntilDone(foreground);
+
+	// Skipping a job skips everything that depends on it
+	CHECK(blocker->isDone() && !blocker->isCancelled());
+	CHECK(cancelled->isDone() && dependent->isDone() && foreground->isDone());
+	CHECK(dependent->isCancelled() && foreground->isCancelled());
+	CHECK_EQUAL(0, log.indexOf("blocker"));
+	CHECK_EQUAL(-1, log.indexOf("cancelled"));
+	CHECK_EQUAL(-1, log.indexOf("dependent"));
+	CHECK_EQUAL(-1, log.indexOf("foreground"));
+
+	// Including jobs queued after it was skipped
+	auto late = worker().queueJob(logJob(log, "late"), JobPriority::Normal, { cancelled });
+	late->wait();
+	CHECK(late->isCancelled());
+	CHECK_EQUAL(-1, log.indexOf("late"));
+}
+
+TEST_F(TestBackgroundWorkerFixture, background_worker_nested_queueing)
+{
+	const int PARENT_COUNT = 8;
+	const int CHILD_COUNT = 100;
+
+	// Jobs queued from a worker thread go on that thread's own queues, where idle threads steal them
+	std::atomic<int> children(0);
+	std::mutex childJobsMutex;
+	std::vector<BackgroundJobPtr> childJobs;
+	std::vector<BackgroundJobPtr> parents;
+	for (int i = 0; i < PARENT_COUNT; ++i)
+	{
+		parents.push_back(worker().queueJob([&](const IBackgroundJob&) {
+			for (int j = 0; j < CHILD_COUNT; ++j)
+			{
+				auto child = worker().queueJob([&children](const IBackgroundJob&) { ++children; });
+				std::lock_guard<std::mutex> lock(childJobsMutex);
+				childJobs.push_back(child);
+			}
+		}));
+	}
+
+	for (auto& parent : parents)
+	{
+		parent->wait();
+	}
+	CHECK_EQUAL(size_t(PARENT_COUNT * CHILD_COUNT), childJobs.size());
+
+	bool joined = false;
+	auto join = worker().queueForegroundJob([&](const IBackgroundJob&) { joined = true; }, childJobs);
+	updateUntilDone(join);
+	CHECK_EQUAL(PARENT_COUNT * CHILD_COUNT, children.load());
+	CHECK(joined);
+}
+
+TEST_F(TestBackgroundWorkerFixture, background_worker_shutdown_releases_dependents)
+{
+	JobLog log;
+
+	// The foreground job never gets an update, so shutting down skips it and then what depends on it
+	auto foreground = worker().queueForegroundJob(logJob(log, "foreground"), IBackgroundWorker::JobDependencies());
+	auto dependent = worker().queueJob(logJob(log, "dependent"), JobPriority::Normal, { foreground });
+	auto continuation = worker().queueForegroundJob(logJob(log, "continuation"), { dependent });
+	worker_.reset();
+
+	CHECK(foreground->isDone() && dependent->isDone() && continuation->isDone());
+	CHECK(dependent->isCancelled() && continuation->isCancelled());
+	CHECK_EQUAL(-1, log.indexOf("dependent"));
+	CHECK_EQUAL(-1, log.indexOf("continuation"));
+}
+} // end namespace wgt
@@ -8,9 +8,11 @@
 #include "core_logging_system/interfaces/i_logging_system.hpp"
 #include "core_logging_system/log_level.hpp"
 
+#include <algorithm>
+
 namespace wgt
 {
-ProgressManager::ProgressManager() : progressValue_(0), isMultiCommandProgress_(false), isViewVisible_(false)
+ProgressManager::ProgressManager() : progressValue_(0), isMultiCommandProgress_(false), multiCommandDepth_(0), isViewVisible_(false)
 {
 }
 
@@ -112,20 +114,24 @@ void ProgressManager::multiCommandStatusChanged(MultiCommandStatus multiCommandS
 	{
 	case ICommandEventListener::MultiCommandStatus_Begin:
 	{
-		isMultiCommandProgress_ = true;
-		createProgressDialog();
-		break;
-	}
-
-	case ICommandEventListener::MultiCommandStatus_Cancel:
-	{
+		// Nested batches share the dialog of the outermost one
+		if (multiCommandDepth_++ == 0)
+		{
+			isMultiCommandProgress_ = true;
+			createProgressDialog();
+		}
 		break;
 	}
 
+	case ICommandEventListener::MultiCommandStatus_Cancel: // Intentional fall through
 	case ICommandEventListener::MultiCommandStatus_Complete:
 	{
-		isMultiCommandProgress_ = false;
-		progressCompleted();
+		multiCommandDepth_ = std::max(multiCommandDepth_ - 1, 0);
+		if (multiCommandDepth_ == 0)
+		{
+			isMultiCommandProgress_ = false;
+			progressCompleted();
+		}
 		break;
 	}
 
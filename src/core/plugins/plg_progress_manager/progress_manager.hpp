@@ -73,6 +73,7 @@ private:
 	}
 	mutable int progressValue_;
 	mutable bool isMultiCommandProgress_;
+	mutable int multiCommandDepth_;
 	mutable CommandIdList commandIdList_;
 	mutable CommandIdList::iterator curCommandId_;
 	mutable bool isViewVisible_;
@@ -130,7 +130,7 @@ Item {
         WGImage {
             anchors.fill: parent
             fillMode: sourceSize.width > parent.width || sourceSize.height > parent.height ? Image.PreserveAspectFit : Image.Pad
-            source: validImagePreview ? "image://QtThumbnailProvider/" + currentPreview.imagePath : ""
+            source: validImagePreview ? "image://QtImagePreviewProvider/" + currentPreview.imagePath : ""
         }
         visible: validImagePreview
     }
@@ -139,7 +139,7 @@ Item {
             Layout.fillHeight: true
             Layout.fillWidth: true
             fillMode: sourceSize.width > parent.width || sourceSize.height > parent.height ? Image.PreserveAspectFit : Image.Pad
-            source: validTexturePreview ? "image://QtThumbnailProvider/" + currentPreview.texturePath : ""
+            source: validTexturePreview ? "image://QtImagePreviewProvider/" + currentPreview.texturePath : ""
         }
 
         WGScrollView {